@@ -0,0 +1,131 @@
+// bench/AnimationBench.cpp
+//
+// CPU cost of posing a crowd the way CrowdScene does each frame: per character,
+// sample the compressed walk and run clips, blend them and build the skinning
+// palette (src/Animation.h). Reports the clip compression, the cost of each
+// stage on one thread, and whole-crowd times on 1..N JobSystem threads for
+// 100 to 10k characters, against the 2 ms budget for 1000.
+#include "Animation.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+    const uint32_t COUNTS[] = { 100, 1000, 10000 };
+    const uint32_t GRAIN = 16;   // CrowdScene's characters per job
+    const int      RUNS = 15;
+    const double   BUDGET_MS = 2.0;   // for 1000 characters
+
+    double bestMs(const std::function<void()>& fn) {
+        double best = 1e30;
+        for (int r = 0; r < RUNS; r++) {
+            auto t0 = std::chrono::steady_clock::now();
+            fn();
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        }
+        return best;
+    }
+
+    struct Scratch {
+        std::vector<JointBlock> walk, run;
+        std::vector<Mat4>       model;
+    };
+
+    struct Crowd {
+        Skeleton      skeleton = createWalkerSkeleton();
+        AnimationClip walk = createWalkerClip(false);
+        AnimationClip run = createWalkerClip(true);
+
+        void animate(uint32_t i, float time, Scratch& s, Mat4* palette) const {
+            float phase = time * 1.1f + float(i) * 0.618f;
+            phase -= float(int(phase));
+            float weight = float(i % 11) / 10.0f;
+            walk.sample(phase * walk.duration(), s.walk.data());
+            run.sample(phase * run.duration(), s.run.data());
+            blendPoses(s.walk.data(), s.run.data(), weight, s.walk.data(), uint32_t(s.walk.size()));
+            Mat4 world = Mat4::translation(Vec3{ float(i % 32), 0.0f, float(i / 32) });
+            computeSkinningPalette(skeleton, s.walk.data(), world, s.model.data(), palette);
+        }
+    };
+
+    std::vector<Scratch> makeScratch(const Skeleton& skeleton, uint32_t threads) {
+        std::vector<Scratch> scratch(threads);
+        for (Scratch& s : scratch) {
+            s.walk.resize(jointBlockCount(skeleton.jointCount()));
+            s.run.resize(s.walk.size());
+            s.model.resize(skeleton.jointCount());
+        }
+        return scratch;
+    }
+}
+
+int main() {
+    Crowd crowd;
+    uint32_t joints = crowd.skeleton.jointCount();
+    uint32_t blocks = jointBlockCount(joints);
+    std::printf("math backend %s, %u joints per character\n", mathBackendName(), joints);
+    std::printf("walk clip: %u keys, %zu bytes (%zu raw)   run clip: %u keys, %zu bytes (%zu raw)\n\n",
+        crowd.walk.keyCount(), crowd.walk.compressedBytes(), crowd.walk.rawBytes(),
+        crowd.run.keyCount(), crowd.run.compressedBytes(), crowd.run.rawBytes());
+
+    // Stage costs on one thread, 1000 characters.
+    {
+        const uint32_t count = 1000;
+        std::vector<Scratch> scratch = makeScratch(crowd.skeleton, 1);
+        Scratch& s = scratch[0];
+        std::vector<Mat4> palettes(size_t(count) * joints);
+        double sampleMs = bestMs([&] {
+            for (uint32_t i = 0; i < count; i++) {
+                crowd.walk.sample(float(i) * 0.01f, s.walk.data());
+                crowd.run.sample(float(i) * 0.01f, s.run.data());
+            }
+        });
+        double blendMs = bestMs([&] {
+            for (uint32_t i = 0; i < count; i++) {
+                blendPoses(s.walk.data(), s.run.data(), 0.4f, s.walk.data(), blocks);
+            }
+        });
+        double paletteMs = bestMs([&] {
+            for (uint32_t i = 0; i < count; i++) {
+                computeSkinningPalette(crowd.skeleton, s.walk.data(), Mat4::identity(), s.model.data(),
+                    &palettes[size_t(i) * joints]);
+            }
+        });
+        std::printf("1000 characters, one thread: sample x2 %.3f ms, blend %.3f ms, palette %.3f ms\n\n",
+            sampleMs, blendMs, paletteMs);
+    }
+
+    uint32_t hardware = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<uint32_t> threadCounts = { 1 };
+    for (uint32_t t = 2; t < hardware; t *= 2) threadCounts.push_back(t);
+    if (hardware > 1) threadCounts.push_back(hardware);
+
+    std::printf("%10s %8s %10s %14s\n", "characters", "threads", "ms", "joints/ms");
+    for (uint32_t count : COUNTS) {
+        std::vector<Mat4> palettes(size_t(count) * joints);
+        for (uint32_t threads : threadCounts) {
+            JobSystem jobs;
+            jobs.init(threads);
+            std::vector<Scratch> scratch = makeScratch(crowd.skeleton, jobs.threadCount());
+            float time = 0.0f;
+            double ms = bestMs([&] {
+                time += 1.0f / 60.0f;
+                jobs.parallelFor(count, GRAIN, [&](uint32_t begin, uint32_t end, uint32_t thread) {
+                    for (uint32_t i = begin; i < end; i++) {
+                        crowd.animate(i, time, scratch[thread], &palettes[size_t(i) * joints]);
+                    }
+                });
+            });
+            jobs.cleanup();
+            std::printf("%10u %8u %10.3f %14.0f%s\n", count, threads, ms, double(count) * joints / ms,
+                count == 1000 && ms > BUDGET_MS ? "   over budget" : "");
+        }
+    }
+    return 0;
+}
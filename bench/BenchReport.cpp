@@ -0,0 +1,309 @@
+// bench/BenchReport.cpp
+#include "BenchReport.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+namespace {
+    const int REPORT_VERSION = 1;
+
+    // Changes below this (in the metric's own unit) never count as regressions:
+    // sub-microsecond phases and fractional allocation counts are mostly noise.
+    const double MIN_ABSOLUTE_CHANGE = 0.01;
+
+    double percentile(const std::vector<double>& sorted, double p) {
+        // Nearest-rank on the sorted samples.
+        size_t rank = size_t(std::ceil(p * double(sorted.size())));
+        return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+
+    //---------------------------------------------------------------------
+    // JSON writing
+    //---------------------------------------------------------------------
+
+    void writeString(std::ostream& out, const std::string& s) {
+        out << '"';
+        for (char c : s) {
+            switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out << buf;
+                }
+                else {
+                    out << c;
+                }
+            }
+        }
+        out << '"';
+    }
+
+    void writeNumber(std::ostream& out, double value) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.6g", std::isfinite(value) ? value : 0.0);
+        out << buf;
+    }
+
+    //---------------------------------------------------------------------
+    // JSON reading (just enough for the files writeReport() produces)
+    //---------------------------------------------------------------------
+
+    class JsonReader {
+    public:
+        explicit JsonReader(const std::string& text) : text(text) {}
+
+        const std::string& error() const { return err; }
+
+        // Calls `member(key)` for every member; the callback must consume the value.
+        bool object(const std::function<bool(const std::string&)>& member) {
+            if (!expect('{')) return false;
+            if (peek() == '}') { pos++; return true; }
+            while (true) {
+                std::string key;
+                if (!string(key) || !expect(':') || !member(key)) return false;
+                char c = peek();
+                pos++;
+                if (c == '}') return true;
+                if (c != ',') return fail("expected ',' or '}'");
+            }
+        }
+
+        bool string(std::string& out) {
+            if (!expect('"')) return false;
+            out.clear();
+            while (pos < text.size() && text[pos] != '"') {
+                char c = text[pos++];
+                if (c == '\\' && pos < text.size()) {
+                    char e = text[pos++];
+                    switch (e) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'u':
+                        if (pos + 4 > text.size()) return fail("bad escape");
+                        out += char(std::strtol(text.substr(pos, 4).c_str(), nullptr, 16));
+                        pos += 4;
+                        break;
+                    default: out += e; break;
+                    }
+                }
+                else {
+                    out += c;
+                }
+            }
+            if (pos >= text.size()) return fail("unterminated string");
+            pos++;
+            return true;
+        }
+
+        bool number(double& out) {
+            peek();
+            const char* begin = text.c_str() + pos;
+            char* end = nullptr;
+            out = std::strtod(begin, &end);
+            if (end == begin) return fail("expected a number");
+            pos += size_t(end - begin);
+            return true;
+        }
+
+        // Skips a value of any type (unknown keys from newer versions).
+        bool skip() {
+            char c = peek();
+            if (c == '"') { std::string s; return string(s); }
+            if (c == '{') return object([this](const std::string&) { return skip(); });
+            if (c == '[') {
+                pos++;
+                if (peek() == ']') { pos++; return true; }
+                while (true) {
+                    if (!skip()) return false;
+                    char d = peek();
+                    pos++;
+                    if (d == ']') return true;
+                    if (d != ',') return fail("expected ',' or ']'");
+                }
+            }
+            for (const char* word : { "true", "false", "null" }) {
+                size_t n = std::char_traits<char>::length(word);
+                if (text.compare(pos, n, word) == 0) { pos += n; return true; }
+            }
+            double ignored;
+            return number(ignored);
+        }
+
+    private:
+        char peek() {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+            return pos < text.size() ? text[pos] : '\0';
+        }
+
+        bool expect(char c) {
+            if (peek() != c) return fail(std::string("expected '") + c + "'");
+            pos++;
+            return true;
+        }
+
+        bool fail(const std::string& what) {
+            if (err.empty()) err = what + " at offset " + std::to_string(pos);
+            return false;
+        }
+
+        const std::string& text;
+        size_t pos = 0;
+        std::string err;
+    };
+}
+
+//-------------------------------------------------------------------------
+// Report
+//-------------------------------------------------------------------------
+
+const double* ScenarioResult::find(const std::string& key) const {
+    for (const auto& metric : metrics) {
+        if (metric.first == key) return &metric.second;
+    }
+    return nullptr;
+}
+
+const ScenarioResult* BenchReport::find(const std::string& scenario) const {
+    for (const ScenarioResult& result : scenarios) {
+        if (result.name == scenario) return &result;
+    }
+    return nullptr;
+}
+
+void addDistribution(ScenarioResult& result, const std::string& prefix, std::vector<double> samples) {
+    if (samples.empty()) return;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double s : samples) sum += s;
+
+    result.add(prefix + "_mean", sum / double(samples.size()));
+    result.add(prefix + "_p50", percentile(samples, 0.50));
+    result.add(prefix + "_p90", percentile(samples, 0.90));
+    result.add(prefix + "_p95", percentile(samples, 0.95));
+    result.add(prefix + "_p99", percentile(samples, 0.99));
+    result.add(prefix + "_max", samples.back());
+}
+
+//-------------------------------------------------------------------------
+// JSON
+//-------------------------------------------------------------------------
+
+bool writeReport(const BenchReport& report, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    out << "{\n  \"version\": " << REPORT_VERSION << ",\n  \"device\": ";
+    writeString(out, report.device);
+    out << ",\n  \"build\": ";
+    writeString(out, report.build);
+    out << ",\n  \"frames\": " << report.frames << ",\n  \"scenarios\": {";
+    for (size_t s = 0; s < report.scenarios.size(); s++) {
+        const ScenarioResult& scenario = report.scenarios[s];
+        out << (s ? ",\n    " : "\n    ");
+        writeString(out, scenario.name);
+        out << ": {";
+        for (size_t m = 0; m < scenario.metrics.size(); m++) {
+            out << (m ? ",\n      " : "\n      ");
+            writeString(out, scenario.metrics[m].first);
+            out << ": ";
+            writeNumber(out, scenario.metrics[m].second);
+        }
+        out << "\n    }";
+    }
+    out << "\n  }\n}\n";
+    return bool(out);
+}
+
+bool readReport(const std::string& path, BenchReport& report, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+
+    report = BenchReport{};
+    JsonReader json(text);
+    bool ok = json.object([&](const std::string& key) {
+        if (key == "device") return json.string(report.device);
+        if (key == "build") return json.string(report.build);
+        if (key == "frames") {
+            double frames = 0.0;
+            if (!json.number(frames)) return false;
+            report.frames = int(frames);
+            return true;
+        }
+        if (key != "scenarios") return json.skip();
+
+        return json.object([&](const std::string& name) {
+            report.scenarios.push_back(ScenarioResult{ name, {} });
+            return json.object([&](const std::string& metric) {
+                double value = 0.0;
+                if (!json.number(value)) return false;
+                report.scenarios.back().add(metric, value);
+                return true;
+            });
+        });
+    });
+    if (!ok) error = path + ": " + json.error();
+    return ok;
+}
+
+//-------------------------------------------------------------------------
+// Comparison
+//-------------------------------------------------------------------------
+
+std::vector<Regression> compareReports(const BenchReport& baseline, const BenchReport& current, double threshold) {
+    std::vector<Regression> regressions;
+    for (const ScenarioResult& now : current.scenarios) {
+        const ScenarioResult* before = baseline.find(now.name);
+        if (!before) continue;
+        for (const auto& metric : now.metrics) {
+            const double* old = before->find(metric.first);
+            if (!old) continue;
+            double grown = metric.second - *old;
+            if (grown > MIN_ABSOLUTE_CHANGE && metric.second > *old * (1.0 + threshold)) {
+                regressions.push_back({ now.name, metric.first, *old, metric.second });
+            }
+        }
+    }
+    return regressions;
+}
+
+void printComparison(const BenchReport& baseline, const BenchReport& current,
+                     const std::vector<Regression>& regressions) {
+    std::printf("baseline: %s (%s)\ncurrent:  %s (%s)\n",
+        baseline.device.c_str(), baseline.build.c_str(), current.device.c_str(), current.build.c_str());
+
+    for (const ScenarioResult& now : current.scenarios) {
+        const ScenarioResult* before = baseline.find(now.name);
+        if (!before) {
+            std::printf("\n%s: not in baseline\n", now.name.c_str());
+            continue;
+        }
+        std::printf("\n%-24s %14s %14s %9s\n", now.name.c_str(), "baseline", "current", "change");
+        for (const auto& metric : now.metrics) {
+            const double* old = before->find(metric.first);
+            if (!old) continue;
+            bool regressed = std::any_of(regressions.begin(), regressions.end(), [&](const Regression& r) {
+                return r.scenario == now.name && r.metric == metric.first;
+            });
+            double change = *old != 0.0 ? (metric.second - *old) / *old * 100.0 : 0.0;
+            std::printf("  %-22s %14.4f %14.4f %+8.1f%%%s\n", metric.first.c_str(), *old, metric.second,
+                change, regressed ? "  REGRESSION" : "");
+        }
+    }
+}
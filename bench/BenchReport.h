@@ -0,0 +1,50 @@
+// bench/BenchReport.h
+//
+// Results of a GameEngineBench run and the JSON file they are stored in.
+// Every metric is a number where lower is better (milliseconds, counts,
+// bytes), which is what lets compareReports() treat them uniformly.
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ScenarioResult {
+    std::string name;
+    std::vector<std::pair<std::string, double>> metrics;   // kept in insertion order
+
+    void add(const std::string& key, double value) { metrics.emplace_back(key, value); }
+    // Pointer to the metric's value, or nullptr when the scenario has no such metric.
+    const double* find(const std::string& key) const;
+};
+
+struct BenchReport {
+    std::string device;          // GPU the numbers were taken on
+    std::string build;           // compiler / SIMD backend
+    int         frames = 0;      // measured frames per scenario
+    std::vector<ScenarioResult> scenarios;
+
+    const ScenarioResult* find(const std::string& scenario) const;
+};
+
+// Adds <prefix>_mean, _p50, _p90, _p95, _p99 and _max of `samples` to `result`.
+void addDistribution(ScenarioResult& result, const std::string& prefix, std::vector<double> samples);
+
+// JSON round trip. readReport() only understands the layout writeReport() produces.
+bool writeReport(const BenchReport& report, const std::string& path);
+bool readReport(const std::string& path, BenchReport& report, std::string& error);
+
+struct Regression {
+    std::string scenario;
+    std::string metric;
+    double      baseline = 0.0;
+    double      current = 0.0;
+};
+
+// Metrics present in both reports that grew by more than `threshold` (0.1 = 10%).
+// Changes smaller than a small absolute floor are treated as noise.
+std::vector<Regression> compareReports(const BenchReport& baseline, const BenchReport& current, double threshold);
+
+// Prints every shared metric side by side, marking the ones in `regressions`.
+void printComparison(const BenchReport& baseline, const BenchReport& current,
+                     const std::vector<Regression>& regressions);
@@ -0,0 +1,345 @@
+// bench/GameEngineBench.cpp
+//
+// Renders reproducible synthetic scenes through the real engine and writes the
+// numbers to JSON, so a change can be checked against a stored baseline:
+//
+//   GameEngineBench --out=results.json
+//   GameEngineBench --baseline=baseline.json --threshold=0.1
+//   GameEngineBench --compare=results.json --baseline=baseline.json
+//
+// It needs no window: VulkanApp runs headless on VK_EXT_headless_surface, so it
+// works on CI machines with a software driver such as lavapipe. Animation runs
+// on a fixed 60 Hz clock and the camera never moves, so every run renders the
+// same frames. Exit code 1 means a regression, 2 an error.
+#include "VulkanApp.h"
+#include "Math.h"
+#include "BenchReport.h"
+#include "HostMemoryTracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    const VkExtent2D BENCH_EXTENT = { 1280, 720 };
+    const float      FRAME_STEP = 1.0f / 60.0f;   // fixed animation clock
+
+    // resize_storm cycles through these, one step every RESIZE_INTERVAL frames.
+    const VkExtent2D RESIZE_CYCLE[] = { { 1280, 720 }, { 800, 600 }, { 1920, 1080 }, { 643, 397 }, { 1024, 1024 } };
+    const int        RESIZE_INTERVAL = 4;
+
+    const int PIPELINE_BURST_COUNT = 64;
+
+    struct Options {
+        int         frames = 300;
+        int         warmupFrames = 30;
+        std::string scenario;                 // empty = all
+        std::string out = "bench_results.json";
+        std::string baseline;
+        std::string compare;                  // results file to compare instead of running
+        double      threshold = 0.10;
+    };
+
+    // Heap allocations so far, from the operator new hook this executable links
+    // (src/HostAllocationHook.cpp).
+    struct Counters {
+        uint64_t count = HostMemoryTracker::global().heapAllocations();
+        uint64_t bytes = HostMemoryTracker::global().heapBytes();
+    };
+
+    double msSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    //---------------------------------------------------------------------
+    // Scenarios
+    //---------------------------------------------------------------------
+
+    enum class ScenarioKind { Frames, ResizeStorm, PipelineBurst };
+
+    struct Scenario {
+        const char*  name;
+        ScenarioKind kind;
+        void       (*configure)(RenderSettings&);
+    };
+
+    const Scenario SCENARIOS[] = {
+        // ~2300 rocks, one vkCmdDrawIndexed each: CPU recording and driver overhead.
+        { "many_draws", ScenarioKind::Frames, [](RenderSettings& s) {
+            s.scene = SceneKind::Lod;
+            s.lodGridSize = 48;
+            s.lodDrawPerInstance = true;
+        } },
+        // 16k rocks in a handful of instanced draws: transforms, LOD selection, uploads.
+        { "many_instances", ScenarioKind::Frames, [](RenderSettings& s) {
+            s.scene = SceneKind::Lod;
+            s.lodGridSize = 128;
+        } },
+        // The same field culled on the GPU (frustum + Hi-Z) and drawn indirectly.
+        { "occlusion_culling", ScenarioKind::Frames, [](RenderSettings& s) {
+            s.scene = SceneKind::Lod;
+            s.lodGridSize = 128;
+            s.occlusionCulling = true;
+        } },
+        // Four shadow cascades over the rock field: static casters cached, spinning clusters redrawn.
+        { "shadows", ScenarioKind::Frames, [](RenderSettings& s) {
+            s.scene = SceneKind::Lod;
+            s.lodGridSize = 128;
+            s.shadows = true;
+        } },
+        // The same with every caster redrawn into every cascade each frame, for comparison.
+        { "shadows_uncached", ScenarioKind::Frames, [](RenderSettings& s) {
+            s.scene = SceneKind::Lod;
+            s.lodGridSize = 128;
+            s.shadows = true;
+            s.shadowCache = false;
+        } },
+        // The rock field rendered to an HDR target, then bloom, auto-exposure and tonemapping in compute.
+        { "post", ScenarioKind::Frames, [](RenderSettings& s) {
+            s.scene = SceneKind::Lod;
+            s.lodGridSize = 128;
+            s.postProcess = true;
+        } },
+        // 100k alpha-blended sprites on 5 textures and 4 layers: CPU batching and fill rate.
+        { "many_sprites", ScenarioKind::Frames, [](RenderSettings& s) {
+            s.scene = SceneKind::Sprites;
+            s.spriteCount = 100000;
+        } },
+        // 1000 skinned characters blending walk and run cycles, posed on every hardware thread.
+        { "crowd", ScenarioKind::Frames, [](RenderSettings& s) {
+            s.scene = SceneKind::Crowd;
+            s.characterCount = 1000;
+        } },
+        // Swapchain recreation every few frames, as while dragging a window edge.
+        { "resize_storm", ScenarioKind::ResizeStorm, [](RenderSettings& s) {
+            s.scene = SceneKind::Triangle;
+            s.msaaSamples = 4;
+        } },
+        // Back-to-back graphics pipeline creation, as when streaming in new materials.
+        { "pipeline_burst", ScenarioKind::PipelineBurst, [](RenderSettings& s) {
+            s.scene = SceneKind::Triangle;
+        } },
+    };
+
+    // Per-frame results of the Frames and ResizeStorm scenarios.
+    void runFrames(const Scenario& scenario, const Options& options, VulkanApp& app, ScenarioResult& result) {
+        const Renderer& renderer = app.getRenderer();
+        int frame = 0;
+        auto render = [&] {
+            if (scenario.kind == ScenarioKind::ResizeStorm && frame > 0 && frame % RESIZE_INTERVAL == 0) {
+                size_t step = size_t(frame / RESIZE_INTERVAL) % (sizeof(RESIZE_CYCLE) / sizeof(RESIZE_CYCLE[0]));
+                app.resize(RESIZE_CYCLE[step]);
+            }
+            app.renderFrame(float(frame) * FRAME_STEP);
+            frame++;
+        };
+
+        for (int i = 0; i < options.warmupFrames; i++) render();
+
+        std::vector<double> frameMs, gpuMs;
+        frameMs.reserve(options.frames);
+        gpuMs.reserve(options.frames);
+        FrameCpuTimings cpuTotals;
+        Counters before;
+
+        for (int i = 0; i < options.frames; i++) {
+            auto start = std::chrono::steady_clock::now();
+            render();
+            frameMs.push_back(msSince(start));
+
+            const FrameCpuTimings& cpu = renderer.lastCpuTimings();
+            cpuTotals.wait += cpu.wait;
+            cpuTotals.acquire += cpu.acquire;
+            cpuTotals.update += cpu.update;
+            cpuTotals.record += cpu.record;
+            cpuTotals.submit += cpu.submit;
+            cpuTotals.present += cpu.present;
+            gpuMs.push_back(renderer.lastGpuFrameMs());
+        }
+        Counters after;
+
+        double n = double(options.frames);
+        addDistribution(result, "frame_ms", std::move(frameMs));
+        result.add("cpu_wait_ms", cpuTotals.wait / n);
+        result.add("cpu_acquire_ms", cpuTotals.acquire / n);
+        result.add("cpu_update_ms", cpuTotals.update / n);
+        result.add("cpu_record_ms", cpuTotals.record / n);
+        result.add("cpu_submit_ms", cpuTotals.submit / n);
+        result.add("cpu_present_ms", cpuTotals.present / n);
+        addDistribution(result, "gpu_frame_ms", std::move(gpuMs));
+        result.add("allocs_per_frame", double(after.count - before.count) / n);
+        result.add("alloc_bytes_per_frame", double(after.bytes - before.bytes) / n);
+    }
+
+    // Creates PIPELINE_BURST_COUNT pipelines cycling through a few state combinations.
+    void runPipelineBurst(VulkanApp& app, ScenarioResult& result) {
+        std::vector<PipelineConfig> configs(4);
+        configs[1].depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+        configs[1].cullMode = VK_CULL_MODE_NONE;
+        configs[2].fragShader.clear();       // depth-only, like the pre-pass
+        configs[2].colorWrite = false;
+        configs[3].vertShader = "shaders_spv/overdraw_vert.spv";
+        configs[3].fragShader = "shaders_spv/overdraw_frag.spv";
+        configs[3].pushConstantSize = sizeof(OverdrawPushConstants);
+        configs[3].additiveBlend = true;
+
+        std::vector<Pipeline> pipelines(PIPELINE_BURST_COUNT);
+        std::vector<double> createMs;
+        createMs.reserve(PIPELINE_BURST_COUNT);
+
+        Counters before;
+        for (int i = 0; i < PIPELINE_BURST_COUNT; i++) {
+            auto start = std::chrono::steady_clock::now();
+            pipelines[i].init(app.getDevice(), app.getSwapChain(), app.getRenderPass(), configs[i % configs.size()]);
+            createMs.push_back(msSince(start));
+        }
+        Counters after;
+        for (Pipeline& pipeline : pipelines) pipeline.cleanup();
+
+        addDistribution(result, "pipeline_ms", std::move(createMs));
+        result.add("allocs_per_pipeline", double(after.count - before.count) / PIPELINE_BURST_COUNT);
+    }
+
+    ScenarioResult runScenario(const Scenario& scenario, const Options& options, std::string& deviceName) {
+        RenderSettings settings;
+        scenario.configure(settings);
+
+        auto app = std::make_unique<VulkanApp>(settings);
+        auto startupStart = std::chrono::steady_clock::now();
+        app->initHeadless(BENCH_EXTENT);
+        double startupMs = msSince(startupStart);
+
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(app->getDevice().physicalDevice(), &props);
+        deviceName = props.deviceName;
+
+        ScenarioResult result;
+        result.name = scenario.name;
+        result.add("startup_ms", startupMs);
+        if (scenario.kind == ScenarioKind::PipelineBurst) {
+            runPipelineBurst(*app, result);
+        }
+        else {
+            runFrames(scenario, options, *app, result);
+        }
+        app->shutdown();
+        return result;
+    }
+
+    void printResult(const ScenarioResult& result) {
+        std::printf("%s\n", result.name.c_str());
+        for (const auto& metric : result.metrics) {
+            std::printf("  %-22s %12.4f\n", metric.first.c_str(), metric.second);
+        }
+    }
+
+    //---------------------------------------------------------------------
+    // Command line
+    //---------------------------------------------------------------------
+
+    const char* optionValue(const char* arg, const char* name) {
+        size_t n = std::strlen(name);
+        return std::strncmp(arg, name, n) == 0 && arg[n] == '=' ? arg + n + 1 : nullptr;
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const char* arg = argv[i];
+            const char* value = nullptr;
+            if ((value = optionValue(arg, "--frames")) != nullptr) {
+                options.frames = std::max(1, std::atoi(value));
+            }
+            else if ((value = optionValue(arg, "--warmup")) != nullptr) {
+                options.warmupFrames = std::max(0, std::atoi(value));
+            }
+            else if ((value = optionValue(arg, "--scenario")) != nullptr) {
+                options.scenario = value;
+            }
+            else if ((value = optionValue(arg, "--out")) != nullptr) {
+                options.out = value;
+            }
+            else if ((value = optionValue(arg, "--baseline")) != nullptr) {
+                options.baseline = value;
+            }
+            else if ((value = optionValue(arg, "--compare")) != nullptr) {
+                options.compare = value;
+            }
+            else if ((value = optionValue(arg, "--threshold")) != nullptr) {
+                options.threshold = std::atof(value);
+            }
+            else {
+                std::fprintf(stderr,
+                    "usage: GameEngineBench [--scenario=<name>] [--frames=<n>] [--warmup=<n>] [--out=<file>]\n"
+                    "                       [--baseline=<file>] [--threshold=<fraction>] [--compare=<results>]\n"
+                    "scenarios: ");
+                for (const Scenario& scenario : SCENARIOS) {
+                    std::fprintf(stderr, "%s%s", &scenario == SCENARIOS ? "" : ", ", scenario.name);
+                }
+                std::fprintf(stderr, "\n");
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+
+    BenchReport current;
+    std::string error;
+    if (!options.compare.empty()) {
+        if (!readReport(options.compare, current, error)) {
+            std::fprintf(stderr, "Error: %s\n", error.c_str());
+            return 2;
+        }
+    }
+    else {
+#ifdef NDEBUG
+        current.build = std::string(mathBackendName()) + " release";
+#else
+        current.build = std::string(mathBackendName()) + " debug";
+#endif
+        current.frames = options.frames;
+
+        try {
+            for (const Scenario& scenario : SCENARIOS) {
+                if (!options.scenario.empty() && options.scenario != scenario.name) continue;
+                current.scenarios.push_back(runScenario(scenario, options, current.device));
+                printResult(current.scenarios.back());
+            }
+        }
+        catch (const std::exception& e) {
+            std::fprintf(stderr, "Error: %s\n", e.what());
+            return 2;
+        }
+        if (current.scenarios.empty()) {
+            std::fprintf(stderr, "Error: unknown scenario '%s'\n", options.scenario.c_str());
+            return 2;
+        }
+        if (!writeReport(current, options.out)) {
+            std::fprintf(stderr, "Error: failed to write %s\n", options.out.c_str());
+            return 2;
+        }
+        std::printf("wrote %s\n", options.out.c_str());
+    }
+
+    if (options.baseline.empty()) return 0;
+
+    BenchReport baseline;
+    if (!readReport(options.baseline, baseline, error)) {
+        std::fprintf(stderr, "Error: %s\n", error.c_str());
+        return 2;
+    }
+    std::vector<Regression> regressions = compareReports(baseline, current, options.threshold);
+    std::printf("\n");
+    printComparison(baseline, current, regressions);
+    std::printf("\n%zu regression(s) beyond %.0f%%\n", regressions.size(), options.threshold * 100.0);
+    return regressions.empty() ? 0 : 1;
+}
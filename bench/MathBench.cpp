@@ -0,0 +1,149 @@
+// bench/MathBench.cpp
+//
+// Microbenchmarks for the batch kernels in src/Math.h against a naive
+// implementation (unaligned float arrays, textbook triple loop). Each case
+// reports the best of several runs and checks both versions agree.
+#include "Math.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+    const size_t POINT_COUNT = 1 << 20;
+    const size_t MATRIX_COUNT = 1 << 16;
+    const int    RUNS = 15;
+
+    //---------------------------------------------------------------------
+    // Naive reference
+    //---------------------------------------------------------------------
+
+    struct NaiveVec3 { float v[3]; };
+    struct NaiveMat4 { float m[16]; };   // column-major
+
+    void naiveTransformPoints(const NaiveMat4& a, const NaiveVec3* in, NaiveVec3* out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            for (int row = 0; row < 3; row++) {
+                float sum = a.m[12 + row];
+                for (int k = 0; k < 3; k++) sum += a.m[k * 4 + row] * in[i].v[k];
+                out[i].v[row] = sum;
+            }
+        }
+    }
+
+    void naiveMultiply(const NaiveMat4& a, const NaiveMat4& b, NaiveMat4& out) {
+        for (int col = 0; col < 4; col++) {
+            for (int row = 0; row < 4; row++) {
+                float sum = 0.0f;
+                for (int k = 0; k < 4; k++) sum += a.m[k * 4 + row] * b.m[col * 4 + k];
+                out.m[col * 4 + row] = sum;
+            }
+        }
+    }
+
+    //---------------------------------------------------------------------
+    // Harness
+    //---------------------------------------------------------------------
+
+    double bestMs(const std::function<void()>& fn) {
+        double best = 1e30;
+        for (int r = 0; r < RUNS; r++) {
+            auto t0 = std::chrono::steady_clock::now();
+            fn();
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        }
+        return best;
+    }
+
+    void report(const char* name, size_t count, double naiveMs, double simdMs, float maxError) {
+        std::printf("%-28s %9zu %10.3f %10.3f %8.2fx %10.2e\n", name, count,
+            naiveMs, simdMs, naiveMs / simdMs, maxError);
+    }
+
+    Mat4 randomAffine(std::mt19937& rng) {
+        std::uniform_real_distribution<float> d(-1.0f, 1.0f);
+        Vec3 axis = normalize(Vec3{ d(rng), d(rng), d(rng) + 2.0f });
+        return Mat4::fromTRS(Vec3{ d(rng) * 10.0f, d(rng) * 10.0f, d(rng) * 10.0f },
+                             Quat::fromAxisAngle(axis, d(rng) * 3.14159f),
+                             Vec3{ 1.0f + d(rng) * 0.5f, 1.0f + d(rng) * 0.5f, 1.0f + d(rng) * 0.5f });
+    }
+
+    NaiveMat4 toNaive(const Mat4& m) {
+        NaiveMat4 r;
+        std::copy(m.m, m.m + 16, r.m);
+        return r;
+    }
+
+    float maxDiff(const float* a, const float* b, size_t n) {
+        float d = 0.0f;
+        for (size_t i = 0; i < n; i++) d = std::max(d, std::fabs(a[i] - b[i]));
+        return d;
+    }
+}
+
+int main() {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> d(-100.0f, 100.0f);
+
+    std::printf("Math backend: %s\n\n", mathBackendName());
+    std::printf("%-28s %9s %10s %10s %9s %10s\n", "case", "count", "naive ms", "simd ms", "speedup", "max err");
+
+    // Points
+    {
+        Mat4 m = randomAffine(rng);
+        NaiveMat4 nm = toNaive(m);
+        std::vector<Vec3> in(POINT_COUNT), out(POINT_COUNT);
+        std::vector<NaiveVec3> nin(POINT_COUNT), nout(POINT_COUNT);
+        for (size_t i = 0; i < POINT_COUNT; i++) {
+            in[i] = Vec3{ d(rng), d(rng), d(rng) };
+            nin[i] = { { in[i].x, in[i].y, in[i].z } };
+        }
+
+        double naiveMs = bestMs([&] { naiveTransformPoints(nm, nin.data(), nout.data(), POINT_COUNT); });
+        double simdMs = bestMs([&] { transformPoints(m, in.data(), out.data(), POINT_COUNT); });
+
+        float err = 0.0f;
+        for (size_t i = 0; i < POINT_COUNT; i++) {
+            const float r[3] = { out[i].x, out[i].y, out[i].z };
+            err = std::max(err, maxDiff(r, nout[i].v, 3));
+        }
+        report("transformPoints", POINT_COUNT, naiveMs, simdMs, err);
+    }
+
+    // Matrices: one parent times many children, and pairwise products.
+    {
+        Mat4 parent = randomAffine(rng);
+        NaiveMat4 nparent = toNaive(parent);
+        std::vector<Mat4> lhs(MATRIX_COUNT), rhs(MATRIX_COUNT), out(MATRIX_COUNT);
+        std::vector<NaiveMat4> nlhs(MATRIX_COUNT), nrhs(MATRIX_COUNT), nout(MATRIX_COUNT);
+        for (size_t i = 0; i < MATRIX_COUNT; i++) {
+            lhs[i] = randomAffine(rng);
+            rhs[i] = randomAffine(rng);
+            nlhs[i] = toNaive(lhs[i]);
+            nrhs[i] = toNaive(rhs[i]);
+        }
+
+        double naiveMs = bestMs([&] {
+            for (size_t i = 0; i < MATRIX_COUNT; i++) naiveMultiply(nparent, nrhs[i], nout[i]);
+        });
+        double simdMs = bestMs([&] { multiplyMatrices(parent, rhs.data(), out.data(), MATRIX_COUNT); });
+        float err = 0.0f;
+        for (size_t i = 0; i < MATRIX_COUNT; i++) err = std::max(err, maxDiff(out[i].m, nout[i].m, 16));
+        report("multiplyMatrices (1 x N)", MATRIX_COUNT, naiveMs, simdMs, err);
+
+        naiveMs = bestMs([&] {
+            for (size_t i = 0; i < MATRIX_COUNT; i++) naiveMultiply(nlhs[i], nrhs[i], nout[i]);
+        });
+        simdMs = bestMs([&] { multiplyMatrices(lhs.data(), rhs.data(), out.data(), MATRIX_COUNT); });
+        err = 0.0f;
+        for (size_t i = 0; i < MATRIX_COUNT; i++) err = std::max(err, maxDiff(out[i].m, nout[i].m, 16));
+        report("multiplyMatrices (N x N)", MATRIX_COUNT, naiveMs, simdMs, err);
+    }
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+// bench/SpatialBench.cpp
+//
+// Dynamic AABB tree (src/AabbTree.h) against brute force for 10k, 100k and 1M
+// boxes scattered at constant density: build time and tree quality, the cost
+// of a frame in which 10% of the objects move, and raycast, overlap and
+// nearest-object queries per second, single-threaded and batched over every
+// hardware thread. Tree answers are checked against the brute-force ones.
+#include "AabbTree.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+    const uint32_t COUNTS[] = { 10000, 100000, 1000000 };
+    const uint32_t QUERIES = 20000;
+    const uint32_t MOVE_FRAMES = 30;
+    const float    MOVING_FRACTION = 0.1f;
+    // Brute force tests per measurement, so 1M objects stays quick.
+    const double   BRUTE_FORCE_TESTS = 4e7;
+
+    double timeMs(const std::function<void()>& fn) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(t1 - t0).count();
+    }
+
+    double perSecond(uint32_t queries, double ms) { return ms > 0.0 ? queries * 1000.0 / ms : 0.0; }
+
+    Aabb boxAround(const Vec3& center, const Vec3& half) { return { center - half, center + half }; }
+
+    float hitBox(const std::vector<Aabb>& boxes, uint32_t object, const Ray& ray, float maxT) {
+        float t;
+        return rayHitsBox(ray, inverseDirection(ray), boxes[object], maxT, t) ? t : -1.0f;
+    }
+
+    // Brute force answers, over the first `count` queries.
+    TreeHit bruteRaycast(const std::vector<Aabb>& boxes, const Ray& ray) {
+        TreeHit hit{ AabbTree::noHit, ray.maxT };
+        Vec3 inverse = inverseDirection(ray);
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            float t;
+            if (rayHitsBox(ray, inverse, boxes[i], hit.distance, t) && t < hit.distance) hit = { i, t };
+        }
+        return hit;
+    }
+
+    TreeHit bruteNearest(const std::vector<Aabb>& boxes, const Vec3& point) {
+        TreeHit hit{ AabbTree::noHit, std::numeric_limits<float>::max() };
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            float d = distanceSquared(boxes[i], point);
+            if (d < hit.distance) hit = { i, d };
+        }
+        return hit;
+    }
+}
+
+int main() {
+    JobSystem jobs;
+    jobs.init();
+    std::printf("math backend %s, %u job threads\n\n", mathBackendName(), jobs.threadCount());
+
+    for (uint32_t count : COUNTS) {
+        // About one object per 8 cubic units, whatever the count.
+        float extent = std::cbrt(float(count) * 8.0f) * 0.5f;
+        std::mt19937 rng(count);
+        std::uniform_real_distribution<float> position(-extent, extent);
+        std::uniform_real_distribution<float> size(0.1f, 0.6f);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        std::vector<Aabb> boxes(count);
+        std::vector<Vec3> halves(count);
+        for (uint32_t i = 0; i < count; i++) {
+            halves[i] = { size(rng), size(rng), size(rng) };
+            boxes[i] = boxAround({ position(rng), position(rng), position(rng) }, halves[i]);
+        }
+
+        // Objects are leaves' exact boxes; the tree only sees their fat boxes.
+        AabbTree tree(0.05f);
+        std::vector<int32_t> proxies(count);
+        double buildMs = timeMs([&] {
+            for (uint32_t i = 0; i < count; i++) proxies[i] = tree.createProxy(boxes[i], i);
+        });
+        float builtRatio = tree.areaRatio();
+
+        // Moving objects drift with a small per-object velocity.
+        uint32_t movingCount = uint32_t(count * MOVING_FRACTION);
+        std::vector<Vec3> velocity(movingCount);
+        for (Vec3& v : velocity) v = Vec3{ unit(rng), unit(rng), unit(rng) } * 0.05f;
+        uint64_t rotationsBefore = tree.rotationCount();
+        uint32_t treeMoves = 0;
+        double moveMs = timeMs([&] {
+            for (uint32_t frame = 0; frame < MOVE_FRAMES; frame++) {
+                for (uint32_t i = 0; i < movingCount; i++) {
+                    boxes[i].min = boxes[i].min + velocity[i];
+                    boxes[i].max = boxes[i].max + velocity[i];
+                    treeMoves += tree.moveProxy(proxies[i], boxes[i], velocity[i]) ? 1 : 0;
+                }
+            }
+        }) / MOVE_FRAMES;
+
+        std::printf("%u objects: build %.1f ms, height %d, area ratio %.1f\n", count, buildMs, tree.height(), builtRatio);
+        std::printf("  %u moving: %.3f ms per frame, %.1f%% left their fat box, %llu rotations, area ratio now %.1f\n",
+            movingCount, moveMs, 100.0 * treeMoves / (double(movingCount) * MOVE_FRAMES),
+            (unsigned long long)(tree.rotationCount() - rotationsBefore), tree.areaRatio());
+
+        // Queries: rays from inside the volume, small boxes, random points.
+        std::vector<Ray> rays(QUERIES);
+        std::vector<Aabb> queryBoxes(QUERIES);
+        std::vector<Vec3> points(QUERIES);
+        for (uint32_t i = 0; i < QUERIES; i++) {
+            rays[i].origin = { position(rng), position(rng), position(rng) };
+            rays[i].direction = normalize(Vec3{ unit(rng), unit(rng), unit(rng) });
+            rays[i].maxT = extent;
+            queryBoxes[i] = boxAround({ position(rng), position(rng), position(rng) }, { 1.0f, 1.0f, 1.0f });
+            points[i] = { position(rng), position(rng), position(rng) };
+        }
+        uint32_t bruteQueries = std::min<uint32_t>(QUERIES, std::max<uint32_t>(1, uint32_t(BRUTE_FORCE_TESTS / count)));
+
+        auto hitTest = [&](uint32_t object, const Ray& ray, float maxT) { return hitBox(boxes, object, ray, maxT); };
+        auto distanceTest = [&](uint32_t object, const Vec3& point) { return distanceSquared(boxes[object], point); };
+
+        std::vector<TreeHit> hits(QUERIES), bruteHits(bruteQueries);
+        double rayTreeMs = timeMs([&] {
+            for (uint32_t i = 0; i < QUERIES; i++) hits[i] = tree.raycast(rays[i], hitTest);
+        });
+        double rayBatchMs = timeMs([&] { tree.raycastBatch(jobs, rays.data(), hits.data(), QUERIES, hitTest); });
+        double rayBruteMs = timeMs([&] {
+            for (uint32_t i = 0; i < bruteQueries; i++) bruteHits[i] = bruteRaycast(boxes, rays[i]);
+        });
+        uint32_t rayMismatches = 0;
+        for (uint32_t i = 0; i < bruteQueries; i++) rayMismatches += hits[i].distance != bruteHits[i].distance;
+
+        std::vector<uint32_t> overlapCounts(QUERIES, 0);
+        uint32_t overlapMismatches = 0;
+        double overlapTreeMs = timeMs([&] {
+            for (uint32_t i = 0; i < QUERIES; i++) {
+                tree.queryOverlaps(queryBoxes[i], [&](uint32_t object) {
+                    overlapCounts[i] += overlaps(boxes[object], queryBoxes[i]);
+                    return true;
+                });
+            }
+        });
+        std::vector<std::vector<uint32_t>> perThread(jobs.threadCount(), std::vector<uint32_t>(QUERIES, 0));
+        double overlapBatchMs = timeMs([&] {
+            tree.overlapBatch(jobs, queryBoxes.data(), QUERIES, [&](uint32_t query, uint32_t object, uint32_t thread) {
+                perThread[thread][query] += overlaps(boxes[object], queryBoxes[query]);
+            });
+        });
+        double overlapBruteMs = timeMs([&] {
+            for (uint32_t i = 0; i < bruteQueries; i++) {
+                uint32_t n = 0;
+                for (const Aabb& box : boxes) n += overlaps(box, queryBoxes[i]);
+                overlapMismatches += n != overlapCounts[i];
+            }
+        });
+        for (uint32_t i = 0; i < QUERIES; i++) {
+            uint32_t n = 0;
+            for (const std::vector<uint32_t>& counts : perThread) n += counts[i];
+            overlapMismatches += n != overlapCounts[i];
+        }
+
+        double nearestTreeMs = timeMs([&] {
+            for (uint32_t i = 0; i < QUERIES; i++) {
+                hits[i] = tree.nearest(points[i], std::numeric_limits<float>::max(), distanceTest);
+            }
+        });
+        uint32_t nearestMismatches = 0;
+        double nearestBruteMs = timeMs([&] {
+            for (uint32_t i = 0; i < bruteQueries; i++) bruteHits[i] = bruteNearest(boxes, points[i]);
+        });
+        for (uint32_t i = 0; i < bruteQueries; i++) nearestMismatches += hits[i].distance != bruteHits[i].distance;
+
+        std::printf("  %-8s %14s %14s %14s %9s\n", "query/s", "tree", "tree batched", "brute force", "speedup");
+        std::printf("  %-8s %14.0f %14.0f %14.0f %8.0fx%s\n", "raycast", perSecond(QUERIES, rayTreeMs),
+            perSecond(QUERIES, rayBatchMs), perSecond(bruteQueries, rayBruteMs),
+            perSecond(QUERIES, rayTreeMs) / perSecond(bruteQueries, rayBruteMs), rayMismatches ? "  MISMATCH" : "");
+        std::printf("  %-8s %14.0f %14.0f %14.0f %8.0fx%s\n", "overlap", perSecond(QUERIES, overlapTreeMs),
+            perSecond(QUERIES, overlapBatchMs), perSecond(bruteQueries, overlapBruteMs),
+            perSecond(QUERIES, overlapTreeMs) / perSecond(bruteQueries, overlapBruteMs), overlapMismatches ? "  MISMATCH" : "");
+        std::printf("  %-8s %14.0f %14s %14.0f %8.0fx%s\n\n", "nearest", perSecond(QUERIES, nearestTreeMs), "-",
+            perSecond(bruteQueries, nearestBruteMs),
+            perSecond(QUERIES, nearestTreeMs) / perSecond(bruteQueries, nearestBruteMs), nearestMismatches ? "  MISMATCH" : "");
+    }
+
+    jobs.cleanup();
+    return 0;
+}
@@ -0,0 +1,99 @@
+// bench/SpriteBench.cpp
+//
+// Throughput of the CPU half of the sprite renderer (src/SpriteBatcher.h):
+// submitting N sprites and sorting/gathering them into an instance buffer, as
+// SpriteRenderer does into mapped memory each frame. Reports sprites per
+// millisecond and the resulting draw count for 10k to 1M sprites, and times the
+// radix sort against std::stable_sort on the same keys.
+#include "RadixSort.h"
+#include "SpriteBatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+    const size_t COUNTS[] = { 10000, 100000, 1000000 };
+    const int    RUNS = 15;
+    const uint32_t TEXTURES = 16;
+    const uint32_t LAYERS = 4;
+
+    double bestMs(const std::function<void()>& fn) {
+        double best = 1e30;
+        for (int r = 0; r < RUNS; r++) {
+            auto t0 = std::chrono::steady_clock::now();
+            fn();
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        }
+        return best;
+    }
+
+    std::vector<Sprite> randomSprites(size_t count, std::mt19937& rng) {
+        std::uniform_real_distribution<float> d(0.0f, 1920.0f);
+        std::vector<Sprite> sprites(count);
+        for (Sprite& s : sprites) {
+            s.x = d(rng);
+            s.y = d(rng);
+            s.width = s.height = 8.0f;
+            s.rotation = d(rng) * 0.001f;
+            s.color = rng();
+            s.texture = uint16_t(rng() % TEXTURES);
+            s.layer = uint16_t(rng() % LAYERS);
+        }
+        return sprites;
+    }
+}
+
+int main() {
+    std::mt19937 rng(1234);
+
+    std::printf("%u textures, %u layers, submitted in random order\n\n", TEXTURES, LAYERS);
+    std::printf("%9s %10s %10s %12s %7s\n", "sprites", "submit ms", "finish ms", "sprites/ms", "draws");
+    for (size_t count : COUNTS) {
+        std::vector<Sprite> sprites = randomSprites(count, rng);
+        std::vector<SpriteInstance> out(count);
+        SpriteBatcher batcher;
+
+        // Warm up once so the batcher's storage is at its steady-state size.
+        batcher.begin();
+        for (const Sprite& s : sprites) batcher.draw(s);
+        batcher.finish(out.data(), out.size());
+
+        double submitMs = bestMs([&] {
+            batcher.begin();
+            for (const Sprite& s : sprites) batcher.draw(s);
+        });
+        double totalMs = bestMs([&] {
+            batcher.begin();
+            for (const Sprite& s : sprites) batcher.draw(s);
+            batcher.finish(out.data(), out.size());
+        });
+        std::printf("%9zu %10.3f %10.3f %12.0f %7zu\n", count, submitMs, totalMs - submitMs,
+            double(count) / totalMs, batcher.runs().size());
+    }
+
+    std::printf("\n%9s %12s %12s %9s\n", "keys", "radix ms", "stable ms", "speedup");
+    for (size_t count : COUNTS) {
+        std::vector<uint32_t> input(count);
+        for (uint32_t& k : input) k = ((rng() % LAYERS) << 16) | (rng() % TEXTURES);
+        std::vector<uint32_t> keys(count), values(count), keyScratch(count), valueScratch(count);
+        std::vector<uint32_t> order(count);
+
+        double radixMs = bestMs([&] {
+            keys = input;
+            std::iota(values.begin(), values.end(), 0u);
+            radixSortPairs(keys.data(), values.data(), keyScratch.data(), valueScratch.data(), count);
+        });
+        double stableMs = bestMs([&] {
+            std::iota(order.begin(), order.end(), 0u);
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return input[a] < input[b]; });
+        });
+        std::printf("%9zu %12.3f %12.3f %8.2fx\n", count, radixMs, stableMs, stableMs / radixMs);
+    }
+    return 0;
+}
@@ -1,7 +1,9 @@
 @echo off
 REM --------------------------------------------------------
-REM compile-shaders.bat: compile two hard-coded shaders
-REM Usage: just double-click this .bat in the same folder
+REM compile-shaders.bat: compile the hard-coded shader list
+REM Usage: just double-click this .bat in the same folder,
+REM        or: compile.bat <shader source dir> <spv output dir>
+REM        (CMake's CompileShaders target passes both)
 REM --------------------------------------------------------
 
 REM 1) Make sure VULKAN_SDK is set
@@ -15,23 +17,61 @@ if not defined VULKAN_SDK (
 REM 2) Define the compiler binary (you can swap in glslangValidator.exe -V if you prefer)
 set GLSL_COMPILER=C:\VulkanSDK\1.4.304.0\Bin\glslc.exe
 
+REM    Input/output folders default to the original hard-coded locations
+set SHADER_SRC=C:\GitHub\Game-Engine-Project\src\shaders
+set SHADER_OUT=C:\GitHub\Game-Engine-Project\build\shaders_spv
+if not "%~1"=="" set SHADER_SRC=%~1
+if not "%~2"=="" set SHADER_OUT=%~2
+if not exist "%SHADER_OUT%" mkdir "%SHADER_OUT%"
+
 REM 3) Compile each shader
-echo Compiling shader.vert to vert.spv
-"C:\VulkanSDK\1.4.304.0\Bin\glslc.exe" -c "C:\GitHub\Game-Engine-Project\src\shaders\shader.vert" -o "C:\GitHub\Game-Engine-Project\build\shaders_spv\vert.spv"
-if errorlevel 1 (
-  echo ** ERROR: failed to compile shader.vert
-  pause
-  exit /b 1
-)
+call :compile shader.vert vert.spv || exit /b 1
+call :compile shader.frag frag.spv || exit /b 1
+call :compile overdraw.vert overdraw_vert.spv || exit /b 1
+call :compile overdraw.frag overdraw_frag.spv || exit /b 1
+call :compile particle.vert particle_vert.spv || exit /b 1
+call :compile particle.frag particle_frag.spv || exit /b 1
+call :compile particle_init.comp particle_init_comp.spv || exit /b 1
+call :compile particle_emit.comp particle_emit_comp.spv || exit /b 1
+call :compile particle_simulate.comp particle_simulate_comp.spv || exit /b 1
+call :compile particle_compact.comp particle_compact_comp.spv || exit /b 1
+call :compile lit.vert lit_vert.spv || exit /b 1
+call :compile lit.frag lit_frag.spv || exit /b 1
+call :compile light_cull.comp light_cull_comp.spv || exit /b 1
+call :compile lod.vert lod_vert.spv || exit /b 1
+call :compile lod.frag lod_frag.spv || exit /b 1
+call :compile overlay.vert overlay_vert.spv || exit /b 1
+call :compile overlay.frag overlay_frag.spv || exit /b 1
+call :compile sprite.vert sprite_vert.spv || exit /b 1
+call :compile sprite.frag sprite_frag.spv || exit /b 1
+call :compile hiz_reduce.comp hiz_reduce_comp.spv || exit /b 1
+call :compile lod_cull.comp lod_cull_comp.spv || exit /b 1
+call :compile shadow.vert shadow_vert.spv || exit /b 1
+call :compile lod_shadowed.frag lod_shadowed_frag.spv || exit /b 1
+call :compile post_prefilter.comp post_prefilter_comp.spv || exit /b 1
+call :compile post_exposure.comp post_exposure_comp.spv || exit /b 1
+call :compile post_exposure.comp post_exposure_subgroup_comp.spv "--target-env=vulkan1.1 -DPOST_SUBGROUPS" || exit /b 1
+call :compile post_downsample.comp post_downsample_comp.spv || exit /b 1
+call :compile post_upsample.comp post_upsample_comp.spv || exit /b 1
+call :compile post_tonemap.comp post_tonemap_comp.spv || exit /b 1
+call :compile post_tonemap.comp post_tonemap_direct_comp.spv -DPOST_DIRECT_OUTPUT || exit /b 1
+call :compile skinned.vert skinned_vert.spv || exit /b 1
+call :compile skinned.frag skinned_frag.spv || exit /b 1
 
-echo Compiling shader.frag to frag.spv
-"C:\VulkanSDK\1.4.304.0\Bin\glslc.exe" -c "C:\GitHub\Game-Engine-Project\src\shaders\shader.frag" -o "C:\GitHub\Game-Engine-Project\build\shaders_spv\frag.spv"
+echo.
+echo All shaders compiled successfully!
+if "%~1"=="" pause
+exit /b 0
+
+REM --------------------------------------------------------
+REM :compile <source file> <output file> ["extra glslc flags"]
+REM --------------------------------------------------------
+:compile
+echo Compiling %1 to %2
+"%GLSL_COMPILER%" %~3 -c "%SHADER_SRC%\%1" -o "%SHADER_OUT%\%2"
 if errorlevel 1 (
-  echo ** ERROR: failed to compile shader.frag
+  echo ** ERROR: failed to compile %1
   pause
   exit /b 1
 )
-
-echo.
-echo All shaders compiled successfully!
-pause
\ No newline at end of file
+exit /b 0
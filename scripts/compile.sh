@@ -0,0 +1,67 @@
+#!/bin/sh
+# --------------------------------------------------------
+# compile.sh: compile the hard-coded shader list (mirrors compile.bat)
+# Usage: compile.sh <shader source dir> <spv output dir>
+#        (CMake's CompileShaders target passes both)
+# --------------------------------------------------------
+
+# 1) Find glslc: $VULKAN_SDK/bin first, then PATH
+if [ -n "$VULKAN_SDK" ] && [ -x "$VULKAN_SDK/bin/glslc" ]; then
+  GLSL_COMPILER="$VULKAN_SDK/bin/glslc"
+else
+  GLSL_COMPILER=glslc
+fi
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+SHADER_SRC=${1:-"$SCRIPT_DIR/../src/shaders"}
+SHADER_OUT=${2:-"$SCRIPT_DIR/../build/shaders_spv"}
+mkdir -p "$SHADER_OUT" || exit 1
+
+# compile <source file> <output file> [extra glslc flags...]
+compile() {
+  src=$1
+  out=$2
+  shift 2
+  echo "Compiling $src to $out"
+  if ! "$GLSL_COMPILER" "$@" -c "$SHADER_SRC/$src" -o "$SHADER_OUT/$out"; then
+    echo "** ERROR: failed to compile $src"
+    exit 1
+  fi
+}
+
+# 2) Compile each shader
+compile shader.vert vert.spv
+compile shader.frag frag.spv
+compile overdraw.vert overdraw_vert.spv
+compile overdraw.frag overdraw_frag.spv
+compile particle.vert particle_vert.spv
+compile particle.frag particle_frag.spv
+compile particle_init.comp particle_init_comp.spv
+compile particle_emit.comp particle_emit_comp.spv
+compile particle_simulate.comp particle_simulate_comp.spv
+compile particle_compact.comp particle_compact_comp.spv
+compile lit.vert lit_vert.spv
+compile lit.frag lit_frag.spv
+compile light_cull.comp light_cull_comp.spv
+compile lod.vert lod_vert.spv
+compile lod.frag lod_frag.spv
+compile overlay.vert overlay_vert.spv
+compile overlay.frag overlay_frag.spv
+compile sprite.vert sprite_vert.spv
+compile sprite.frag sprite_frag.spv
+compile hiz_reduce.comp hiz_reduce_comp.spv
+compile lod_cull.comp lod_cull_comp.spv
+compile shadow.vert shadow_vert.spv
+compile lod_shadowed.frag lod_shadowed_frag.spv
+compile post_prefilter.comp post_prefilter_comp.spv
+compile post_exposure.comp post_exposure_comp.spv
+compile post_exposure.comp post_exposure_subgroup_comp.spv --target-env=vulkan1.1 -DPOST_SUBGROUPS
+compile post_downsample.comp post_downsample_comp.spv
+compile post_upsample.comp post_upsample_comp.spv
+compile post_tonemap.comp post_tonemap_comp.spv
+compile post_tonemap.comp post_tonemap_direct_comp.spv -DPOST_DIRECT_OUTPUT
+compile skinned.vert skinned_vert.spv
+compile skinned.frag skinned_frag.spv
+
+echo
+echo "All shaders compiled successfully!"
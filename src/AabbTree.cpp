@@ -0,0 +1,304 @@
+// src/AabbTree.cpp
+#include "AabbTree.h"
+
+namespace {
+    // The fat box leads a moving object by this many steps of its displacement.
+    const float DISPLACEMENT_MULTIPLIER = 2.0f;
+
+    bool sameBox(const Aabb& a, const Aabb& b) {
+        return a.min.x == b.min.x && a.min.y == b.min.y && a.min.z == b.min.z &&
+               a.max.x == b.max.x && a.max.y == b.max.y && a.max.z == b.max.z;
+    }
+}
+
+//-------------------------------------------------------------------------
+// Proxies
+//-------------------------------------------------------------------------
+
+int32_t AabbTree::createProxy(const Aabb& box, uint32_t userData) {
+    int32_t proxy = allocateNode();
+    Node& node = nodes[proxy];
+    node.box = fatten(box, Vec3{});
+    node.userData = userData;
+    insertLeaf(proxy);
+    leafCount++;
+    return proxy;
+}
+
+void AabbTree::destroyProxy(int32_t proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    leafCount--;
+}
+
+bool AabbTree::moveProxy(int32_t proxy, const Aabb& box, const Vec3& displacement) {
+    if (contains(nodes[proxy].box, box)) {
+        return false;
+    }
+
+    Aabb fat = fatten(box, displacement);
+    if (!overlaps(nodes[proxy].box, fat)) {
+        // Teleported: its old spot in the tree says nothing about the new one.
+        removeLeaf(proxy);
+        nodes[proxy].box = fat;
+        insertLeaf(proxy);
+    }
+    else {
+        nodes[proxy].box = fat;
+        refitUpwards(nodes[proxy].parent);
+    }
+    return true;
+}
+
+void AabbTree::clear() {
+    nodes.clear();
+    root = nullNode;
+    freeList = nullNode;
+    leafCount = 0;
+}
+
+float AabbTree::areaRatio() const {
+    if (root == nullNode || nodes[root].isLeaf()) return 1.0f;
+
+    float internalArea = 0.0f;
+    Stack<int32_t> stack;
+    stack.push(root);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.pop()];
+        if (node.isLeaf()) continue;
+        internalArea += surfaceArea(node.box);
+        stack.push(node.child1);
+        stack.push(node.child2);
+    }
+    float rootArea = surfaceArea(nodes[root].box);
+    return rootArea > 0.0f ? internalArea / rootArea : 1.0f;
+}
+
+//-------------------------------------------------------------------------
+// Nodes
+//-------------------------------------------------------------------------
+
+int32_t AabbTree::allocateNode() {
+    int32_t index;
+    if (freeList != nullNode) {
+        index = freeList;
+        freeList = nodes[index].parent;
+        nodes[index] = Node{};
+    }
+    else {
+        index = int32_t(nodes.size());
+        nodes.emplace_back();
+    }
+    return index;
+}
+
+void AabbTree::freeNode(int32_t node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+Aabb AabbTree::fatten(const Aabb& box, const Vec3& displacement) const {
+    Vec3 grow{ margin, margin, margin };
+    Aabb fat{ box.min - grow, box.max + grow };
+    Vec3 lead = displacement * DISPLACEMENT_MULTIPLIER;
+    (lead.x < 0.0f ? fat.min.x : fat.max.x) += lead.x;
+    (lead.y < 0.0f ? fat.min.y : fat.max.y) += lead.y;
+    (lead.z < 0.0f ? fat.min.z : fat.max.z) += lead.z;
+    return fat;
+}
+
+//-------------------------------------------------------------------------
+// Insertion and removal
+//-------------------------------------------------------------------------
+
+void AabbTree::insertLeaf(int32_t leaf) {
+    if (root == nullNode) {
+        root = leaf;
+        nodes[leaf].parent = nullNode;
+        return;
+    }
+
+    Aabb box = nodes[leaf].box;
+    int32_t sibling = findBestSibling(box);
+    int32_t oldParent = nodes[sibling].parent;
+
+    int32_t newParent = allocateNode();   // may move `nodes`; no references held across it
+    Node& parent = nodes[newParent];
+    parent.parent = oldParent;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    parent.box = unionOf(box, nodes[sibling].box);
+    parent.height = nodes[sibling].height + 1;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == nullNode) {
+        root = newParent;
+        return;
+    }
+    Node& grand = nodes[oldParent];
+    (grand.child1 == sibling ? grand.child1 : grand.child2) = newParent;
+    refitUpwards(oldParent);
+}
+
+void AabbTree::removeLeaf(int32_t leaf) {
+    if (leaf == root) {
+        root = nullNode;
+        return;
+    }
+
+    int32_t parent = nodes[leaf].parent;
+    int32_t grand = nodes[parent].parent;
+    int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+    freeNode(parent);
+
+    nodes[sibling].parent = grand;
+    if (grand == nullNode) {
+        root = sibling;
+        return;
+    }
+    Node& g = nodes[grand];
+    (g.child1 == parent ? g.child1 : g.child2) = sibling;
+    refitUpwards(grand);
+}
+
+// Making node N the sibling costs the area of the new parent, area(N + box),
+// plus the growth of every ancestor of N. Walks down from the root towards the
+// child with the lower bound on that cost and stops once neither child can beat
+// the best node seen so far, so an insert stays logarithmic.
+int32_t AabbTree::findBestSibling(const Aabb& box) {
+    float boxArea = surfaceArea(box);
+    int32_t index = root;
+    float area = surfaceArea(nodes[root].box);
+    float directCost = surfaceArea(unionOf(nodes[root].box, box));
+    float inheritedCost = 0.0f;
+
+    int32_t best = root;
+    float bestCost = directCost;
+    while (!nodes[index].isLeaf()) {
+        const Node& node = nodes[index];
+        float cost = directCost + inheritedCost;
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = index;
+        }
+        // Every node below grows this one, and its ancestors, as well.
+        inheritedCost += directCost - area;
+
+        int32_t children[2] = { node.child1, node.child2 };
+        float lowerCost[2], childDirect[2], childArea[2];
+        bool leaf[2];
+        for (int i = 0; i < 2; i++) {
+            const Node& child = nodes[children[i]];
+            leaf[i] = child.isLeaf();
+            childArea[i] = surfaceArea(child.box);
+            childDirect[i] = surfaceArea(unionOf(child.box, box));
+            lowerCost[i] = std::numeric_limits<float>::max();
+            if (leaf[i]) {
+                float leafCost = childDirect[i] + inheritedCost;
+                if (leafCost < bestCost) {
+                    bestCost = leafCost;
+                    best = children[i];
+                }
+            }
+            else {
+                // Going further down can at best shrink the new parent to the
+                // inserted box itself.
+                lowerCost[i] = inheritedCost + childDirect[i] + std::min(boxArea - childArea[i], 0.0f);
+            }
+        }
+        if (leaf[0] && leaf[1]) break;
+        if (bestCost <= lowerCost[0] && bestCost <= lowerCost[1]) break;
+
+        int next = (lowerCost[0] < lowerCost[1] && !leaf[0]) || leaf[1] ? 0 : 1;
+        index = children[next];
+        area = childArea[next];
+        directCost = childDirect[next];
+    }
+    return best;
+}
+
+//-------------------------------------------------------------------------
+// Refit and rotations
+//-------------------------------------------------------------------------
+
+void AabbTree::refitUpwards(int32_t index) {
+    while (index != nullNode) {
+        Node& node = nodes[index];
+        Aabb box = unionOf(nodes[node.child1].box, nodes[node.child2].box);
+        int32_t height = 1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+        bool changed = !sameBox(box, node.box) || height != node.height;
+        node.box = box;
+        node.height = height;
+        changed |= rotate(index);
+        // Nothing above can change if this node did not.
+        if (!changed) return;
+        index = node.parent;
+    }
+}
+
+// With children B and C, swapping B for one of C's children (or C for one of
+// B's) leaves this node's box alone but changes the box of the child that
+// receives the swapped node. Applies the swap that shrinks that box the most,
+// if any does. Returns true if it rotated.
+bool AabbTree::rotate(int32_t a) {
+    Node& A = nodes[a];
+    if (A.height < 2) return false;
+
+    int32_t b = A.child1, c = A.child2;
+    Node& B = nodes[b];
+    Node& C = nodes[c];
+
+    enum class Swap { None, BF, BG, CD, CE } best = Swap::None;
+    float bestDelta = 0.0f;
+    if (!C.isLeaf()) {
+        float areaC = surfaceArea(C.box);
+        float deltaBF = surfaceArea(unionOf(B.box, nodes[C.child2].box)) - areaC;   // C keeps G
+        float deltaBG = surfaceArea(unionOf(B.box, nodes[C.child1].box)) - areaC;   // C keeps F
+        if (deltaBF < bestDelta) { bestDelta = deltaBF; best = Swap::BF; }
+        if (deltaBG < bestDelta) { bestDelta = deltaBG; best = Swap::BG; }
+    }
+    if (!B.isLeaf()) {
+        float areaB = surfaceArea(B.box);
+        float deltaCD = surfaceArea(unionOf(C.box, nodes[B.child2].box)) - areaB;   // B keeps E
+        float deltaCE = surfaceArea(unionOf(C.box, nodes[B.child1].box)) - areaB;   // B keeps D
+        if (deltaCD < bestDelta) { bestDelta = deltaCD; best = Swap::CD; }
+        if (deltaCE < bestDelta) { bestDelta = deltaCE; best = Swap::CE; }
+    }
+
+    switch (best) {
+    case Swap::None:
+        return false;
+
+    case Swap::BF:
+    case Swap::BG: {
+        int32_t moved = best == Swap::BF ? C.child1 : C.child2;
+        int32_t kept = best == Swap::BF ? C.child2 : C.child1;
+        A.child1 = moved;
+        nodes[moved].parent = a;
+        (best == Swap::BF ? C.child1 : C.child2) = b;
+        B.parent = c;
+        C.box = unionOf(B.box, nodes[kept].box);
+        C.height = 1 + std::max(B.height, nodes[kept].height);
+        A.height = 1 + std::max(C.height, nodes[moved].height);
+        break;
+    }
+
+    case Swap::CD:
+    case Swap::CE: {
+        int32_t moved = best == Swap::CD ? B.child1 : B.child2;
+        int32_t kept = best == Swap::CD ? B.child2 : B.child1;
+        A.child2 = moved;
+        nodes[moved].parent = a;
+        (best == Swap::CD ? B.child1 : B.child2) = c;
+        C.parent = b;
+        B.box = unionOf(C.box, nodes[kept].box);
+        B.height = 1 + std::max(C.height, nodes[kept].height);
+        A.height = 1 + std::max(B.height, nodes[moved].height);
+        break;
+    }
+    }
+    rotations++;
+    return true;
+}
@@ -0,0 +1,338 @@
+// src/AabbTree.h
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "JobSystem.h"
+#include "Math.h"
+
+//-------------------------------------------------------------------------
+// Boxes and rays
+//-------------------------------------------------------------------------
+
+// Axis-aligned box. Both corners keep their Vec3 padding at zero, so the SSE
+// helpers below can load them whole.
+struct Aabb {
+    Vec3 min;
+    Vec3 max;
+};
+
+inline Aabb unionOf(const Aabb& a, const Aabb& b) {
+    Aabb r;
+#if ENGINE_MATH_SSE
+    _mm_store_ps(&r.min.x, _mm_min_ps(_mm_load_ps(&a.min.x), _mm_load_ps(&b.min.x)));
+    _mm_store_ps(&r.max.x, _mm_max_ps(_mm_load_ps(&a.max.x), _mm_load_ps(&b.max.x)));
+#else
+    r.min = { std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) };
+    r.max = { std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) };
+#endif
+    return r;
+}
+
+inline bool overlaps(const Aabb& a, const Aabb& b) {
+#if ENGINE_MATH_SSE
+    __m128 le = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(&a.min.x), _mm_load_ps(&b.max.x)),
+                           _mm_cmple_ps(_mm_load_ps(&b.min.x), _mm_load_ps(&a.max.x)));
+    return (_mm_movemask_ps(le) & 7) == 7;
+#else
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+           a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+#endif
+}
+
+// True if `inner` lies entirely inside `outer`.
+inline bool contains(const Aabb& outer, const Aabb& inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+           inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+// Half the surface area; only ever compared, so the factor 2 is left out.
+inline float surfaceArea(const Aabb& b) {
+    float dx = b.max.x - b.min.x, dy = b.max.y - b.min.y, dz = b.max.z - b.min.z;
+    return dx * dy + dy * dz + dz * dx;
+}
+
+// Squared distance from p to the closest point of the box (0 inside).
+inline float distanceSquared(const Aabb& b, const Vec3& p) {
+    float dx = std::max(std::max(b.min.x - p.x, p.x - b.max.x), 0.0f);
+    float dy = std::max(std::max(b.min.y - p.y, p.y - b.max.y), 0.0f);
+    float dz = std::max(std::max(b.min.z - p.z, p.z - b.max.z), 0.0f);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Points origin + t * direction for t in [0, maxT]. The direction need not be
+// unit length; hit distances are measured in multiples of it.
+struct Ray {
+    Vec3  origin;
+    Vec3  direction;
+    float maxT = std::numeric_limits<float>::max();
+};
+
+// Componentwise 1 / direction, computed once per ray for the slab tests.
+inline Vec3 inverseDirection(const Ray& ray) {
+    return { 1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z };
+}
+
+// Slab test. On a hit, tEntry is where the ray enters the box (0 if it starts inside).
+inline bool rayHitsBox(const Ray& ray, const Vec3& inverse, const Aabb& b, float maxT, float& tEntry) {
+    float tx1 = (b.min.x - ray.origin.x) * inverse.x, tx2 = (b.max.x - ray.origin.x) * inverse.x;
+    float ty1 = (b.min.y - ray.origin.y) * inverse.y, ty2 = (b.max.y - ray.origin.y) * inverse.y;
+    float tz1 = (b.min.z - ray.origin.z) * inverse.z, tz2 = (b.max.z - ray.origin.z) * inverse.z;
+    float tNear = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::max(std::min(tz1, tz2), 0.0f));
+    float tFar = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::min(std::max(tz1, tz2), maxT));
+    tEntry = tNear;
+    return tNear <= tFar;
+}
+
+// Result of a raycast or nearest query. userData is AabbTree::noHit when nothing was found.
+struct TreeHit {
+    uint32_t userData;
+    float    distance;   // ray t, or squared distance for nearest()
+};
+
+//-------------------------------------------------------------------------
+// Dynamic AABB tree
+//-------------------------------------------------------------------------
+
+// Bounding volume hierarchy over objects that are added, moved and removed at
+// any time, for picking, visibility and gameplay queries.
+//
+// Each object is a leaf holding a "fat" box: its real box grown by a margin and
+// by its predicted motion, so small moves that stay inside it cost nothing.
+// Inserting picks the sibling that adds the least total surface area to the
+// tree (surface area heuristic), searching down from the root with a lower
+// bound on the cost so only one path is followed. An object that leaves its fat box is refit in place: its ancestors'
+// boxes are recomputed on the way to the root and each one tries the tree
+// rotation (swapping a child with a grandchild) that most reduces its children's
+// area, so the tree keeps its shape without being rebuilt. Only an object that
+// jumps clear of its old fat box is removed and reinserted.
+//
+// Queries are const and may run on many threads at once, as long as nothing
+// modifies the tree meanwhile; the batch versions spread them over a JobSystem.
+// Node indices double as proxy ids and stay valid until the proxy is destroyed.
+class AabbTree {
+public:
+    static constexpr int32_t  nullNode = -1;
+    static constexpr uint32_t noHit = 0xFFFFFFFFu;
+
+    // `margin` is added on every side of each object's fat box, in world units.
+    explicit AabbTree(float margin = 0.1f) : margin(margin) {}
+
+    // Adds an object and returns its proxy id.
+    int32_t createProxy(const Aabb& box, uint32_t userData);
+    void    destroyProxy(int32_t proxy);
+    // Call when the object's box changes. `displacement` is how far it moved
+    // this step; the fat box is stretched that way to anticipate the next.
+    // Returns true if the tree changed.
+    bool    moveProxy(int32_t proxy, const Aabb& box, const Vec3& displacement);
+    void    clear();
+
+    uint32_t    userData(int32_t proxy) const { return nodes[proxy].userData; }
+    const Aabb& fatBox(int32_t proxy) const { return nodes[proxy].box; }
+
+    uint32_t proxyCount() const { return leafCount; }
+    int32_t  height() const { return root == nullNode ? 0 : nodes[root].height; }
+    // Summed area of the internal nodes over the root's: the expected cost of
+    // a query, lower is better. Meant for benchmarks and debugging; walks every node.
+    float    areaRatio() const;
+    // Rotations applied since creation.
+    uint64_t rotationCount() const { return rotations; }
+
+    //---------------------------------------------------------------------
+    // Queries
+    //---------------------------------------------------------------------
+
+    // Calls fn(userData) for every object whose fat box overlaps `box`;
+    // fn returns false to stop early.
+    template <typename Fn>
+    void queryOverlaps(const Aabb& box, Fn&& fn) const;
+
+    // Closest hit along the ray. hitTest(userData, ray, maxT) does the exact
+    // test against an object whose fat box the ray reaches before maxT and
+    // returns the hit t, or any value >= maxT (or negative) for a miss.
+    template <typename Fn>
+    TreeHit raycast(const Ray& ray, Fn&& hitTest) const;
+
+    // Object closest to `point` within sqrt(maxDistanceSquared).
+    // distanceSquared(userData, point) returns the exact squared distance.
+    template <typename Fn>
+    TreeHit nearest(const Vec3& point, float maxDistanceSquared, Fn&& distanceSq) const;
+
+    // raycast() for every ray, spread over the job system: hits[i] for rays[i].
+    // hitTest is called from several threads at once.
+    template <typename Fn>
+    void raycastBatch(JobSystem& jobs, const Ray* rays, TreeHit* hits, uint32_t count, Fn&& hitTest) const;
+
+    // queryOverlaps() for every box, spread over the job system. Calls
+    // onOverlap(queryIndex, userData, thread) for each overlap; `thread` is
+    // below jobs.threadCount() so results can go to per-thread lists.
+    template <typename Fn>
+    void overlapBatch(JobSystem& jobs, const Aabb* boxes, uint32_t count, Fn&& onOverlap) const;
+
+private:
+    // One per cache line. Leaves have child1 == nullNode.
+    struct alignas(64) Node {
+        Aabb     box;
+        int32_t  parent = nullNode;   // next free node while on the free list
+        int32_t  child1 = nullNode;
+        int32_t  child2 = nullNode;
+        int32_t  height = 0;          // leaves are 0
+        uint32_t userData = 0;
+
+        bool isLeaf() const { return child1 == nullNode; }
+    };
+
+    // Depth-first traversal stack. Big enough for any tree the rotations
+    // leave behind; deeper ones spill to the heap.
+    template <typename T>
+    class Stack {
+    public:
+        void push(const T& value) {
+            if (size < INLINE) { inlineItems[size++] = value; }
+            else { spill.push_back(value); size++; }
+        }
+        T pop() {
+            if (size > INLINE) { T value = spill.back(); spill.pop_back(); size--; return value; }
+            return inlineItems[--size];
+        }
+        bool empty() const { return size == 0; }
+
+    private:
+        static constexpr uint32_t INLINE = 128;
+        T inlineItems[INLINE];
+        uint32_t size = 0;
+        std::vector<T> spill;
+    };
+
+    struct Candidate {
+        int32_t node;
+        float   key;   // ray entry t, or squared distance
+    };
+
+    int32_t allocateNode();
+    void    freeNode(int32_t node);
+    Aabb    fatten(const Aabb& box, const Vec3& displacement) const;
+    void    insertLeaf(int32_t leaf);
+    void    removeLeaf(int32_t leaf);
+    int32_t findBestSibling(const Aabb& box);
+    // Recomputes boxes and heights from `node` to the root, rotating on the way.
+    void    refitUpwards(int32_t node);
+    bool    rotate(int32_t node);
+
+    float   margin;
+    std::vector<Node> nodes;
+    int32_t  root = nullNode;
+    int32_t  freeList = nullNode;
+    uint32_t leafCount = 0;
+    uint64_t rotations = 0;
+};
+
+//-------------------------------------------------------------------------
+// Query templates
+//-------------------------------------------------------------------------
+
+template <typename Fn>
+void AabbTree::queryOverlaps(const Aabb& box, Fn&& fn) const {
+    if (root == nullNode) return;
+    Stack<int32_t> stack;
+    stack.push(root);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.pop()];
+        if (!overlaps(node.box, box)) continue;
+        if (node.isLeaf()) {
+            if (!fn(node.userData)) return;
+        }
+        else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
+
+template <typename Fn>
+TreeHit AabbTree::raycast(const Ray& ray, Fn&& hitTest) const {
+    TreeHit hit{ noHit, ray.maxT };
+    if (root == nullNode) return hit;
+
+    Vec3 inverse = inverseDirection(ray);
+    float t;
+    if (!rayHitsBox(ray, inverse, nodes[root].box, hit.distance, t)) return hit;
+
+    // Nearer child on top, so the closest hit is usually found first and
+    // shortens the ray for everything behind it.
+    Stack<Candidate> stack;
+    stack.push({ root, t });
+    while (!stack.empty()) {
+        Candidate candidate = stack.pop();
+        if (candidate.key > hit.distance) continue;
+        const Node& node = nodes[candidate.node];
+        if (node.isLeaf()) {
+            float objectT = hitTest(node.userData, ray, hit.distance);
+            if (objectT >= 0.0f && objectT < hit.distance) {
+                hit = { node.userData, objectT };
+            }
+            continue;
+        }
+        float t1, t2;
+        bool hit1 = rayHitsBox(ray, inverse, nodes[node.child1].box, hit.distance, t1);
+        bool hit2 = rayHitsBox(ray, inverse, nodes[node.child2].box, hit.distance, t2);
+        if (hit1 && hit2) {
+            if (t1 <= t2) { stack.push({ node.child2, t2 }); stack.push({ node.child1, t1 }); }
+            else          { stack.push({ node.child1, t1 }); stack.push({ node.child2, t2 }); }
+        }
+        else if (hit1) stack.push({ node.child1, t1 });
+        else if (hit2) stack.push({ node.child2, t2 });
+    }
+    return hit;
+}
+
+template <typename Fn>
+TreeHit AabbTree::nearest(const Vec3& point, float maxDistanceSquared, Fn&& distanceSq) const {
+    TreeHit hit{ noHit, maxDistanceSquared };
+    if (root == nullNode) return hit;
+
+    Stack<Candidate> stack;
+    stack.push({ root, distanceSquared(nodes[root].box, point) });
+    while (!stack.empty()) {
+        Candidate candidate = stack.pop();
+        if (candidate.key > hit.distance) continue;
+        const Node& node = nodes[candidate.node];
+        if (node.isLeaf()) {
+            float d = distanceSq(node.userData, point);
+            if (d < hit.distance) {
+                hit = { node.userData, d };
+            }
+            continue;
+        }
+        float d1 = distanceSquared(nodes[node.child1].box, point);
+        float d2 = distanceSquared(nodes[node.child2].box, point);
+        if (d1 <= d2) { stack.push({ node.child2, d2 }); stack.push({ node.child1, d1 }); }
+        else          { stack.push({ node.child1, d1 }); stack.push({ node.child2, d2 }); }
+    }
+    return hit;
+}
+
+template <typename Fn>
+void AabbTree::raycastBatch(JobSystem& jobs, const Ray* rays, TreeHit* hits, uint32_t count, Fn&& hitTest) const {
+    jobs.parallelFor(count, 64, [&](uint32_t begin, uint32_t end, uint32_t) {
+        for (uint32_t i = begin; i < end; i++) {
+            hits[i] = raycast(rays[i], hitTest);
+        }
+    });
+}
+
+template <typename Fn>
+void AabbTree::overlapBatch(JobSystem& jobs, const Aabb* boxes, uint32_t count, Fn&& onOverlap) const {
+    jobs.parallelFor(count, 64, [&](uint32_t begin, uint32_t end, uint32_t thread) {
+        for (uint32_t i = begin; i < end; i++) {
+            queryOverlaps(boxes[i], [&](uint32_t userData) {
+                onOverlap(i, userData, thread);
+                return true;
+            });
+        }
+    });
+}
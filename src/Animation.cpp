@@ -0,0 +1,386 @@
+// src/Animation.cpp
+#include "Animation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const float QUANT_SIGNED = 32767.0f;
+    const float QUANT_UNSIGNED = 65535.0f;
+
+    // Walker clips are baked at this rate; a 30 Hz key spacing is invisible after interpolation.
+    const float WALKER_SAMPLE_RATE = 30.0f;
+    const float TWO_PI = 6.2831853f;
+
+    int16_t quantizeSigned(float v) {
+        return int16_t(std::lround(std::min(std::max(v, -1.0f), 1.0f) * QUANT_SIGNED));
+    }
+
+#if ENGINE_MATH_SSE
+    // Four joints' rotations and translations in registers.
+    struct PoseLanes {
+        __m128 r[4];
+        __m128 t[3];
+    };
+
+    inline __m128 loadSigned(const int16_t* p) {
+        __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+        return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+    }
+
+    inline __m128 loadUnsigned(const uint16_t* p) {
+        __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+        return _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, _mm_setzero_si128()));
+    }
+
+    inline void loadBlock(const JointBlock& block, PoseLanes& out) {
+        out.r[0] = _mm_load_ps(block.rx);
+        out.r[1] = _mm_load_ps(block.ry);
+        out.r[2] = _mm_load_ps(block.rz);
+        out.r[3] = _mm_load_ps(block.rw);
+        out.t[0] = _mm_load_ps(block.tx);
+        out.t[1] = _mm_load_ps(block.ty);
+        out.t[2] = _mm_load_ps(block.tz);
+    }
+
+    // Per lane: nlerp along the shorter arc for rotations, lerp for translations.
+    inline void interpolate(const PoseLanes& a, const PoseLanes& b, __m128 t, JointBlock& out) {
+        __m128 d = _mm_mul_ps(a.r[0], b.r[0]);
+        d = _mm_add_ps(d, _mm_mul_ps(a.r[1], b.r[1]));
+        d = _mm_add_ps(d, _mm_mul_ps(a.r[2], b.r[2]));
+        d = _mm_add_ps(d, _mm_mul_ps(a.r[3], b.r[3]));
+        __m128 flip = _mm_and_ps(d, _mm_set1_ps(-0.0f));   // sign bit where the dot is negative
+
+        __m128 r[4];
+        __m128 lengthSq = _mm_setzero_ps();
+        for (int c = 0; c < 4; c++) {
+            __m128 end = _mm_xor_ps(b.r[c], flip);
+            r[c] = _mm_add_ps(a.r[c], _mm_mul_ps(_mm_sub_ps(end, a.r[c]), t));
+            lengthSq = _mm_add_ps(lengthSq, _mm_mul_ps(r[c], r[c]));
+        }
+        __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSq));
+        _mm_store_ps(out.rx, _mm_mul_ps(r[0], inv));
+        _mm_store_ps(out.ry, _mm_mul_ps(r[1], inv));
+        _mm_store_ps(out.rz, _mm_mul_ps(r[2], inv));
+        _mm_store_ps(out.rw, _mm_mul_ps(r[3], inv));
+
+        _mm_store_ps(out.tx, _mm_add_ps(a.t[0], _mm_mul_ps(_mm_sub_ps(b.t[0], a.t[0]), t)));
+        _mm_store_ps(out.ty, _mm_add_ps(a.t[1], _mm_mul_ps(_mm_sub_ps(b.t[1], a.t[1]), t)));
+        _mm_store_ps(out.tz, _mm_add_ps(a.t[2], _mm_mul_ps(_mm_sub_ps(b.t[2], a.t[2]), t)));
+    }
+#else
+    // Scalar version of the lane interpolation above, for one lane.
+    void interpolateLane(const float a[7], const float b[7], float t, JointBlock& out, int lane) {
+        float d = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+        float sign = d < 0.0f ? -1.0f : 1.0f;
+        float r[4];
+        float lengthSq = 0.0f;
+        for (int c = 0; c < 4; c++) {
+            r[c] = a[c] + (b[c] * sign - a[c]) * t;
+            lengthSq += r[c] * r[c];
+        }
+        float inv = 1.0f / std::sqrt(lengthSq);
+        out.rx[lane] = r[0] * inv;
+        out.ry[lane] = r[1] * inv;
+        out.rz[lane] = r[2] * inv;
+        out.rw[lane] = r[3] * inv;
+        out.tx[lane] = a[4] + (b[4] - a[4]) * t;
+        out.ty[lane] = a[5] + (b[5] - a[5]) * t;
+        out.tz[lane] = a[6] + (b[6] - a[6]) * t;
+    }
+
+    void laneOf(const JointBlock& block, int lane, float out[7]) {
+        out[0] = block.rx[lane]; out[1] = block.ry[lane]; out[2] = block.rz[lane]; out[3] = block.rw[lane];
+        out[4] = block.tx[lane]; out[5] = block.ty[lane]; out[6] = block.tz[lane];
+    }
+#endif
+
+    // Local matrices of the first `count` joints of `block`.
+    void localMatrices(const JointBlock& block, Mat4* out, uint32_t count) {
+#if ENGINE_MATH_SSE
+        __m128 x = _mm_load_ps(block.rx), y = _mm_load_ps(block.ry);
+        __m128 z = _mm_load_ps(block.rz), w = _mm_load_ps(block.rw);
+        __m128 two = _mm_set1_ps(2.0f), one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+
+        __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        // Same terms as Mat4::fromTRS, one register per matrix element, one lane per joint.
+        __m128 columns[4][4] = {
+            { _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))),
+              _mm_mul_ps(two, _mm_add_ps(xy, wz)),
+              _mm_mul_ps(two, _mm_sub_ps(xz, wy)), zero },
+            { _mm_mul_ps(two, _mm_sub_ps(xy, wz)),
+              _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))),
+              _mm_mul_ps(two, _mm_add_ps(yz, wx)), zero },
+            { _mm_mul_ps(two, _mm_add_ps(xz, wy)),
+              _mm_mul_ps(two, _mm_sub_ps(yz, wx)),
+              _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), zero },
+            { _mm_load_ps(block.tx), _mm_load_ps(block.ty), _mm_load_ps(block.tz), one },
+        };
+        // Transposing a column's four element registers yields that column for each joint.
+        for (int c = 0; c < 4; c++) {
+            __m128* e = columns[c];
+            _MM_TRANSPOSE4_PS(e[0], e[1], e[2], e[3]);
+            for (uint32_t lane = 0; lane < count; lane++) {
+                _mm_store_ps(out[lane].m + c * 4, e[lane]);
+            }
+        }
+#else
+        for (uint32_t lane = 0; lane < count; lane++) {
+            out[lane] = Mat4::fromTRS(Vec3{ block.tx[lane], block.ty[lane], block.tz[lane] },
+                Quat{ block.rx[lane], block.ry[lane], block.rz[lane], block.rw[lane] }, Vec3{ 1.0f, 1.0f, 1.0f });
+        }
+#endif
+    }
+
+    Quat axisAngle(float x, float y, float z, float radians) {
+        return Quat::fromAxisAngle(Vec3{ x, y, z }, radians);
+    }
+    Quat pitch(float radians) { return axisAngle(1.0f, 0.0f, 0.0f, radians); }
+    Quat yaw(float radians)   { return axisAngle(0.0f, 1.0f, 0.0f, radians); }
+    Quat roll(float radians)  { return axisAngle(0.0f, 0.0f, 1.0f, radians); }
+
+    const int32_t WALKER_PARENTS[WalkerJointCount] = {
+        -1, WalkerPelvis, WalkerSpine, WalkerChest,
+        WalkerChest, WalkerUpperArmL, WalkerLowerArmL,
+        WalkerChest, WalkerUpperArmR, WalkerLowerArmR,
+        WalkerPelvis, WalkerThighL, WalkerShinL,
+        WalkerPelvis, WalkerThighR, WalkerShinR,
+    };
+
+    const Vec3 WALKER_OFFSETS[WalkerJointCount] = {
+        { 0.0f, 0.95f, 0.0f }, { 0.0f, 0.12f, 0.0f }, { 0.0f, 0.25f, 0.0f }, { 0.0f, 0.3f, 0.0f },
+        { 0.2f, 0.2f, 0.0f },  { 0.0f, -0.28f, 0.0f }, { 0.0f, -0.26f, 0.0f },
+        { -0.2f, 0.2f, 0.0f }, { 0.0f, -0.28f, 0.0f }, { 0.0f, -0.26f, 0.0f },
+        { 0.1f, -0.05f, 0.0f }, { 0.0f, -0.43f, 0.0f }, { 0.0f, -0.42f, 0.0f },
+        { -0.1f, -0.05f, 0.0f }, { 0.0f, -0.43f, 0.0f }, { 0.0f, -0.42f, 0.0f },
+    };
+
+    // Gait parameters; the clips differ only in these.
+    struct Gait {
+        float cycleSeconds;
+        float hipSwing, kneeBase, kneeSwing;
+        float armSwing, elbow;
+        float lean, twist, bob, pelvisHeight;
+    };
+    const Gait WALK = { 1.1f,  0.45f, 0.05f, 0.9f, 0.35f, -0.25f, 0.05f, 0.1f,  0.03f, 0.95f };
+    const Gait RUN  = { 0.72f, 0.85f, 0.25f, 1.6f, 0.7f,  -1.3f,  0.25f, 0.15f, 0.06f, 0.9f };
+
+    // Local transforms of every walker joint at normalized phase p. Positive pitch
+    // swings a hanging limb backwards (towards -Z).
+    void walkerPose(const Gait& g, float p, AnimationClip::Key* out) {
+        float s = std::sin(TWO_PI * p);
+        float c = std::cos(TWO_PI * p);
+        for (uint32_t j = 0; j < WalkerJointCount; j++) {
+            out[j].rotation = Quat{};
+            out[j].translation = WALKER_OFFSETS[j];
+        }
+
+        // Two bobs per cycle, lowest mid-stance.
+        out[WalkerPelvis].translation.y = g.pelvisHeight + g.bob * std::cos(2.0f * TWO_PI * p);
+        out[WalkerPelvis].rotation = yaw(g.twist * c);
+        out[WalkerSpine].rotation = yaw(-0.8f * g.twist * c) * pitch(g.lean);
+        out[WalkerChest].rotation = yaw(-0.6f * g.twist * c);
+        out[WalkerHead].rotation = pitch(-g.lean);
+
+        // Left leg forward at p = 0; a leg bends its knee while it swings forward.
+        float kneeL = g.kneeBase + g.kneeSwing * std::max(0.0f, -s);
+        float kneeR = g.kneeBase + g.kneeSwing * std::max(0.0f, s);
+        out[WalkerThighL].rotation = pitch(-g.hipSwing * c);
+        out[WalkerThighR].rotation = pitch(g.hipSwing * c);
+        out[WalkerShinL].rotation = pitch(kneeL);
+        out[WalkerShinR].rotation = pitch(kneeR);
+        out[WalkerFootL].rotation = pitch(-0.5f * (kneeL - g.hipSwing * c));
+        out[WalkerFootR].rotation = pitch(-0.5f * (kneeR + g.hipSwing * c));
+
+        // Arms swing against the legs, held slightly away from the body.
+        out[WalkerUpperArmL].rotation = roll(0.08f) * pitch(g.armSwing * c);
+        out[WalkerUpperArmR].rotation = roll(-0.08f) * pitch(-g.armSwing * c);
+        out[WalkerLowerArmL].rotation = pitch(g.elbow);
+        out[WalkerLowerArmR].rotation = pitch(g.elbow);
+    }
+}
+
+//-------------------------------------------------------------------------
+// AnimationClip
+//-------------------------------------------------------------------------
+
+void AnimationClip::compress(const std::vector<Key>& source, uint32_t jointCount, float sampleRate) {
+    joints = jointCount;
+    blocks = jointBlockCount(jointCount);
+    keys = uint32_t(source.size() / jointCount);
+    rate = sampleRate;
+
+    // Per joint and axis: translation range over the whole clip. Padding lanes stay at zero.
+    ranges.assign(blocks, TranslationRange{});
+    for (uint32_t j = 0; j < joints; j++) {
+        TranslationRange& range = ranges[j / 4];
+        uint32_t lane = j % 4;
+        for (int axis = 0; axis < 3; axis++) {
+            float lo = 1e30f, hi = -1e30f;
+            for (uint32_t k = 0; k < keys; k++) {
+                const Vec3& t = source[size_t(k) * joints + j].translation;
+                float v = axis == 0 ? t.x : axis == 1 ? t.y : t.z;
+                lo = std::min(lo, v);
+                hi = std::max(hi, v);
+            }
+            range.minimum[axis][lane] = lo;
+            range.scale[axis][lane] = (hi - lo) / QUANT_UNSIGNED;
+        }
+    }
+
+    data.assign(size_t(keys) * blocks, KeyBlock{});
+    for (uint32_t k = 0; k < keys; k++) {
+        for (uint32_t b = 0; b < blocks; b++) {
+            KeyBlock& block = data[size_t(k) * blocks + b];
+            const TranslationRange& range = ranges[b];
+            for (uint32_t lane = 0; lane < 4; lane++) {
+                uint32_t j = b * 4 + lane;
+                if (j >= joints) {
+                    block.rotation[3][lane] = int16_t(QUANT_SIGNED);   // identity padding
+                    continue;
+                }
+                const Key& key = source[size_t(k) * joints + j];
+                // q and -q are the same rotation; w >= 0 keeps neighbouring keys on one hemisphere.
+                Quat q = normalize(key.rotation);
+                if (q.w < 0.0f) q = Quat{ -q.x, -q.y, -q.z, -q.w };
+                block.rotation[0][lane] = quantizeSigned(q.x);
+                block.rotation[1][lane] = quantizeSigned(q.y);
+                block.rotation[2][lane] = quantizeSigned(q.z);
+                block.rotation[3][lane] = quantizeSigned(q.w);
+
+                const float t[3] = { key.translation.x, key.translation.y, key.translation.z };
+                for (int axis = 0; axis < 3; axis++) {
+                    float scale = range.scale[axis][lane];
+                    float u = scale > 0.0f ? (t[axis] - range.minimum[axis][lane]) / scale : 0.0f;
+                    block.translation[axis][lane] = uint16_t(std::lround(std::min(std::max(u, 0.0f), QUANT_UNSIGNED)));
+                }
+            }
+        }
+    }
+}
+
+void AnimationClip::sample(float time, JointBlock* out) const {
+    float t = time * rate;
+    t -= std::floor(t / float(keys)) * float(keys);
+    uint32_t k0 = std::min(uint32_t(t), keys - 1);
+    uint32_t k1 = k0 + 1 == keys ? 0 : k0 + 1;
+    float alpha = t - float(k0);
+
+    const KeyBlock* row0 = &data[size_t(k0) * blocks];
+    const KeyBlock* row1 = &data[size_t(k1) * blocks];
+
+#if ENGINE_MATH_SSE
+    const __m128 rotationScale = _mm_set1_ps(1.0f / QUANT_SIGNED);
+    const __m128 weight = _mm_set1_ps(alpha);
+    for (uint32_t b = 0; b < blocks; b++) {
+        const TranslationRange& range = ranges[b];
+        PoseLanes lanes[2];
+        const KeyBlock* rows[2] = { &row0[b], &row1[b] };
+        for (int i = 0; i < 2; i++) {
+            for (int c = 0; c < 4; c++) {
+                lanes[i].r[c] = _mm_mul_ps(loadSigned(rows[i]->rotation[c]), rotationScale);
+            }
+            for (int axis = 0; axis < 3; axis++) {
+                lanes[i].t[axis] = _mm_add_ps(_mm_load_ps(range.minimum[axis]),
+                    _mm_mul_ps(loadUnsigned(rows[i]->translation[axis]), _mm_load_ps(range.scale[axis])));
+            }
+        }
+        interpolate(lanes[0], lanes[1], weight, out[b]);
+    }
+#else
+    for (uint32_t b = 0; b < blocks; b++) {
+        const TranslationRange& range = ranges[b];
+        const KeyBlock* rows[2] = { &row0[b], &row1[b] };
+        for (int lane = 0; lane < 4; lane++) {
+            float lanes[2][7];
+            for (int i = 0; i < 2; i++) {
+                for (int c = 0; c < 4; c++) {
+                    lanes[i][c] = float(rows[i]->rotation[c][lane]) / QUANT_SIGNED;
+                }
+                for (int axis = 0; axis < 3; axis++) {
+                    lanes[i][4 + axis] = range.minimum[axis][lane]
+                        + float(rows[i]->translation[axis][lane]) * range.scale[axis][lane];
+                }
+            }
+            interpolateLane(lanes[0], lanes[1], alpha, out[b], lane);
+        }
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Blending & skinning
+//-------------------------------------------------------------------------
+
+void blendPoses(const JointBlock* a, const JointBlock* b, float weight, JointBlock* out, uint32_t blockCount) {
+#if ENGINE_MATH_SSE
+    const __m128 t = _mm_set1_ps(weight);
+    for (uint32_t i = 0; i < blockCount; i++) {
+        PoseLanes la, lb;
+        loadBlock(a[i], la);
+        loadBlock(b[i], lb);
+        interpolate(la, lb, t, out[i]);
+    }
+#else
+    for (uint32_t i = 0; i < blockCount; i++) {
+        for (int lane = 0; lane < 4; lane++) {
+            float la[7], lb[7];
+            laneOf(a[i], lane, la);
+            laneOf(b[i], lane, lb);
+            interpolateLane(la, lb, weight, out[i], lane);
+        }
+    }
+#endif
+}
+
+void computeSkinningPalette(const Skeleton& skeleton, const JointBlock* local, const Mat4& world,
+                            Mat4* model, Mat4* palette) {
+    uint32_t count = skeleton.jointCount();
+    for (uint32_t b = 0; b * 4 < count; b++) {
+        localMatrices(local[b], model + b * 4, std::min(count - b * 4, 4u));
+    }
+    for (uint32_t j = 0; j < count; j++) {
+        int32_t parent = skeleton.parents[j];
+        model[j] = (parent < 0 ? world : model[parent]) * model[j];
+        palette[j] = model[j] * skeleton.inverseBind[j];
+    }
+}
+
+//-------------------------------------------------------------------------
+// Procedural content
+//-------------------------------------------------------------------------
+
+std::vector<Vec3> walkerBindPositions() {
+    std::vector<Vec3> positions(WalkerJointCount);
+    for (uint32_t j = 0; j < WalkerJointCount; j++) {
+        int32_t parent = WALKER_PARENTS[j];
+        positions[j] = parent < 0 ? WALKER_OFFSETS[j] : positions[parent] + WALKER_OFFSETS[j];
+    }
+    return positions;
+}
+
+Skeleton createWalkerSkeleton() {
+    Skeleton skeleton;
+    skeleton.parents.assign(WALKER_PARENTS, WALKER_PARENTS + WalkerJointCount);
+    for (const Vec3& p : walkerBindPositions()) {
+        skeleton.inverseBind.push_back(Mat4::translation(-p));   // the bind pose has no rotation
+    }
+    return skeleton;
+}
+
+AnimationClip createWalkerClip(bool run) {
+    const Gait& gait = run ? RUN : WALK;
+    uint32_t keyCount = uint32_t(std::lround(gait.cycleSeconds * WALKER_SAMPLE_RATE));
+
+    std::vector<AnimationClip::Key> keys(size_t(keyCount) * WalkerJointCount);
+    for (uint32_t k = 0; k < keyCount; k++) {
+        walkerPose(gait, float(k) / float(keyCount), &keys[size_t(k) * WalkerJointCount]);
+    }
+
+    AnimationClip clip;
+    clip.compress(keys, WalkerJointCount, WALKER_SAMPLE_RATE);
+    return clip;
+}
@@ -0,0 +1,111 @@
+// src/Animation.h
+#pragma once
+
+#include "Math.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Local transforms of four consecutive joints in structure-of-arrays form.
+// Poses are arrays of these (jointBlockCount() of them), so sampling and
+// blending work on four joints per SSE operation. Scale is not animated.
+// Lanes past the skeleton's last joint are padding and hold identity.
+struct alignas(16) JointBlock {
+    float rx[4], ry[4], rz[4], rw[4];   // rotation
+    float tx[4], ty[4], tz[4];          // translation relative to the parent
+    float pad[4];
+};
+static_assert(sizeof(JointBlock) == 128, "JointBlock should stay two cache lines");
+
+inline uint32_t jointBlockCount(uint32_t jointCount) { return (jointCount + 3) / 4; }
+
+// Joint hierarchy. Parents precede their children, so model-space matrices can
+// be built in a single pass in joint order.
+struct Skeleton {
+    std::vector<int32_t> parents;       // -1 for the root
+    std::vector<Mat4>    inverseBind;   // model space -> joint space in the bind pose
+
+    uint32_t jointCount() const { return uint32_t(parents.size()); }
+};
+
+// Looping clip, sampled at a fixed rate and stored quantized:
+//   rotations     four int16 components, 8 bytes instead of 16;
+//   translations  three uint16, relative to each joint's range over the clip,
+//                 6 bytes instead of 12 (exact for joints that never move).
+// Keys are stored key-major in blocks of four joints, mirroring JointBlock, so
+// sampling one time reads two contiguous rows and decodes them with a handful of
+// integer-to-float conversions.
+class AnimationClip {
+public:
+    struct Key {
+        Quat rotation;
+        Vec3 translation;
+    };
+
+    // `keys` holds keyCount * jointCount local transforms, key-major, sampled at
+    // `sampleRate` keys per second over exactly one loop (the first key is not
+    // repeated at the end).
+    void compress(const std::vector<Key>& keys, uint32_t jointCount, float sampleRate);
+
+    // Samples the clip at `time` seconds, wrapped into the loop, into
+    // jointBlockCount(jointCount()) blocks.
+    void sample(float time, JointBlock* out) const;
+
+    uint32_t jointCount() const { return joints; }
+    uint32_t keyCount() const { return keys; }
+    float    duration() const { return float(keys) / rate; }
+
+    size_t compressedBytes() const { return data.size() * sizeof(KeyBlock) + ranges.size() * sizeof(TranslationRange); }
+    size_t rawBytes() const { return size_t(keys) * joints * (sizeof(Quat) + 3 * sizeof(float)); }
+
+private:
+    struct KeyBlock {
+        int16_t  rotation[4][4];      // [component][lane], scaled by 32767
+        uint16_t translation[3][4];   // [axis][lane], 0..65535 over the joint's range
+    };
+    struct alignas(16) TranslationRange {
+        float minimum[3][4];          // [axis][lane]
+        float scale[3][4];            // (max - min) / 65535
+    };
+
+    uint32_t joints = 0;
+    uint32_t blocks = 0;
+    uint32_t keys = 0;
+    float    rate = 30.0f;
+    std::vector<KeyBlock>         data;     // keys * blocks
+    std::vector<TranslationRange> ranges;   // blocks
+};
+
+// out = a blended towards b by `weight` (0 = a, 1 = b): nlerp per rotation,
+// lerp per translation. `out` may alias either input.
+void blendPoses(const JointBlock* a, const JointBlock* b, float weight, JointBlock* out, uint32_t blockCount);
+
+// Builds the skinning palette of one posed character: palette[j] =
+// world * model(j) * inverseBind[j]. `model` is jointCount() matrices of scratch.
+// The palette is only written, never read, so it may point into mapped GPU memory.
+void computeSkinningPalette(const Skeleton& skeleton, const JointBlock* local, const Mat4& world,
+                            Mat4* model, Mat4* palette);
+
+//-------------------------------------------------------------------------
+// Procedural content
+//-------------------------------------------------------------------------
+
+// Joints of the procedural biped, in hierarchy order.
+enum WalkerJoint : uint32_t {
+    WalkerPelvis, WalkerSpine, WalkerChest, WalkerHead,
+    WalkerUpperArmL, WalkerLowerArmL, WalkerHandL,
+    WalkerUpperArmR, WalkerLowerArmR, WalkerHandR,
+    WalkerThighL, WalkerShinL, WalkerFootL,
+    WalkerThighR, WalkerShinR, WalkerFootR,
+    WalkerJointCount
+};
+
+// The biped's skeleton: about 1.85 units tall, standing on the origin facing +Z.
+Skeleton createWalkerSkeleton();
+// Model-space position of every joint in the bind pose.
+std::vector<Vec3> walkerBindPositions();
+// One gait cycle of the walker, walking or running, in place.
+// Both clips start with the left foot forward, so they can be blended at the
+// same normalized phase.
+AnimationClip createWalkerClip(bool run);
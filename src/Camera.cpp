@@ -0,0 +1,30 @@
+// src/Camera.cpp
+#include "Camera.h"
+
+//-------------------------------------------------------------------------
+// Camera
+//-------------------------------------------------------------------------
+
+void Camera::setPerspective(float fovY_, float zNear_, float zFar_) {
+    fovYRadians = fovY_;
+    zNear = zNear_;
+    zFar = zFar_;
+    updateProjection();
+}
+
+void Camera::setAspect(float aspect_) {
+    aspectRatio = aspect_;
+    updateProjection();
+}
+
+void Camera::lookAt(const Vec3& eye_, const Vec3& target) {
+    eye = eye_;
+    forwardAxis = normalize(target - eye);
+    rightAxis = normalize(cross(forwardAxis, Vec3{ 0.0f, 1.0f, 0.0f }));
+    upAxis = cross(rightAxis, forwardAxis);
+    viewMatrix = Mat4::lookAt(eye, target, Vec3{ 0.0f, 1.0f, 0.0f });
+}
+
+void Camera::updateProjection() {
+    projMatrix = Mat4::perspective(fovYRadians, aspectRatio, zNear, zFar);
+}
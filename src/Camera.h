@@ -0,0 +1,42 @@
+// src/Camera.h
+#pragma once
+
+#include "Math.h"
+
+// Right-handed perspective camera with Vulkan clip conventions
+// (Y down in clip space, depth 0..1).
+class Camera {
+public:
+    void setPerspective(float fovYRadians, float zNear, float zFar);
+    void setAspect(float aspect);
+    void lookAt(const Vec3& eye, const Vec3& target);
+
+    const Mat4& view()       const { return viewMatrix; }
+    const Mat4& projection() const { return projMatrix; }
+    Mat4        viewProjection() const { return projMatrix * viewMatrix; }
+
+    const Vec3& position() const { return eye; }
+    const Vec3& right()    const { return rightAxis; }
+    const Vec3& up()       const { return upAxis; }
+    const Vec3& forward()  const { return forwardAxis; }
+
+    float fovY()      const { return fovYRadians; }
+    float aspect()    const { return aspectRatio; }
+    float nearPlane() const { return zNear; }
+    float farPlane()  const { return zFar; }
+
+private:
+    void updateProjection();
+
+    Vec3  eye{ 0.0f, 0.0f, 1.0f };
+    Vec3  rightAxis{ 1.0f, 0.0f, 0.0f };
+    Vec3  upAxis{ 0.0f, 1.0f, 0.0f };
+    Vec3  forwardAxis{ 0.0f, 0.0f, -1.0f };
+    float fovYRadians = 1.0472f;   // 60 degrees
+    float aspectRatio = 1.0f;
+    float zNear = 0.1f;
+    float zFar = 200.0f;
+
+    Mat4 viewMatrix = Mat4::identity();
+    Mat4 projMatrix = Mat4::identity();
+};
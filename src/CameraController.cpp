@@ -0,0 +1,78 @@
+// src/CameraController.cpp
+#include "CameraController.h"
+#include "Camera.h"
+#include "InputSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const float LOOK_RADIANS_PER_PIXEL = 0.003f;
+    const float MAX_PITCH = 1.55f;            // just short of straight up/down
+    const float FAST_MULTIPLIER = 4.0f;
+    const float SPEED_STEP_PER_NOTCH = 1.2f;
+
+    const int LOOK_BUTTON = GLFW_MOUSE_BUTTON_RIGHT;
+
+    Vec3 forwardFor(float yaw, float pitch) {
+        return { std::cos(pitch) * std::sin(yaw), std::sin(pitch), -std::cos(pitch) * std::cos(yaw) };
+    }
+}
+
+void CameraController::init(const Camera& camera) {
+    const Vec3& f = camera.forward();
+    position = camera.position();
+    yaw = std::atan2(f.x, -f.z);
+    pitch = std::asin(std::clamp(f.y, -1.0f, 1.0f));
+}
+
+void CameraController::fixedUpdate(const InputState& input, float dt) {
+    if (input.scroll != 0.0) {
+        moveSpeed *= std::pow(SPEED_STEP_PER_NOTCH, float(input.scroll));
+        moveSpeed = std::clamp(moveSpeed, 0.5f, 500.0f);
+    }
+
+    if (input.buttonDown(LOOK_BUTTON)) {
+        yaw += float(input.cursorDeltaX) * LOOK_RADIANS_PER_PIXEL;
+        pitch = std::clamp(pitch - float(input.cursorDeltaY) * LOOK_RADIANS_PER_PIXEL, -MAX_PITCH, MAX_PITCH);
+    }
+
+    // Move in the horizontal plane, plus straight up/down.
+    Vec3 forward{ std::sin(yaw), 0.0f, -std::cos(yaw) };
+    Vec3 right{ std::cos(yaw), 0.0f, std::sin(yaw) };
+    Vec3 move{};
+    if (input.keyDown(GLFW_KEY_W)) move = move + forward;
+    if (input.keyDown(GLFW_KEY_S)) move = move - forward;
+    if (input.keyDown(GLFW_KEY_D)) move = move + right;
+    if (input.keyDown(GLFW_KEY_A)) move = move - right;
+    if (input.keyDown(GLFW_KEY_E)) move.y += 1.0f;
+    if (input.keyDown(GLFW_KEY_Q)) move.y -= 1.0f;
+
+    if (dot(move, move) > 0.0f) {
+        float speed = moveSpeed * (input.keyDown(GLFW_KEY_LEFT_SHIFT) ? FAST_MULTIPLIER : 1.0f);
+        position = position + normalize(move) * (speed * dt);
+    }
+}
+
+CameraPose CameraController::pose(const InputState& input) const {
+    CameraPose p;
+    p.position = position;
+    p.yaw = yaw;
+    p.pitch = pitch;
+    p.looking = input.buttonDown(LOOK_BUTTON);
+    p.cursorX = input.cursorX;
+    p.cursorY = input.cursorY;
+    return p;
+}
+
+void CameraController::lateSample(const CameraPose& pose, const InputSystem& input, Camera& camera) {
+    float viewYaw = pose.yaw;
+    float viewPitch = pose.pitch;
+    if (pose.looking) {
+        viewYaw += float(input.latestCursorX() - pose.cursorX) * LOOK_RADIANS_PER_PIXEL;
+        viewPitch = std::clamp(viewPitch - float(input.latestCursorY() - pose.cursorY) * LOOK_RADIANS_PER_PIXEL,
+                               -MAX_PITCH, MAX_PITCH);
+    }
+
+    camera.lookAt(pose.position, pose.position + forwardFor(viewYaw, viewPitch));
+}
@@ -0,0 +1,45 @@
+// src/CameraController.h
+#pragma once
+
+#include "Math.h"
+
+class Camera;
+class InputSystem;
+struct InputState;
+
+// Snapshot of the simulated camera, safe to hand to another thread.
+struct CameraPose {
+    Vec3   position;
+    float  yaw = 0.0f;
+    float  pitch = 0.0f;
+    bool   looking = false;             // look button held at the end of the last step
+    double cursorX = 0.0, cursorY = 0.0;   // cursor position the last step consumed
+};
+
+// Fly camera. Movement (WASD, E/Q up and down, Shift faster, scroll for speed)
+// and mouse look (hold the right button) are integrated in fixed simulation
+// steps from the events InputSystem delivered for that step.
+//
+// Mouse movement that has happened since the last step is not lost until the
+// next one: lateSample() adds it to the view just before the frame is recorded,
+// without committing it to the simulated state.
+class CameraController {
+public:
+    // Takes the starting pose from `camera`.
+    void init(const Camera& camera);
+
+    void fixedUpdate(const InputState& input, float dt);
+
+    // Current simulated pose, tagged with the input state it was simulated from.
+    CameraPose pose(const InputState& input) const;
+
+    // Aims `camera` at `pose` plus the cursor movement not simulated yet. Only reads
+    // InputSystem's atomics, so the render thread may call it.
+    static void lateSample(const CameraPose& pose, const InputSystem& input, Camera& camera);
+
+private:
+    Vec3  position;
+    float yaw = 0.0f;     // radians, 0 looks down -Z
+    float pitch = 0.0f;   // radians, positive looks up
+    float moveSpeed = 10.0f;   // units per second
+};
@@ -0,0 +1,433 @@
+// src/CascadedShadowMap.cpp
+#include "CascadedShadowMap.h"
+#include "HostMemoryTracker.h"
+#include "Device.h"
+#include "Camera.h"
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace {
+    // Mandatory as a sampled depth attachment, and half the copy traffic of D32.
+    // Cascades span a few hundred units at most, so 16 bits of linear depth suffice.
+    const VkFormat SHADOW_FORMAT = VK_FORMAT_D16_UNORM;
+
+    const float DEPTH_BIAS_CONSTANT = 4.0f;
+    const float DEPTH_BIAS_SLOPE = 1.5f;
+
+    struct ShadowPushConstants {
+        float viewProj[16];
+    };
+    static_assert(sizeof(ShadowPushConstants) == CascadedShadowMap::pushConstantSize, "shadow push constant size mismatch");
+
+    // std140 mirror of `Shadows` in lod_shadowed.frag.
+    struct ShadowUniforms {
+        float cascadeViewProj[CascadedShadowMap::MAX_CASCADES][16];
+        float splitFar[4];
+        float texelSize[4];
+        float cameraPosition[4];   // w = cascade count
+        float cameraForward[4];
+    };
+
+    VkRenderPass createDepthPass(VkDevice dev, VkAttachmentLoadOp loadOp, VkImageLayout initialLayout,
+        VkImageLayout finalLayout, const VkSubpassDependency (&dependencies)[2])
+    {
+        VkAttachmentDescription depth{};
+        depth.format = SHADOW_FORMAT;
+        depth.samples = VK_SAMPLE_COUNT_1_BIT;
+        depth.loadOp = loadOp;
+        depth.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        depth.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depth.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depth.initialLayout = initialLayout;
+        depth.finalLayout = finalLayout;
+
+        VkAttachmentReference depthRef{ 0, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.pDepthStencilAttachment = &depthRef;
+
+        VkRenderPassCreateInfo info{ VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
+        info.attachmentCount = 1;
+        info.pAttachments = &depth;
+        info.subpassCount = 1;
+        info.pSubpasses = &subpass;
+        info.dependencyCount = 2;
+        info.pDependencies = dependencies;
+
+        VkRenderPass pass = VK_NULL_HANDLE;
+        if (vkCreateRenderPass(dev, &info, hostAllocator("CascadedShadowMap"), &pass) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create shadow render pass!");
+        }
+        return pass;
+    }
+}
+
+//-------------------------------------------------------------------------
+// Init & cleanup
+//-------------------------------------------------------------------------
+
+void CascadedShadowMap::init(Device& dev, const ShadowCascadeSettings& settings_, uint32_t framesInFlight,
+                             VkDescriptorSetLayout casterSetLayout,
+                             const std::vector<VkVertexInputBindingDescription>& vertexBindings,
+                             const std::vector<VkVertexInputAttributeDescription>& vertexAttributes, bool cacheStatic_)
+{
+    device = &dev;
+    settings = settings_;
+    settings.cascadeCount = std::min(std::max(settings.cascadeCount, 1u), MAX_CASCADES);
+    cacheStatic = cacheStatic_;
+    cacheValid.assign(settings.cascadeCount, false);
+
+    createImages();
+    createRenderPasses();
+    createFramebuffers();
+    createDescriptors(framesInFlight);
+
+    // Both passes are compatible (one depth attachment of the same format), so one pipeline serves them.
+    PipelineConfig config;
+    config.vertShader = "shaders_spv/shadow_vert.spv";
+    config.pushConstantSize = pushConstantSize;
+    config.setLayouts = { casterSetLayout };
+    config.cullMode = VK_CULL_MODE_NONE;
+    config.depthBiasConstant = DEPTH_BIAS_CONSTANT;
+    config.depthBiasSlope = DEPTH_BIAS_SLOPE;
+    config.vertexBindings = vertexBindings;
+    config.vertexAttributes = vertexAttributes;
+    casterPipeline.initDepthOnly(*device, shadowPass, VkExtent2D{ settings.resolution, settings.resolution }, config);
+}
+
+void CascadedShadowMap::cleanup() {
+    VkDevice dev = device->device();
+
+    casterPipeline.cleanup();
+
+    for (size_t i = 0; i < uniformBuffers.size(); i++) {
+        vkUnmapMemory(dev, uniformMemory[i]);
+        vkDestroyBuffer(dev, uniformBuffers[i], hostAllocator("CascadedShadowMap"));
+        device->freeMemory(uniformMemory[i]);
+    }
+    uniformBuffers.clear();
+    vkDestroyDescriptorPool(dev, descriptorPool, hostAllocator("CascadedShadowMap"));
+    vkDestroyDescriptorSetLayout(dev, descriptorSetLayout, hostAllocator("CascadedShadowMap"));
+    vkDestroySampler(dev, compareSampler, hostAllocator("CascadedShadowMap"));
+
+    for (VkFramebuffer framebuffer : cacheFramebuffers) vkDestroyFramebuffer(dev, framebuffer, hostAllocator("CascadedShadowMap"));
+    for (VkFramebuffer framebuffer : shadowFramebuffers) vkDestroyFramebuffer(dev, framebuffer, hostAllocator("CascadedShadowMap"));
+    cacheFramebuffers.clear();
+    shadowFramebuffers.clear();
+    if (cachePass != VK_NULL_HANDLE) vkDestroyRenderPass(dev, cachePass, hostAllocator("CascadedShadowMap"));
+    vkDestroyRenderPass(dev, shadowPass, hostAllocator("CascadedShadowMap"));
+
+    for (VkImageView view : layerViews) vkDestroyImageView(dev, view, hostAllocator("CascadedShadowMap"));
+    layerViews.clear();
+    vkDestroyImageView(dev, shadowArrayView, hostAllocator("CascadedShadowMap"));
+    vkDestroyImage(dev, shadowImage, hostAllocator("CascadedShadowMap"));
+    device->freeMemory(shadowMemory);
+    if (cacheImage != VK_NULL_HANDLE) {
+        vkDestroyImage(dev, cacheImage, hostAllocator("CascadedShadowMap"));
+        device->freeMemory(cacheMemory);
+    }
+}
+
+void CascadedShadowMap::createImages() {
+    VkDevice dev = device->device();
+    uint32_t size = settings.resolution;
+    uint32_t layers = settings.cascadeCount;
+
+    device->createImage(size, size, SHADOW_FORMAT, VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, shadowImage, shadowMemory, VK_SAMPLE_COUNT_1_BIT,
+        GpuMemoryCategory::RenderTarget, 1, layers);
+    if (cacheStatic) {
+        device->createImage(size, size, SHADOW_FORMAT, VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, cacheImage, cacheMemory, VK_SAMPLE_COUNT_1_BIT,
+            GpuMemoryCategory::RenderTarget, 1, layers);
+    }
+
+    VkImageViewCreateInfo viewInfo{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewInfo.image = shadowImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = SHADOW_FORMAT;
+    viewInfo.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, layers };
+    if (vkCreateImageView(dev, &viewInfo, hostAllocator("CascadedShadowMap"), &shadowArrayView) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create shadow map view!");
+    }
+
+    // One 2D view per layer to render into: cache layers first, then shadow layers.
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    for (VkImage image : { cacheImage, shadowImage }) {
+        if (image == VK_NULL_HANDLE) continue;
+        viewInfo.image = image;
+        for (uint32_t layer = 0; layer < layers; layer++) {
+            viewInfo.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, layer, 1 };
+            VkImageView view = VK_NULL_HANDLE;
+            if (vkCreateImageView(dev, &viewInfo, hostAllocator("CascadedShadowMap"), &view) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create shadow map layer view!");
+            }
+            layerViews.push_back(view);
+        }
+    }
+}
+
+void CascadedShadowMap::createRenderPasses() {
+    VkDevice dev = device->device();
+    const VkPipelineStageFlags fragmentTests =
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    const VkAccessFlags depthAccess =
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // The cache pass waits for earlier copies out of the layer, and its result is copied next.
+    if (cacheStatic) {
+        VkSubpassDependency dependencies[2] = {
+            { VK_SUBPASS_EXTERNAL, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, fragmentTests,
+              0, depthAccess, 0 },
+            { 0, VK_SUBPASS_EXTERNAL, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+              VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, 0 },
+        };
+        cachePass = createDepthPass(dev, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dependencies);
+    }
+
+    // The shadow pass draws on top of the copied cache (or clears without one), after
+    // the previous frame's receivers have sampled the layer; receivers sample it next.
+    VkSubpassDependency dependencies[2] = {
+        { VK_SUBPASS_EXTERNAL, 0, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, fragmentTests,
+          VK_ACCESS_TRANSFER_WRITE_BIT, depthAccess, 0 },
+        { 0, VK_SUBPASS_EXTERNAL, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, 0 },
+    };
+    shadowPass = createDepthPass(dev,
+        cacheStatic ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR,
+        cacheStatic ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, dependencies);
+}
+
+void CascadedShadowMap::createFramebuffers() {
+    VkDevice dev = device->device();
+    uint32_t layers = settings.cascadeCount;
+    size_t shadowViews = cacheStatic ? layers : 0;   // index of the first shadow layer view
+
+    VkFramebufferCreateInfo info{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+    info.attachmentCount = 1;
+    info.width = settings.resolution;
+    info.height = settings.resolution;
+    info.layers = 1;
+
+    auto create = [&](VkRenderPass pass, VkImageView view) {
+        info.renderPass = pass;
+        info.pAttachments = &view;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        if (vkCreateFramebuffer(dev, &info, hostAllocator("CascadedShadowMap"), &framebuffer) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create shadow framebuffer!");
+        }
+        return framebuffer;
+    };
+
+    for (uint32_t layer = 0; layer < layers; layer++) {
+        if (cacheStatic) cacheFramebuffers.push_back(create(cachePass, layerViews[layer]));
+        shadowFramebuffers.push_back(create(shadowPass, layerViews[shadowViews + layer]));
+    }
+}
+
+void CascadedShadowMap::createDescriptors(uint32_t framesInFlight) {
+    VkDevice dev = device->device();
+
+    // Hardware comparison, one texel per tap; lod_shadowed.frag filters with several taps.
+    VkSamplerCreateInfo samplerInfo{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;   // outside a cascade = lit
+    samplerInfo.compareEnable = VK_TRUE;
+    samplerInfo.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    if (vkCreateSampler(dev, &samplerInfo, hostAllocator("CascadedShadowMap"), &compareSampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create shadow sampler!");
+    }
+
+    VkDescriptorSetLayoutBinding bindings[2]{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(dev, &layoutInfo, hostAllocator("CascadedShadowMap"), &descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create shadow descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSizes[2] = {
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, framesInFlight },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, framesInFlight },
+    };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = framesInFlight;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(dev, &poolInfo, hostAllocator("CascadedShadowMap"), &descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create shadow descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(framesInFlight, descriptorSetLayout);
+    descriptorSets.resize(framesInFlight);
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = framesInFlight;
+    allocInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(dev, &allocInfo, descriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate shadow descriptor sets!");
+    }
+
+    uniformBuffers.resize(framesInFlight);
+    uniformMemory.resize(framesInFlight);
+    uniformMapped.resize(framesInFlight);
+    for (uint32_t i = 0; i < framesInFlight; i++) {
+        device->createBuffer(sizeof(ShadowUniforms), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            uniformBuffers[i], uniformMemory[i]);
+        vkMapMemory(dev, uniformMemory[i], 0, VK_WHOLE_SIZE, 0, &uniformMapped[i]);
+
+        VkDescriptorBufferInfo bufferInfo{ uniformBuffers[i], 0, VK_WHOLE_SIZE };
+        VkDescriptorImageInfo imageInfo{ compareSampler, shadowArrayView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+
+        VkWriteDescriptorSet writes[2]{};
+        writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[0].dstSet = descriptorSets[i];
+        writes[0].dstBinding = 0;
+        writes[0].descriptorCount = 1;
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        writes[0].pBufferInfo = &bufferInfo;
+        writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[1].dstSet = descriptorSets[i];
+        writes[1].dstBinding = 1;
+        writes[1].descriptorCount = 1;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writes[1].pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(dev, 2, writes, 0, nullptr);
+    }
+}
+
+//-------------------------------------------------------------------------
+// Per frame
+//-------------------------------------------------------------------------
+
+void CascadedShadowMap::update(uint32_t frame, const Camera& camera, const Vec3& towardsLight) {
+    currentLight = normalize(towardsLight);
+    fitShadowCascades(camera, currentLight, settings, cascades);
+
+    ShadowUniforms u{};
+    for (uint32_t c = 0; c < settings.cascadeCount; c++) {
+        std::memcpy(u.cascadeViewProj[c], cascades[c].viewProjection.m, sizeof(u.cascadeViewProj[c]));
+        u.splitFar[c] = cascades[c].splitFar;
+        u.texelSize[c] = cascades[c].texelSize;
+    }
+    u.cameraPosition[0] = camera.position().x;
+    u.cameraPosition[1] = camera.position().y;
+    u.cameraPosition[2] = camera.position().z;
+    u.cameraPosition[3] = float(settings.cascadeCount);
+    u.cameraForward[0] = camera.forward().x;
+    u.cameraForward[1] = camera.forward().y;
+    u.cameraForward[2] = camera.forward().z;
+    std::memcpy(uniformMapped[frame], &u, sizeof(u));
+}
+
+uint32_t CascadedShadowMap::record(VkCommandBuffer commandBuffer, const DrawCasters& drawCasters) {
+    uint32_t draws = 0;
+    lastRefreshed = 0;
+
+    if (!cacheStatic) {
+        // Everything, every frame, straight into the sampled layers.
+        for (uint32_t c = 0; c < settings.cascadeCount; c++) {
+            beginCascade(commandBuffer, shadowPass, shadowFramebuffers[c], c);
+            draws += drawCasters(commandBuffer, casterPipeline.layout(), c, Casters::Static);
+            draws += drawCasters(commandBuffer, casterPipeline.layout(), c, Casters::Dynamic);
+            vkCmdEndRenderPass(commandBuffer);
+        }
+        return draws;
+    }
+
+    // A new light direction moves every cascade in ways the snapped cells do not capture.
+    if (currentLight.x != cachedLight.x || currentLight.y != cachedLight.y || currentLight.z != cachedLight.z) {
+        invalidateStaticCasters();
+        cachedLight = currentLight;
+    }
+
+    // 1) Static casters, only into the layers whose cascade moved.
+    for (uint32_t c = 0; c < settings.cascadeCount; c++) {
+        if (cacheValid[c] && samePlacement(cachedCascades[c], cascades[c])) continue;
+
+        beginCascade(commandBuffer, cachePass, cacheFramebuffers[c], c);
+        draws += drawCasters(commandBuffer, casterPipeline.layout(), c, Casters::Static);
+        vkCmdEndRenderPass(commandBuffer);
+
+        cachedCascades[c] = cascades[c];
+        cacheValid[c] = true;
+        lastRefreshed++;
+    }
+
+    // 2) Cache -> shadow array, once the previous frame's receivers are done with it.
+    VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+    barrier.oldLayout = needsLayoutInit ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = shadowImage;
+    barrier.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, settings.cascadeCount };
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &barrier);
+    needsLayoutInit = false;
+
+    VkImageCopy region{};
+    region.srcSubresource = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, settings.cascadeCount };
+    region.dstSubresource = region.srcSubresource;
+    region.extent = { settings.resolution, settings.resolution, 1 };
+    vkCmdCopyImage(commandBuffer, cacheImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        shadowImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    // 3) Dynamic casters on top; the pass leaves each layer ready to be sampled.
+    for (uint32_t c = 0; c < settings.cascadeCount; c++) {
+        beginCascade(commandBuffer, shadowPass, shadowFramebuffers[c], c);
+        draws += drawCasters(commandBuffer, casterPipeline.layout(), c, Casters::Dynamic);
+        vkCmdEndRenderPass(commandBuffer);
+    }
+    return draws;
+}
+
+void CascadedShadowMap::beginCascade(VkCommandBuffer commandBuffer, VkRenderPass pass, VkFramebuffer framebuffer,
+                                     uint32_t cascade)
+{
+    VkClearValue clear{};
+    clear.depthStencil = { 1.0f, 0 };
+
+    VkRenderPassBeginInfo beginInfo{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+    beginInfo.renderPass = pass;
+    beginInfo.framebuffer = framebuffer;
+    beginInfo.renderArea = { { 0, 0 }, { settings.resolution, settings.resolution } };
+    beginInfo.clearValueCount = 1;
+    beginInfo.pClearValues = &clear;
+    vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+    VkViewport viewport{ 0.0f, 0.0f, float(settings.resolution), float(settings.resolution), 0.0f, 1.0f };
+    VkRect2D scissor{ { 0, 0 }, { settings.resolution, settings.resolution } };
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    casterPipeline.bind(commandBuffer);
+    ShadowPushConstants push{};
+    std::memcpy(push.viewProj, cascades[cascade].viewProjection.m, sizeof(push.viewProj));
+    vkCmdPushConstants(commandBuffer, casterPipeline.layout(), VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        0, sizeof(push), &push);
+}
@@ -0,0 +1,102 @@
+// src/CascadedShadowMap.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Pipeline.h"
+#include "ShadowCascades.h"
+
+class Device;
+class Camera;
+
+// Cascaded shadow map for one directional light, with the static casters cached.
+//
+// Every cascade is a layer of two depth arrays. The cache holds the static
+// casters only and is re-rendered per layer when that cascade's snapped
+// placement changes (see fitShadowCascades) or after invalidateStaticCasters().
+// Each frame the cache is copied into the sampled array and only the dynamic
+// casters are drawn on top, so a still or slowly moving camera pays a copy plus
+// the moving objects instead of redrawing the whole scene into every cascade.
+//
+// Receivers bind descriptorSet(frame) as set 1 (see lod_shadowed.frag).
+class CascadedShadowMap {
+public:
+    static constexpr uint32_t MAX_CASCADES = 4;   // cascadeViewProj[4] in lod_shadowed.frag
+    // Bytes of push constants shadow.vert expects.
+    static constexpr uint32_t pushConstantSize = 64;
+
+    enum class Casters { Static, Dynamic };
+    // Records the draws of one caster set for `cascade` with the shadow pipeline
+    // (layout `layout`, set 0 = instances) bound and its matrix pushed.
+    // Returns the number of draw calls.
+    using DrawCasters = std::function<uint32_t(VkCommandBuffer, VkPipelineLayout, uint32_t cascade, Casters)>;
+
+    // casterSetLayout: set 0 of shadow.vert (the caster instance buffer).
+    // cacheStatic = false redraws the static casters into every cascade each frame.
+    void init(Device& device, const ShadowCascadeSettings& settings, uint32_t framesInFlight,
+              VkDescriptorSetLayout casterSetLayout, const std::vector<VkVertexInputBindingDescription>& vertexBindings,
+              const std::vector<VkVertexInputAttributeDescription>& vertexAttributes, bool cacheStatic = true);
+    void cleanup();
+
+    VkDescriptorSetLayout setLayout() const { return descriptorSetLayout; }
+    VkDescriptorSet       descriptorSet(uint32_t frame) const { return descriptorSets[frame]; }
+
+    // Refits the cascades to `camera` and fills this frame slot's uniforms.
+    void update(uint32_t frame, const Camera& camera, const Vec3& towardsLight);
+
+    // Static casters moved, appeared or disappeared: every cached layer is redrawn next frame.
+    void invalidateStaticCasters() { cacheValid.assign(cacheValid.size(), false); }
+
+    // Renders all cascades, outside any render pass. Leaves the shadow array
+    // readable by fragment shaders. Returns the number of draw calls.
+    uint32_t record(VkCommandBuffer commandBuffer, const DrawCasters& drawCasters);
+
+    uint32_t cascadeCount() const { return settings.cascadeCount; }
+    // Cached layers re-rendered by the last record(), for stats.
+    uint32_t cascadesRefreshed() const { return lastRefreshed; }
+
+private:
+    void createImages();
+    void createRenderPasses();
+    void createFramebuffers();
+    void createDescriptors(uint32_t framesInFlight);
+    // Begins `pass` on one layer, binds the caster pipeline and pushes the cascade's matrix.
+    void beginCascade(VkCommandBuffer commandBuffer, VkRenderPass pass, VkFramebuffer framebuffer, uint32_t cascade);
+
+    Device* device = nullptr;
+    ShadowCascadeSettings settings;
+    bool cacheStatic = true;
+
+    // Cached static casters and the sampled result, one layer per cascade.
+    VkImage        cacheImage = VK_NULL_HANDLE;   // only with cacheStatic
+    VkDeviceMemory cacheMemory = VK_NULL_HANDLE;
+    VkImage        shadowImage = VK_NULL_HANDLE;
+    VkDeviceMemory shadowMemory = VK_NULL_HANDLE;
+    VkImageView    shadowArrayView = VK_NULL_HANDLE;
+    std::vector<VkImageView>   layerViews;      // cache layers (when caching), then shadow layers
+    std::vector<VkFramebuffer> cacheFramebuffers;
+    std::vector<VkFramebuffer> shadowFramebuffers;
+
+    VkRenderPass cachePass = VK_NULL_HANDLE;    // clears, ends ready to be copied from
+    VkRenderPass shadowPass = VK_NULL_HANDLE;   // loads the copied cache (clears uncached), ends ready to be sampled
+    Pipeline     casterPipeline;
+
+    VkSampler                    compareSampler = VK_NULL_HANDLE;
+    VkDescriptorSetLayout        descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool             descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> descriptorSets;
+    std::vector<VkBuffer>        uniformBuffers;
+    std::vector<VkDeviceMemory>  uniformMemory;
+    std::vector<void*>           uniformMapped;
+
+    ShadowCascade      cascades[MAX_CASCADES];
+    ShadowCascade      cachedCascades[MAX_CASCADES];   // placement each cached layer was drawn with
+    std::vector<bool>  cacheValid;
+    Vec3               cachedLight{ 0.0f, 0.0f, 0.0f };
+    Vec3               currentLight{ 0.0f, 0.0f, 0.0f };
+    bool               needsLayoutInit = true;          // the shadow array is still UNDEFINED
+    uint32_t           lastRefreshed = 0;
+};
@@ -0,0 +1,268 @@
+// src/ClusteredLighting.cpp
+#include "ClusteredLighting.h"
+#include "HostMemoryTracker.h"
+#include "Device.h"
+#include "Camera.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+namespace {
+    // std140 mirror of `FrameUniforms` in lighting_common.glsl.
+    struct FrameUniforms {
+        float    viewProj[16];
+        float    view[16];
+        float    cameraPosition[4];
+        float    projParams[4];      // tan(fovX/2), tan(fovY/2), near, far
+        float    clusterParams[4];   // slice scale, slice bias, tile width, tile height (pixels)
+        float    screenSize[4];      // width, height, 0, 0
+        uint32_t clusterGrid[4];     // CLUSTER_X, CLUSTER_Y, CLUSTER_Z, light count
+    };
+
+    const uint32_t BINDING_COUNT = 4;   // frame uniforms, lights, cluster counts, cluster lights
+
+    // Lights are scattered over the lit scene's floor (see lit.vert).
+    const float SCENE_HALF_EXTENT = 24.0f;
+}
+
+//-------------------------------------------------------------------------
+// Init & cleanup
+//-------------------------------------------------------------------------
+
+void ClusteredLighting::init(Device& dev, uint32_t count, uint32_t framesInFlight) {
+    device = &dev;
+    lightCount = count;
+
+    createLights();
+    createBuffers(framesInFlight);
+    createDescriptors(framesInFlight);
+
+    cullPipeline.init(*device, "shaders_spv/light_cull_comp.spv", { descriptorSetLayout });
+}
+
+void ClusteredLighting::cleanup() {
+    VkDevice dev = device->device();
+
+    cullPipeline.cleanup();
+    vkDestroyDescriptorPool(dev, descriptorPool, hostAllocator("ClusteredLighting"));
+    vkDestroyDescriptorSetLayout(dev, descriptorSetLayout, hostAllocator("ClusteredLighting"));
+
+    for (size_t i = 0; i < frameBuffers.size(); i++) {
+        vkUnmapMemory(dev, frameMemory[i]);
+        vkDestroyBuffer(dev, frameBuffers[i], hostAllocator("ClusteredLighting"));
+        device->freeMemory(frameMemory[i]);
+
+        vkUnmapMemory(dev, lightMemory[i]);
+        vkDestroyBuffer(dev, lightBuffers[i], hostAllocator("ClusteredLighting"));
+        device->freeMemory(lightMemory[i]);
+    }
+    frameBuffers.clear();
+    lightBuffers.clear();
+
+    vkDestroyBuffer(dev, clusterCountBuffer, hostAllocator("ClusteredLighting"));
+    device->freeMemory(clusterCountMemory);
+    vkDestroyBuffer(dev, clusterLightBuffer, hostAllocator("ClusteredLighting"));
+    device->freeMemory(clusterLightMemory);
+}
+
+void ClusteredLighting::createLights() {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    motions.resize(lightCount);
+    baseLights.resize(lightCount);
+
+    for (uint32_t i = 0; i < lightCount; i++) {
+        LightMotion& m = motions[i];
+        m.center[0] = (unit(rng) * 2.0f - 1.0f) * SCENE_HALF_EXTENT;
+        m.center[1] = 0.5f + unit(rng) * 3.0f;
+        m.center[2] = (unit(rng) * 2.0f - 1.0f) * SCENE_HALF_EXTENT;
+        m.orbitRadius = 0.5f + unit(rng) * 2.5f;
+        m.orbitSpeed = (unit(rng) * 2.0f - 1.0f) * 1.5f;
+        m.phase = unit(rng) * 6.2831853f;
+
+        // Saturated hue, so overlapping lights stay distinguishable.
+        float hue = unit(rng) * 6.0f;
+        float r = std::fabs(hue - 3.0f) - 1.0f;
+        float g = 2.0f - std::fabs(hue - 2.0f);
+        float b = 2.0f - std::fabs(hue - 4.0f);
+
+        GpuLight& light = baseLights[i];
+        light.positionRadius[3] = 2.0f + unit(rng) * 3.0f;
+        light.colorIntensity[0] = std::fmin(std::fmax(r, 0.0f), 1.0f);
+        light.colorIntensity[1] = std::fmin(std::fmax(g, 0.0f), 1.0f);
+        light.colorIntensity[2] = std::fmin(std::fmax(b, 0.0f), 1.0f);
+        light.colorIntensity[3] = 2.0f + unit(rng) * 2.0f;
+    }
+}
+
+void ClusteredLighting::createBuffers(uint32_t framesInFlight) {
+    const VkMemoryPropertyFlags hostVisible =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    VkDeviceSize lightBytes = std::max<VkDeviceSize>(lightCount, 1) * sizeof(GpuLight);
+
+    frameBuffers.resize(framesInFlight);
+    frameMemory.resize(framesInFlight);
+    frameMapped.resize(framesInFlight);
+    lightBuffers.resize(framesInFlight);
+    lightMemory.resize(framesInFlight);
+    lightMapped.resize(framesInFlight);
+
+    for (uint32_t i = 0; i < framesInFlight; i++) {
+        device->createBuffer(sizeof(FrameUniforms), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            hostVisible, frameBuffers[i], frameMemory[i]);
+        vkMapMemory(device->device(), frameMemory[i], 0, VK_WHOLE_SIZE, 0, &frameMapped[i]);
+
+        device->createBuffer(lightBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            hostVisible, lightBuffers[i], lightMemory[i]);
+        vkMapMemory(device->device(), lightMemory[i], 0, VK_WHOLE_SIZE, 0, &lightMapped[i]);
+    }
+
+    device->createBuffer(CLUSTER_COUNT * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, clusterCountBuffer, clusterCountMemory);
+    device->createBuffer(VkDeviceSize(CLUSTER_COUNT) * MAX_LIGHTS_PER_CLUSTER * sizeof(uint32_t),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, clusterLightBuffer, clusterLightMemory);
+}
+
+void ClusteredLighting::createDescriptors(uint32_t framesInFlight) {
+    VkDevice dev = device->device();
+
+    VkDescriptorSetLayoutBinding bindings[BINDING_COUNT]{};
+    for (uint32_t i = 0; i < BINDING_COUNT; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+                                            : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT |
+                                 VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.bindingCount = BINDING_COUNT;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(dev, &layoutInfo, hostAllocator("ClusteredLighting"), &descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create lighting descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSizes[2]{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSizes[0].descriptorCount = framesInFlight;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[1].descriptorCount = framesInFlight * (BINDING_COUNT - 1);
+
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = framesInFlight;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(dev, &poolInfo, hostAllocator("ClusteredLighting"), &descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create lighting descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(framesInFlight, descriptorSetLayout);
+    descriptorSets.resize(framesInFlight);
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = framesInFlight;
+    allocInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(dev, &allocInfo, descriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate lighting descriptor sets!");
+    }
+
+    for (uint32_t i = 0; i < framesInFlight; i++) {
+        VkDescriptorBufferInfo infos[BINDING_COUNT] = {
+            { frameBuffers[i],    0, VK_WHOLE_SIZE },
+            { lightBuffers[i],    0, VK_WHOLE_SIZE },
+            { clusterCountBuffer, 0, VK_WHOLE_SIZE },
+            { clusterLightBuffer, 0, VK_WHOLE_SIZE },
+        };
+
+        VkWriteDescriptorSet writes[BINDING_COUNT]{};
+        for (uint32_t b = 0; b < BINDING_COUNT; b++) {
+            writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet = descriptorSets[i];
+            writes[b].dstBinding = b;
+            writes[b].descriptorCount = 1;
+            writes[b].descriptorType = bindings[b].descriptorType;
+            writes[b].pBufferInfo = &infos[b];
+        }
+        vkUpdateDescriptorSets(dev, BINDING_COUNT, writes, 0, nullptr);
+    }
+}
+
+//-------------------------------------------------------------------------
+// Per frame
+//-------------------------------------------------------------------------
+
+void ClusteredLighting::update(uint32_t frame, const Camera& camera, VkExtent2D extent, float time) {
+    // Lights drift on small horizontal circles around their anchor.
+    GpuLight* lights = static_cast<GpuLight*>(lightMapped[frame]);
+    for (uint32_t i = 0; i < lightCount; i++) {
+        const LightMotion& m = motions[i];
+        float angle = m.phase + m.orbitSpeed * time;
+
+        GpuLight light = baseLights[i];
+        light.positionRadius[0] = m.center[0] + std::cos(angle) * m.orbitRadius;
+        light.positionRadius[1] = m.center[1];
+        light.positionRadius[2] = m.center[2] + std::sin(angle) * m.orbitRadius;
+        lights[i] = light;
+    }
+
+    float zNear = camera.nearPlane();
+    float zFar = camera.farPlane();
+    float logRatio = std::log(zFar / zNear);
+    float tanHalfY = std::tan(camera.fovY() * 0.5f);
+
+    FrameUniforms u{};
+    Mat4 viewProj = camera.viewProjection();
+    std::memcpy(u.viewProj, viewProj.m, sizeof(u.viewProj));
+    std::memcpy(u.view, camera.view().m, sizeof(u.view));
+    u.cameraPosition[0] = camera.position().x;
+    u.cameraPosition[1] = camera.position().y;
+    u.cameraPosition[2] = camera.position().z;
+    u.projParams[0] = tanHalfY * camera.aspect();
+    u.projParams[1] = tanHalfY;
+    u.projParams[2] = zNear;
+    u.projParams[3] = zFar;
+    // slice = log(depth) * scale + bias  <=>  depth = near * (far/near)^(slice / CLUSTER_Z)
+    u.clusterParams[0] = float(CLUSTER_Z) / logRatio;
+    u.clusterParams[1] = -float(CLUSTER_Z) * std::log(zNear) / logRatio;
+    u.clusterParams[2] = std::ceil(float(extent.width) / float(CLUSTER_X));
+    u.clusterParams[3] = std::ceil(float(extent.height) / float(CLUSTER_Y));
+    u.screenSize[0] = float(extent.width);
+    u.screenSize[1] = float(extent.height);
+    u.clusterGrid[0] = CLUSTER_X;
+    u.clusterGrid[1] = CLUSTER_Y;
+    u.clusterGrid[2] = CLUSTER_Z;
+    u.clusterGrid[3] = lightCount;
+
+    std::memcpy(frameMapped[frame], &u, sizeof(u));
+}
+
+void ClusteredLighting::recordCulling(VkCommandBuffer commandBuffer, uint32_t frame) {
+    // The previous frame's fragment shaders may still be reading the cluster lists
+    // on this queue (write-after-read: an execution dependency is enough).
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+    cullPipeline.bind(commandBuffer);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline.layout(),
+        0, 1, &descriptorSets[frame], 0, nullptr);
+    vkCmdDispatch(commandBuffer, CLUSTER_X, CLUSTER_Y, CLUSTER_Z);   // one workgroup per cluster
+
+    VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void ClusteredLighting::bind(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frame) {
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+        0, 1, &descriptorSets[frame], 0, nullptr);
+}
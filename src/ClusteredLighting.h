@@ -0,0 +1,91 @@
+// src/ClusteredLighting.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+#include "ComputePipeline.h"
+
+class Device;
+class Camera;
+
+// Clustered forward lighting.
+//
+// The view frustum is split into a CLUSTER_X x CLUSTER_Y x CLUSTER_Z grid (screen
+// tiles x exponential depth slices). Each frame a compute pass tests every light's
+// bounding sphere against every cluster and writes a fixed-size light list per
+// cluster. The forward fragment shader (lit.frag) finds its cluster from
+// gl_FragCoord and view depth and loops over that list only, so per-pixel cost is
+// bounded by MAX_LIGHTS_PER_CLUSTER regardless of the scene's light count.
+//
+// All of it runs on the graphics queue inside the frame's command buffer, before
+// the render pass begins.
+class ClusteredLighting {
+public:
+    static constexpr uint32_t CLUSTER_X = 16;
+    static constexpr uint32_t CLUSTER_Y = 9;
+    static constexpr uint32_t CLUSTER_Z = 24;
+    static constexpr uint32_t CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+    static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 128;   // must match the shaders
+
+    void init(Device& device, uint32_t lightCount, uint32_t framesInFlight);
+    void cleanup();
+
+    // Layout of the set lit.vert/lit.frag bind as set 0.
+    VkDescriptorSetLayout setLayout() const { return descriptorSetLayout; }
+
+    // Animates the lights and writes this frame slot's uniforms. Call after the
+    // slot's fence has been waited on.
+    void update(uint32_t frame, const Camera& camera, VkExtent2D extent, float time);
+
+    // Records light binning. Call outside a render pass, before the lit draws.
+    void recordCulling(VkCommandBuffer commandBuffer, uint32_t frame);
+
+    // Binds this frame slot's set for a graphics pipeline created with setLayout().
+    void bind(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frame);
+
+private:
+    // Must match `struct Light` in the shaders.
+    struct GpuLight {
+        float positionRadius[4];
+        float colorIntensity[4];
+    };
+
+    // Per-light animation parameters, CPU only.
+    struct LightMotion {
+        float center[3];
+        float orbitRadius;
+        float orbitSpeed;
+        float phase;
+    };
+
+    void createBuffers(uint32_t framesInFlight);
+    void createDescriptors(uint32_t framesInFlight);
+    void createLights();
+
+    Device*  device = nullptr;
+    uint32_t lightCount = 0;
+
+    std::vector<LightMotion> motions;
+    std::vector<GpuLight>    baseLights;   // radius and color; positions are animated
+
+    // Per frame in flight: host-visible uniforms and light positions.
+    std::vector<VkBuffer>       frameBuffers;
+    std::vector<VkDeviceMemory> frameMemory;
+    std::vector<void*>          frameMapped;
+    std::vector<VkBuffer>       lightBuffers;
+    std::vector<VkDeviceMemory> lightMemory;
+    std::vector<void*>          lightMapped;
+
+    // Binning results, rewritten every frame.
+    VkBuffer       clusterCountBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory clusterCountMemory = VK_NULL_HANDLE;
+    VkBuffer       clusterLightBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory clusterLightMemory = VK_NULL_HANDLE;
+
+    VkDescriptorSetLayout        descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool             descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> descriptorSets;
+
+    ComputePipeline cullPipeline;
+};
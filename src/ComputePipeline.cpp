@@ -0,0 +1,64 @@
+// src/ComputePipeline.cpp
+#include "ComputePipeline.h"
+#include "HostMemoryTracker.h"
+#include "Device.h"
+#include "ShaderCache.h"
+
+#include <stdexcept>
+
+void ComputePipeline::init(Device& dev, const std::string& spvPath,
+                           const std::vector<VkDescriptorSetLayout>& setLayouts,
+                           uint32_t pushConstantSize)
+{
+    device = &dev;
+
+    const std::vector<char>& code = ShaderCache::global().load(spvPath);
+
+    VkShaderModuleCreateInfo moduleInfo{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    moduleInfo.codeSize = code.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(device->device(), &moduleInfo, hostAllocator("ComputePipeline"), &shaderModule) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create shader module!");
+    }
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = pushConstantSize;
+
+    VkPipelineLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    layoutInfo.pSetLayouts = setLayouts.data();
+    layoutInfo.pushConstantRangeCount = pushConstantSize > 0 ? 1 : 0;
+    layoutInfo.pPushConstantRanges = pushConstantSize > 0 ? &pushConstantRange : nullptr;
+
+    if (vkCreatePipelineLayout(device->device(), &layoutInfo, hostAllocator("ComputePipeline"), &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create compute pipeline layout!");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = pipelineLayout;
+
+    if (vkCreateComputePipelines(device->device(), VK_NULL_HANDLE, 1, &pipelineInfo, hostAllocator("ComputePipeline"), &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create compute pipeline!");
+    }
+
+    vkDestroyShaderModule(device->device(), shaderModule, hostAllocator("ComputePipeline"));
+}
+
+void ComputePipeline::cleanup() {
+    vkDestroyPipeline(device->device(), pipeline, hostAllocator("ComputePipeline"));
+    vkDestroyPipelineLayout(device->device(), pipelineLayout, hostAllocator("ComputePipeline"));
+    pipeline = VK_NULL_HANDLE;
+    pipelineLayout = VK_NULL_HANDLE;
+}
+
+void ComputePipeline::bind(VkCommandBuffer commandBuffer) {
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+}
@@ -0,0 +1,33 @@
+// src/ComputePipeline.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+
+class Device;
+
+/// A compute shader plus its pipeline layout.
+class ComputePipeline {
+public:
+    /// Loads `spvPath` and builds the pipeline.
+    ///  - setLayouts are bound in order as sets 0..n-1
+    ///  - pushConstantSize bytes are visible to the compute stage (0 = none)
+    void init(Device& dev, const std::string& spvPath,
+              const std::vector<VkDescriptorSetLayout>& setLayouts,
+              uint32_t pushConstantSize = 0);
+
+    /// Destroy the pipeline object and its layout (in that order).
+    void cleanup();
+
+    void bind(VkCommandBuffer commandBuffer);
+
+    VkPipeline       get()    const { return pipeline; }
+    VkPipelineLayout layout() const { return pipelineLayout; }
+
+private:
+    Device* device = nullptr;
+
+    VkPipeline       pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+};
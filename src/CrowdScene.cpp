@@ -0,0 +1,343 @@
+// src/CrowdScene.cpp
+#include "CrowdScene.h"
+#include "HostMemoryTracker.h"
+#include "Device.h"
+#include "Camera.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+namespace {
+    const float CHARACTER_SPACING = 5.0f;   // grid cell per character
+    const float MIN_RADIUS = 1.5f;
+    const float MAX_RADIUS = 2.2f;
+    const float WALK_SPEED = 1.3f;          // units per second at the walk clip's cadence
+    const float RUN_SPEED = 3.4f;
+    const float SPEED_CHANGE_RATE = 0.3f;   // radians per second of the walk/run oscillation
+    // Characters posed per job; large enough that dispatch cost stays in the noise.
+    const uint32_t CHARACTERS_PER_JOB = 16;
+
+    struct PushConstants {
+        float viewProj[16];
+        float lightDir[4];
+    };
+    static_assert(sizeof(PushConstants) == CrowdScene::pushConstantSize, "crowd push constant size mismatch");
+
+    // Bindings 0..3 in skinned.vert.
+    struct SkinnedVertex {
+        float   position[3];
+        float   normal[3];
+        uint8_t joints[4];
+        uint8_t weights[4];   // unorm, sums to 255
+    };
+
+    // One box per joint, in bind-pose model space; right-side boxes mirror the left ones.
+    struct BodyPart {
+        uint32_t joint;
+        Vec3     min, max;
+    };
+    const BodyPart BODY_PARTS[] = {
+        { WalkerPelvis,    { -0.16f, 0.85f, -0.1f },   { 0.16f, 1.07f, 0.1f } },
+        { WalkerSpine,     { -0.15f, 1.07f, -0.09f },  { 0.15f, 1.32f, 0.09f } },
+        { WalkerChest,     { -0.19f, 1.32f, -0.11f },  { 0.19f, 1.56f, 0.11f } },
+        { WalkerHead,      { -0.1f,  1.62f, -0.11f },  { 0.1f,  1.85f, 0.11f } },
+        { WalkerUpperArmL, { 0.15f,  1.24f, -0.05f },  { 0.25f, 1.52f, 0.05f } },
+        { WalkerLowerArmL, { 0.16f,  0.98f, -0.045f }, { 0.24f, 1.24f, 0.045f } },
+        { WalkerHandL,     { 0.17f,  0.86f, -0.04f },  { 0.23f, 0.98f, 0.04f } },
+        { WalkerThighL,    { 0.03f,  0.47f, -0.07f },  { 0.17f, 0.9f,  0.07f } },
+        { WalkerShinL,     { 0.05f,  0.05f, -0.06f },  { 0.15f, 0.47f, 0.06f } },
+        { WalkerFootL,     { 0.05f,  0.0f,  -0.06f },  { 0.15f, 0.08f, 0.18f } },
+    };
+
+    uint32_t mirrorJoint(uint32_t joint) {
+        switch (joint) {
+        case WalkerUpperArmL: return WalkerUpperArmR;
+        case WalkerLowerArmL: return WalkerLowerArmR;
+        case WalkerHandL:     return WalkerHandR;
+        case WalkerThighL:    return WalkerThighR;
+        case WalkerShinL:     return WalkerShinR;
+        case WalkerFootL:     return WalkerFootR;
+        default:              return joint;
+        }
+    }
+
+    // Appends a box bound to `joint`. The face nearest the joint is shared half
+    // and half with the parent, so elbows, knees and the spine bend smoothly.
+    void appendBox(uint32_t joint, int32_t parent, float jointY, const Vec3& lo, const Vec3& hi,
+                   std::vector<SkinnedVertex>& vertices, std::vector<uint32_t>& indices) {
+        // Outward normal, then the four corners counter-clockwise seen from outside.
+        struct Face { Vec3 normal; Vec3 corners[4]; };
+        const Face faces[6] = {
+            { { 1, 0, 0 },  { { hi.x, lo.y, hi.z }, { hi.x, lo.y, lo.z }, { hi.x, hi.y, lo.z }, { hi.x, hi.y, hi.z } } },
+            { { -1, 0, 0 }, { { lo.x, lo.y, lo.z }, { lo.x, lo.y, hi.z }, { lo.x, hi.y, hi.z }, { lo.x, hi.y, lo.z } } },
+            { { 0, 1, 0 },  { { lo.x, hi.y, hi.z }, { hi.x, hi.y, hi.z }, { hi.x, hi.y, lo.z }, { lo.x, hi.y, lo.z } } },
+            { { 0, -1, 0 }, { { lo.x, lo.y, lo.z }, { hi.x, lo.y, lo.z }, { hi.x, lo.y, hi.z }, { lo.x, lo.y, hi.z } } },
+            { { 0, 0, 1 },  { { lo.x, lo.y, hi.z }, { hi.x, lo.y, hi.z }, { hi.x, hi.y, hi.z }, { lo.x, hi.y, hi.z } } },
+            { { 0, 0, -1 }, { { hi.x, lo.y, lo.z }, { lo.x, lo.y, lo.z }, { lo.x, hi.y, lo.z }, { hi.x, hi.y, lo.z } } },
+        };
+        float sharedY = std::fabs(lo.y - jointY) < std::fabs(hi.y - jointY) ? lo.y : hi.y;
+
+        for (const Face& face : faces) {
+            uint32_t base = uint32_t(vertices.size());
+            for (const Vec3& corner : face.corners) {
+                SkinnedVertex v{};
+                v.position[0] = corner.x; v.position[1] = corner.y; v.position[2] = corner.z;
+                v.normal[0] = face.normal.x; v.normal[1] = face.normal.y; v.normal[2] = face.normal.z;
+                v.joints[0] = uint8_t(joint);
+                v.weights[0] = 255;
+                if (parent >= 0 && corner.y == sharedY) {
+                    v.joints[1] = uint8_t(parent);
+                    v.weights[0] = 128;
+                    v.weights[1] = 127;
+                }
+                vertices.push_back(v);
+            }
+            // Clockwise seen from outside (the pipelines' front face).
+            const uint32_t quad[6] = { 0, 2, 1, 0, 3, 2 };
+            for (uint32_t i : quad) indices.push_back(base + i);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------
+// Init & cleanup
+//-------------------------------------------------------------------------
+
+void CrowdScene::init(Device& dev, JobSystem& jobs_, uint32_t characterCount, uint32_t framesInFlight) {
+    device = &dev;
+    jobs = &jobs_;
+
+    skeleton = createWalkerSkeleton();
+    walkClip = createWalkerClip(false);
+    runClip = createWalkerClip(true);
+
+    uint32_t blocks = jointBlockCount(skeleton.jointCount());
+    scratch.resize(jobs->threadCount());
+    for (Scratch& s : scratch) {
+        s.walkPose.resize(blocks);
+        s.runPose.resize(blocks);
+        s.model.resize(skeleton.jointCount());
+    }
+
+    createGeometry();
+    createCharacters(characterCount);
+    createDescriptors(framesInFlight);
+}
+
+void CrowdScene::cleanup() {
+    VkDevice dev = device->device();
+
+    vkDestroyDescriptorPool(dev, descriptorPool, hostAllocator("CrowdScene"));
+    vkDestroyDescriptorSetLayout(dev, descriptorSetLayout, hostAllocator("CrowdScene"));
+
+    for (size_t i = 0; i < paletteBuffers.size(); i++) {
+        vkUnmapMemory(dev, paletteMemory[i]);
+        vkDestroyBuffer(dev, paletteBuffers[i], hostAllocator("CrowdScene"));
+        device->freeMemory(paletteMemory[i]);
+    }
+    paletteBuffers.clear();
+
+    vkDestroyBuffer(dev, indexBuffer, hostAllocator("CrowdScene"));
+    device->freeMemory(indexMemory);
+    vkDestroyBuffer(dev, vertexBuffer, hostAllocator("CrowdScene"));
+    device->freeMemory(vertexMemory);
+}
+
+void CrowdScene::createGeometry() {
+    std::vector<Vec3> joints = walkerBindPositions();
+    std::vector<SkinnedVertex> vertices;
+    std::vector<uint32_t> indices;
+
+    for (const BodyPart& part : BODY_PARTS) {
+        appendBox(part.joint, skeleton.parents[part.joint], joints[part.joint].y, part.min, part.max,
+            vertices, indices);
+        uint32_t mirrored = mirrorJoint(part.joint);
+        if (mirrored != part.joint) {
+            appendBox(mirrored, skeleton.parents[mirrored], joints[mirrored].y,
+                Vec3{ -part.max.x, part.min.y, part.min.z }, Vec3{ -part.min.x, part.max.y, part.max.z },
+                vertices, indices);
+        }
+    }
+    indexCount = uint32_t(indices.size());
+
+    device->createDeviceLocalBuffer(vertices.data(), vertices.size() * sizeof(SkinnedVertex),
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexMemory, GpuMemoryCategory::Mesh);
+    device->createDeviceLocalBuffer(indices.data(), indices.size() * sizeof(uint32_t),
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexMemory, GpuMemoryCategory::Mesh);
+}
+
+void CrowdScene::createCharacters(uint32_t characterCount) {
+    std::mt19937 rng(31);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    uint32_t side = uint32_t(std::ceil(std::sqrt(float(characterCount))));
+    float half = float(side - 1) * 0.5f;
+    characters.resize(characterCount);
+    for (uint32_t i = 0; i < characterCount; i++) {
+        Character& c = characters[i];
+        c.homeX = (float(i % side) - half) * CHARACTER_SPACING;
+        c.homeZ = (float(i / side) - half) * CHARACTER_SPACING;
+        c.radius = MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS) * unit(rng);
+        c.direction = unit(rng) < 0.5f ? -1.0f : 1.0f;
+        c.startAngle = unit(rng) * 6.2831853f;
+        c.startPhase = unit(rng);
+        c.speedOffset = unit(rng) * 6.2831853f;
+    }
+}
+
+void CrowdScene::createDescriptors(uint32_t framesInFlight) {
+    VkDevice dev = device->device();
+    VkDeviceSize paletteBytes = std::max<size_t>(characters.size(), 1) * skeleton.jointCount() * sizeof(Mat4);
+
+    paletteBuffers.resize(framesInFlight);
+    paletteMemory.resize(framesInFlight);
+    paletteMapped.resize(framesInFlight);
+    for (uint32_t i = 0; i < framesInFlight; i++) {
+        device->createBuffer(paletteBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            paletteBuffers[i], paletteMemory[i]);
+        vkMapMemory(dev, paletteMemory[i], 0, VK_WHOLE_SIZE, 0, &paletteMapped[i]);
+    }
+
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+    if (vkCreateDescriptorSetLayout(dev, &layoutInfo, hostAllocator("CrowdScene"), &descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create crowd descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, framesInFlight };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = framesInFlight;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(dev, &poolInfo, hostAllocator("CrowdScene"), &descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create crowd descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(framesInFlight, descriptorSetLayout);
+    descriptorSets.resize(framesInFlight);
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = framesInFlight;
+    allocInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(dev, &allocInfo, descriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate crowd descriptor sets!");
+    }
+
+    for (uint32_t i = 0; i < framesInFlight; i++) {
+        VkDescriptorBufferInfo info{ paletteBuffers[i], 0, VK_WHOLE_SIZE };
+        VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.dstSet = descriptorSets[i];
+        write.dstBinding = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &info;
+        vkUpdateDescriptorSets(dev, 1, &write, 0, nullptr);
+    }
+}
+
+std::vector<VkVertexInputBindingDescription> CrowdScene::vertexBindings() {
+    return { { 0, sizeof(SkinnedVertex), VK_VERTEX_INPUT_RATE_VERTEX } };
+}
+
+std::vector<VkVertexInputAttributeDescription> CrowdScene::vertexAttributes() {
+    return {
+        { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(SkinnedVertex, position) },
+        { 1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(SkinnedVertex, normal) },
+        { 2, 0, VK_FORMAT_R8G8B8A8_UINT,    offsetof(SkinnedVertex, joints) },
+        { 3, 0, VK_FORMAT_R8G8B8A8_UNORM,   offsetof(SkinnedVertex, weights) },
+    };
+}
+
+uint32_t CrowdScene::animationThreads() const {
+    return jobs->threadCount();
+}
+
+//-------------------------------------------------------------------------
+// Per frame
+//-------------------------------------------------------------------------
+
+void CrowdScene::update(uint32_t frame, float time) {
+    auto start = std::chrono::steady_clock::now();
+
+    Mat4* palettes = static_cast<Mat4*>(paletteMapped[frame]);
+    uint32_t joints = skeleton.jointCount();
+    jobs->parallelFor(uint32_t(characters.size()), CHARACTERS_PER_JOB,
+        [&](uint32_t begin, uint32_t end, uint32_t thread) {
+            Scratch& s = scratch[thread];
+            for (uint32_t i = begin; i < end; i++) {
+                animate(characters[i], time, s, palettes + size_t(i) * joints);
+            }
+        });
+
+    lastAnimationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void CrowdScene::animate(const Character& c, float time, Scratch& s, Mat4* palette) const {
+    // Run weight w(t) = (1 + sin(kt + offset)) / 2. Cadence and speed are linear in
+    // w, so gait phase and distance travelled integrate in closed form.
+    float k = SPEED_CHANGE_RATE;
+    float angle = k * time + c.speedOffset;
+    float runWeight = 0.5f + 0.5f * std::sin(angle);
+    float runTime = 0.5f * time + 0.5f * (std::cos(c.speedOffset) - std::cos(angle)) / k;   // integral of w
+
+    float walkRate = 1.0f / walkClip.duration();   // cycles per second
+    float runRate = 1.0f / runClip.duration();
+    float phase = c.startPhase + walkRate * time + (runRate - walkRate) * runTime;
+    phase -= std::floor(phase);
+    float distance = WALK_SPEED * time + (RUN_SPEED - WALK_SPEED) * runTime;
+
+    // Both clips start on the same foot, so sampling them at one normalized phase keeps the feet in step.
+    walkClip.sample(phase * walkClip.duration(), s.walkPose.data());
+    runClip.sample(phase * runClip.duration(), s.runPose.data());
+    blendPoses(s.walkPose.data(), s.runPose.data(), runWeight, s.walkPose.data(), uint32_t(s.walkPose.size()));
+
+    // Around the circle, facing along it.
+    float around = c.startAngle + c.direction * distance / c.radius;
+    float ca = std::cos(around), sa = std::sin(around);
+    Vec3 position{ c.homeX + c.radius * ca, 0.0f, c.homeZ + c.radius * sa };
+    float heading = std::atan2(-sa * c.direction, ca * c.direction);
+    Mat4 world = Mat4::fromTRS(position, Quat::fromAxisAngle(Vec3{ 0.0f, 1.0f, 0.0f }, heading),
+        Vec3{ 1.0f, 1.0f, 1.0f });
+
+    computeSkinningPalette(skeleton, s.walkPose.data(), world, s.model.data(), palette);
+}
+
+uint32_t CrowdScene::recordDraws(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frame,
+                                 const Camera& camera)
+{
+    if (characters.empty()) return 0;
+
+    PushConstants push{};
+    Mat4 viewProj = camera.viewProjection();
+    std::memcpy(push.viewProj, viewProj.m, sizeof(push.viewProj));
+    Vec3 light = lightDirection();
+    push.lightDir[0] = light.x;
+    push.lightDir[1] = light.y;
+    push.lightDir[2] = light.z;
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+        0, 1, &descriptorSets[frame], 0, nullptr);
+    vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        0, sizeof(push), &push);
+
+    // The whole crowd in one instanced draw; skinned.vert finds each palette by gl_InstanceIndex.
+    vkCmdDrawIndexed(commandBuffer, indexCount, uint32_t(characters.size()), 0, 0, 0);
+    return 1;
+}
@@ -0,0 +1,97 @@
+// src/CrowdScene.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+#include "Animation.h"
+
+class Device;
+class Camera;
+class JobSystem;
+
+// Crowd of skinned characters walking circles, each blending a walk and a run
+// cycle by its current speed.
+//
+// Every frame update() poses the characters on the JobSystem: per character,
+// both compressed clips are sampled at the same normalized phase, blended, and
+// turned into a joint palette that is written straight into this frame slot's
+// mapped storage buffer. Nothing is kept between frames (speed, phase and
+// position are closed-form functions of time), so the work splits freely across
+// threads and the scene is deterministic for benchmarks. skinned.vert reads the
+// palettes and the whole crowd is one instanced draw.
+class CrowdScene {
+public:
+    void init(Device& device, JobSystem& jobs, uint32_t characterCount, uint32_t framesInFlight);
+    void cleanup();
+
+    VkDescriptorSetLayout setLayout() const { return descriptorSetLayout; }
+    static std::vector<VkVertexInputBindingDescription>   vertexBindings();
+    static std::vector<VkVertexInputAttributeDescription> vertexAttributes();
+
+    // Bytes of push constants skinned.vert/skinned.frag expect.
+    static constexpr uint32_t pushConstantSize = 80;
+    // Direction towards the scene's sun.
+    static Vec3 lightDirection() { return Vec3{ 0.4f, 0.8f, 0.45f }; }
+
+    // Poses every character and fills this frame slot's palette buffer.
+    void update(uint32_t frame, float time);
+
+    // Returns the number of draw calls recorded.
+    uint32_t recordDraws(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frame, const Camera& camera);
+
+    size_t   characterCount() const { return characters.size(); }
+    uint32_t jointCount() const { return skeleton.jointCount(); }
+    // Wall-clock CPU time of the last update()'s animation work, across all threads.
+    double   animationMs() const { return lastAnimationMs; }
+    uint32_t animationThreads() const;
+
+private:
+    // Seed parameters of one character.
+    struct Character {
+        float homeX, homeZ;    // centre of its circle
+        float radius;
+        float direction;       // +1 counter-clockwise, -1 clockwise
+        float startAngle;
+        float startPhase;      // gait cycles
+        float speedOffset;     // phase of its walk/run oscillation
+    };
+
+    // Per JobSystem thread, reused every frame.
+    struct Scratch {
+        std::vector<JointBlock> walkPose;
+        std::vector<JointBlock> runPose;
+        std::vector<Mat4>       model;
+    };
+
+    void createGeometry();
+    void createCharacters(uint32_t characterCount);
+    void createDescriptors(uint32_t framesInFlight);
+    void animate(const Character& character, float time, Scratch& scratch, Mat4* palette) const;
+
+    Device*    device = nullptr;
+    JobSystem* jobs = nullptr;
+
+    Skeleton      skeleton;
+    AnimationClip walkClip;
+    AnimationClip runClip;
+    std::vector<Character> characters;
+    std::vector<Scratch>   scratch;
+    double lastAnimationMs = 0.0;
+
+    VkBuffer       vertexBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory vertexMemory = VK_NULL_HANDLE;
+    VkBuffer       indexBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory indexMemory = VK_NULL_HANDLE;
+    uint32_t       indexCount = 0;
+
+    // Per frame in flight: host-visible joint palettes, jointCount() matrices per character.
+    std::vector<VkBuffer>       paletteBuffers;
+    std::vector<VkDeviceMemory> paletteMemory;
+    std::vector<void*>          paletteMapped;
+
+    VkDescriptorSetLayout        descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool             descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> descriptorSets;
+};
@@ -1,21 +1,20 @@
 // src/DebugUtils.cpp
 #include "DebugUtils.h"
+#include "HostMemoryTracker.h"
+#include "Logger.h"
 #include <cstring>
-#include <iostream>
 #include <stdexcept>
 #include <vector>
 
-DebugUtils::DebugUtils() {
-#ifdef NDEBUG
-    enableValidation = false;
-#endif
-}
+DebugUtils::DebugUtils() = default;
 
 DebugUtils::~DebugUtils() = default;
 
-void DebugUtils::setupValidationLayers() {
-    if (enableValidation && !checkValidationLayerSupport()) {
-        throw std::runtime_error("validation layers requested, but not available!");
+void DebugUtils::setupValidationLayers(bool requested) {
+    enableValidation = requested && checkValidationLayerSupport();
+    if (requested && !enableValidation) {
+        Logger::global().logf(LogSeverity::Warning, "engine",
+            "validation layers requested, but not available; running without them");
     }
 }
 
@@ -25,14 +24,14 @@ void DebugUtils::setupDebugMessenger(VkInstance instance) {
     VkDebugUtilsMessengerCreateInfoEXT createInfo{};
     populateDebugMessengerCreateInfo(createInfo);
 
-    if (CreateDebugUtilsMessengerEXT(instance, &createInfo, nullptr, &debugMessenger) != VK_SUCCESS) {
+    if (CreateDebugUtilsMessengerEXT(instance, &createInfo, hostAllocator("DebugUtils"), &debugMessenger) != VK_SUCCESS) {
         throw std::runtime_error("failed to set up debug messenger!");
     }
 }
 
 void DebugUtils::cleanup(VkInstance instance) {
     if (enableValidation) {
-        DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
+        DestroyDebugUtilsMessengerEXT(instance, debugMessenger, hostAllocator("DebugUtils"));
     }
 }
 
@@ -61,6 +60,7 @@ void DebugUtils::populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInf
     ci.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
     ci.messageSeverity =
         VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT
+        | VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT
         | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT
         | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
     ci.messageType =
@@ -102,6 +102,16 @@ VKAPI_ATTR VkBool32 VKAPI_CALL DebugUtils::debugCallback(
     const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
     void* pUserData)
 {
-    std::cerr << "validation layer: " << pCallbackData->pMessage << std::endl;
+    LogSeverity severity = LogSeverity::Verbose;
+    if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) severity = LogSeverity::Error;
+    else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) severity = LogSeverity::Warning;
+    else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) severity = LogSeverity::Info;
+
+    Logger& logger = Logger::global();
+    if (logger.enabled(severity)) {
+        // The layer's message ID number groups repeats of the same check.
+        logger.log(severity, "validation", static_cast<uint32_t>(pCallbackData->messageIdNumber),
+                   pCallbackData->pMessage);
+    }
     return VK_FALSE;
 }
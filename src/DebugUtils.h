@@ -9,8 +9,10 @@ public:
     DebugUtils();
     ~DebugUtils();
 
-    // Call before vkCreateInstance to validate layer support.
-    void setupValidationLayers();
+    // Call before vkCreateInstance. Enables the validation layers when `requested`
+    // and installed; a missing layer only logs a warning.
+    void setupValidationLayers(bool requested);
+    bool validationEnabled() const { return enableValidation; }
 
     // After VkInstance is created, set up the debug messenger.
     void setupDebugMessenger(VkInstance instance);
@@ -38,7 +40,8 @@ private:
         VkDebugUtilsMessengerEXT debugMessenger,
         const VkAllocationCallbacks* pAllocator);
 
-    // Callback invoked by the validation layers.
+    // Callback invoked by the validation layers. Only queues the message on
+    // Logger::global(); the console I/O happens on the logger's thread.
     static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
         VkDebugUtilsMessageSeverityFlagBitsEXT      messageSeverity,
         VkDebugUtilsMessageTypeFlagsEXT             messageType,
@@ -48,6 +51,6 @@ private:
     const std::vector<const char*> validationLayers = {
         "VK_LAYER_KHRONOS_validation"
     };
-    bool enableValidation = true;
+    bool enableValidation = false;
     VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
 };
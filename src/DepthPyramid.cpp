@@ -0,0 +1,271 @@
+// src/DepthPyramid.cpp
+#include "DepthPyramid.h"
+#include "HostMemoryTracker.h"
+#include "Device.h"
+#include "SwapChain.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    const uint32_t MAX_LEVELS = 16;        // a 32768-pixel level 0
+    const uint32_t GROUP_SIZE = 8;         // local_size_x/y in hiz_reduce.comp
+
+    struct ReducePushConstants {
+        int32_t sourceSize[2];
+        int32_t destinationSize[2];
+    };
+
+    uint32_t previousPowerOfTwo(uint32_t v) {
+        uint32_t p = 1;
+        while (p * 2 <= v) p *= 2;
+        return p;
+    }
+
+    VkImageAspectFlags depthAspectMask(VkFormat format) {
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+        if (format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT) {
+            aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+        return aspect;
+    }
+
+    VkImageMemoryBarrier imageBarrier(VkImage image, VkImageAspectFlags aspect,
+        VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess)
+    {
+        VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = { aspect, 0, VK_REMAINING_MIP_LEVELS, 0, 1 };
+        return barrier;
+    }
+}
+
+bool DepthPyramid::supported(Device& device, VkFormat depthFormat) {
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(device.physicalDevice(), depthFormat, &props);
+    return (props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+}
+
+//-------------------------------------------------------------------------
+// Init & cleanup
+//-------------------------------------------------------------------------
+
+void DepthPyramid::init(Device& dev, SwapChain& swapChain) {
+    device = &dev;
+
+    VkSamplerCreateInfo samplerInfo{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = float(MAX_LEVELS);
+    if (vkCreateSampler(device->device(), &samplerInfo, hostAllocator("DepthPyramid"), &pointSampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create depth pyramid sampler!");
+    }
+
+    createDescriptors();
+    reducePipeline.init(*device, "shaders_spv/hiz_reduce_comp.spv", { descriptorSetLayout },
+        sizeof(ReducePushConstants));
+    createPyramid(swapChain);
+}
+
+void DepthPyramid::cleanup() {
+    VkDevice dev = device->device();
+
+    destroyPyramid();
+    reducePipeline.cleanup();
+    vkDestroyDescriptorPool(dev, descriptorPool, hostAllocator("DepthPyramid"));
+    vkDestroyDescriptorSetLayout(dev, descriptorSetLayout, hostAllocator("DepthPyramid"));
+    vkDestroySampler(dev, pointSampler, hostAllocator("DepthPyramid"));
+}
+
+void DepthPyramid::resize(SwapChain& swapChain) {
+    destroyPyramid();
+    createPyramid(swapChain);
+}
+
+void DepthPyramid::createDescriptors() {
+    VkDevice dev = device->device();
+
+    VkDescriptorSetLayoutBinding bindings[2]{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(dev, &layoutInfo, hostAllocator("DepthPyramid"), &descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create depth pyramid descriptor set layout!");
+    }
+
+    // Sets are reallocated on every resize: the pool is reset rather than freed per set.
+    VkDescriptorPoolSize poolSizes[2] = {
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_LEVELS },
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, MAX_LEVELS },
+    };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = MAX_LEVELS;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(dev, &poolInfo, hostAllocator("DepthPyramid"), &descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create depth pyramid descriptor pool!");
+    }
+}
+
+void DepthPyramid::createPyramid(SwapChain& swapChain) {
+    VkDevice dev = device->device();
+
+    depthImage = swapChain.getDepthImage();
+    depthView = swapChain.getDepthImageView();
+    depthAspect = depthAspectMask(swapChain.getDepthFormat());
+    depthExtent = swapChain.getExtent();
+
+    pyramidWidth = previousPowerOfTwo(depthExtent.width);
+    pyramidHeight = previousPowerOfTwo(depthExtent.height);
+    levels = 1;
+    while (levels < MAX_LEVELS && ((pyramidWidth | pyramidHeight) >> levels) != 0) levels++;
+
+    device->createImage(pyramidWidth, pyramidHeight, VK_FORMAT_R32_SFLOAT, VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        pyramid, pyramidMemory, VK_SAMPLE_COUNT_1_BIT, GpuMemoryCategory::RenderTarget, levels);
+
+    VkImageViewCreateInfo viewInfo{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewInfo.image = pyramid;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R32_SFLOAT;
+    viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, levels, 0, 1 };
+    if (vkCreateImageView(dev, &viewInfo, hostAllocator("DepthPyramid"), &pyramidView) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create depth pyramid view!");
+    }
+
+    levelViews.resize(levels);
+    for (uint32_t level = 0; level < levels; level++) {
+        viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1 };
+        if (vkCreateImageView(dev, &viewInfo, hostAllocator("DepthPyramid"), &levelViews[level]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create depth pyramid level view!");
+        }
+    }
+
+    vkResetDescriptorPool(dev, descriptorPool, 0);
+    std::vector<VkDescriptorSetLayout> layouts(levels, descriptorSetLayout);
+    levelSets.resize(levels);
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = levels;
+    allocInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(dev, &allocInfo, levelSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate depth pyramid descriptor sets!");
+    }
+
+    for (uint32_t level = 0; level < levels; level++) {
+        VkDescriptorImageInfo source = level == 0
+            ? VkDescriptorImageInfo{ pointSampler, depthView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL }
+            : VkDescriptorImageInfo{ pointSampler, levelViews[level - 1], VK_IMAGE_LAYOUT_GENERAL };
+        VkDescriptorImageInfo destination{ VK_NULL_HANDLE, levelViews[level], VK_IMAGE_LAYOUT_GENERAL };
+
+        VkWriteDescriptorSet writes[2]{};
+        writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[0].dstSet = levelSets[level];
+        writes[0].dstBinding = 0;
+        writes[0].descriptorCount = 1;
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writes[0].pImageInfo = &source;
+        writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[1].dstSet = levelSets[level];
+        writes[1].dstBinding = 1;
+        writes[1].descriptorCount = 1;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[1].pImageInfo = &destination;
+        vkUpdateDescriptorSets(dev, 2, writes, 0, nullptr);
+    }
+
+    needsLayoutInit = true;
+    built = false;
+}
+
+void DepthPyramid::destroyPyramid() {
+    VkDevice dev = device->device();
+
+    for (VkImageView view : levelViews) {
+        vkDestroyImageView(dev, view, hostAllocator("DepthPyramid"));
+    }
+    levelViews.clear();
+    vkDestroyImageView(dev, pyramidView, hostAllocator("DepthPyramid"));
+    vkDestroyImage(dev, pyramid, hostAllocator("DepthPyramid"));
+    device->freeMemory(pyramidMemory);
+    pyramidView = VK_NULL_HANDLE;
+    pyramid = VK_NULL_HANDLE;
+    pyramidMemory = VK_NULL_HANDLE;
+}
+
+//-------------------------------------------------------------------------
+// Per frame
+//-------------------------------------------------------------------------
+
+void DepthPyramid::recordBuild(VkCommandBuffer commandBuffer, const Mat4& viewProjection) {
+    // The depth attachment becomes a texture; the pyramid may still be read by this
+    // frame's culling pass (write-after-read, covered by the COMPUTE source stage).
+    VkImageMemoryBarrier barriers[2] = {
+        imageBarrier(depthImage, depthAspect,
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT),
+        imageBarrier(pyramid, VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, 0, VK_ACCESS_SHADER_WRITE_BIT),
+    };
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, needsLayoutInit ? 2 : 1, barriers);
+    needsLayoutInit = false;
+
+    reducePipeline.bind(commandBuffer);
+
+    VkMemoryBarrier levelWritten{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    levelWritten.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    levelWritten.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    int32_t sourceWidth = int32_t(depthExtent.width);
+    int32_t sourceHeight = int32_t(depthExtent.height);
+    for (uint32_t level = 0; level < levels; level++) {
+        int32_t width = int32_t(std::max(pyramidWidth >> level, 1u));
+        int32_t height = int32_t(std::max(pyramidHeight >> level, 1u));
+
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, reducePipeline.layout(),
+            0, 1, &levelSets[level], 0, nullptr);
+        ReducePushConstants push{ { sourceWidth, sourceHeight }, { width, height } };
+        vkCmdPushConstants(commandBuffer, reducePipeline.layout(), VK_SHADER_STAGE_COMPUTE_BIT,
+            0, sizeof(push), &push);
+        vkCmdDispatch(commandBuffer, (uint32_t(width) + GROUP_SIZE - 1) / GROUP_SIZE,
+            (uint32_t(height) + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+
+        // The next level reads this one; after the last level, so does next frame's
+        // culling. The fragment test stages make the next clear of the depth
+        // attachment wait for level 0's reads of it.
+        bool last = level + 1 == levels;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            last ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                   VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+                 : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &levelWritten, 0, nullptr, 0, nullptr);
+
+        sourceWidth = width;
+        sourceHeight = height;
+    }
+
+    built = true;
+    builtViewProjection = viewProjection;
+}
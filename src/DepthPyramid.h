@@ -0,0 +1,77 @@
+// src/DepthPyramid.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+#include "ComputePipeline.h"
+#include "Math.h"
+
+class Device;
+class SwapChain;
+
+// Hierarchical-Z buffer for GPU occlusion culling.
+//
+// After the main pass, recordBuild() reduces the swapchain's depth attachment
+// into an R32F mip chain where every texel holds the farthest depth of the
+// pixels it covers (hiz_reduce.comp, one dispatch per level). Level 0 is the
+// largest power of two not above the framebuffer, so each higher level halves
+// exactly. Culling in the next frame tests an object's nearest depth against
+// the texels covering its screen rectangle, projected with viewProjection(),
+// the matrix that depth was rendered with.
+//
+// Needs SwapChain::setDepthSampled(true) and a single-sampled depth attachment.
+class DepthPyramid {
+public:
+    // False when `depthFormat` cannot be sampled (the pyramid cannot be built from it).
+    static bool supported(Device& device, VkFormat depthFormat);
+
+    void init(Device& device, SwapChain& swapChain);
+    void cleanup();
+    // Recreates the pyramid for the swapchain's new extent; the next frame culls nothing.
+    void resize(SwapChain& swapChain);
+
+    // Records the reduction after the render pass has ended. Leaves the pyramid
+    // readable by compute shaders and the depth attachment ready to be cleared.
+    void recordBuild(VkCommandBuffer commandBuffer, const Mat4& viewProjection);
+
+    // Whole chain, for texelFetch(pyramid, coord, level) in GENERAL layout.
+    VkImageView view() const { return pyramidView; }
+    VkSampler   sampler() const { return pointSampler; }
+    uint32_t    width() const { return pyramidWidth; }
+    uint32_t    height() const { return pyramidHeight; }
+    uint32_t    levelCount() const { return levels; }
+
+    // True once a build has been recorded since init()/resize(): until then the
+    // contents are undefined and must not be used to reject anything.
+    bool        valid() const { return built; }
+    const Mat4& viewProjection() const { return builtViewProjection; }
+
+private:
+    void createPyramid(SwapChain& swapChain);
+    void destroyPyramid();
+    void createDescriptors();
+
+    Device*   device = nullptr;
+    VkImage   depthImage = VK_NULL_HANDLE;
+    VkImageView depthView = VK_NULL_HANDLE;   // owned by the swapchain
+    VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    VkExtent2D depthExtent{};
+
+    VkImage        pyramid = VK_NULL_HANDLE;
+    VkDeviceMemory pyramidMemory = VK_NULL_HANDLE;
+    VkImageView    pyramidView = VK_NULL_HANDLE;
+    std::vector<VkImageView> levelViews;
+    uint32_t pyramidWidth = 0, pyramidHeight = 0, levels = 0;
+
+    VkSampler             pointSampler = VK_NULL_HANDLE;
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool      descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> levelSets;   // level i reads level i-1 (the depth attachment for 0)
+    ComputePipeline       reducePipeline;
+
+    bool needsLayoutInit = true;   // the new pyramid is still in UNDEFINED layout
+    bool built = false;
+    Mat4 builtViewProjection = Mat4::identity();
+};
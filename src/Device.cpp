@@ -1,39 +1,57 @@
 #include "Device.h"
+#include "HostMemoryTracker.h"
 #include "Utils.h" // for getRequiredExtensions
+#include "Logger.h"
 #include <stdexcept>
+#include <string>
 #include <vector>
 #include <set>
 #include <cstring>
+#include <algorithm>
+#include <functional>
 #include "SwapChain.h" // for SwapChainSupportDetails
 
 void Device::init(GLFWwindow* window, DebugUtils& debugUtils) {
     this->window = window;
+    enableValidation = debugUtils.validationEnabled();
 
-#ifdef NDEBUG
-    enableValidation = false;
-#endif
-    debugUtils.setupValidationLayers();
     createInstance("Modor Engine", debugUtils);
     debugUtils.setupDebugMessenger(_instance);
     createSurface();
     pickPhysicalDevice();
+    queryDynamicRenderingSupport();
     createLogicalDevice();
+    loadDeviceFunctions();
+    _memory.init(_physical, _capabilities.memoryBudget);
 }
 
 void Device::createSurface() {
-    if (glfwCreateWindowSurface(_instance, window, nullptr, &_surface) != VK_SUCCESS) {
+    if (isHeadless()) {
+        auto createHeadlessSurface = (PFN_vkCreateHeadlessSurfaceEXT)
+            vkGetInstanceProcAddr(_instance, "vkCreateHeadlessSurfaceEXT");
+        VkHeadlessSurfaceCreateInfoEXT info{ VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT };
+        if (!createHeadlessSurface || createHeadlessSurface(_instance, &info, hostAllocator("Device"), &_surface) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create headless surface!");
+        }
+        return;
+    }
+    if (glfwCreateWindowSurface(_instance, window, hostAllocator("Device"), &_surface) != VK_SUCCESS) {
         throw std::runtime_error("failed to create window surface!");
 
     }
 }
 
 void Device::cleanup() {
-    vkDestroyDevice(_device, nullptr);
+    if (size_t leaked = _memory.liveAllocations()) {
+        Logger::global().logf(LogSeverity::Warning, "memory", "%zu device memory allocations still live at shutdown; %s",
+            leaked, _memory.summary().c_str());
+    }
+    vkDestroyDevice(_device, hostAllocator("Device"));
     if (_surface != VK_NULL_HANDLE) {
-        vkDestroySurfaceKHR(_instance, _surface, nullptr);
+        vkDestroySurfaceKHR(_instance, _surface, hostAllocator("Device"));
         _surface = VK_NULL_HANDLE;
     }
-    vkDestroyInstance(_instance, nullptr);
+    vkDestroyInstance(_instance, hostAllocator("Device"));
 }
 
 VkInstance Device::instance() const { return _instance; }
@@ -42,21 +60,34 @@ VkDevice Device::device() const { return _device; }
 VkQueue Device::graphicsQueue() const { return _graphicsQ; }
 VkQueue Device::presentQueue() const { return _presentQ; }
 
+void Device::cmdBeginRendering(VkCommandBuffer cmd, const VkRenderingInfoKHR* info) const {
+    _vkCmdBeginRendering(cmd, info);
+}
 
+void Device::cmdEndRendering(VkCommandBuffer cmd) const {
+    _vkCmdEndRendering(cmd);
+}
 
-void Device::createInstance(const char* appName, DebugUtils& debugUtils) {
-    if (enableValidation && !checkValidationLayerSupport()) {
-        throw std::runtime_error("validation layers requested, but not available");
-    }
 
+
+void Device::createInstance(const char* appName, DebugUtils& debugUtils) {
     VkApplicationInfo appInfo{ VK_STRUCTURE_TYPE_APPLICATION_INFO };
     appInfo.pApplicationName = appName;
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName = "Modor Engine";
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    // Ask for the newest API we know about, but never more than the loader supports.
+    // vkEnumerateInstanceVersion only exists on 1.1+ loaders.
+    uint32_t loaderVersion = VK_API_VERSION_1_0;
+    auto enumerateInstanceVersion = (PFN_vkEnumerateInstanceVersion)
+        vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion");
+    if (enumerateInstanceVersion) {
+        enumerateInstanceVersion(&loaderVersion);
+    }
+    _apiVersion = std::min(loaderVersion, static_cast<uint32_t>(VK_API_VERSION_1_3));
+    appInfo.apiVersion = _apiVersion;
 
-    auto extensions = getRequiredExtensions(enableValidation);
+    auto extensions = getRequiredExtensions(enableValidation, isHeadless());
     VkInstanceCreateInfo createInfo{ VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
     createInfo.pApplicationInfo = &appInfo;
     createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
@@ -67,7 +98,7 @@ void Device::createInstance(const char* appName, DebugUtils& debugUtils) {
         createInfo.ppEnabledLayerNames = validationLayers.data();
     }
 
-    if (vkCreateInstance(&createInfo, nullptr, &_instance) != VK_SUCCESS) {
+    if (vkCreateInstance(&createInfo, hostAllocator("Device"), &_instance) != VK_SUCCESS) {
         throw std::runtime_error("failed to create Vulkan instance");
     }
 }
@@ -82,27 +113,80 @@ void Device::pickPhysicalDevice() {
     std::vector<VkPhysicalDevice> devices(count);
     vkEnumeratePhysicalDevices(_instance, &count, devices.data());
 
+    // Highest score among the devices that can drive our surface.
+    int64_t bestScore = -1;
     for (const auto& dev : devices) {
-        if (isDeviceSuitable(dev)) {
+        if (!isDeviceSuitable(dev)) continue;
+
+        DeviceCapabilities caps = queryDeviceCapabilities(dev, _apiVersion);
+        int64_t score = scoreDeviceCapabilities(caps);
+        Logger::global().logf(LogSeverity::Info, "engine", "GPU candidate %s, score %lld",
+            describeDevice(caps).c_str(), static_cast<long long>(score));
+        if (score > bestScore) {
+            bestScore = score;
             _physical = dev;
-            break;
+            _capabilities = std::move(caps);
         }
     }
 
     if (_physical == VK_NULL_HANDLE) {
         throw std::runtime_error("failed to find a suitable GPU");
     }
+    Logger::global().logf(LogSeverity::Info, "engine", "using %s; optional features: %s",
+        describeDevice(_capabilities).c_str(), describeFeatures(_capabilities).c_str());
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(_physical, &props);
+    _apiVersion = _capabilities.apiVersion;
+
+    // Timestamps are only meaningful if the graphics family actually writes them.
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(_physical, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(_physical, &familyCount, families.data());
+    uint32_t graphicsFamily = findQueueFamilies(_physical).graphicsFamily.value();
+    if (families[graphicsFamily].timestampValidBits > 0) {
+        _timestampPeriod = props.limits.timestampPeriod;
+    }
+
+    _attachmentSampleCounts = props.limits.framebufferColorSampleCounts
+                            & props.limits.framebufferDepthSampleCounts;
+
+    _swapChainSupport = querySwapChainSupport(_physical);
+}
+
+// Dynamic rendering is used when the device is 1.3 (core feature), or 1.2 with
+// VK_KHR_dynamic_rendering (its dependencies are all core in 1.2). Anything older
+// stays on the VkRenderPass/VkFramebuffer path.
+void Device::queryDynamicRenderingSupport() {
+    _dynamicRendering = false;
+    if (_apiVersion < VK_API_VERSION_1_2) return;
+
+    _dynamicRenderingIsCore = _apiVersion >= VK_API_VERSION_1_3;
+    if (!_dynamicRenderingIsCore && !hasDeviceExtension(_physical, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) {
+        return;
+    }
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR };
+    VkPhysicalDeviceFeatures2 features2{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+    features2.pNext = &dynamicRenderingFeatures;
+    vkGetPhysicalDeviceFeatures2(_physical, &features2);
+
+    _dynamicRendering = dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
 }
 
 void Device::createLogicalDevice() {
     // Find queue families
     auto indices = findQueueFamilies(_physical);
+    _queueFamilies = indices;
 
     std::vector<VkDeviceQueueCreateInfo> queueInfos;
     float priority = 1.0f;
     std::set<uint32_t> uniqueFamilies = {
         indices.graphicsFamily.value(),
-        indices.presentFamily.value()
+        indices.presentFamily.value(),
+        indices.computeFamily.value()
     };
     for (uint32_t fam : uniqueFamilies) {
         VkDeviceQueueCreateInfo qi{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
@@ -112,49 +196,58 @@ void Device::createLogicalDevice() {
         queueInfos.push_back(qi);
     }
 
-    VkPhysicalDeviceFeatures features{};
+    std::vector<const char*> extensions = deviceExtensions;
+    extensions.insert(extensions.end(), _capabilities.extensions.begin(), _capabilities.extensions.end());
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR };
+    if (_dynamicRendering) {
+        dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+        if (!_dynamicRenderingIsCore) {
+            extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        }
+    }
+
+    // Every optional feature the device supports, with dynamic rendering at the end of the chain.
+    DeviceFeatureChain features(_capabilities, _dynamicRendering ? &dynamicRenderingFeatures : nullptr);
     VkDeviceCreateInfo ci{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
     ci.queueCreateInfoCount = static_cast<uint32_t>(queueInfos.size());
     ci.pQueueCreateInfos = queueInfos.data();
-    ci.pEnabledFeatures = &features;
-    ci.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    ci.ppEnabledExtensionNames = deviceExtensions.data();
+    ci.pEnabledFeatures = features.features();
+    ci.pNext = features.pNext();
+
+    ci.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    ci.ppEnabledExtensionNames = extensions.data();
 
     if (enableValidation) {
         ci.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
         ci.ppEnabledLayerNames = validationLayers.data();
     }
 
-    if (vkCreateDevice(_physical, &ci, nullptr, &_device) != VK_SUCCESS) {
+    if (vkCreateDevice(_physical, &ci, hostAllocator("Device"), &_device) != VK_SUCCESS) {
         throw std::runtime_error("failed to create logical device");
     }
 
     vkGetDeviceQueue(_device, indices.graphicsFamily.value(), 0, &_graphicsQ);
     vkGetDeviceQueue(_device, indices.presentFamily.value(), 0, &_presentQ);
+    vkGetDeviceQueue(_device, indices.computeFamily.value(), 0, &_computeQ);
 }
 
-// Check if all requested validation layers are available
-bool Device::checkValidationLayerSupport() {
-    uint32_t layerCount;
-    vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
-
-    std::vector<VkLayerProperties> available(layerCount);
-    vkEnumerateInstanceLayerProperties(&layerCount, available.data());
-
-    for (const char* layerName : validationLayers) {
-        bool found = false;
-        for (const auto& prop : available) {
-            if (std::strcmp(prop.layerName, layerName) == 0) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) return false;
+void Device::loadDeviceFunctions() {
+    if (!_dynamicRendering) return;
+
+    const char* beginName = _dynamicRenderingIsCore ? "vkCmdBeginRendering" : "vkCmdBeginRenderingKHR";
+    const char* endName = _dynamicRenderingIsCore ? "vkCmdEndRendering" : "vkCmdEndRenderingKHR";
+    _vkCmdBeginRendering = (PFN_vkCmdBeginRenderingKHR)vkGetDeviceProcAddr(_device, beginName);
+    _vkCmdEndRendering = (PFN_vkCmdEndRenderingKHR)vkGetDeviceProcAddr(_device, endName);
+
+    // A driver that advertises the feature but hands back no entry points gets the legacy path.
+    if (!_vkCmdBeginRendering || !_vkCmdEndRendering) {
+        _dynamicRendering = false;
     }
-    return true;
 }
 
-// Find queue families (graphics and present)
+// Find queue families (graphics, present and compute)
 Device::QueueFamilyIndices Device::findQueueFamilies(VkPhysicalDevice dev) {
     QueueFamilyIndices indices;
     
@@ -167,6 +260,18 @@ Device::QueueFamilyIndices Device::findQueueFamilies(VkPhysicalDevice dev) {
             // Original: find both graphics and present support, using surface
         uint32_t i = 0;
     for (const auto& queueFamily : queueFamilies) {
+        // Keep scanning after graphics/present are found: a dedicated compute
+        // family is usually listed after the graphics one.
+        if ((queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+            !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) &&
+            !indices.computeFamily.has_value()) {
+            indices.computeFamily = i;
+        }
+        if (indices.isComplete()) {
+            i++;
+            continue;
+        }
+
         if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
             indices.graphicsFamily = i;
             
@@ -177,11 +282,13 @@ Device::QueueFamilyIndices Device::findQueueFamilies(VkPhysicalDevice dev) {
             indices.presentFamily = i;
             
         }
-        if (indices.isComplete()) {
-            break;
-        }
         i++;
     }
+
+    // Graphics queues always support compute; use one when there is no async family.
+    if (!indices.computeFamily.has_value()) {
+        indices.computeFamily = indices.graphicsFamily;
+    }
     return indices;
 }
 
@@ -200,6 +307,19 @@ bool Device::checkDeviceExtensionSupport(VkPhysicalDevice dev) {
     return required.empty();
 }
 
+bool Device::hasDeviceExtension(VkPhysicalDevice dev, const char* name) {
+    uint32_t extCount;
+    vkEnumerateDeviceExtensionProperties(dev, nullptr, &extCount, nullptr);
+
+    std::vector<VkExtensionProperties> available(extCount);
+    vkEnumerateDeviceExtensionProperties(dev, nullptr, &extCount, available.data());
+
+    for (const auto& ext : available) {
+        if (std::strcmp(ext.extensionName, name) == 0) return true;
+    }
+    return false;
+}
+
 // Determine if a device is suitable: has necessary queue families and extensions
 bool Device::isDeviceSuitable(VkPhysicalDevice device) {
     // use queue lookup function :)
@@ -221,17 +341,38 @@ bool Device::isDeviceSuitable(VkPhysicalDevice device) {
 }
 
 uint32_t Device::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
+    uint32_t typeIndex = 0;
+    if (tryFindMemoryType(typeFilter, properties, typeIndex)) {
+        return typeIndex;
+    }
+
+    throw std::runtime_error("failed to find suitable memory type!");
+}
+
+bool Device::tryFindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& typeIndex) {
     VkPhysicalDeviceMemoryProperties memProperties;
     vkGetPhysicalDeviceMemoryProperties(_physical, &memProperties);
 
     for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
         if ((typeFilter & (1 << i)) &&
             (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
+            typeIndex = i;
+            return true;
         }
     }
+    return false;
+}
 
-    throw std::runtime_error("failed to find suitable memory type!");
+VkSampleCountFlagBits Device::clampSampleCount(uint32_t requested) const {
+    const VkSampleCountFlagBits candidates[] = {
+        VK_SAMPLE_COUNT_8_BIT, VK_SAMPLE_COUNT_4_BIT, VK_SAMPLE_COUNT_2_BIT
+    };
+    for (VkSampleCountFlagBits count : candidates) {
+        if (static_cast<uint32_t>(count) <= requested && (_attachmentSampleCounts & count)) {
+            return count;
+        }
+    }
+    return VK_SAMPLE_COUNT_1_BIT;
 }
 
 // Insert this definition after those methods:
@@ -259,3 +400,258 @@ SwapChainSupportDetails Device::querySwapChainSupport(VkPhysicalDevice physDev)
     return details;
 }
 
+const SwapChainSupportDetails& Device::swapChainSupport() {
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(_physical, _surface, &_swapChainSupport.capabilities);
+    return _swapChainSupport;
+}
+
+VkFormat Device::findSupportedFormat(const std::vector<VkFormat>& candidates,
+    VkImageTiling tiling, VkFormatFeatureFlags features)
+{
+    for (VkFormat format : candidates) {
+        VkFormatProperties props;
+        vkGetPhysicalDeviceFormatProperties(_physical, format, &props);
+
+        if (tiling == VK_IMAGE_TILING_LINEAR && (props.linearTilingFeatures & features) == features) {
+            return format;
+        }
+        if (tiling == VK_IMAGE_TILING_OPTIMAL && (props.optimalTilingFeatures & features) == features) {
+            return format;
+        }
+    }
+
+    throw std::runtime_error("failed to find supported format!");
+}
+
+VkFormat Device::findDepthFormat() {
+    return findSupportedFormat(
+        { VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT },
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+}
+
+void Device::createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling,
+    VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
+    VkImage& image, VkDeviceMemory& imageMemory, VkSampleCountFlagBits samples, GpuMemoryCategory category,
+    uint32_t mipLevels, uint32_t arrayLayers)
+{
+    VkImageCreateInfo imageInfo{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = width;
+    imageInfo.extent.height = height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = mipLevels;
+    imageInfo.arrayLayers = arrayLayers;
+    imageInfo.format = format;
+    imageInfo.tiling = tiling;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = usage;
+    imageInfo.samples = samples;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(_device, &imageInfo, hostAllocator("Device"), &image) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create image!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(_device, image, &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocInfo.allocationSize = memRequirements.size;
+    // Lazily allocated memory (tile memory on mobile/tilers) only backs transient
+    // attachments and is often missing on desktop GPUs; fall back to the rest.
+    uint32_t typeIndex = 0;
+    if (!tryFindMemoryType(memRequirements.memoryTypeBits, properties, typeIndex)) {
+        typeIndex = findMemoryType(memRequirements.memoryTypeBits,
+            properties & ~static_cast<VkMemoryPropertyFlags>(VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT));
+    }
+    allocInfo.memoryTypeIndex = typeIndex;
+
+    imageMemory = allocateMemory(allocInfo, category, "image");
+
+    vkBindImageMemory(_device, image, imageMemory, 0);
+}
+
+void Device::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+    VkBuffer& buffer, VkDeviceMemory& bufferMemory, bool concurrentCompute, GpuMemoryCategory category)
+{
+    VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    uint32_t families[] = {
+        _queueFamilies.graphicsFamily.value(),
+        _queueFamilies.computeFamily.value()
+    };
+    if (concurrentCompute && hasAsyncCompute()) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = 2;
+        bufferInfo.pQueueFamilyIndices = families;
+    }
+
+    if (vkCreateBuffer(_device, &bufferInfo, hostAllocator("Device"), &buffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(_device, buffer, &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
+
+    bufferMemory = allocateMemory(allocInfo, category, "buffer");
+
+    vkBindBufferMemory(_device, buffer, bufferMemory, 0);
+}
+
+void Device::createDeviceLocalBuffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+    VkBuffer& buffer, VkDeviceMemory& bufferMemory, GpuMemoryCategory category)
+{
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingMemory;
+    createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        stagingBuffer, stagingMemory, false, GpuMemoryCategory::Staging);
+
+    void* mapped;
+    vkMapMemory(_device, stagingMemory, 0, size, 0, &mapped);
+    std::memcpy(mapped, data, static_cast<size_t>(size));
+    vkUnmapMemory(_device, stagingMemory);
+
+    createBuffer(size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        buffer, bufferMemory, false, category);
+
+    submitImmediate([&](VkCommandBuffer cmd) {
+        VkBufferCopy region{ 0, 0, size };
+        vkCmdCopyBuffer(cmd, stagingBuffer, buffer, 1, &region);
+    });
+
+    vkDestroyBuffer(_device, stagingBuffer, hostAllocator("Device"));
+    freeMemory(stagingMemory);
+}
+
+void Device::createDeviceLocalImage(const void* pixels, VkDeviceSize size, uint32_t width, uint32_t height,
+    VkFormat format, VkImage& image, VkDeviceMemory& imageMemory, GpuMemoryCategory category)
+{
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingMemory;
+    createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        stagingBuffer, stagingMemory, false, GpuMemoryCategory::Staging);
+
+    void* mapped;
+    vkMapMemory(_device, stagingMemory, 0, size, 0, &mapped);
+    std::memcpy(mapped, pixels, static_cast<size_t>(size));
+    vkUnmapMemory(_device, stagingMemory);
+
+    createImage(width, height, format, VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        image, imageMemory, VK_SAMPLE_COUNT_1_BIT, category);
+
+    submitImmediate([&](VkCommandBuffer cmd) {
+        VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        VkBufferImageCopy region{};
+        region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        region.imageExtent = { width, height, 1 };
+        vkCmdCopyBufferToImage(cmd, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+        // Later submissions on this queue see the upload: vkQueueWaitIdle orders them.
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+    });
+
+    vkDestroyBuffer(_device, stagingBuffer, hostAllocator("Device"));
+    freeMemory(stagingMemory);
+}
+
+void Device::submitImmediate(const std::function<void(VkCommandBuffer)>& record) {
+    // Own transient pool on the graphics queue; only used while loading.
+    VkCommandPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = _queueFamilies.graphicsFamily.value();
+    VkCommandPool pool;
+    if (vkCreateCommandPool(_device, &poolInfo, hostAllocator("Device"), &pool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create upload command pool!");
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    allocInfo.commandPool = pool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    VkCommandBuffer cmd;
+    vkAllocateCommandBuffers(_device, &allocInfo, &cmd);
+
+    VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+    record(cmd);
+    vkEndCommandBuffer(cmd);
+
+    VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    {
+        // Startup steps upload from several threads; the queue needs one at a time.
+        std::lock_guard<std::mutex> lock(_uploadMutex);
+        if (vkQueueSubmit(_graphicsQ, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+            throw std::runtime_error("failed to submit upload!");
+        }
+        vkQueueWaitIdle(_graphicsQ);
+    }
+
+    vkDestroyCommandPool(_device, pool, hostAllocator("Device"));
+}
+
+VkDeviceMemory Device::allocateMemory(const VkMemoryAllocateInfo& info, GpuMemoryCategory category, const char* what) {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkResult result = vkAllocateMemory(_device, &info, hostAllocator("Device"), &memory);
+    if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY || result == VK_ERROR_OUT_OF_HOST_MEMORY) {
+        _memory.reportOutOfMemory(info.allocationSize, category);
+    }
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error(std::string("failed to allocate ") + what + " memory!");
+    }
+    _memory.onAllocate(memory, info.allocationSize, info.memoryTypeIndex, category);
+    return memory;
+}
+
+void Device::freeMemory(VkDeviceMemory memory) {
+    if (memory == VK_NULL_HANDLE) return;
+    _memory.onFree(memory);
+    vkFreeMemory(_device, memory, hostAllocator("Device"));
+}
+
+VkImageView Device::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags) {
+    VkImageViewCreateInfo viewInfo{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = aspectFlags;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    VkImageView imageView;
+    if (vkCreateImageView(_device, &viewInfo, hostAllocator("Device"), &imageView) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create image view!");
+    }
+    return imageView;
+}
@@ -4,16 +4,24 @@
 #include <GLFW/glfw3.h>
 #include <vector>
 #include <optional>
+#include <functional>
+#include <mutex>
 #include <set>
 #include "DebugUtils.h"
+#include "DeviceCapabilities.h"
+#include "GpuMemoryTracker.h"
 #include "SwapChain.h"   // for SwapChainSupportDetails
 
 // Manages instance, physical device selection, logical device, and queues.
 class Device {
 public:
     // Initialize Vulkan instance, debug messenger, pick & create devices.
+    // A null window runs headless on a VK_EXT_headless_surface (benchmarks, CI).
+    // Validation follows debugUtils, so call its setupValidationLayers() first.
     void init(GLFWwindow* window, DebugUtils& debugUtils);
 
+    bool isHeadless() const { return window == nullptr; }
+
     // Cleanup Vulkan objects.
     void cleanup();
     
@@ -26,15 +34,75 @@ public:
     VkDevice          device()         const;
     VkQueue           graphicsQueue()  const;
     VkQueue           presentQueue()   const;
+    VkQueue           computeQueue()   const { return _computeQ; }
+    uint32_t          apiVersion()     const { return _apiVersion; }
+    // Optional features and extensions enabled on the logical device.
+    const DeviceCapabilities& capabilities() const { return _capabilities; }
+    // Budget, per-category usage and pressure callbacks for device memory.
+    GpuMemoryTracker& memory() { return _memory; }
+
+    // Dynamic rendering (core in 1.3, VK_KHR_dynamic_rendering before that).
+    // When enabled, render passes and framebuffers can be skipped entirely.
+    bool dynamicRenderingSupported() const { return _dynamicRendering; }
+    void cmdBeginRendering(VkCommandBuffer cmd, const VkRenderingInfoKHR* info) const;
+    void cmdEndRendering(VkCommandBuffer cmd) const;
 
     // Helpers for finding queue families:
     struct QueueFamilyIndices {
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
-        bool isComplete() { return graphicsFamily.has_value() && presentFamily.has_value(); }
+        // Compute-capable family, preferring one without graphics (async compute).
+        // Falls back to the graphics family, which always supports compute.
+        std::optional<uint32_t> computeFamily;
+        bool isComplete() const { return graphicsFamily.has_value() && presentFamily.has_value(); }
     };
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
+
+    // Families chosen for the logical device (cached by createLogicalDevice).
+    const QueueFamilyIndices& queueFamilies() const { return _queueFamilies; }
+    // True when compute work goes to a queue family separate from graphics.
+    bool hasAsyncCompute() const { return _queueFamilies.computeFamily != _queueFamilies.graphicsFamily; }
     SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice physDev) const;
+    // Support of the chosen device for our surface. Formats and present modes are
+    // queried once; the capabilities (current extent) are refreshed on every call.
+    const SwapChainSupportDetails& swapChainSupport();
+
+    // Resource helpers:
+    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    bool tryFindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& typeIndex);
+    VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates,
+        VkImageTiling tiling, VkFormatFeatureFlags features);
+    VkFormat findDepthFormat();
+    // VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT in `properties` is a preference:
+    // it is dropped when no memory type for the image offers it.
+    void createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling,
+        VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
+        VkImage& image, VkDeviceMemory& imageMemory,
+        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
+        GpuMemoryCategory category = GpuMemoryCategory::Texture, uint32_t mipLevels = 1,
+        uint32_t arrayLayers = 1);
+    VkImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags);
+    // concurrentCompute: share the buffer between the graphics and async compute
+    // families without ownership transfers (no-op when they are the same family).
+    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+        VkBuffer& buffer, VkDeviceMemory& bufferMemory, bool concurrentCompute = false,
+        GpuMemoryCategory category = GpuMemoryCategory::Buffer);
+    // Device-local buffer filled from `data` through a staging buffer (blocks until the copy is done).
+    void createDeviceLocalBuffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+        VkBuffer& buffer, VkDeviceMemory& bufferMemory,
+        GpuMemoryCategory category = GpuMemoryCategory::Buffer);
+    // Sampled 2D image (one mip) filled from `pixels` through a staging buffer and
+    // left in SHADER_READ_ONLY_OPTIMAL (blocks until the copy is done).
+    void createDeviceLocalImage(const void* pixels, VkDeviceSize size, uint32_t width, uint32_t height,
+        VkFormat format, VkImage& image, VkDeviceMemory& imageMemory,
+        GpuMemoryCategory category = GpuMemoryCategory::Texture);
+    // Counterpart of the create helpers above; every vkFreeMemory goes through
+    // here so the tracker sees it. Ignores VK_NULL_HANDLE.
+    void freeMemory(VkDeviceMemory memory);
+    float timestampPeriod() const { return _timestampPeriod; }  // ns per timestamp tick
+
+    // Highest sample count <= `requested` usable for both color and depth attachments.
+    VkSampleCountFlagBits clampSampleCount(uint32_t requested) const;
 
 private:
     void createInstance(const char* appName, DebugUtils& debugUtils);
@@ -42,13 +110,18 @@ private:
     void pickPhysicalDevice();
     void createLogicalDevice();
 
-    bool checkValidationLayerSupport();
     bool isDeviceSuitable(VkPhysicalDevice device);
     bool checkDeviceExtensionSupport(VkPhysicalDevice device);
-    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    bool hasDeviceExtension(VkPhysicalDevice device, const char* name);
+    void queryDynamicRenderingSupport();
+    void loadDeviceFunctions();
+    // Records with `record` into a one-time command buffer, submits it to the
+    // graphics queue and waits for it. Loading only; safe from several init threads.
+    void submitImmediate(const std::function<void(VkCommandBuffer)>& record);
+    // vkAllocateMemory with tracking. On out-of-memory, logs the usage breakdown
+    // (and tells pressure listeners) before throwing.
+    VkDeviceMemory allocateMemory(const VkMemoryAllocateInfo& info, GpuMemoryCategory category, const char* what);
 
-    
-   
     // Member data:
     GLFWwindow* window = nullptr;
     VkInstance _instance = VK_NULL_HANDLE;
@@ -57,6 +130,21 @@ private:
     VkDevice _device = VK_NULL_HANDLE;
     VkQueue _graphicsQ = VK_NULL_HANDLE;
     VkQueue _presentQ = VK_NULL_HANDLE;
+    VkQueue _computeQ = VK_NULL_HANDLE;
+    QueueFamilyIndices _queueFamilies;
+    DeviceCapabilities _capabilities;           // of the chosen device, from pickPhysicalDevice()
+    SwapChainSupportDetails _swapChainSupport{};
+    uint32_t _apiVersion = VK_API_VERSION_1_0;  // min(instance, physical device)
+    float _timestampPeriod = 0.0f;              // 0 when the graphics queue has no timestamps
+    VkSampleCountFlags _attachmentSampleCounts = VK_SAMPLE_COUNT_1_BIT;
+    GpuMemoryTracker _memory;
+    std::mutex _uploadMutex;                    // the graphics queue, for submitImmediate()
+
+    // Dynamic rendering state:
+    bool _dynamicRendering = false;
+    bool _dynamicRenderingIsCore = false;       // false -> needs the KHR extension
+    PFN_vkCmdBeginRenderingKHR _vkCmdBeginRendering = nullptr;
+    PFN_vkCmdEndRenderingKHR   _vkCmdEndRendering = nullptr;
 
     // Extensions & validation:
     const std::vector<const char*> validationLayers = {
@@ -65,5 +153,5 @@ private:
     const std::vector<const char*> deviceExtensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
     };
-    bool enableValidation = true;  // set in init() based on NDEBUG
+    bool enableValidation = false;  // DebugUtils decides, see setupValidationLayers()
 };
@@ -0,0 +1,208 @@
+// src/DeviceCapabilities.cpp
+#include "DeviceCapabilities.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+    const VkDeviceSize MIB = 1024 * 1024;
+
+    bool hasExtension(const std::vector<VkExtensionProperties>& available, const char* name) {
+        return std::any_of(available.begin(), available.end(), [name](const VkExtensionProperties& ext) {
+            return std::strcmp(ext.extensionName, name) == 0;
+        });
+    }
+
+    int64_t typeScore(VkPhysicalDeviceType type) {
+        switch (type) {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   return 100000;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return 50000;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    return 20000;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:            return 10000;
+        default:                                     return 0;
+        }
+    }
+
+    const char* typeName(VkPhysicalDeviceType type) {
+        switch (type) {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   return "discrete";
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return "integrated";
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    return "virtual";
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:            return "cpu";
+        default:                                     return "other";
+        }
+    }
+}
+
+DeviceCapabilities queryDeviceCapabilities(VkPhysicalDevice device, uint32_t instanceApiVersion) {
+    DeviceCapabilities caps;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(device, &props);
+    caps.name = props.deviceName;
+    caps.type = props.deviceType;
+    caps.apiVersion = std::min(instanceApiVersion, props.apiVersion);
+
+    VkPhysicalDeviceMemoryProperties memory;
+    vkGetPhysicalDeviceMemoryProperties(device, &memory);
+    for (uint32_t i = 0; i < memory.memoryHeapCount; i++) {
+        if (memory.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            caps.deviceLocalBytes = std::max(caps.deviceLocalBytes, memory.memoryHeaps[i].size);
+        }
+    }
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, families.data());
+    for (const VkQueueFamilyProperties& family : families) {
+        bool graphics = family.queueFlags & VK_QUEUE_GRAPHICS_BIT;
+        bool compute = family.queueFlags & VK_QUEUE_COMPUTE_BIT;
+        if (compute && !graphics) caps.asyncComputeFamily = true;
+        if ((family.queueFlags & VK_QUEUE_TRANSFER_BIT) && !graphics && !compute) caps.transferFamily = true;
+    }
+
+    VkPhysicalDeviceFeatures core;
+    vkGetPhysicalDeviceFeatures(device, &core);
+    caps.samplerAnisotropy = core.samplerAnisotropy;
+    caps.multiDrawIndirect = core.multiDrawIndirect;
+    caps.drawIndirectFirstInstance = core.drawIndirectFirstInstance;
+    caps.depthClamp = core.depthClamp;
+    caps.fillModeNonSolid = core.fillModeNonSolid;
+    caps.storageImageWriteWithoutFormat = core.shaderStorageImageWriteWithoutFormat;
+
+    // The rest needs vkGetPhysicalDeviceFeatures2 (core in 1.1).
+    if (caps.apiVersion < VK_API_VERSION_1_1) return caps;
+
+    uint32_t extCount = 0;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extCount, nullptr);
+    std::vector<VkExtensionProperties> available(extCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extCount, available.data());
+
+    // Only chain structs the device knows about: core at its version, or through the extension.
+    bool timelineCore = caps.apiVersion >= VK_API_VERSION_1_2;
+    bool sync2Core = caps.apiVersion >= VK_API_VERSION_1_3;
+    bool indexingCore = caps.apiVersion >= VK_API_VERSION_1_2;
+    bool timelineKnown = timelineCore || hasExtension(available, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    bool sync2Known = sync2Core || hasExtension(available, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    bool indexingKnown = indexingCore || hasExtension(available, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES };
+    VkPhysicalDeviceSynchronization2FeaturesKHR sync2{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR };
+    VkPhysicalDeviceDescriptorIndexingFeatures indexing{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES };
+    VkPhysicalDeviceFeatures2 features2{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+    void** tail = &features2.pNext;
+    if (timelineKnown) { *tail = &timeline; tail = &timeline.pNext; }
+    if (sync2Known)    { *tail = &sync2;    tail = &sync2.pNext; }
+    if (indexingKnown) { *tail = &indexing; tail = &indexing.pNext; }
+    vkGetPhysicalDeviceFeatures2(device, &features2);
+
+    caps.timelineSemaphores = timelineKnown && timeline.timelineSemaphore;
+    caps.synchronization2 = sync2Known && sync2.synchronization2;
+    // The subset bindless texturing needs.
+    caps.descriptorIndexing = indexingKnown
+        && indexing.runtimeDescriptorArray
+        && indexing.descriptorBindingPartiallyBound
+        && indexing.descriptorBindingVariableDescriptorCount
+        && indexing.shaderSampledImageArrayNonUniformIndexing
+        && indexing.descriptorBindingSampledImageUpdateAfterBind;
+    caps.memoryBudget = hasExtension(available, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+    VkPhysicalDeviceSubgroupProperties subgroup{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES };
+    VkPhysicalDeviceProperties2 props2{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 };
+    props2.pNext = &subgroup;
+    vkGetPhysicalDeviceProperties2(device, &props2);
+    const VkSubgroupFeatureFlags arithmetic = VK_SUBGROUP_FEATURE_BASIC_BIT | VK_SUBGROUP_FEATURE_ARITHMETIC_BIT;
+    caps.subgroupArithmetic = (subgroup.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT)
+        && (subgroup.supportedOperations & arithmetic) == arithmetic;
+    caps.subgroupSize = subgroup.subgroupSize;
+
+    if (caps.timelineSemaphores && !timelineCore) caps.extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    if (caps.synchronization2 && !sync2Core) caps.extensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    if (caps.descriptorIndexing && !indexingCore) caps.extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+    if (caps.memoryBudget) caps.extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    return caps;
+}
+
+int64_t scoreDeviceCapabilities(const DeviceCapabilities& caps) {
+    int64_t score = typeScore(caps.type);
+
+    // Up to 16 GiB of local memory counts, 10 points per GiB.
+    score += int64_t(std::min<VkDeviceSize>(caps.deviceLocalBytes / (1024 * MIB), 16)) * 10;
+
+    if (caps.apiVersion >= VK_API_VERSION_1_3) score += 60;
+    else if (caps.apiVersion >= VK_API_VERSION_1_2) score += 30;
+
+    if (caps.asyncComputeFamily) score += 40;
+    if (caps.transferFamily) score += 10;
+
+    if (caps.timelineSemaphores) score += 20;
+    if (caps.synchronization2) score += 20;
+    if (caps.descriptorIndexing) score += 20;
+    if (caps.multiDrawIndirect && caps.drawIndirectFirstInstance) score += 20;
+    if (caps.memoryBudget) score += 10;
+    if (caps.samplerAnisotropy) score += 5;
+    if (caps.depthClamp) score += 5;
+    return score;
+}
+
+DeviceFeatureChain::DeviceFeatureChain(const DeviceCapabilities& caps, void* next) {
+    core.samplerAnisotropy = caps.samplerAnisotropy;
+    core.multiDrawIndirect = caps.multiDrawIndirect;
+    core.drawIndirectFirstInstance = caps.drawIndirectFirstInstance;
+    core.depthClamp = caps.depthClamp;
+    core.fillModeNonSolid = caps.fillModeNonSolid;
+    core.shaderStorageImageWriteWithoutFormat = caps.storageImageWriteWithoutFormat;
+
+    // Built back to front so `next` ends up last.
+    head = next;
+    if (caps.descriptorIndexing) {
+        indexing.runtimeDescriptorArray = VK_TRUE;
+        indexing.descriptorBindingPartiallyBound = VK_TRUE;
+        indexing.descriptorBindingVariableDescriptorCount = VK_TRUE;
+        indexing.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+        indexing.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        indexing.pNext = head;
+        head = &indexing;
+    }
+    if (caps.synchronization2) {
+        sync2.synchronization2 = VK_TRUE;
+        sync2.pNext = head;
+        head = &sync2;
+    }
+    if (caps.timelineSemaphores) {
+        timeline.timelineSemaphore = VK_TRUE;
+        timeline.pNext = head;
+        head = &timeline;
+    }
+}
+
+std::string describeDevice(const DeviceCapabilities& caps) {
+    return caps.name + " (" + typeName(caps.type) + ", "
+        + std::to_string(caps.deviceLocalBytes / MIB) + " MiB, Vulkan "
+        + std::to_string(VK_API_VERSION_MAJOR(caps.apiVersion)) + "."
+        + std::to_string(VK_API_VERSION_MINOR(caps.apiVersion)) + ")";
+}
+
+std::string describeFeatures(const DeviceCapabilities& caps) {
+    const std::pair<bool, const char*> features[] = {
+        { caps.timelineSemaphores, "timeline semaphores" },
+        { caps.synchronization2, "synchronization2" },
+        { caps.descriptorIndexing, "descriptor indexing" },
+        { caps.memoryBudget, "memory budget" },
+        { caps.subgroupArithmetic, "subgroup arithmetic" },
+        { caps.multiDrawIndirect, "multi-draw indirect" },
+        { caps.samplerAnisotropy, "anisotropy" },
+        { caps.depthClamp, "depth clamp" },
+        { caps.asyncComputeFamily, "async compute" },
+        { caps.transferFamily, "transfer queue" },
+    };
+    std::string list;
+    for (const auto& feature : features) {
+        if (!feature.first) continue;
+        if (!list.empty()) list += ", ";
+        list += feature.second;
+    }
+    return list.empty() ? "none" : list;
+}
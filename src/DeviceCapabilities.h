@@ -0,0 +1,81 @@
+// src/DeviceCapabilities.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// What a physical device offers beyond the baseline the engine requires, as
+// far as the engine cares. Device fills one per candidate to rank them, and
+// enables every optional feature the chosen one supports, so for
+// Device::capabilities() "supported" and "enabled" mean the same thing.
+struct DeviceCapabilities {
+    std::string          name;
+    VkPhysicalDeviceType type = VK_PHYSICAL_DEVICE_TYPE_OTHER;
+    uint32_t             apiVersion = VK_API_VERSION_1_0;   // min(instance, device)
+    VkDeviceSize         deviceLocalBytes = 0;              // largest device-local heap
+
+    // Queue families
+    bool asyncComputeFamily = false;   // compute family without graphics
+    bool transferFamily = false;       // transfer-only family (copy engine)
+
+    // Core 1.0 features
+    bool samplerAnisotropy = false;
+    bool multiDrawIndirect = false;
+    bool drawIndirectFirstInstance = false;
+    bool depthClamp = false;
+    bool fillModeNonSolid = false;
+    bool storageImageWriteWithoutFormat = false;   // imageStore to views of any format (e.g. BGRA swapchains)
+
+    // Newer features, core or through their extension
+    bool timelineSemaphores = false;   // 1.2 / VK_KHR_timeline_semaphore
+    bool synchronization2 = false;     // 1.3 / VK_KHR_synchronization2
+    bool descriptorIndexing = false;   // 1.2 / VK_EXT_descriptor_indexing: bindless sampled-image arrays
+    bool memoryBudget = false;         // VK_EXT_memory_budget
+
+    // Subgroup operations (1.1): subgroupAdd() and friends in compute shaders.
+    bool     subgroupArithmetic = false;
+    uint32_t subgroupSize = 0;
+
+    // Device extensions the optional features above need on this device.
+    std::vector<const char*> extensions;
+};
+
+// Reads the capabilities of `device` for an instance created with `instanceApiVersion`.
+DeviceCapabilities queryDeviceCapabilities(VkPhysicalDevice device, uint32_t instanceApiVersion);
+
+// Ranking for device selection, higher is better. Device type dominates
+// (discrete > integrated > virtual > CPU); memory size, API version, queue
+// families and optional features break ties within a type.
+int64_t scoreDeviceCapabilities(const DeviceCapabilities& caps);
+
+// Feature structs for VkDeviceCreateInfo that turn on everything `caps` has.
+// Holds the storage the pNext chain points into, so keep it alive until
+// vkCreateDevice returns.
+class DeviceFeatureChain {
+public:
+    // `next` is appended after the optional structs (e.g. the dynamic rendering features).
+    DeviceFeatureChain(const DeviceCapabilities& caps, void* next);
+    DeviceFeatureChain(const DeviceFeatureChain&) = delete;   // the chain points into itself
+    DeviceFeatureChain& operator=(const DeviceFeatureChain&) = delete;
+
+    const VkPhysicalDeviceFeatures* features() const { return &core; }
+    void* pNext() const { return head; }
+
+private:
+    VkPhysicalDeviceFeatures core{};
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES };
+    VkPhysicalDeviceSynchronization2FeaturesKHR sync2{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR };
+    VkPhysicalDeviceDescriptorIndexingFeatures indexing{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES };
+    void* head = nullptr;
+};
+
+// One-line summary for the log, e.g. "NVIDIA ... (discrete, 8192 MiB, Vulkan 1.3)".
+std::string describeDevice(const DeviceCapabilities& caps);
+// Comma-separated optional features, e.g. "timeline semaphores, synchronization2".
+std::string describeFeatures(const DeviceCapabilities& caps);
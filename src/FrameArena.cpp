@@ -0,0 +1,64 @@
+// src/FrameArena.cpp
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace {
+    // Spills per frame tracked before the list itself has to grow.
+    const size_t OVERFLOW_RESERVE = 64;
+
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+void FrameArena::init(size_t capacity) {
+    block.reset(new unsigned char[capacity]);
+    blockSize = capacity;
+    offset = 0;
+    overflowBytes = 0;
+    peak = 0;
+    overflow.reserve(OVERFLOW_RESERVE);
+}
+
+void FrameArena::cleanup() {
+    reset();
+    block.reset();
+    blockSize = 0;
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    // Align the address, not the offset: the block itself is only max_align_t aligned.
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.get());
+    size_t start = alignUp(base + offset, alignment) - base;
+    if (block && start + size <= blockSize) {
+        offset = start + size;
+        peak = std::max(peak, used());
+        return block.get() + start;
+    }
+
+    size_t spillAlignment = std::max(alignment, alignof(std::max_align_t));
+    void* spill = ::operator new(size, std::align_val_t(spillAlignment));
+    overflow.push_back({ spill, spillAlignment });
+    overflowBytes += alignUp(size, alignment);
+    peak = std::max(peak, used());
+    return spill;
+}
+
+void FrameArena::reset() {
+    for (const Spill& spill : overflow) {
+        ::operator delete(spill.ptr, std::align_val_t(spill.alignment));
+    }
+    overflow.clear();
+
+    // Grow once so the frames that spilled fit next time (with some headroom).
+    if (overflowBytes > 0) {
+        size_t grown = alignUp(peak + peak / 2, 4096);
+        block.reset(new unsigned char[grown]);
+        blockSize = grown;
+    }
+    offset = 0;
+    overflowBytes = 0;
+}
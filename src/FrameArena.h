@@ -0,0 +1,70 @@
+// src/FrameArena.h
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Linear allocator for data that lives for one frame. Allocation is a pointer
+// bump; individual frees are no-ops and reset() releases everything at once.
+// The renderer keeps one arena per frame in flight and resets it after that
+// frame's fence has signalled, so nothing the GPU may still read is recycled.
+//
+// When a frame needs more than the capacity, the excess comes from the heap and
+// the next reset() grows the block to the high-water mark, so after warm-up the
+// frame loop allocates nothing.
+class FrameArena {
+public:
+    void init(size_t capacity);
+    void cleanup();
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(size_t count) { return static_cast<T*>(allocate(sizeof(T) * count, alignof(T))); }
+
+    // Frees every allocation made since the last reset.
+    void reset();
+
+    size_t capacity()  const { return blockSize; }
+    size_t used()      const { return offset + overflowBytes; }
+    size_t highWater() const { return peak; }
+
+private:
+    std::unique_ptr<unsigned char[]> block;
+    size_t blockSize = 0;
+    size_t offset = 0;
+
+    struct Spill { void* ptr; size_t alignment; };
+    std::vector<Spill> overflow;     // heap spill for this frame, freed by reset()
+    size_t overflowBytes = 0;
+    size_t peak = 0;
+};
+
+// STL allocator drawing from a FrameArena. deallocate() is a no-op, so a
+// container using it must not outlive the arena's next reset().
+//     std::vector<uint32_t, ArenaAllocator<uint32_t>> v{ ArenaAllocator<uint32_t>(arena) };
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena& arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T*   allocate(size_t n) { return arena->allocateArray<T>(n); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+private:
+    template <typename U> friend class ArenaAllocator;
+    FrameArena* arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
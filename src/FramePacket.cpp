@@ -0,0 +1,62 @@
+// src/FramePacket.cpp
+#include "FramePacket.h"
+
+int FramePacketExchange::findSlot(SlotState state) const {
+    for (int i = 0; i < 2; i++) {
+        if (states[i] == state) return i;
+    }
+    return -1;
+}
+
+void FramePacketExchange::publish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        int slot = findSlot(SlotState::Writing);
+        if (slot < 0) return;
+        states[slot] = SlotState::Ready;
+    }
+    changed.notify_all();
+}
+
+const FramePacket* FramePacketExchange::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [&] { return stopped || findSlot(SlotState::Ready) >= 0; });
+    if (stopped) return nullptr;
+
+    // Both slots can only be ready if the reader fell behind; take the newest
+    // and hand the stale one back to the writer.
+    int slot = findSlot(SlotState::Ready);
+    int other = 1 - slot;
+    if (states[other] == SlotState::Ready) {
+        if (packets[other].frameNumber > packets[slot].frameNumber) std::swap(slot, other);
+        packets[slot].framebufferResized |= packets[other].framebufferResized;
+        states[other] = SlotState::Free;
+    }
+    states[slot] = SlotState::Reading;
+    lock.unlock();
+    changed.notify_all();
+    return &packets[slot];
+}
+
+void FramePacketExchange::release() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        int slot = findSlot(SlotState::Reading);
+        if (slot < 0) return;
+        states[slot] = SlotState::Free;
+    }
+    changed.notify_all();
+}
+
+void FramePacketExchange::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    changed.notify_all();
+}
+
+bool FramePacketExchange::isShutdown() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stopped;
+}
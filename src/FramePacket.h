@@ -0,0 +1,65 @@
+// src/FramePacket.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "CameraController.h"
+
+// Everything the render thread needs from the game-logic thread for one frame.
+// Written once by the logic thread, then read-only until the renderer releases it.
+struct FramePacket {
+    uint64_t   frameNumber = 0;
+    float      time = 0.0f;              // simulation time in seconds (drives animation)
+    CameraPose camera;                   // simulated camera, refined by late sampling
+    VkExtent2D framebufferExtent{};      // window size in pixels, never 0x0
+    bool       framebufferResized = false;
+    bool       showOverlay = false;      // draw the performance overlay (F1 / --overlay)
+};
+
+// Double-buffered hand-off of FramePackets between the logic thread (writer) and
+// the render thread (reader). The writer fills one packet while the reader
+// consumes the other, so simulating frame N+1 overlaps rendering frame N; it
+// blocks only when it gets a full packet ahead of the renderer.
+class FramePacketExchange {
+public:
+    // Writer: a packet to fill, or nullptr after `timeout` (or shutdown). The
+    // timeout lets the writer keep pumping window events while it waits.
+    template <typename Rep, typename Period>
+    FramePacket* beginWrite(std::chrono::duration<Rep, Period> timeout);
+    void publish();
+
+    // Reader: blocks for the newest published packet; nullptr once shut down.
+    const FramePacket* acquire();
+    void release();
+
+    // Wakes both sides; afterwards beginWrite() and acquire() return nullptr.
+    void shutdown();
+    bool isShutdown() const;
+
+private:
+    enum class SlotState : uint8_t { Free, Writing, Ready, Reading };
+
+    int findSlot(SlotState state) const;
+
+    FramePacket packets[2];
+    SlotState   states[2] = { SlotState::Free, SlotState::Free };
+    bool        stopped = false;
+
+    mutable std::mutex      mutex;
+    std::condition_variable changed;
+};
+
+template <typename Rep, typename Period>
+FramePacket* FramePacketExchange::beginWrite(std::chrono::duration<Rep, Period> timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    bool ready = changed.wait_for(lock, timeout, [&] { return stopped || findSlot(SlotState::Free) >= 0; });
+    if (!ready || stopped) return nullptr;
+
+    int slot = findSlot(SlotState::Free);
+    states[slot] = SlotState::Writing;
+    return &packets[slot];
+}
@@ -0,0 +1,202 @@
+// src/GpuMemoryTracker.cpp
+#include "GpuMemoryTracker.h"
+#include "Logger.h"
+
+#include <algorithm>
+
+namespace {
+    const VkDeviceSize MIB = 1024 * 1024;
+    // Without VK_EXT_memory_budget, assume this much of a heap is ours to use.
+    const double FALLBACK_BUDGET_FRACTION = 0.8;
+
+    const char* CATEGORY_NAMES[] = { "mesh", "texture", "render target", "staging", "buffer" };
+    const char* PRESSURE_NAMES[] = { "normal", "high", "critical" };
+
+    double fill(const GpuHeapUsage& heap) {
+        return heap.budget > 0 ? double(heap.usage) / double(heap.budget) : 0.0;
+    }
+}
+
+const char* gpuMemoryCategoryName(GpuMemoryCategory category) {
+    return category < GpuMemoryCategory::Count ? CATEGORY_NAMES[size_t(category)] : "unknown";
+}
+
+void GpuMemoryTracker::init(VkPhysicalDevice physicalDevice, bool budgetExtension) {
+    physical = physicalDevice;
+    useBudgetExtension = budgetExtension;
+
+    VkPhysicalDeviceMemoryProperties props;
+    vkGetPhysicalDeviceMemoryProperties(physical, &props);
+    typeToHeap.resize(props.memoryTypeCount);
+    for (uint32_t i = 0; i < props.memoryTypeCount; i++) {
+        typeToHeap[i] = props.memoryTypes[i].heapIndex;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    trackedHeapBytes.assign(props.memoryHeapCount, 0);
+    heapUsage.resize(props.memoryHeapCount);
+    for (uint32_t i = 0; i < props.memoryHeapCount; i++) {
+        heapUsage[i].size = props.memoryHeaps[i].size;
+        heapUsage[i].budget = VkDeviceSize(double(props.memoryHeaps[i].size) * FALLBACK_BUDGET_FRACTION);
+        heapUsage[i].deviceLocal = (props.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+    }
+}
+
+//-------------------------------------------------------------------------
+// Allocation bookkeeping
+//-------------------------------------------------------------------------
+
+void GpuMemoryTracker::onAllocate(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex,
+                                  GpuMemoryCategory category) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t heap = memoryTypeIndex < typeToHeap.size() ? typeToHeap[memoryTypeIndex] : 0;
+    allocations[memory] = Allocation{ size, heap, category };
+    categoryTotals[size_t(category)] += size;
+    categoryCounts[size_t(category)]++;
+    if (heap < trackedHeapBytes.size()) trackedHeapBytes[heap] += size;
+}
+
+void GpuMemoryTracker::onFree(VkDeviceMemory memory) {
+    if (memory == VK_NULL_HANDLE) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = allocations.find(memory);
+    if (it == allocations.end()) return;
+
+    const Allocation& a = it->second;
+    categoryTotals[size_t(a.category)] -= a.size;
+    categoryCounts[size_t(a.category)]--;
+    if (a.heap < trackedHeapBytes.size()) trackedHeapBytes[a.heap] -= a.size;
+    allocations.erase(it);
+}
+
+//-------------------------------------------------------------------------
+// Budget and pressure
+//-------------------------------------------------------------------------
+
+void GpuMemoryTracker::update() {
+    if (physical == VK_NULL_HANDLE) return;
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT };
+    if (useBudgetExtension) {
+        VkPhysicalDeviceMemoryProperties2 props2{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2 };
+        props2.pNext = &budget;
+        vkGetPhysicalDeviceMemoryProperties2(physical, &props2);
+    }
+
+    GpuHeapUsage worst;
+    GpuMemoryPressure level = GpuMemoryPressure::None;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < heapUsage.size(); i++) {
+            GpuHeapUsage& heap = heapUsage[i];
+            if (useBudgetExtension) {
+                heap.budget = budget.heapBudget[i];
+                heap.usage = budget.heapUsage[i];
+            }
+            else {
+                heap.usage = trackedHeapBytes[i];
+            }
+            if (fill(heap) >= fill(worst)) worst = heap;
+        }
+
+        double worstFill = fill(worst);
+        if (worstFill >= CRITICAL_PRESSURE) level = GpuMemoryPressure::Critical;
+        else if (worstFill >= HIGH_PRESSURE) level = GpuMemoryPressure::High;
+        if (level == currentPressure) return;
+        currentPressure = level;
+    }
+
+    Logger::global().logf(level == GpuMemoryPressure::None ? LogSeverity::Info : LogSeverity::Warning, "memory",
+        "GPU memory pressure %s: %llu of %llu MiB budget in use", PRESSURE_NAMES[size_t(level)],
+        static_cast<unsigned long long>(worst.usage / MIB), static_cast<unsigned long long>(worst.budget / MIB));
+    notify(level, worst);
+}
+
+void GpuMemoryTracker::reportOutOfMemory(VkDeviceSize requested, GpuMemoryCategory category) {
+    Logger& log = Logger::global();
+    log.logf(LogSeverity::Error, "memory", "out of device memory allocating %llu KiB (%s); %s",
+        static_cast<unsigned long long>(requested / 1024), gpuMemoryCategoryName(category), summary().c_str());
+
+    GpuHeapUsage worst;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const GpuHeapUsage& heap : heapUsage) {
+            log.logf(LogSeverity::Error, "memory", "  heap %llu MiB: %llu MiB used, %llu MiB budget%s",
+                static_cast<unsigned long long>(heap.size / MIB), static_cast<unsigned long long>(heap.usage / MIB),
+                static_cast<unsigned long long>(heap.budget / MIB), heap.deviceLocal ? " (device local)" : "");
+            if (fill(heap) >= fill(worst)) worst = heap;
+        }
+        currentPressure = GpuMemoryPressure::Critical;
+    }
+    notify(GpuMemoryPressure::Critical, worst);
+}
+
+uint32_t GpuMemoryTracker::addPressureListener(PressureListener listener) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t id = nextListenerId++;
+    listeners.emplace_back(id, std::move(listener));
+    return id;
+}
+
+void GpuMemoryTracker::removePressureListener(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+        [id](const auto& entry) { return entry.first == id; }), listeners.end());
+}
+
+void GpuMemoryTracker::notify(GpuMemoryPressure level, const GpuHeapUsage& heap) {
+    // Copied so listeners may free memory (onFree) or unregister without deadlocking.
+    std::vector<std::pair<uint32_t, PressureListener>> current;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = listeners;
+    }
+    for (const auto& entry : current) entry.second(level, heap);
+}
+
+//-------------------------------------------------------------------------
+// Queries
+//-------------------------------------------------------------------------
+
+VkDeviceSize GpuMemoryTracker::categoryBytes(GpuMemoryCategory category) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return categoryTotals[size_t(category)];
+}
+
+uint32_t GpuMemoryTracker::categoryAllocations(GpuMemoryCategory category) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return categoryCounts[size_t(category)];
+}
+
+size_t GpuMemoryTracker::liveAllocations() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return allocations.size();
+}
+
+std::vector<GpuHeapUsage> GpuMemoryTracker::heaps() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return heapUsage;
+}
+
+GpuMemoryPressure GpuMemoryTracker::pressure() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return currentPressure;
+}
+
+std::string GpuMemoryTracker::summary() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    VkDeviceSize used = 0, budget = 0;
+    for (const GpuHeapUsage& heap : heapUsage) {
+        if (!heap.deviceLocal) continue;
+        used += heap.usage;
+        budget += heap.budget;
+    }
+
+    std::string line = "gpu memory " + std::to_string(used / MIB) + "/" + std::to_string(budget / MIB) + " MiB (";
+    for (size_t c = 0; c < size_t(GpuMemoryCategory::Count); c++) {
+        if (c) line += ", ";
+        line += CATEGORY_NAMES[c];
+        line += " " + std::to_string(categoryTotals[c] / MIB);
+    }
+    return line + ")";
+}
@@ -0,0 +1,97 @@
+// src/GpuMemoryTracker.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// What a device memory allocation is for, so usage can be broken down.
+enum class GpuMemoryCategory : uint8_t {
+    Mesh,           // vertex / index data
+    Texture,        // sampled images
+    RenderTarget,   // swapchain-sized attachments
+    Staging,        // upload buffers
+    Buffer,         // uniform / storage / indirect buffers
+    Count
+};
+const char* gpuMemoryCategoryName(GpuMemoryCategory category);
+
+enum class GpuMemoryPressure : uint8_t {
+    None,
+    High,       // over HIGH_PRESSURE of the budget: stop growing caches
+    Critical,   // over CRITICAL_PRESSURE, or an allocation already failed: release what you can
+};
+
+struct GpuHeapUsage {
+    VkDeviceSize size = 0;     // physical heap size
+    VkDeviceSize budget = 0;   // what this process can use without trouble
+    VkDeviceSize usage = 0;    // what this process uses
+    bool         deviceLocal = false;
+};
+
+// Device memory telemetry. Device reports every vkAllocateMemory/vkFreeMemory,
+// tagged with a category; once per frame update() re-reads the per-heap budget
+// (VK_EXT_memory_budget when enabled, else 80% of the heap against our own
+// tracked allocations) and tells pressure listeners when the level changes.
+class GpuMemoryTracker {
+public:
+    static constexpr double HIGH_PRESSURE = 0.85;
+    static constexpr double CRITICAL_PRESSURE = 0.95;
+
+    void init(VkPhysicalDevice physicalDevice, bool budgetExtension);
+
+    void onAllocate(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, GpuMemoryCategory category);
+    void onFree(VkDeviceMemory memory);   // ignores VK_NULL_HANDLE
+
+    // Re-reads heap budgets; call once per frame. Listeners run on the calling thread.
+    void update();
+
+    // Logs the full breakdown and sends Critical to every listener. The failed
+    // allocation is not retried: nothing in the engine registers a listener yet.
+    void reportOutOfMemory(VkDeviceSize requested, GpuMemoryCategory category);
+
+    // Pressure listeners, for subsystems that can shrink (none yet). Called with
+    // the new level and the heap closest to its budget.
+    using PressureListener = std::function<void(GpuMemoryPressure, const GpuHeapUsage&)>;
+    uint32_t addPressureListener(PressureListener listener);
+    void removePressureListener(uint32_t id);
+
+    VkDeviceSize categoryBytes(GpuMemoryCategory category) const;
+    uint32_t categoryAllocations(GpuMemoryCategory category) const;
+    size_t liveAllocations() const;
+    std::vector<GpuHeapUsage> heaps() const;
+    GpuMemoryPressure pressure() const;
+
+    // One line for the periodic stats dump, e.g.
+    // "gpu memory 412/6144 MiB (mesh 96, texture 0, render target 48, staging 0, buffer 12)".
+    std::string summary() const;
+
+private:
+    struct Allocation {
+        VkDeviceSize      size;
+        uint32_t          heap;
+        GpuMemoryCategory category;
+    };
+
+    void notify(GpuMemoryPressure level, const GpuHeapUsage& heap);
+
+    VkPhysicalDevice physical = VK_NULL_HANDLE;
+    bool             useBudgetExtension = false;
+    std::vector<uint32_t> typeToHeap;
+
+    mutable std::mutex mutex;   // allocations come from the main and render threads
+    std::unordered_map<VkDeviceMemory, Allocation> allocations;
+    VkDeviceSize categoryTotals[size_t(GpuMemoryCategory::Count)] = {};
+    uint32_t     categoryCounts[size_t(GpuMemoryCategory::Count)] = {};
+    std::vector<VkDeviceSize> trackedHeapBytes;
+    std::vector<GpuHeapUsage> heapUsage;
+    GpuMemoryPressure         currentPressure = GpuMemoryPressure::None;
+
+    std::vector<std::pair<uint32_t, PressureListener>> listeners;
+    uint32_t nextListenerId = 1;
+};
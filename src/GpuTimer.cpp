@@ -0,0 +1,63 @@
+// src/GpuTimer.cpp
+#include "GpuTimer.h"
+#include "HostMemoryTracker.h"
+#include "Device.h"
+#include <stdexcept>
+
+void GpuTimer::init(Device& dev, uint32_t framesInFlight, uint32_t scopes) {
+    device = &dev;
+    maxScopes = scopes;
+    nsPerTick = dev.timestampPeriod();
+    writtenScopes.assign(framesInFlight, 0);
+    lastResultsMs.assign(scopes, 0.0);
+
+    if (nsPerTick <= 0.0) return;
+
+    VkQueryPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = framesInFlight * scopes * 2;
+
+    if (vkCreateQueryPool(device->device(), &poolInfo, hostAllocator("GpuTimer"), &queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create timestamp query pool!");
+    }
+}
+
+void GpuTimer::cleanup() {
+    if (queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device->device(), queryPool, hostAllocator("GpuTimer"));
+        queryPool = VK_NULL_HANDLE;
+    }
+}
+
+void GpuTimer::reset(VkCommandBuffer cmd, uint32_t frame) {
+    if (!supported()) return;
+    vkCmdResetQueryPool(cmd, queryPool, queryIndex(frame, 0), maxScopes * 2);
+    writtenScopes[frame] = 0;
+}
+
+void GpuTimer::begin(VkCommandBuffer cmd, uint32_t frame, uint32_t scope) {
+    if (!supported()) return;
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, queryIndex(frame, scope));
+}
+
+void GpuTimer::end(VkCommandBuffer cmd, uint32_t frame, uint32_t scope) {
+    if (!supported()) return;
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, queryIndex(frame, scope) + 1);
+    writtenScopes[frame] |= 1u << scope;
+}
+
+void GpuTimer::collect(uint32_t frame) {
+    if (!supported()) return;
+
+    for (uint32_t scope = 0; scope < maxScopes; scope++) {
+        if ((writtenScopes[frame] & (1u << scope)) == 0) continue;
+
+        uint64_t ticks[2] = {};
+        VkResult result = vkGetQueryPoolResults(device->device(), queryPool, queryIndex(frame, scope), 2,
+            sizeof(ticks), ticks, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (result == VK_SUCCESS) {
+            lastResultsMs[scope] = double(ticks[1] - ticks[0]) * nsPerTick * 1e-6;
+        }
+    }
+    writtenScopes[frame] = 0;
+}
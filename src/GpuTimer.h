@@ -0,0 +1,47 @@
+// src/GpuTimer.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+class Device;
+
+// Timestamp-query based GPU timing, one query range per frame in flight.
+// Each frame can time up to `maxScopes` regions; results are read back once
+// that frame's fence has signalled, so collecting never stalls.
+class GpuTimer {
+public:
+    void init(Device& device, uint32_t framesInFlight, uint32_t maxScopes);
+    void cleanup();
+
+    // False when the graphics queue has no timestamp support; all calls become no-ops.
+    bool supported() const { return queryPool != VK_NULL_HANDLE; }
+
+    // Record once at the start of the frame's command buffer (outside any render pass).
+    void reset(VkCommandBuffer cmd, uint32_t frame);
+    void begin(VkCommandBuffer cmd, uint32_t frame, uint32_t scope);
+    void end(VkCommandBuffer cmd, uint32_t frame, uint32_t scope);
+
+    // Call after the frame's fence has signalled to pick up its timings.
+    void collect(uint32_t frame);
+
+    // Scopes recorded for `frame` since its last reset(). A cached command
+    // buffer that is submitted again without re-recording writes the same
+    // queries, so hand its scopes back through replay() to collect them.
+    uint32_t recordedScopes(uint32_t frame) const { return writtenScopes[frame]; }
+    void replay(uint32_t frame, uint32_t scopes) { writtenScopes[frame] = scopes; }
+
+    // Most recent duration of a scope in milliseconds (0 if never recorded).
+    double lastMs(uint32_t scope) const { return scope < lastResultsMs.size() ? lastResultsMs[scope] : 0.0; }
+
+private:
+    uint32_t queryIndex(uint32_t frame, uint32_t scope) const { return (frame * maxScopes + scope) * 2; }
+
+    Device* device = nullptr;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    uint32_t maxScopes = 0;
+    double   nsPerTick = 0.0;
+
+    std::vector<uint32_t> writtenScopes;   // bitmask of scopes recorded per frame slot
+    std::vector<double>   lastResultsMs;
+};
@@ -0,0 +1,55 @@
+// src/HostAllocationHook.cpp
+//
+// Global operator new/delete replacement that credits every heap allocation to
+// the allocating thread's HostAllocationScope. Not part of the engine library:
+// an executable that wants heap counts compiles this file itself (GameEngine
+// with ENGINE_HOST_ALLOCATION_HOOK, GameEngineBench always), so the replacement
+// is linked in for certain rather than left to static-library member selection.
+#include "HostMemoryTracker.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    const bool HOOK_REGISTERED = (HostMemoryTracker::global().setHeapHookEnabled(), true);
+
+    void* trackedAlloc(size_t size) {
+        HostMemoryTracker::global().onHeapAllocate(size);
+        if (void* p = std::malloc(size ? size : 1)) return p;
+        throw std::bad_alloc();
+    }
+
+    void* trackedAlignedAlloc(size_t size, std::align_val_t align) {
+        HostMemoryTracker::global().onHeapAllocate(size);
+        size_t alignment = static_cast<size_t>(align);
+#ifdef _MSC_VER
+        void* p = _aligned_malloc(size ? size : 1, alignment);
+#else
+        void* p = std::aligned_alloc(alignment, (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment);
+#endif
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+
+    void alignedFree(void* p) {
+#ifdef _MSC_VER
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+void* operator new(size_t size) { return trackedAlloc(size); }
+void* operator new[](size_t size) { return trackedAlloc(size); }
+void* operator new(size_t size, std::align_val_t align) { return trackedAlignedAlloc(size, align); }
+void* operator new[](size_t size, std::align_val_t align) { return trackedAlignedAlloc(size, align); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
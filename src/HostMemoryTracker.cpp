@@ -0,0 +1,247 @@
+// src/HostMemoryTracker.cpp
+#include "HostMemoryTracker.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    const char* const UNSCOPED_SITE = "unscoped";
+    const char* const OVERFLOW_SITE = "other";   // sites registered past MAX_SITES
+    const uint32_t UNSCOPED_INDEX = 0;
+    const uint32_t OVERFLOW_INDEX = 1;
+
+    const char* const SCOPE_NAMES[] = { "command", "object", "cache", "device", "instance" };
+    const size_t MIN_ALIGNMENT = 16;
+
+    // Site the calling thread's heap allocations are credited to.
+    thread_local uint32_t currentSite = UNSCOPED_INDEX;
+
+    // Sits right below every block handed to the driver, so a free or realloc
+    // can find the start of the malloc block and the site and scope to credit.
+    struct BlockHeader {
+        size_t   size;
+        uint16_t site;
+        uint8_t  scope;
+        uint8_t  unused;
+        uint32_t offset;   // from the malloc block to the returned pointer
+    };
+    static_assert(sizeof(BlockHeader) == MIN_ALIGNMENT, "header must keep blocks aligned");
+
+    BlockHeader* headerOf(void* memory) { return static_cast<BlockHeader*>(memory) - 1; }
+
+    double mib(int64_t bytes) { return double(bytes) / (1024.0 * 1024.0); }
+}
+
+//-------------------------------------------------------------------------
+// Sites
+//-------------------------------------------------------------------------
+
+HostMemoryTracker& HostMemoryTracker::global() {
+    static HostMemoryTracker tracker;
+    return tracker;
+}
+
+HostMemoryTracker::HostMemoryTracker() {
+    for (uint32_t i = 0; i < MAX_SITES; i++) {
+        Site& site = sites[i];
+        site.index = i;
+        site.callbacks.pUserData = &site;
+        site.callbacks.pfnAllocation = vulkanAllocate;
+        site.callbacks.pfnReallocation = vulkanReallocate;
+        site.callbacks.pfnFree = vulkanFree;
+        site.callbacks.pfnInternalAllocation = vulkanInternalAllocation;
+        site.callbacks.pfnInternalFree = vulkanInternalFree;
+    }
+    sites[UNSCOPED_INDEX].name.store(UNSCOPED_SITE, std::memory_order_relaxed);
+    sites[OVERFLOW_INDEX].name.store(OVERFLOW_SITE, std::memory_order_relaxed);
+    siteCount.store(2, std::memory_order_release);
+}
+
+uint32_t HostMemoryTracker::siteIndex(const char* site) {
+    uint32_t count = siteCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++) {
+        const char* name = sites[i].name.load(std::memory_order_relaxed);
+        if (name == site || std::strcmp(name, site) == 0) return i;
+    }
+
+    std::lock_guard<std::mutex> lock(registerMutex);
+    uint32_t registered = siteCount.load(std::memory_order_relaxed);
+    for (uint32_t i = count; i < registered; i++) {
+        if (std::strcmp(sites[i].name.load(std::memory_order_relaxed), site) == 0) return i;
+    }
+    if (registered == MAX_SITES) return OVERFLOW_INDEX;
+    sites[registered].name.store(site, std::memory_order_relaxed);
+    siteCount.store(registered + 1, std::memory_order_release);
+    return registered;
+}
+
+const VkAllocationCallbacks* HostMemoryTracker::vulkanCallbacks(const char* site) {
+    return &sites[siteIndex(site)].callbacks;
+}
+
+void HostMemoryTracker::onHeapAllocate(size_t size) {
+    Site& site = sites[currentSite];
+    site.heapCount.fetch_add(1, std::memory_order_relaxed);
+    site.heapBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+HostAllocationScope::HostAllocationScope(const char* site) : previous(currentSite) {
+    currentSite = HostMemoryTracker::global().siteIndex(site);
+}
+
+HostAllocationScope::~HostAllocationScope() {
+    currentSite = previous;
+}
+
+void HostAllocationScope::enter(const char* site) {
+    currentSite = HostMemoryTracker::global().siteIndex(site);
+}
+
+//-------------------------------------------------------------------------
+// Vulkan callbacks
+//-------------------------------------------------------------------------
+
+void* VKAPI_PTR HostMemoryTracker::vulkanAllocate(void* userData, size_t size, size_t alignment,
+                                                  VkSystemAllocationScope scope) {
+    if (size == 0) return nullptr;
+    alignment = std::max(alignment, MIN_ALIGNMENT);
+    auto* raw = static_cast<unsigned char*>(std::malloc(size + alignment + sizeof(BlockHeader)));
+    if (!raw) return nullptr;   // the driver reports VK_ERROR_OUT_OF_HOST_MEMORY
+
+    uintptr_t first = reinterpret_cast<uintptr_t>(raw) + sizeof(BlockHeader);
+    auto* memory = reinterpret_cast<unsigned char*>((first + alignment - 1) & ~uintptr_t(alignment - 1));
+    Site& site = *static_cast<Site*>(userData);
+    BlockHeader* header = headerOf(memory);
+    header->size = size;
+    header->site = uint16_t(site.index);
+    header->scope = uint8_t(scope);
+    header->offset = uint32_t(memory - raw);
+
+    site.vulkanCount.fetch_add(1, std::memory_order_relaxed);
+    site.vulkanBytes.fetch_add(size, std::memory_order_relaxed);
+    site.vulkanLive.fetch_add(int64_t(size), std::memory_order_relaxed);
+    global().scopeLive[scope].fetch_add(int64_t(size), std::memory_order_relaxed);
+    return memory;
+}
+
+void* VKAPI_PTR HostMemoryTracker::vulkanReallocate(void* userData, void* original, size_t size, size_t alignment,
+                                                    VkSystemAllocationScope scope) {
+    if (!original) return vulkanAllocate(userData, size, alignment, scope);
+    if (size == 0) {
+        vulkanFree(userData, original);
+        return nullptr;
+    }
+    void* memory = vulkanAllocate(userData, size, alignment, scope);
+    if (!memory) return nullptr;   // the original stays valid
+    std::memcpy(memory, original, std::min(size, headerOf(original)->size));
+    vulkanFree(userData, original);
+    return memory;
+}
+
+void VKAPI_PTR HostMemoryTracker::vulkanFree(void*, void* memory) {
+    if (!memory) return;
+    // Credit the site that allocated the block, whichever callbacks free it.
+    BlockHeader* header = headerOf(memory);
+    HostMemoryTracker& tracker = global();
+    tracker.sites[header->site].vulkanLive.fetch_sub(int64_t(header->size), std::memory_order_relaxed);
+    tracker.scopeLive[header->scope].fetch_sub(int64_t(header->size), std::memory_order_relaxed);
+    std::free(static_cast<unsigned char*>(memory) - header->offset);
+}
+
+void VKAPI_PTR HostMemoryTracker::vulkanInternalAllocation(void* userData, size_t size, VkInternalAllocationType,
+                                                           VkSystemAllocationScope) {
+    static_cast<Site*>(userData)->vulkanInternal.fetch_add(int64_t(size), std::memory_order_relaxed);
+}
+
+void VKAPI_PTR HostMemoryTracker::vulkanInternalFree(void* userData, size_t size, VkInternalAllocationType,
+                                                     VkSystemAllocationScope) {
+    static_cast<Site*>(userData)->vulkanInternal.fetch_sub(int64_t(size), std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------
+// Reporting
+//-------------------------------------------------------------------------
+
+const HostSiteFrame* HostFrameAllocations::find(const char* name) const {
+    for (uint32_t i = 0; i < siteCount; i++) {
+        if (std::strcmp(sites[i].name, name) == 0) return &sites[i];
+    }
+    return nullptr;
+}
+
+void HostMemoryTracker::endFrame(HostFrameAllocations& frame) {
+    frame.count = 0;
+    frame.bytes = 0;
+    frame.siteCount = 0;
+
+    uint32_t count = siteCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++) {
+        const Site& site = sites[i];
+        SiteSnapshot now;
+        now.heapCount = site.heapCount.load(std::memory_order_relaxed);
+        now.heapBytes = site.heapBytes.load(std::memory_order_relaxed);
+        now.vulkanCount = site.vulkanCount.load(std::memory_order_relaxed);
+        now.vulkanBytes = site.vulkanBytes.load(std::memory_order_relaxed);
+
+        HostSiteFrame delta;
+        delta.name = site.name.load(std::memory_order_relaxed);
+        delta.heapCount = uint32_t(now.heapCount - snapshot[i].heapCount);
+        delta.heapBytes = now.heapBytes - snapshot[i].heapBytes;
+        delta.vulkanCount = uint32_t(now.vulkanCount - snapshot[i].vulkanCount);
+        delta.vulkanBytes = now.vulkanBytes - snapshot[i].vulkanBytes;
+        snapshot[i] = now;
+
+        if (delta.count() == 0) continue;
+        frame.count += delta.count();
+        frame.bytes += delta.bytes();
+        frame.sites[frame.siteCount++] = delta;
+    }
+    std::sort(frame.sites, frame.sites + frame.siteCount, [](const HostSiteFrame& a, const HostSiteFrame& b) {
+        return a.count() > b.count();
+    });
+}
+
+uint64_t HostMemoryTracker::heapAllocations() const {
+    uint64_t total = 0;
+    for (const Site& site : sites) total += site.heapCount.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t HostMemoryTracker::heapBytes() const {
+    uint64_t total = 0;
+    for (const Site& site : sites) total += site.heapBytes.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t HostMemoryTracker::vulkanAllocations() const {
+    uint64_t total = 0;
+    for (const Site& site : sites) total += site.vulkanCount.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t HostMemoryTracker::vulkanLiveBytes() const {
+    int64_t total = 0;
+    for (const Site& site : sites) total += site.vulkanLive.load(std::memory_order_relaxed);
+    return uint64_t(std::max<int64_t>(total, 0));
+}
+
+std::string HostMemoryTracker::summary() const {
+    int64_t internal = 0;
+    for (const Site& site : sites) internal += site.vulkanInternal.load(std::memory_order_relaxed);
+
+    char text[256];
+    int length = std::snprintf(text, sizeof(text), "host memory: vulkan %.1f MiB live (", mib(int64_t(vulkanLiveBytes())));
+    for (uint32_t scope = 1; scope < 5; scope++) {   // command-scope blocks are gone by the next frame
+        length += std::snprintf(text + length, sizeof(text) - length, "%s%s %.1f", scope > 1 ? ", " : "",
+            SCOPE_NAMES[scope], mib(scopeLive[scope].load(std::memory_order_relaxed)));
+    }
+    length += std::snprintf(text + length, sizeof(text) - length, "), %lld internal KiB",
+        (long long)(internal / 1024));
+    if (heapHookEnabled()) {
+        std::snprintf(text + length, sizeof(text) - length, ", heap %llu allocations",
+            (unsigned long long)heapAllocations());
+    }
+    return text;
+}
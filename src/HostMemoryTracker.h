@@ -0,0 +1,149 @@
+// src/HostMemoryTracker.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// One site's allocations over a frame.
+struct HostSiteFrame {
+    const char* name = "";
+    uint32_t    heapCount = 0;
+    uint64_t    heapBytes = 0;
+    uint32_t    vulkanCount = 0;
+    uint64_t    vulkanBytes = 0;
+
+    uint32_t count() const { return heapCount + vulkanCount; }
+    uint64_t bytes() const { return heapBytes + vulkanBytes; }
+};
+
+// Host allocations made between two HostMemoryTracker::endFrame() calls.
+struct HostFrameAllocations {
+    static constexpr uint32_t MAX_SITES = 64;
+
+    uint32_t      count = 0;
+    uint64_t      bytes = 0;
+    uint32_t      siteCount = 0;          // sites that allocated, most allocations first
+    HostSiteFrame sites[MAX_SITES];
+
+    // nullptr when `name` did not allocate this frame.
+    const HostSiteFrame* find(const char* name) const;
+};
+
+// Host (CPU) memory telemetry, by site. A site is a string literal naming
+// either the code that created a Vulkan object or a HostAllocationScope.
+//
+// Vulkan: every vkCreate*/vkAllocate*/vkDestroy*/vkFree* gets vulkanCallbacks(site),
+// which routes the driver's host allocations through malloc with a small header
+// and credits them to that site. Commands that allocate later (submits, command
+// buffer allocation) use the callbacks of the object they run on, so their
+// allocations land on the device's or the pool's site.
+//
+// Heap: in executables that compile src/HostAllocationHook.cpp every global
+// operator new is credited to the innermost HostAllocationScope of the
+// allocating thread, or "unscoped". Without it only Vulkan allocations count.
+//
+// Counting is a few relaxed atomics; nothing on the allocation path allocates.
+// endFrame() turns the running totals into per-frame numbers.
+class HostMemoryTracker {
+public:
+    static constexpr uint32_t MAX_SITES = HostFrameAllocations::MAX_SITES;
+    static HostMemoryTracker& global();
+
+    HostMemoryTracker();
+    HostMemoryTracker(const HostMemoryTracker&) = delete;
+    HostMemoryTracker& operator=(const HostMemoryTracker&) = delete;
+
+    // Callbacks crediting `site`. The same site always returns the same pointer,
+    // valid for the life of the process; any site can free what another allocated.
+    const VkAllocationCallbacks* vulkanCallbacks(const char* site);
+
+    // Index of `site` in the table, registering it on first use. Sites past
+    // MAX_SITES share the "other" slot.
+    uint32_t siteIndex(const char* site);
+    void onHeapAllocate(size_t size);   // credits the calling thread's scope
+
+    // Fills `frame` with the allocations since the previous call. Call from one
+    // thread only (the render thread, once per frame).
+    void endFrame(HostFrameAllocations& frame);
+
+    // Whether the operator new hook is linked in; it registers itself during
+    // static initialization.
+    bool heapHookEnabled() const { return heapHook.load(std::memory_order_relaxed); }
+    void setHeapHookEnabled() { heapHook.store(true, std::memory_order_relaxed); }
+
+    // Running totals since startup.
+    uint64_t heapAllocations() const;
+    uint64_t heapBytes() const;
+    uint64_t vulkanAllocations() const;
+    uint64_t vulkanLiveBytes() const;
+
+    // One line for the periodic stats dump, e.g.
+    // "host memory: vulkan 3.1 MiB live (object 2.8, cache 0.1, device 0.2, instance 0.0), 5 internal KiB, heap 41234 allocations".
+    std::string summary() const;
+
+private:
+    friend class HostAllocationScope;
+
+    struct alignas(64) Site {
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<uint64_t>    heapCount{ 0 };
+        std::atomic<uint64_t>    heapBytes{ 0 };
+        std::atomic<uint64_t>    vulkanCount{ 0 };
+        std::atomic<uint64_t>    vulkanBytes{ 0 };
+        std::atomic<int64_t>     vulkanLive{ 0 };
+        std::atomic<int64_t>     vulkanInternal{ 0 };
+        VkAllocationCallbacks    callbacks{};
+        uint32_t                 index = 0;
+    };
+    // What endFrame() saw last time, per site.
+    struct SiteSnapshot {
+        uint64_t heapCount = 0;
+        uint64_t heapBytes = 0;
+        uint64_t vulkanCount = 0;
+        uint64_t vulkanBytes = 0;
+    };
+
+    static void* VKAPI_PTR vulkanAllocate(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static void* VKAPI_PTR vulkanReallocate(void* userData, void* original, size_t size, size_t alignment,
+                                            VkSystemAllocationScope scope);
+    static void  VKAPI_PTR vulkanFree(void* userData, void* memory);
+    static void  VKAPI_PTR vulkanInternalAllocation(void* userData, size_t size, VkInternalAllocationType type,
+                                                    VkSystemAllocationScope scope);
+    static void  VKAPI_PTR vulkanInternalFree(void* userData, size_t size, VkInternalAllocationType type,
+                                              VkSystemAllocationScope scope);
+
+    Site                  sites[MAX_SITES];
+    std::atomic<uint32_t> siteCount{ 0 };
+    std::atomic<bool>     heapHook{ false };
+    std::mutex            registerMutex;   // registration only; lookups are lock-free
+    // Live Vulkan bytes by VkSystemAllocationScope (command, object, cache, device, instance).
+    std::atomic<int64_t>  scopeLive[5] = {};
+    SiteSnapshot          snapshot[MAX_SITES];
+};
+
+// Credits the calling thread's heap allocations to `site` (a string literal)
+// until it goes out of scope, then restores the enclosing scope. enter()
+// switches sites without nesting, for code that moves through phases.
+class HostAllocationScope {
+public:
+    explicit HostAllocationScope(const char* site);
+    ~HostAllocationScope();
+
+    HostAllocationScope(const HostAllocationScope&) = delete;
+    HostAllocationScope& operator=(const HostAllocationScope&) = delete;
+
+    void enter(const char* site);
+
+private:
+    uint32_t previous;
+};
+
+// Shorthand for HostMemoryTracker::global().vulkanCallbacks(site).
+inline const VkAllocationCallbacks* hostAllocator(const char* site) {
+    return HostMemoryTracker::global().vulkanCallbacks(site);
+}
@@ -0,0 +1,185 @@
+// src/InitGraph.cpp
+#include "InitGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Removes and returns the earliest-added step in `queue`.
+    InitGraph::StepId takeFirst(std::vector<InitGraph::StepId>& queue) {
+        auto first = std::min_element(queue.begin(), queue.end());
+        InitGraph::StepId id = *first;
+        queue.erase(first);
+        return id;
+    }
+}
+
+InitGraph::StepId InitGraph::add(const char* name, std::function<void()> fn,
+                                 std::initializer_list<StepId> dependencies, InitThread thread) {
+    StepId id = StepId(steps.size());
+    Step step;
+    step.name = name;
+    step.fn = std::move(fn);
+    step.thread = thread;
+    for (StepId dependency : dependencies) {
+        if (dependency == none) continue;
+        if (dependency >= id) {
+            throw std::runtime_error("init step depends on a step added after it!");
+        }
+        step.dependencies.push_back(dependency);
+        steps[dependency].dependents.push_back(id);
+    }
+    steps.push_back(std::move(step));
+    return id;
+}
+
+//-------------------------------------------------------------------------
+// Scheduling
+//-------------------------------------------------------------------------
+
+void InitGraph::run(uint32_t threads) {
+    const size_t count = steps.size();
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::max<uint32_t>(1, std::min<uint32_t>(threads, uint32_t(count)));
+    stepTimings.assign(count, InitStepTiming{});
+
+    std::mutex mutex;
+    std::condition_variable changed;   // a step finished or failed
+    std::vector<uint32_t> waitingOn(count);
+    std::vector<StepId> readyAny, readyMain;
+    size_t   finished = 0;
+    uint32_t running = 0;
+    std::exception_ptr error;
+
+    for (StepId id = 0; id < count; id++) {
+        waitingOn[id] = uint32_t(steps[id].dependencies.size());
+        if (waitingOn[id] == 0) (steps[id].thread == InitThread::Main ? readyMain : readyAny).push_back(id);
+    }
+
+    const Clock::time_point start = Clock::now();
+    auto sinceStart = [start](Clock::time_point t) {
+        return std::chrono::duration<double, std::milli>(t - start).count();
+    };
+
+    // Called and returns with the lock held; runs the step without it.
+    auto execute = [&](StepId id, uint32_t thread, std::unique_lock<std::mutex>& lock) {
+        running++;
+        lock.unlock();
+        Clock::time_point stepStart = Clock::now();
+        std::exception_ptr stepError;
+        try {
+            steps[id].fn();
+        }
+        catch (...) {
+            stepError = std::current_exception();
+        }
+        Clock::time_point stepEnd = Clock::now();
+        lock.lock();
+
+        running--;
+        finished++;
+        stepTimings[id] = { steps[id].name, sinceStart(stepStart), sinceStart(stepEnd), thread };
+        if (stepError) {
+            if (!error) error = stepError;
+        }
+        else {
+            for (StepId dependent : steps[id].dependents) {
+                if (--waitingOn[dependent] == 0) {
+                    (steps[dependent].thread == InitThread::Main ? readyMain : readyAny).push_back(dependent);
+                }
+            }
+        }
+        changed.notify_all();
+    };
+
+    std::vector<std::thread> workers;
+    for (uint32_t thread = 1; thread < threadCount; thread++) {
+        workers.emplace_back([&, thread] {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                changed.wait(lock, [&] { return error || finished == count || !readyAny.empty(); });
+                if (error || finished == count) return;
+                execute(takeFirst(readyAny), thread, lock);
+            }
+        });
+    }
+
+    {
+        // The caller owns the main-thread steps and helps with the rest. Alone,
+        // it takes steps strictly in the order they were added.
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            changed.wait(lock, [&] {
+                if (error) return running == 0;
+                return finished == count || !readyMain.empty() || !readyAny.empty();
+            });
+            if (error || finished == count) break;
+
+            bool main = !readyMain.empty();
+            if (main && threadCount == 1 && !readyAny.empty()) {
+                main = *std::min_element(readyMain.begin(), readyMain.end()) <
+                       *std::min_element(readyAny.begin(), readyAny.end());
+            }
+            execute(takeFirst(main ? readyMain : readyAny), 0, lock);
+        }
+    }
+    for (std::thread& worker : workers) worker.join();
+    wallMs = sinceStart(Clock::now());
+
+    if (error) std::rethrow_exception(error);
+}
+
+//-------------------------------------------------------------------------
+// Report
+//-------------------------------------------------------------------------
+
+std::string InitGraph::report() const {
+    if (stepTimings.empty()) return "startup: no steps";
+
+    double stepMs = 0.0;
+    size_t nameWidth = 4;
+    StepId last = 0;
+    for (StepId id = 0; id < stepTimings.size(); id++) {
+        const InitStepTiming& timing = stepTimings[id];
+        stepMs += timing.endMs - timing.startMs;
+        nameWidth = std::max(nameWidth, std::char_traits<char>::length(timing.name));
+        if (timing.endMs > stepTimings[last].endMs) last = id;
+    }
+
+    // Walk back from the step that finished last through whichever dependency
+    // released it (the one that finished last).
+    std::vector<StepId> path{ last };
+    for (;;) {
+        const std::vector<StepId>& dependencies = steps[path.back()].dependencies;
+        if (dependencies.empty()) break;
+        path.push_back(*std::max_element(dependencies.begin(), dependencies.end(), [this](StepId a, StepId b) {
+            return stepTimings[a].endMs < stepTimings[b].endMs;
+        }));
+    }
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "startup %.1f ms on %u threads (%.1f ms of steps)\n  critical path:",
+        wallMs, threadCount, stepMs);
+    std::string text = line;
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        text += it == path.rbegin() ? " " : " > ";
+        text += stepTimings[*it].name;
+    }
+    for (const InitStepTiming& timing : stepTimings) {
+        char thread[24];
+        if (timing.thread == 0) std::snprintf(thread, sizeof(thread), "main");
+        else std::snprintf(thread, sizeof(thread), "worker %u", timing.thread);
+        std::snprintf(line, sizeof(line), "\n  %-*s %8.1f - %8.1f ms  %s", int(nameWidth), timing.name,
+            timing.startMs, timing.endMs, thread);
+        text += line;
+    }
+    return text;
+}
@@ -0,0 +1,64 @@
+// src/InitGraph.h
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// Where a step may run: anywhere, or only on the thread that calls run()
+// (window-system calls, or anything else tied to the main thread).
+enum class InitThread : uint8_t { Any, Main };
+
+struct InitStepTiming {
+    const char* name = "";
+    double      startMs = 0.0;   // since run() started
+    double      endMs = 0.0;
+    uint32_t    thread = 0;      // 0 is the caller
+};
+
+// Startup as a dependency graph. Steps are added in an order that already
+// respects their dependencies (a step can only depend on steps added before
+// it), then run() starts every step as soon as the ones it depends on have
+// finished, on a few short-lived threads plus the caller. That order is also
+// the serial fallback, so run(1) behaves exactly like the straight-line code.
+//
+// A step that throws stops new steps from starting; run() waits for the
+// running ones and rethrows the first exception on the caller.
+class InitGraph {
+public:
+    using StepId = uint32_t;
+    static constexpr StepId none = ~0u;   // ignored in dependency lists
+
+    // `name` must be a string literal. Dependencies equal to `none` are skipped,
+    // so optional steps can be depended on unconditionally.
+    StepId add(const char* name, std::function<void()> fn, std::initializer_list<StepId> dependencies = {},
+               InitThread thread = InitThread::Any);
+
+    // Runs every step; 0 threads uses every hardware thread, 1 runs all of them
+    // on the caller in the order they were added.
+    void run(uint32_t threads = 0);
+
+    // Filled by run(), in the order the steps were added.
+    const std::vector<InitStepTiming>& timings() const { return stepTimings; }
+    double   totalMs() const { return wallMs; }
+    uint32_t threadsUsed() const { return threadCount; }
+
+    // Wall time, summed step time, the critical path and one line per step.
+    std::string report() const;
+
+private:
+    struct Step {
+        const char*           name;
+        std::function<void()> fn;
+        std::vector<StepId>   dependencies;
+        std::vector<StepId>   dependents;
+        InitThread            thread = InitThread::Any;
+    };
+
+    std::vector<Step>           steps;
+    std::vector<InitStepTiming> stepTimings;
+    double   wallMs = 0.0;
+    uint32_t threadCount = 0;
+};
@@ -0,0 +1,113 @@
+// src/InputSystem.cpp
+#include "InputSystem.h"
+
+namespace {
+    // A few seconds of very fast mouse movement between two simulation steps.
+    const size_t EVENT_QUEUE_CAPACITY = 4096;
+}
+
+InputSystem::InputSystem()
+    : epoch(std::chrono::steady_clock::now())
+    , queue(EVENT_QUEUE_CAPACITY) {
+}
+
+double InputSystem::now() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+//-------------------------------------------------------------------------
+// Producer (GLFW callbacks)
+//-------------------------------------------------------------------------
+
+void InputSystem::push(const InputEvent& event) {
+    if (!queue.push(event)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void InputSystem::onKey(int key, int action) {
+    InputEvent e;
+    e.type = InputEvent::Type::Key;
+    e.code = key;
+    e.action = action;
+    e.time = now();
+    push(e);
+}
+
+void InputSystem::onMouseButton(int button, int action) {
+    InputEvent e;
+    e.type = InputEvent::Type::MouseButton;
+    e.code = button;
+    e.action = action;
+    e.time = now();
+    push(e);
+}
+
+void InputSystem::onCursorMove(double x, double y) {
+    cursorX.store(x, std::memory_order_relaxed);
+    cursorY.store(y, std::memory_order_relaxed);
+
+    InputEvent e;
+    e.type = InputEvent::Type::CursorMove;
+    e.x = x;
+    e.y = y;
+    e.time = now();
+    push(e);
+}
+
+void InputSystem::onScroll(double dx, double dy) {
+    InputEvent e;
+    e.type = InputEvent::Type::Scroll;
+    e.x = dx;
+    e.y = dy;
+    e.time = now();
+    push(e);
+}
+
+//-------------------------------------------------------------------------
+// Consumer (simulation)
+//-------------------------------------------------------------------------
+
+void InputSystem::beginStep(double stepEnd) {
+    current.keysPressed.reset();
+    current.cursorDeltaX = 0.0;
+    current.cursorDeltaY = 0.0;
+    current.scroll = 0.0;
+
+    // Events after stepEnd stay queued for a later step.
+    while (const InputEvent* e = queue.peek()) {
+        if (e->time > stepEnd) break;
+
+        switch (e->type) {
+        case InputEvent::Type::Key:
+            if (e->code >= 0 && e->code <= GLFW_KEY_LAST) {
+                if (e->action == GLFW_PRESS) {
+                    current.keys.set(e->code);
+                    current.keysPressed.set(e->code);
+                }
+                else if (e->action == GLFW_RELEASE) {
+                    current.keys.reset(e->code);
+                }
+            }
+            break;
+        case InputEvent::Type::MouseButton:
+            if (e->code >= 0 && e->code <= GLFW_MOUSE_BUTTON_LAST) {
+                current.buttons.set(e->code, e->action == GLFW_PRESS);
+            }
+            break;
+        case InputEvent::Type::CursorMove:
+            if (cursorSeen) {
+                current.cursorDeltaX += e->x - current.cursorX;
+                current.cursorDeltaY += e->y - current.cursorY;
+            }
+            cursorSeen = true;
+            current.cursorX = e->x;
+            current.cursorY = e->y;
+            break;
+        case InputEvent::Type::Scroll:
+            current.scroll += e->y;
+            break;
+        }
+        queue.pop();
+    }
+}
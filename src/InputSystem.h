@@ -0,0 +1,82 @@
+// src/InputSystem.h
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+
+#include "SpscQueue.h"
+
+// One GLFW input callback, stamped with the time it was received.
+struct InputEvent {
+    enum class Type : uint8_t { Key, MouseButton, CursorMove, Scroll };
+
+    Type   type = Type::Key;
+    int    code = 0;        // GLFW key or mouse button
+    int    action = 0;      // GLFW_PRESS / GLFW_RELEASE / GLFW_REPEAT
+    double x = 0.0, y = 0.0;  // cursor position or scroll offsets
+    double time = 0.0;      // seconds on InputSystem::now()'s clock
+};
+
+// Input as seen by one fixed simulation step.
+struct InputState {
+    std::bitset<GLFW_KEY_LAST + 1>          keys;
+    std::bitset<GLFW_KEY_LAST + 1>          keysPressed;   // went down during this step
+    std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> buttons;
+    double cursorX = 0.0, cursorY = 0.0;   // after the last event consumed
+    double cursorDeltaX = 0.0, cursorDeltaY = 0.0;
+    double scroll = 0.0;
+
+    bool keyDown(int key) const { return key >= 0 && key <= GLFW_KEY_LAST && keys.test(key); }
+    bool keyPressed(int key) const { return key >= 0 && key <= GLFW_KEY_LAST && keysPressed.test(key); }
+    bool buttonDown(int button) const {
+        return button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST && buttons.test(button);
+    }
+};
+
+// Input subsystem. GLFW callbacks (main thread) push timestamped events into a
+// lock-free SPSC queue. The simulation consumes them per fixed step: beginStep(t)
+// applies exactly the events received before t, so replaying the same event
+// stream gives the same simulation regardless of frame rate.
+//
+// The latest cursor position and look-button state are also published through
+// atomics, so the renderer can sample them just before recording a frame.
+class InputSystem {
+public:
+    InputSystem();
+
+    // Seconds since construction; the clock event times and steps use.
+    double now() const;
+
+    // Called from the GLFW callbacks.
+    void onKey(int key, int action);
+    void onMouseButton(int button, int action);
+    void onCursorMove(double x, double y);
+    void onScroll(double dx, double dy);
+
+    // Consumer: applies every queued event stamped before `stepEnd`.
+    void beginStep(double stepEnd);
+    const InputState& state() const { return current; }
+
+    // Latest cursor position, updated by every cursor callback.
+    double latestCursorX() const { return cursorX.load(std::memory_order_relaxed); }
+    double latestCursorY() const { return cursorY.load(std::memory_order_relaxed); }
+
+    // Events dropped because the queue was full.
+    uint64_t droppedEvents() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    void push(const InputEvent& event);
+
+    std::chrono::steady_clock::time_point epoch;
+    SpscQueue<InputEvent> queue;
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<double>   cursorX{ 0.0 };
+    std::atomic<double>   cursorY{ 0.0 };
+
+    InputState current;   // consumer-owned
+    bool cursorSeen = false;   // the first cursor event sets the position without a delta
+};
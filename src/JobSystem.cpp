@@ -0,0 +1,93 @@
+// src/JobSystem.cpp
+#include "JobSystem.h"
+
+#include <algorithm>
+
+void JobSystem::init(uint32_t threads) {
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    uint32_t workerCount = threads - 1;
+    stopping = false;
+    workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+    }
+}
+
+void JobSystem::cleanup() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void JobSystem::run(uint32_t count, uint32_t grain, RangeFn fn, void* body) {
+    if (count == 0) return;
+    grain = std::max(grain, 1u);
+
+    // Not worth waking anyone for a single chunk.
+    if (workers.empty() || count <= grain) {
+        fn(body, 0, count, 0);
+        return;
+    }
+
+    {
+        // A worker that woke too late for the previous loop may still be on its
+        // way out of drain(); it must not see these fields change under it.
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return busyWorkers == 0; });
+        loopFn = fn;
+        loopBody = body;
+        loopCount = count;
+        loopGrain = grain;
+        loopChunks = (count + grain - 1) / grain;
+        nextChunk.store(0, std::memory_order_relaxed);
+        chunksDone.store(0, std::memory_order_relaxed);
+        generation++;
+    }
+    wake.notify_all();
+
+    drain(0);
+
+    // Chunks a worker claimed may still be running.
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] {
+        return busyWorkers == 0 && chunksDone.load(std::memory_order_acquire) == loopChunks;
+    });
+}
+
+void JobSystem::workerLoop(uint32_t thread) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+
+        busyWorkers++;
+        lock.unlock();
+        drain(thread);
+        lock.lock();
+        if (--busyWorkers == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+void JobSystem::drain(uint32_t thread) {
+    for (;;) {
+        uint32_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= loopChunks) return;
+
+        uint32_t begin = chunk * loopGrain;
+        uint32_t end = std::min(begin + loopGrain, loopCount);
+        loopFn(loopBody, begin, end, thread);
+        chunksDone.fetch_add(1, std::memory_order_release);
+    }
+}
@@ -0,0 +1,69 @@
+// src/JobSystem.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed pool of worker threads for data-parallel loops on the frame's critical path.
+//
+// parallelFor() splits [0, count) into chunks of `grain` items that the workers
+// and the calling thread take from a shared atomic counter, so uneven chunks
+// balance themselves and the caller never sits idle while work is left. It
+// returns once every chunk has run; workers sleep on a condition variable in
+// between. One loop runs at a time: parallelFor() is meant to be called from a
+// single thread (the render thread) and must not be nested. Dispatching
+// allocates nothing.
+class JobSystem {
+public:
+    // Starts threads - 1 workers (the caller is the last thread); 0 uses every
+    // hardware thread. One thread runs every loop inline on the caller.
+    void init(uint32_t threads = 0);
+    void cleanup();
+
+    // Threads that run chunks, the caller included. Thread indices passed to
+    // parallelFor() bodies are below this (the caller is 0), so per-thread
+    // scratch can be indexed by them.
+    uint32_t threadCount() const { return uint32_t(workers.size()) + 1; }
+
+    // Calls fn(begin, end, thread) for consecutive ranges covering [0, count).
+    // fn must not throw.
+    template <typename Fn>
+    void parallelFor(uint32_t count, uint32_t grain, Fn&& fn) {
+        using Body = std::remove_reference_t<Fn>;
+        run(count, grain, [](void* body, uint32_t begin, uint32_t end, uint32_t thread) {
+            (*static_cast<Body*>(body))(begin, end, thread);
+        }, const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+private:
+    using RangeFn = void (*)(void* body, uint32_t begin, uint32_t end, uint32_t thread);
+
+    void run(uint32_t count, uint32_t grain, RangeFn fn, void* body);
+    void workerLoop(uint32_t thread);
+    // Runs chunks of the current loop until none are left.
+    void drain(uint32_t thread);
+
+    std::vector<std::thread> workers;
+
+    std::mutex              mutex;
+    std::condition_variable wake;      // a new loop was published, or stopping
+    std::condition_variable finished;  // a worker left drain()
+    uint64_t generation = 0;           // loops published so far (guarded by mutex)
+    uint32_t busyWorkers = 0;          // workers inside drain() (guarded by mutex)
+    bool     stopping = false;
+
+    // The loop being run. Written under the mutex before `generation` moves and
+    // left alone until every worker is out of drain() again.
+    RangeFn  loopFn = nullptr;
+    void*    loopBody = nullptr;
+    uint32_t loopCount = 0;
+    uint32_t loopGrain = 1;
+    uint32_t loopChunks = 0;
+    std::atomic<uint32_t> nextChunk{ 0 };
+    std::atomic<uint32_t> chunksDone{ 0 };
+};
@@ -0,0 +1,608 @@
+// src/LodScene.cpp
+#include "LodScene.h"
+#include "HostMemoryTracker.h"
+#include "Device.h"
+#include "Camera.h"
+#include "DepthPyramid.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+namespace {
+    const float  INSTANCE_SPACING = 6.0f;
+    const uint32_t GROUP_SIZE = 8;          // rocks per side of one cluster node
+    const uint32_t SPINNING_GROUP_EVERY = 16;
+    const float  LOD_HYSTERESIS = 0.25f;
+    const char*  ROCK_CACHE_PATH = "lod_cache/rock.lod";
+
+    struct PushConstants {
+        float viewProj[16];
+        float lightDirTint[4];   // xyz = direction towards the light, w = 1 to tint by LOD
+    };
+    static_assert(sizeof(PushConstants) == LodScene::pushConstantSize, "lod push constant size mismatch");
+
+    // std140 mirror of `Cull` in lod_cull.comp.
+    struct CullUniforms {
+        float    viewProj[16];
+        float    occlusionViewProj[16];
+        float    bounds[4];        // object-space bounding sphere: center, radius
+        float    pyramidSize[4];   // level 0 width, height, level count, 0
+        uint32_t counts[4];        // instances, occlusion test enabled, 0, 0
+    };
+
+    const uint32_t CULL_GROUP_SIZE = 64;   // local_size_x in lod_cull.comp
+    const uint32_t CULL_BINDING_COUNT = 5; // uniforms, instances, visible, draws, pyramid
+
+    // Shadow casters use a fixed LOD per cascade instead of the camera's choice, so a
+    // cached layer stays valid however the selection changes: SHADOW_LOD + cascade.
+    const uint32_t SHADOW_LOD = 2;
+}
+
+//-------------------------------------------------------------------------
+// Init & cleanup
+//-------------------------------------------------------------------------
+
+void LodScene::init(Device& dev, uint32_t gridSize, float errorThresholdPixels, uint32_t framesInFlight,
+                    DepthPyramid* occlusion, bool shadowCasters_) {
+    device = &dev;
+    pyramid = occlusion;
+    shadowCasters = shadowCasters_;
+    selector.configure(errorThresholdPixels, LOD_HYSTERESIS);
+
+    createGeometry();
+    createInstances(gridSize);
+    createDescriptors(framesInFlight);
+    if (pyramid) {
+        createCulling(framesInFlight);
+    }
+    if (shadowCasters) {
+        createShadowCasters(framesInFlight);
+    }
+}
+
+void LodScene::cleanup() {
+    VkDevice dev = device->device();
+
+    if (shadowCasters) {
+        vkDestroyDescriptorPool(dev, casterPool, hostAllocator("LodScene"));
+        for (size_t i = 0; i < dynamicCasterBuffers.size(); i++) {
+            vkUnmapMemory(dev, dynamicCasterMemory[i]);
+            vkDestroyBuffer(dev, dynamicCasterBuffers[i], hostAllocator("LodScene"));
+            device->freeMemory(dynamicCasterMemory[i]);
+        }
+        dynamicCasterBuffers.clear();
+        if (staticCasterBuffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(dev, staticCasterBuffer, hostAllocator("LodScene"));
+            device->freeMemory(staticCasterMemory);
+        }
+    }
+
+    if (pyramid) {
+        cullPipeline.cleanup();
+        vkDestroyDescriptorPool(dev, cullPool, hostAllocator("LodScene"));
+        vkDestroyDescriptorSetLayout(dev, cullSetLayout, hostAllocator("LodScene"));
+        for (size_t i = 0; i < cullUniformBuffers.size(); i++) {
+            vkUnmapMemory(dev, cullUniformMemory[i]);
+            vkDestroyBuffer(dev, cullUniformBuffers[i], hostAllocator("LodScene"));
+            device->freeMemory(cullUniformMemory[i]);
+
+            vkUnmapMemory(dev, drawCommandMemory[i]);
+            vkDestroyBuffer(dev, drawCommandBuffers[i], hostAllocator("LodScene"));
+            device->freeMemory(drawCommandMemory[i]);
+
+            vkDestroyBuffer(dev, visibleBuffers[i], hostAllocator("LodScene"));
+            device->freeMemory(visibleMemory[i]);
+        }
+        cullUniformBuffers.clear();
+    }
+
+    vkDestroyDescriptorPool(dev, descriptorPool, hostAllocator("LodScene"));
+    vkDestroyDescriptorSetLayout(dev, descriptorSetLayout, hostAllocator("LodScene"));
+
+    for (size_t i = 0; i < instanceBuffers.size(); i++) {
+        vkUnmapMemory(dev, instanceMemory[i]);
+        vkDestroyBuffer(dev, instanceBuffers[i], hostAllocator("LodScene"));
+        device->freeMemory(instanceMemory[i]);
+    }
+    instanceBuffers.clear();
+
+    vkDestroyBuffer(dev, indexBuffer, hostAllocator("LodScene"));
+    device->freeMemory(indexMemory);
+    vkDestroyBuffer(dev, vertexBuffer, hostAllocator("LodScene"));
+    device->freeMemory(vertexMemory);
+}
+
+void LodScene::createGeometry() {
+    // 20480 triangles at LOD 0; the chain comes from the offline cache when it is current.
+    MeshData mesh = createRockMesh(5, 7);
+
+    std::vector<uint32_t> indices;
+    rock = loadOrBuildLodChain(ROCK_CACHE_PATH, mesh, indices);
+
+    device->createDeviceLocalBuffer(mesh.vertices.data(), mesh.vertices.size() * sizeof(MeshVertex),
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexMemory, GpuMemoryCategory::Mesh);
+    device->createDeviceLocalBuffer(indices.data(), indices.size() * sizeof(uint32_t),
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexMemory, GpuMemoryCategory::Mesh);
+
+    drawRanges.resize(rock.lods.size());
+}
+
+void LodScene::createInstances(uint32_t gridSize) {
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const Vec3 up{ 0.0f, 1.0f, 0.0f };
+
+    // Cluster nodes first, then one child per rock positioned relative to its cluster.
+    uint32_t groupsPerSide = (gridSize + GROUP_SIZE - 1) / GROUP_SIZE;
+    float half = float(gridSize - 1) * 0.5f;
+    float groupExtent = float(GROUP_SIZE) * INSTANCE_SPACING;
+
+    std::vector<TransformHierarchy::NodeId> groups(size_t(groupsPerSide) * groupsPerSide);
+    std::vector<bool> groupSpins(groups.size(), false);
+    std::vector<Vec3> groupCenters(groups.size());
+    for (uint32_t gz = 0; gz < groupsPerSide; gz++) {
+        for (uint32_t gx = 0; gx < groupsPerSide; gx++) {
+            size_t g = size_t(gz) * groupsPerSide + gx;
+            groupCenters[g] = Vec3{ (float(gx) + 0.5f) * groupExtent - (half + 0.5f) * INSTANCE_SPACING, 0.0f,
+                                    (float(gz) + 0.5f) * groupExtent - (half + 0.5f) * INSTANCE_SPACING };
+            groups[g] = transforms.createNode();
+            transforms.setLocalPosition(groups[g], groupCenters[g]);
+            if (g % SPINNING_GROUP_EVERY == 0) {
+                spinningGroups.push_back(groups[g]);
+                groupSpins[g] = true;
+            }
+        }
+    }
+
+    rockNodes.resize(size_t(gridSize) * gridSize);
+    rockSpins.resize(rockNodes.size());
+    currentLods.assign(rockNodes.size(), 0);
+    for (uint32_t z = 0; z < gridSize; z++) {
+        for (uint32_t x = 0; x < gridSize; x++) {
+            size_t g = size_t(z / GROUP_SIZE) * groupsPerSide + x / GROUP_SIZE;
+            float scale = 0.6f + 1.9f * unit(rng) * unit(rng);
+            Vec3 position{
+                (float(x) - half + (unit(rng) - 0.5f)) * INSTANCE_SPACING - groupCenters[g].x,
+                scale * 0.4f,
+                (float(z) - half + (unit(rng) - 0.5f)) * INSTANCE_SPACING - groupCenters[g].z };
+
+            TransformHierarchy::NodeId node = transforms.createNode(groups[g]);
+            transforms.setLocalTransform(node, position, Quat::fromAxisAngle(up, unit(rng) * 6.2831853f),
+                Vec3{ scale, scale, scale });
+            rockNodes[size_t(z) * gridSize + x] = node;
+            rockSpins[size_t(z) * gridSize + x] = groupSpins[g];
+        }
+    }
+}
+
+void LodScene::createDescriptors(uint32_t framesInFlight) {
+    VkDevice dev = device->device();
+    VkDeviceSize instanceBytes = rockNodes.size() * sizeof(GpuInstance);
+
+    instanceBuffers.resize(framesInFlight);
+    instanceMemory.resize(framesInFlight);
+    instanceMapped.resize(framesInFlight);
+    for (uint32_t i = 0; i < framesInFlight; i++) {
+        device->createBuffer(instanceBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            instanceBuffers[i], instanceMemory[i]);
+        vkMapMemory(dev, instanceMemory[i], 0, VK_WHOLE_SIZE, 0, &instanceMapped[i]);
+    }
+
+    // With GPU culling lod.vert reads the compacted survivors instead.
+    if (pyramid) {
+        visibleBuffers.resize(framesInFlight);
+        visibleMemory.resize(framesInFlight);
+        for (uint32_t i = 0; i < framesInFlight; i++) {
+            device->createBuffer(instanceBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, visibleBuffers[i], visibleMemory[i]);
+        }
+    }
+
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+    if (vkCreateDescriptorSetLayout(dev, &layoutInfo, hostAllocator("LodScene"), &descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create LOD scene descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, framesInFlight };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = framesInFlight;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(dev, &poolInfo, hostAllocator("LodScene"), &descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create LOD scene descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(framesInFlight, descriptorSetLayout);
+    descriptorSets.resize(framesInFlight);
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = framesInFlight;
+    allocInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(dev, &allocInfo, descriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate LOD scene descriptor sets!");
+    }
+
+    for (uint32_t i = 0; i < framesInFlight; i++) {
+        VkDescriptorBufferInfo info{ pyramid ? visibleBuffers[i] : instanceBuffers[i], 0, VK_WHOLE_SIZE };
+        VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.dstSet = descriptorSets[i];
+        write.dstBinding = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &info;
+        vkUpdateDescriptorSets(dev, 1, &write, 0, nullptr);
+    }
+}
+
+void LodScene::createCulling(uint32_t framesInFlight) {
+    VkDevice dev = device->device();
+    const VkMemoryPropertyFlags hostVisible =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    VkDeviceSize commandBytes = drawRanges.size() * sizeof(VkDrawIndexedIndirectCommand);
+
+    cullUniformBuffers.resize(framesInFlight);
+    cullUniformMemory.resize(framesInFlight);
+    cullUniformMapped.resize(framesInFlight);
+    drawCommandBuffers.resize(framesInFlight);
+    drawCommandMemory.resize(framesInFlight);
+    drawCommandMapped.resize(framesInFlight);
+    for (uint32_t i = 0; i < framesInFlight; i++) {
+        device->createBuffer(sizeof(CullUniforms), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            hostVisible, cullUniformBuffers[i], cullUniformMemory[i]);
+        vkMapMemory(dev, cullUniformMemory[i], 0, VK_WHOLE_SIZE, 0, &cullUniformMapped[i]);
+
+        // Host-visible so update() can write the commands and read back last use's counts.
+        device->createBuffer(commandBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            hostVisible, drawCommandBuffers[i], drawCommandMemory[i]);
+        vkMapMemory(dev, drawCommandMemory[i], 0, VK_WHOLE_SIZE, 0, &drawCommandMapped[i]);
+        std::memset(drawCommandMapped[i], 0, size_t(commandBytes));
+    }
+
+    VkDescriptorSetLayoutBinding bindings[CULL_BINDING_COUNT]{};
+    for (uint32_t b = 0; b < CULL_BINDING_COUNT; b++) {
+        bindings[b].binding = b;
+        bindings[b].descriptorCount = 1;
+        bindings[b].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        bindings[b].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    }
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[4].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.bindingCount = CULL_BINDING_COUNT;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(dev, &layoutInfo, hostAllocator("LodScene"), &cullSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create LOD culling descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSizes[3] = {
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, framesInFlight },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, framesInFlight * 3 },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, framesInFlight },
+    };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = framesInFlight;
+    poolInfo.poolSizeCount = 3;
+    poolInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(dev, &poolInfo, hostAllocator("LodScene"), &cullPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create LOD culling descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(framesInFlight, cullSetLayout);
+    cullSets.resize(framesInFlight);
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = cullPool;
+    allocInfo.descriptorSetCount = framesInFlight;
+    allocInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(dev, &allocInfo, cullSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate LOD culling descriptor sets!");
+    }
+
+    for (uint32_t i = 0; i < framesInFlight; i++) {
+        VkDescriptorBufferInfo infos[4] = {
+            { cullUniformBuffers[i], 0, VK_WHOLE_SIZE },
+            { instanceBuffers[i],    0, VK_WHOLE_SIZE },
+            { visibleBuffers[i],     0, VK_WHOLE_SIZE },
+            { drawCommandBuffers[i], 0, VK_WHOLE_SIZE },
+        };
+
+        VkWriteDescriptorSet writes[4]{};
+        for (uint32_t b = 0; b < 4; b++) {
+            writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet = cullSets[i];
+            writes[b].dstBinding = b;
+            writes[b].descriptorCount = 1;
+            writes[b].descriptorType = bindings[b].descriptorType;
+            writes[b].pBufferInfo = &infos[b];
+        }
+        vkUpdateDescriptorSets(dev, 4, writes, 0, nullptr);
+    }
+    cullPyramidViews.assign(framesInFlight, VK_NULL_HANDLE);
+    for (uint32_t i = 0; i < framesInFlight; i++) {
+        writeCullPyramid(i);
+    }
+
+    cullPipeline.init(*device, "shaders_spv/lod_cull_comp.spv", { cullSetLayout });
+}
+
+void LodScene::writeCullPyramid(uint32_t frame) {
+    VkDescriptorImageInfo info{ pyramid->sampler(), pyramid->view(), VK_IMAGE_LAYOUT_GENERAL };
+    VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    write.dstSet = cullSets[frame];
+    write.dstBinding = 4;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &info;
+    vkUpdateDescriptorSets(device->device(), 1, &write, 0, nullptr);
+    cullPyramidViews[frame] = pyramid->view();
+}
+
+void LodScene::createShadowCasters(uint32_t framesInFlight) {
+    VkDevice dev = device->device();
+
+    // Still clusters never move: their world matrices are final once, here.
+    transforms.update();
+    std::vector<GpuInstance> staticInstances;
+    for (size_t i = 0; i < rockNodes.size(); i++) {
+        if (rockSpins[i]) {
+            dynamicCasterRocks.push_back(uint32_t(i));
+            continue;
+        }
+        GpuInstance inst{};
+        std::memcpy(inst.model, transforms.worldMatrix(rockNodes[i]).m, sizeof(inst.model));
+        staticInstances.push_back(inst);
+    }
+    staticCasterCount = uint32_t(staticInstances.size());
+    if (staticCasterCount > 0) {
+        device->createDeviceLocalBuffer(staticInstances.data(), staticInstances.size() * sizeof(GpuInstance),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, staticCasterBuffer, staticCasterMemory);
+    }
+
+    // Sized for at least one instance so every frame slot has a valid set.
+    VkDeviceSize dynamicBytes = std::max<size_t>(dynamicCasterRocks.size(), 1) * sizeof(GpuInstance);
+    dynamicCasterBuffers.resize(framesInFlight);
+    dynamicCasterMemory.resize(framesInFlight);
+    dynamicCasterMapped.resize(framesInFlight);
+    for (uint32_t i = 0; i < framesInFlight; i++) {
+        device->createBuffer(dynamicBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            dynamicCasterBuffers[i], dynamicCasterMemory[i]);
+        vkMapMemory(dev, dynamicCasterMemory[i], 0, VK_WHOLE_SIZE, 0, &dynamicCasterMapped[i]);
+    }
+
+    uint32_t setCount = framesInFlight + 1;
+    VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, setCount };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = setCount;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(dev, &poolInfo, hostAllocator("LodScene"), &casterPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create LOD shadow caster descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(setCount, descriptorSetLayout);
+    std::vector<VkDescriptorSet> sets(setCount);
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = casterPool;
+    allocInfo.descriptorSetCount = setCount;
+    allocInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(dev, &allocInfo, sets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate LOD shadow caster descriptor sets!");
+    }
+    staticCasterSet = sets[0];
+    dynamicCasterSets.assign(sets.begin() + 1, sets.end());
+
+    for (uint32_t i = 0; i < setCount; i++) {
+        VkBuffer buffer = i == 0 ? staticCasterBuffer : dynamicCasterBuffers[i - 1];
+        if (buffer == VK_NULL_HANDLE) continue;   // no static casters: the set is never bound
+
+        VkDescriptorBufferInfo info{ buffer, 0, VK_WHOLE_SIZE };
+        VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.dstSet = sets[i];
+        write.dstBinding = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &info;
+        vkUpdateDescriptorSets(dev, 1, &write, 0, nullptr);
+    }
+}
+
+std::vector<VkVertexInputBindingDescription> LodScene::vertexBindings() {
+    return { { 0, sizeof(MeshVertex), VK_VERTEX_INPUT_RATE_VERTEX } };
+}
+
+std::vector<VkVertexInputAttributeDescription> LodScene::vertexAttributes() {
+    return {
+        { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(MeshVertex, position) },
+        { 1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(MeshVertex, normal) },
+    };
+}
+
+//-------------------------------------------------------------------------
+// Per frame
+//-------------------------------------------------------------------------
+
+void LodScene::update(uint32_t frame, const Camera& camera, VkExtent2D extent, float time, FrameArena& arena) {
+    const Vec3 up{ 0.0f, 1.0f, 0.0f };
+    for (size_t i = 0; i < spinningGroups.size(); i++) {
+        float speed = 0.2f + 0.1f * float(i % 3);
+        transforms.setLocalRotation(spinningGroups[i], Quat::fromAxisAngle(up, time * speed));
+    }
+    transforms.update();
+
+    selector.setView(camera, float(extent.height));
+
+    // Pass 1: choose LODs and count instances per LOD.
+    for (DrawRange& range : drawRanges) range = DrawRange{};
+    for (size_t i = 0; i < rockNodes.size(); i++) {
+        const Mat4& model = transforms.worldMatrix(rockNodes[i]);
+        float scale = std::sqrt(model.m[0] * model.m[0] + model.m[1] * model.m[1] + model.m[2] * model.m[2]);
+        uint32_t lod = selector.select(rock, &model.m[12], scale, currentLods[i]);
+        currentLods[i] = lod;
+        drawRanges[lod].instanceCount++;
+    }
+
+    // Pass 2: counting sort into the mapped buffer so each LOD is one contiguous range.
+    uint32_t first = 0;
+    lastTriangleCount = 0;
+    for (size_t lod = 0; lod < drawRanges.size(); lod++) {
+        drawRanges[lod].firstInstance = first;
+        first += drawRanges[lod].instanceCount;
+        lastTriangleCount += uint64_t(drawRanges[lod].instanceCount) * (rock.lods[lod].indexCount / 3);
+    }
+
+    uint32_t* cursor = arena.allocateArray<uint32_t>(drawRanges.size());
+    for (size_t lod = 0; lod < drawRanges.size(); lod++) {
+        cursor[lod] = drawRanges[lod].firstInstance;
+    }
+
+    GpuInstance* out = static_cast<GpuInstance*>(instanceMapped[frame]);
+    for (size_t i = 0; i < rockNodes.size(); i++) {
+        GpuInstance& inst = out[cursor[currentLods[i]]++];
+        std::memcpy(inst.model, transforms.worldMatrix(rockNodes[i]).m, sizeof(inst.model));
+        inst.lod[0] = float(currentLods[i]);
+    }
+    lastVisibleCount = rockNodes.size();
+
+    if (shadowCasters) {
+        GpuInstance* casters = static_cast<GpuInstance*>(dynamicCasterMapped[frame]);
+        for (size_t i = 0; i < dynamicCasterRocks.size(); i++) {
+            std::memcpy(casters[i].model, transforms.worldMatrix(rockNodes[dynamicCasterRocks[i]]).m,
+                sizeof(casters[i].model));
+        }
+    }
+
+    if (!pyramid) return;
+
+    // The fence for this frame slot has signalled, so the counts its culling pass
+    // left in the draw commands are final: report those, then reset them.
+    VkDrawIndexedIndirectCommand* commands = static_cast<VkDrawIndexedIndirectCommand*>(drawCommandMapped[frame]);
+    lastTriangleCount = 0;
+    lastVisibleCount = 0;
+    for (size_t lod = 0; lod < drawRanges.size(); lod++) {
+        lastTriangleCount += uint64_t(commands[lod].instanceCount) * (rock.lods[lod].indexCount / 3);
+        lastVisibleCount += commands[lod].instanceCount;
+
+        commands[lod].indexCount = rock.lods[lod].indexCount;
+        commands[lod].instanceCount = 0;
+        commands[lod].firstIndex = rock.lods[lod].firstIndex;
+        commands[lod].vertexOffset = 0;
+        commands[lod].firstInstance = drawRanges[lod].firstInstance;
+    }
+
+    // A resize recreated the pyramid; this slot's set is idle once its fence signalled.
+    if (cullPyramidViews[frame] != pyramid->view()) {
+        writeCullPyramid(frame);
+    }
+
+    CullUniforms u{};
+    Mat4 viewProj = camera.viewProjection();
+    std::memcpy(u.viewProj, viewProj.m, sizeof(u.viewProj));
+    std::memcpy(u.occlusionViewProj, pyramid->viewProjection().m, sizeof(u.occlusionViewProj));
+    u.bounds[0] = rock.center[0];
+    u.bounds[1] = rock.center[1];
+    u.bounds[2] = rock.center[2];
+    u.bounds[3] = rock.radius;
+    u.pyramidSize[0] = float(pyramid->width());
+    u.pyramidSize[1] = float(pyramid->height());
+    u.pyramidSize[2] = float(pyramid->levelCount());
+    u.counts[0] = uint32_t(rockNodes.size());
+    u.counts[1] = pyramid->valid() ? 1u : 0u;
+    std::memcpy(cullUniformMapped[frame], &u, sizeof(u));
+}
+
+void LodScene::recordCulling(VkCommandBuffer commandBuffer, uint32_t frame) {
+    if (!pyramid) return;
+
+    // The pyramid was left readable by its last build; this slot's buffers were
+    // last used by a frame whose fence has signalled.
+    cullPipeline.bind(commandBuffer);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline.layout(),
+        0, 1, &cullSets[frame], 0, nullptr);
+    vkCmdDispatch(commandBuffer, (uint32_t(rockNodes.size()) + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    // Draws consume the counts and survivors; update() reads the counts back on the host.
+    VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+uint32_t LodScene::recordDraws(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frame,
+                               const Camera& camera, bool tintByLod, bool perInstance)
+{
+    PushConstants push{};
+    Mat4 viewProj = camera.viewProjection();
+    std::memcpy(push.viewProj, viewProj.m, sizeof(push.viewProj));
+    Vec3 light = lightDirection();
+    push.lightDirTint[0] = light.x;
+    push.lightDirTint[1] = light.y;
+    push.lightDirTint[2] = light.z;
+    push.lightDirTint[3] = tintByLod ? 1.0f : 0.0f;
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+        0, 1, &descriptorSets[frame], 0, nullptr);
+    vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        0, sizeof(push), &push);
+
+    // One instanced draw per LOD; gl_InstanceIndex includes firstInstance.
+    uint32_t draws = 0;
+    for (size_t lod = 0; lod < drawRanges.size(); lod++) {
+        const DrawRange& range = drawRanges[lod];
+        if (range.instanceCount == 0) continue;
+        if (pyramid) {
+            // Instance count written by recordCulling(); zero when every rock of this LOD was culled.
+            vkCmdDrawIndexedIndirect(commandBuffer, drawCommandBuffers[frame],
+                lod * sizeof(VkDrawIndexedIndirectCommand), 1, sizeof(VkDrawIndexedIndirectCommand));
+            draws++;
+            continue;
+        }
+        if (perInstance) {
+            for (uint32_t i = 0; i < range.instanceCount; i++) {
+                vkCmdDrawIndexed(commandBuffer, rock.lods[lod].indexCount, 1,
+                    rock.lods[lod].firstIndex, 0, range.firstInstance + i);
+            }
+            draws += range.instanceCount;
+            continue;
+        }
+        vkCmdDrawIndexed(commandBuffer, rock.lods[lod].indexCount, range.instanceCount,
+            rock.lods[lod].firstIndex, 0, range.firstInstance);
+        draws++;
+    }
+    return draws;
+}
+
+uint32_t LodScene::recordShadowCasters(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frame,
+                                       uint32_t cascade, bool staticCasters)
+{
+    uint32_t count = staticCasters ? staticCasterCount : uint32_t(dynamicCasterRocks.size());
+    if (!shadowCasters || count == 0) return 0;
+
+    VkDescriptorSet set = staticCasters ? staticCasterSet : dynamicCasterSets[frame];
+    const MeshLod& lod = rock.lods[std::min<size_t>(SHADOW_LOD + cascade, rock.lods.size() - 1)];
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &set, 0, nullptr);
+    vkCmdDrawIndexed(commandBuffer, lod.indexCount, count, lod.firstIndex, 0, 0);
+    return 1;
+}
@@ -0,0 +1,155 @@
+// src/LodScene.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+#include "MeshLod.h"
+#include "TransformHierarchy.h"
+#include "FrameArena.h"
+#include "ComputePipeline.h"
+
+class Device;
+class Camera;
+class DepthPyramid;
+
+// Large outdoor-style field of rock instances sharing one LOD chain.
+//
+// Rocks are nodes in a TransformHierarchy, grouped under one parent node per
+// cluster of the field; a few clusters spin, so only their subtrees need new
+// world matrices each frame. Every frame the CPU then picks a LOD per instance with LodSelector, buckets the
+// instances by LOD and writes them, grouped, into this frame slot's instance
+// buffer. Recording then issues one instanced vkCmdDrawIndexed per non-empty LOD.
+//
+// With a DepthPyramid the scene is culled on the GPU instead: recordCulling()
+// tests every rock against the frustum and the previous frame's Hi-Z pyramid,
+// compacts the survivors into a device-local buffer and counts them into one
+// indirect draw per LOD. Hidden rocks then cost no vertex work, and the CPU
+// records the same few indirect draws however many are visible. A rock that
+// becomes visible from behind an occluder appears one frame late.
+//
+// With shadow casters the rocks are also split for a CascadedShadowMap: those
+// in still clusters go once into a device-local static caster buffer, those in
+// spinning clusters are rewritten every frame as dynamic casters.
+class LodScene {
+public:
+    // occlusion: cull on the GPU against this pyramid (built by the renderer each frame).
+    // shadowCasters: keep the caster buffers recordShadowCasters() draws from.
+    void init(Device& device, uint32_t gridSize, float errorThresholdPixels, uint32_t framesInFlight,
+              DepthPyramid* occlusion = nullptr, bool shadowCasters = false);
+    void cleanup();
+
+    VkDescriptorSetLayout setLayout() const { return descriptorSetLayout; }
+    static std::vector<VkVertexInputBindingDescription>   vertexBindings();
+    static std::vector<VkVertexInputAttributeDescription> vertexAttributes();
+
+    // Bytes of push constants lod.vert/lod.frag expect.
+    static constexpr uint32_t pushConstantSize = 80;
+    // Direction towards the scene's sun.
+    static Vec3 lightDirection() { return Vec3{ 0.4f, 0.8f, 0.45f }; }
+
+    // Selects LODs and fills this frame slot's instance buffer. Scratch comes from `arena`.
+    void update(uint32_t frame, const Camera& camera, VkExtent2D extent, float time, FrameArena& arena);
+
+    // GPU culling, recorded before the render pass; nothing without a depth pyramid.
+    void recordCulling(VkCommandBuffer commandBuffer, uint32_t frame);
+
+    // Draws every instance with the pipeline whose layout is `layout` bound.
+    // perInstance splits each LOD's instanced draw into one draw per rock
+    // (ignored with GPU culling, which always draws indirectly per LOD).
+    // Returns the number of draw calls recorded.
+    uint32_t recordDraws(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frame,
+                     const Camera& camera, bool tintByLod, bool perInstance = false);
+
+    // Draws the static or dynamic casters into one shadow cascade, with the shadow
+    // pipeline (set 0 = setLayout()) bound and the cascade's matrix pushed.
+    // Returns the number of draw calls recorded.
+    uint32_t recordShadowCasters(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frame,
+                                 uint32_t cascade, bool staticCasters);
+
+    // Triangles submitted by the last update(), for stats. With GPU culling this is
+    // what survived culling, read back from a frame that has finished on the GPU.
+    uint64_t triangleCount() const { return lastTriangleCount; }
+    // Rocks drawn (after GPU culling, with the same delay) and in total.
+    size_t visibleInstances() const { return lastVisibleCount; }
+    size_t instanceCount() const { return rockNodes.size(); }
+    // World matrices recomputed by the last update(), for stats.
+    size_t transformsUpdated() const { return transforms.lastUpdatedCount(); }
+
+private:
+    // Must match `struct Instance` in lod.vert.
+    struct GpuInstance {
+        float model[16];
+        float lod[4];      // x = selected LOD
+    };
+
+    struct DrawRange {
+        uint32_t firstInstance = 0;
+        uint32_t instanceCount = 0;
+    };
+
+    void createGeometry();
+    void createInstances(uint32_t gridSize);
+    void createDescriptors(uint32_t framesInFlight);
+    void createCulling(uint32_t framesInFlight);
+    void createShadowCasters(uint32_t framesInFlight);
+    void writeCullPyramid(uint32_t frame);
+
+    Device* device = nullptr;
+
+    LodMesh     rock;
+    LodSelector selector;
+
+    VkBuffer       vertexBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory vertexMemory = VK_NULL_HANDLE;
+    VkBuffer       indexBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory indexMemory = VK_NULL_HANDLE;
+
+    TransformHierarchy                     transforms;
+    std::vector<TransformHierarchy::NodeId> rockNodes;       // one per instance
+    std::vector<TransformHierarchy::NodeId> spinningGroups;  // cluster nodes animated in update()
+    std::vector<bool>        rockSpins;     // per instance: its cluster is one of spinningGroups
+    std::vector<uint32_t>    currentLods;   // last frame's choice per instance (hysteresis)
+    std::vector<DrawRange>   drawRanges;    // per LOD, for the frame being recorded
+    uint64_t lastTriangleCount = 0;
+    size_t   lastVisibleCount = 0;
+
+    // Per frame in flight: host-visible instance data.
+    std::vector<VkBuffer>       instanceBuffers;
+    std::vector<VkDeviceMemory> instanceMemory;
+    std::vector<void*>          instanceMapped;
+
+    VkDescriptorSetLayout        descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool             descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> descriptorSets;
+
+    // GPU culling (only with a depth pyramid); one of each per frame in flight.
+    DepthPyramid*               pyramid = nullptr;
+    ComputePipeline             cullPipeline;
+    VkDescriptorSetLayout       cullSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool            cullPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> cullSets;
+    std::vector<VkImageView>    cullPyramidViews;   // pyramid view each cull set was written with
+    std::vector<VkBuffer>       cullUniformBuffers;
+    std::vector<VkDeviceMemory> cullUniformMemory;
+    std::vector<void*>          cullUniformMapped;
+    std::vector<VkBuffer>       drawCommandBuffers;   // VkDrawIndexedIndirectCommand per LOD, host-visible
+    std::vector<VkDeviceMemory> drawCommandMemory;
+    std::vector<void*>          drawCommandMapped;
+    std::vector<VkBuffer>       visibleBuffers;       // survivors, read by lod.vert
+    std::vector<VkDeviceMemory> visibleMemory;
+
+    // Shadow casters (only with shadowCasters). Static ones never move, so they are
+    // uploaded once; dynamic ones are written per frame in flight.
+    bool                         shadowCasters = false;
+    VkBuffer                     staticCasterBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory               staticCasterMemory = VK_NULL_HANDLE;
+    uint32_t                     staticCasterCount = 0;
+    std::vector<uint32_t>        dynamicCasterRocks;   // indices into rockNodes
+    std::vector<VkBuffer>        dynamicCasterBuffers;
+    std::vector<VkDeviceMemory>  dynamicCasterMemory;
+    std::vector<void*>           dynamicCasterMapped;
+    VkDescriptorPool             casterPool = VK_NULL_HANDLE;
+    VkDescriptorSet              staticCasterSet = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> dynamicCasterSets;
+};
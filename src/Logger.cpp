@@ -0,0 +1,235 @@
+// src/Logger.cpp
+#include "Logger.h"
+#include "HostMemoryTracker.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::duration RATE_WINDOW = std::chrono::seconds(1);
+    // How often the writer closes expired windows while messages keep coming.
+    const Clock::duration SWEEP_INTERVAL = std::chrono::milliseconds(100);
+    const std::chrono::milliseconds IDLE_SLEEP{ 2 };
+
+    const char* SEVERITY_NAMES[] = { "verbose", "info", "warning", "error" };
+
+    uint32_t hashText(const char* text) {
+        uint32_t h = 2166136261u;   // FNV-1a
+        for (; *text; text++) {
+            h = (h ^ static_cast<unsigned char>(*text)) * 16777619u;
+        }
+        return h ? h : 1;
+    }
+
+    // Writer-thread bookkeeping for one message ID within its current window.
+    // Fixed size, so writing a message never allocates.
+    template <uint32_t MaxPrinted>
+    struct IdWindow {
+        uint32_t          id = 0;              // 0: free slot
+        Clock::time_point start;
+        LogSeverity       severity = LogSeverity::Info;
+        const char*       category = "";
+        uint32_t          suppressed = 0;
+        uint32_t          printedCount = 0;
+        uint32_t          printedHashes[MaxPrinted] = {};   // texts already shown this window
+    };
+}
+
+Logger& Logger::global() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() {
+    writer = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    running.store(false, std::memory_order_release);
+    if (writer.joinable()) writer.join();
+}
+
+bool Logger::parseSeverity(const char* name, LogSeverity& out) {
+    for (uint8_t i = 0; i < 4; i++) {
+        if (std::strcmp(name, SEVERITY_NAMES[i]) == 0) {
+            out = LogSeverity(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+//-------------------------------------------------------------------------
+// Producers
+//-------------------------------------------------------------------------
+
+bool Logger::suppressedAtSource(uint32_t id) {
+    SuppressSlot& slot = suppress[id & (SUPPRESS_SLOTS - 1)];
+    if (slot.id.load(std::memory_order_relaxed) != id) return false;
+    if (Clock::now().time_since_epoch().count() >= slot.until.load(std::memory_order_relaxed)) return false;
+    slot.dropped.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void Logger::enqueue(const Message& message) {
+    if (queue.push(message)) {
+        queued.fetch_add(1, std::memory_order_release);
+    }
+    else {
+        overflowed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Logger::log(LogSeverity severity, const char* category, uint32_t id, const char* text) {
+    if (!enabled(severity)) return;
+    if (id == 0) id = hashText(text);
+    if (suppressedAtSource(id)) return;
+
+    Message message;
+    message.severity = severity;
+    message.category = category;
+    message.id = id;
+    std::strncpy(message.text, text, MESSAGE_BYTES - 1);
+    enqueue(message);
+}
+
+void Logger::logf(LogSeverity severity, const char* category, const char* format, ...) {
+    if (!enabled(severity)) return;
+    uint32_t id = hashText(format);
+    if (suppressedAtSource(id)) return;
+
+    Message message;
+    message.severity = severity;
+    message.category = category;
+    message.id = id;
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(message.text, MESSAGE_BYTES, format, args);
+    va_end(args);
+    enqueue(message);
+}
+
+void Logger::flush() {
+    uint64_t target = queued.load(std::memory_order_acquire);
+    while (running.load(std::memory_order_relaxed) && written.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+//-------------------------------------------------------------------------
+// Writer thread
+//-------------------------------------------------------------------------
+
+void Logger::writerLoop() {
+    // Anything the writer allocates is the logger's, not the frame's that logged.
+    HostAllocationScope allocationScope("logger");
+
+    // One slot per ID with an open window; closing the window frees the slot.
+    using Window = IdWindow<MAX_PRINTED_PER_WINDOW>;
+    std::vector<Window> windows(WINDOW_SLOTS);
+    Clock::time_point lastSweep = Clock::now();
+
+    // The ID's window, claiming a free slot for a new ID; nullptr when all are taken.
+    // Probing starts at the ID's home slot, so a scan usually ends on the first one.
+    auto findWindow = [&](uint32_t id) -> Window* {
+        Window* freeSlot = nullptr;
+        for (size_t i = 0; i < WINDOW_SLOTS; i++) {
+            Window& window = windows[(id + i) & (WINDOW_SLOTS - 1)];
+            if (window.id == id) return &window;
+            if (window.id == 0 && !freeSlot) freeSlot = &window;
+        }
+        if (freeSlot) freeSlot->id = id;
+        return freeSlot;
+    };
+
+    auto closeWindow = [&](uint32_t id, Window& window) {
+        uint32_t total = window.suppressed;
+        SuppressSlot& slot = suppress[id & (SUPPRESS_SLOTS - 1)];
+        if (slot.id.load(std::memory_order_relaxed) == id) {
+            slot.until.store(0, std::memory_order_relaxed);
+            total += slot.dropped.exchange(0, std::memory_order_relaxed);
+        }
+        if (total > 0) {
+            std::cerr << "[" << SEVERITY_NAMES[uint8_t(window.severity)] << "] " << window.category
+                      << ": (" << total << " similar message" << (total == 1 ? "" : "s") << " suppressed)\n";
+        }
+    };
+
+    auto sweep = [&](Clock::time_point now) {
+        for (Window& window : windows) {
+            if (window.id != 0 && now - window.start >= RATE_WINDOW) {
+                closeWindow(window.id, window);
+                window = Window{};
+            }
+        }
+        if (uint64_t lost = overflowed.exchange(0, std::memory_order_relaxed)) {
+            std::cerr << "[warning] logger: " << lost << " messages dropped (queue full)\n";
+        }
+        lastSweep = now;
+    };
+
+    auto print = [](const Message& message) {
+        std::cerr << "[" << SEVERITY_NAMES[uint8_t(message.severity)] << "] " << message.category
+                  << ": " << message.text << "\n";
+    };
+
+    auto write = [&](const Message& message, Clock::time_point now) {
+        Window* found = findWindow(message.id);
+        if (!found) {
+            print(message);   // too many IDs at once to track this one
+            return;
+        }
+        Window& window = *found;
+        if (window.printedCount == 0 && window.suppressed == 0) {
+            window.start = now;
+            window.severity = message.severity;
+            window.category = message.category;
+        }
+
+        uint32_t limit = std::min(maxPerIdPerSecond(), MAX_PRINTED_PER_WINDOW);
+        uint32_t hash = hashText(message.text);
+        uint32_t* printedEnd = window.printedHashes + window.printedCount;
+        bool duplicate = std::find(window.printedHashes, printedEnd, hash) != printedEnd;
+        if (duplicate || window.printedCount >= limit) {
+            window.suppressed++;
+            if (window.printedCount + window.suppressed > limit) {
+                // Over the limit: have producers drop this ID until the window closes.
+                SuppressSlot& slot = suppress[message.id & (SUPPRESS_SLOTS - 1)];
+                if (slot.id.load(std::memory_order_relaxed) != message.id) {
+                    slot.dropped.store(0, std::memory_order_relaxed);
+                    slot.id.store(message.id, std::memory_order_relaxed);
+                }
+                slot.until.store((window.start + RATE_WINDOW).time_since_epoch().count(), std::memory_order_relaxed);
+            }
+            return;
+        }
+
+        window.printedHashes[window.printedCount++] = hash;
+        print(message);
+    };
+
+    while (true) {
+        bool stopping = !running.load(std::memory_order_acquire);
+        Clock::time_point now = Clock::now();
+        if (now - lastSweep >= SWEEP_INTERVAL) sweep(now);
+
+        if (const Message* message = queue.peek()) {
+            write(*message, now);
+            queue.pop();
+            written.fetch_add(1, std::memory_order_release);
+            continue;
+        }
+        if (stopping) break;
+        std::this_thread::sleep_for(IDLE_SLEEP);
+    }
+
+    // Report whatever is still pending in open windows.
+    sweep(Clock::now() + RATE_WINDOW);
+    std::cerr.flush();
+}
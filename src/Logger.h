@@ -0,0 +1,98 @@
+// src/Logger.h
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "MpscQueue.h"
+
+enum class LogSeverity : uint8_t { Verbose, Info, Warning, Error };
+
+// Asynchronous log shared by the whole engine, validation messages included.
+//
+// Producers (any thread, including the driver's debug callback) only format
+// into a fixed-size message and push it onto a lock-free queue; a background
+// thread does the console I/O. On the way out every message ID gets:
+//   - dedupe: a repeat of the exact text already printed in the current
+//     one-second window is counted, not printed;
+//   - rate limiting: at most maxPerIdPerSecond() lines per window. Once an ID
+//     has been seen more often than that, producers drop its messages before
+//     queueing them until the window closes.
+// Suppressed counts are reported when the window closes, queue overflow as a
+// dropped count. Severity below minSeverity() is filtered before anything else.
+//
+// The writer thread allocates its bookkeeping once, at startup, and credits
+// it to the "logger" host allocation site; logging a message never allocates.
+class Logger {
+public:
+    static Logger& global();
+
+    Logger();
+    ~Logger();   // drains the queue and stops the thread
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // `category` must be a string literal (it is stored as a pointer). `id` groups
+    // messages for dedupe and rate limiting; 0 derives it from the text.
+    void log(LogSeverity severity, const char* category, uint32_t id, const char* text);
+    // printf-style convenience; the format string doubles as the message ID.
+    void logf(LogSeverity severity, const char* category, const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((format(printf, 4, 5)))
+#endif
+        ;
+
+    // Runtime filters, safe to change from any thread. The per-ID limit is capped
+    // at MAX_PRINTED_PER_WINDOW.
+    void setMinSeverity(LogSeverity severity) { minSeverityLevel.store(uint8_t(severity), std::memory_order_relaxed); }
+    LogSeverity minSeverity() const { return LogSeverity(minSeverityLevel.load(std::memory_order_relaxed)); }
+    bool enabled(LogSeverity severity) const { return uint8_t(severity) >= minSeverityLevel.load(std::memory_order_relaxed); }
+    void setMaxPerIdPerSecond(uint32_t limit) { rateLimit.store(limit, std::memory_order_relaxed); }
+    uint32_t maxPerIdPerSecond() const { return rateLimit.load(std::memory_order_relaxed); }
+
+    // Blocks until everything queued so far has been written (before printing
+    // directly to the console, or on a crash path).
+    void flush();
+
+    // Parses verbose | info | warning | error; false leaves `out` untouched.
+    static bool parseSeverity(const char* name, LogSeverity& out);
+
+private:
+    static constexpr size_t MESSAGE_BYTES = 1024;   // longer messages are truncated
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+    static constexpr size_t SUPPRESS_SLOTS = 256;   // producer-side drop table, indexed by ID
+    static constexpr size_t WINDOW_SLOTS = 256;     // IDs the writer tracks at once; the rest skip dedupe
+    static constexpr uint32_t MAX_PRINTED_PER_WINDOW = 32;   // caps maxPerIdPerSecond()
+
+    struct Message {
+        LogSeverity severity = LogSeverity::Info;
+        const char* category = "";
+        uint32_t    id = 0;
+        char        text[MESSAGE_BYTES] = {};
+    };
+
+    // Set by the writer thread while an ID is over its rate limit. Producers
+    // drop that ID's messages until `until` (steady clock ticks) and count them.
+    struct alignas(64) SuppressSlot {
+        std::atomic<uint32_t> id{ 0 };
+        std::atomic<int64_t>  until{ 0 };
+        std::atomic<uint32_t> dropped{ 0 };
+    };
+
+    bool suppressedAtSource(uint32_t id);
+    void enqueue(const Message& message);
+    void writerLoop();
+
+    MpscQueue<Message>    queue{ QUEUE_CAPACITY };
+    SuppressSlot          suppress[SUPPRESS_SLOTS];
+    std::atomic<uint8_t>  minSeverityLevel{ uint8_t(LogSeverity::Warning) };
+    std::atomic<uint32_t> rateLimit{ 5 };
+    std::atomic<uint64_t> queued{ 0 };      // accepted by push()
+    std::atomic<uint64_t> written{ 0 };     // handled by the writer thread
+    std::atomic<uint64_t> overflowed{ 0 };  // lost to a full queue
+    std::atomic<bool>     running{ true };
+    std::thread           writer;
+};
@@ -0,0 +1,277 @@
+// src/Math.cpp
+#include "Math.h"
+
+namespace {
+#if ENGINE_MATH_AVX2
+    // Multiply-add; FMA ships with every AVX2 CPU but GCC/Clang only expose it with -mfma.
+    inline __m256 madd(__m256 a, __m256 b, __m256 c) {
+#if defined(__FMA__) || defined(_MSC_VER)
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+
+    // The types are only 16-byte aligned, so 256-bit accesses use loadu/storeu.
+
+    // Column c of `m` in both 128-bit halves.
+    inline __m256 broadcastColumn(const Mat4& m, int c) {
+        return _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.m + c * 4));
+    }
+
+    // Two output columns per iteration: lhs * rhs[col .. col + 1], each half
+    // broadcasting its own column's elements with an in-lane shuffle.
+    inline void multiplyAvx(const __m256 a[4], const Mat4& rhs, Mat4& out) {
+        for (int c = 0; c < 4; c += 2) {
+            __m256 b = _mm256_loadu_ps(rhs.m + c * 4);
+            __m256 r = _mm256_mul_ps(a[0], _mm256_shuffle_ps(b, b, _MM_SHUFFLE(0, 0, 0, 0)));
+            r = madd(a[1], _mm256_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 1, 1)), r);
+            r = madd(a[2], _mm256_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 2, 2)), r);
+            r = madd(a[3], _mm256_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 3, 3)), r);
+            _mm256_storeu_ps(out.m + c * 4, r);
+        }
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Quat / Mat4
+//-------------------------------------------------------------------------
+
+Quat slerp(const Quat& a, const Quat& b, float t) {
+    float cosTheta = dot(a, b);
+    Quat end = b;
+    if (cosTheta < 0.0f) {
+        cosTheta = -cosTheta;
+        end = { -b.x, -b.y, -b.z, -b.w };
+    }
+    // Nearly parallel: sin(theta) underflows, nlerp is exact enough.
+    if (cosTheta > 0.9995f) {
+        return nlerp(a, end, t);
+    }
+    float theta = std::acos(cosTheta);
+    float invSin = 1.0f / std::sin(theta);
+    float wa = std::sin((1.0f - t) * theta) * invSin;
+    float wb = std::sin(t * theta) * invSin;
+    return { a.x * wa + end.x * wb, a.y * wa + end.y * wb, a.z * wa + end.z * wb, a.w * wa + end.w * wb };
+}
+
+Mat4 Mat4::translation(const Vec3& t) {
+    Mat4 r = identity();
+    r.m[12] = t.x;
+    r.m[13] = t.y;
+    r.m[14] = t.z;
+    return r;
+}
+
+Mat4 Mat4::scale(const Vec3& s) {
+    Mat4 r;
+    r.m[0] = s.x;
+    r.m[5] = s.y;
+    r.m[10] = s.z;
+    r.m[15] = 1.0f;
+    return r;
+}
+
+Mat4 Mat4::fromQuat(const Quat& q) {
+    return fromTRS(Vec3{}, q, Vec3{ 1.0f, 1.0f, 1.0f });
+}
+
+Mat4 Mat4::fromTRS(const Vec3& t, const Quat& q, const Vec3& s) {
+    float x = q.x, y = q.y, z = q.z, w = q.w;
+    Mat4 r;
+    r.m[0]  = (1 - 2 * (y * y + z * z)) * s.x;
+    r.m[1]  = 2 * (x * y + w * z) * s.x;
+    r.m[2]  = 2 * (x * z - w * y) * s.x;
+    r.m[4]  = 2 * (x * y - w * z) * s.y;
+    r.m[5]  = (1 - 2 * (x * x + z * z)) * s.y;
+    r.m[6]  = 2 * (y * z + w * x) * s.y;
+    r.m[8]  = 2 * (x * z + w * y) * s.z;
+    r.m[9]  = 2 * (y * z - w * x) * s.z;
+    r.m[10] = (1 - 2 * (x * x + y * y)) * s.z;
+    r.m[12] = t.x;
+    r.m[13] = t.y;
+    r.m[14] = t.z;
+    r.m[15] = 1.0f;
+    return r;
+}
+
+Mat4 Mat4::lookAt(const Vec3& eye, const Vec3& target, const Vec3& up) {
+    Vec3 f = normalize(target - eye);
+    Vec3 r = normalize(cross(f, up));
+    Vec3 u = cross(r, f);
+
+    Mat4 v = identity();
+    v.m[0] = r.x;  v.m[4] = r.y;  v.m[8]  = r.z;
+    v.m[1] = u.x;  v.m[5] = u.y;  v.m[9]  = u.z;
+    v.m[2] = -f.x; v.m[6] = -f.y; v.m[10] = -f.z;
+    v.m[12] = -dot(r, eye);
+    v.m[13] = -dot(u, eye);
+    v.m[14] = dot(f, eye);
+    return v;
+}
+
+Mat4 Mat4::perspective(float fovYRadians, float aspect, float zNear, float zFar) {
+    float t = 1.0f / std::tan(fovYRadians * 0.5f);
+
+    Mat4 p;
+    p.m[0] = t / aspect;
+    p.m[5] = -t;                               // Vulkan clip space Y points down
+    p.m[10] = zFar / (zNear - zFar);           // depth 0 at near, 1 at far
+    p.m[11] = -1.0f;
+    p.m[14] = (zNear * zFar) / (zNear - zFar);
+    return p;
+}
+
+Mat4 Mat4::orthographic(float left, float right, float bottom, float top, float zNear, float zFar) {
+    Mat4 p;
+    p.m[0] = 2.0f / (right - left);
+    p.m[5] = -2.0f / (top - bottom);           // Vulkan clip space Y points down
+    p.m[10] = 1.0f / (zNear - zFar);           // depth 0 at near, 1 at far
+    p.m[12] = -(right + left) / (right - left);
+    p.m[13] = (top + bottom) / (top - bottom);
+    p.m[14] = zNear / (zNear - zFar);
+    p.m[15] = 1.0f;
+    return p;
+}
+
+Mat4 transpose(const Mat4& a) {
+    Mat4 r;
+#if ENGINE_MATH_SSE
+    __m128 c0 = _mm_load_ps(a.m), c1 = _mm_load_ps(a.m + 4);
+    __m128 c2 = _mm_load_ps(a.m + 8), c3 = _mm_load_ps(a.m + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _mm_store_ps(r.m, c0);
+    _mm_store_ps(r.m + 4, c1);
+    _mm_store_ps(r.m + 8, c2);
+    _mm_store_ps(r.m + 12, c3);
+#else
+    for (int c = 0; c < 4; c++) {
+        for (int row = 0; row < 4; row++) r.m[c * 4 + row] = a.m[row * 4 + c];
+    }
+#endif
+    return r;
+}
+
+Mat4 inverseAffine(const Mat4& a) {
+    // Inverse of the upper 3x3 via its adjugate, then -inv(A) * t.
+    const float* m = a.m;
+    float c00 = m[5] * m[10] - m[9] * m[6];
+    float c01 = m[9] * m[2] - m[1] * m[10];
+    float c02 = m[1] * m[6] - m[5] * m[2];
+    float det = m[0] * c00 + m[4] * c01 + m[8] * c02;
+    float inv = 1.0f / det;
+
+    Mat4 r;
+    r.m[0] = c00 * inv;
+    r.m[1] = c01 * inv;
+    r.m[2] = c02 * inv;
+    r.m[4] = (m[8] * m[6] - m[4] * m[10]) * inv;
+    r.m[5] = (m[0] * m[10] - m[8] * m[2]) * inv;
+    r.m[6] = (m[4] * m[2] - m[0] * m[6]) * inv;
+    r.m[8] = (m[4] * m[9] - m[8] * m[5]) * inv;
+    r.m[9] = (m[8] * m[1] - m[0] * m[9]) * inv;
+    r.m[10] = (m[0] * m[5] - m[4] * m[1]) * inv;
+    r.m[12] = -(r.m[0] * m[12] + r.m[4] * m[13] + r.m[8] * m[14]);
+    r.m[13] = -(r.m[1] * m[12] + r.m[5] * m[13] + r.m[9] * m[14]);
+    r.m[14] = -(r.m[2] * m[12] + r.m[6] * m[13] + r.m[10] * m[14]);
+    r.m[15] = 1.0f;
+    return r;
+}
+
+//-------------------------------------------------------------------------
+// Batch kernels
+//-------------------------------------------------------------------------
+
+void transformPoints(const Mat4& m, const Vec3* in, Vec3* out, size_t count) {
+    size_t i = 0;
+#if ENGINE_MATH_AVX2
+    // Two points per iteration, one per 128-bit half; the w lane is masked back to zero padding.
+    const __m256 c0 = broadcastColumn(m, 0), c1 = broadcastColumn(m, 1);
+    const __m256 c2 = broadcastColumn(m, 2), c3 = broadcastColumn(m, 3);
+    const __m256 xyzMask = _mm256_castsi256_ps(_mm256_setr_epi32(-1, -1, -1, 0, -1, -1, -1, 0));
+    for (; i + 2 <= count; i += 2) {
+        __m256 p = _mm256_loadu_ps(&in[i].x);
+        __m256 r = madd(c0, _mm256_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0)), c3);
+        r = madd(c1, _mm256_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1)), r);
+        r = madd(c2, _mm256_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2)), r);
+        _mm256_storeu_ps(&out[i].x, _mm256_and_ps(r, xyzMask));
+    }
+#endif
+#if ENGINE_MATH_SSE
+    const __m128 s0 = _mm_load_ps(m.m), s1 = _mm_load_ps(m.m + 4);
+    const __m128 s2 = _mm_load_ps(m.m + 8), s3 = _mm_load_ps(m.m + 12);
+    const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    for (; i < count; i++) {
+        __m128 p = _mm_load_ps(&in[i].x);
+        __m128 r = _mm_add_ps(s3, _mm_mul_ps(s0, _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0))));
+        r = _mm_add_ps(r, _mm_mul_ps(s1, _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1))));
+        r = _mm_add_ps(r, _mm_mul_ps(s2, _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2))));
+        _mm_store_ps(&out[i].x, _mm_and_ps(r, mask));
+    }
+#else
+    for (; i < count; i++) {
+        Vec3 p = in[i];
+        out[i] = Vec3{ m.m[0] * p.x + m.m[4] * p.y + m.m[8]  * p.z + m.m[12],
+                       m.m[1] * p.x + m.m[5] * p.y + m.m[9]  * p.z + m.m[13],
+                       m.m[2] * p.x + m.m[6] * p.y + m.m[10] * p.z + m.m[14] };
+    }
+#endif
+}
+
+void transformVec4s(const Mat4& m, const Vec4* in, Vec4* out, size_t count) {
+    size_t i = 0;
+#if ENGINE_MATH_AVX2
+    const __m256 c0 = broadcastColumn(m, 0), c1 = broadcastColumn(m, 1);
+    const __m256 c2 = broadcastColumn(m, 2), c3 = broadcastColumn(m, 3);
+    for (; i + 2 <= count; i += 2) {
+        __m256 v = _mm256_loadu_ps(&in[i].x);
+        __m256 r = _mm256_mul_ps(c0, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = madd(c1, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+        r = madd(c2, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+        r = madd(c3, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+        _mm256_storeu_ps(&out[i].x, r);
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = m * in[i];
+    }
+}
+
+void multiplyMatrices(const Mat4& lhs, const Mat4* rhs, Mat4* out, size_t count) {
+#if ENGINE_MATH_AVX2
+    const __m256 a[4] = { broadcastColumn(lhs, 0), broadcastColumn(lhs, 1),
+                          broadcastColumn(lhs, 2), broadcastColumn(lhs, 3) };
+    for (size_t i = 0; i < count; i++) {
+        multiplyAvx(a, rhs[i], out[i]);
+    }
+#else
+    for (size_t i = 0; i < count; i++) {
+        out[i] = lhs * rhs[i];
+    }
+#endif
+}
+
+void multiplyMatrices(const Mat4* lhs, const Mat4* rhs, Mat4* out, size_t count) {
+#if ENGINE_MATH_AVX2
+    for (size_t i = 0; i < count; i++) {
+        const __m256 a[4] = { broadcastColumn(lhs[i], 0), broadcastColumn(lhs[i], 1),
+                              broadcastColumn(lhs[i], 2), broadcastColumn(lhs[i], 3) };
+        multiplyAvx(a, rhs[i], out[i]);
+    }
+#else
+    for (size_t i = 0; i < count; i++) {
+        out[i] = lhs[i] * rhs[i];
+    }
+#endif
+}
+
+const char* mathBackendName() {
+#if ENGINE_MATH_AVX2
+    return "AVX2";
+#elif ENGINE_MATH_SSE
+    return "SSE";
+#else
+    return "scalar";
+#endif
+}
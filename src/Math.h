@@ -0,0 +1,227 @@
+// src/Math.h
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+//-------------------------------------------------------------------------
+// SIMD backend, chosen at compile time from the target flags (see ENGINE_SIMD
+// in CMakeLists.txt). Define ENGINE_MATH_FORCE_SCALAR to use the portable path.
+//-------------------------------------------------------------------------
+#if !defined(ENGINE_MATH_FORCE_SCALAR) && defined(__AVX2__)
+#define ENGINE_MATH_AVX2 1
+#define ENGINE_MATH_SSE 1
+#include <immintrin.h>
+#elif !defined(ENGINE_MATH_FORCE_SCALAR) && \
+      (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define ENGINE_MATH_SSE 1
+#include <emmintrin.h>
+#endif
+
+//-------------------------------------------------------------------------
+// Types
+//
+// All types are 16-byte aligned and match GLSL std140/std430 layouts, so
+// arrays of them can be memcpy'd straight into uniform or storage buffers:
+//   Vec3 -> vec3 (16-byte stride, as vec3 arrays and struct members are padded)
+//   Vec4 -> vec4, Quat -> vec4, Mat4 -> mat4 (column-major)
+//-------------------------------------------------------------------------
+
+struct alignas(16) Vec3 {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+    float pad = 0.0f;   // std140/std430 padding; not part of the value
+
+    Vec3() = default;
+    constexpr Vec3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+};
+
+struct alignas(16) Vec4 {
+    float x = 0.0f, y = 0.0f, z = 0.0f, w = 0.0f;
+
+    Vec4() = default;
+    constexpr Vec4(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+    constexpr Vec4(const Vec3& v, float w_) : x(v.x), y(v.y), z(v.z), w(w_) {}
+};
+
+struct alignas(16) Quat {
+    float x = 0.0f, y = 0.0f, z = 0.0f, w = 1.0f;
+
+    Quat() = default;
+    constexpr Quat(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+
+    static Quat fromAxisAngle(const Vec3& axis, float radians);   // axis must be unit length
+};
+
+// Column-major: m[column * 4 + row], as GLSL's mat4.
+struct alignas(16) Mat4 {
+    float m[16] = {};
+
+    static Mat4 identity();
+    static Mat4 translation(const Vec3& t);
+    static Mat4 scale(const Vec3& s);
+    static Mat4 fromQuat(const Quat& q);
+    // translation * rotation * scale
+    static Mat4 fromTRS(const Vec3& t, const Quat& r, const Vec3& s);
+
+    // Right-handed view matrix looking from `eye` at `target`.
+    static Mat4 lookAt(const Vec3& eye, const Vec3& target, const Vec3& up);
+    // Vulkan clip space: Y down, depth 0 (near) .. 1 (far).
+    static Mat4 perspective(float fovYRadians, float aspect, float zNear, float zFar);
+    // Vulkan clip space like perspective(); zNear/zFar are distances along -Z and may be negative.
+    static Mat4 orthographic(float left, float right, float bottom, float top, float zNear, float zFar);
+
+    Vec4 column(int c) const { return { m[c * 4], m[c * 4 + 1], m[c * 4 + 2], m[c * 4 + 3] }; }
+};
+
+static_assert(sizeof(Vec3) == 16 && alignof(Vec3) == 16, "Vec3 must match std430 vec3 stride");
+static_assert(sizeof(Vec4) == 16 && alignof(Vec4) == 16, "Vec4 must match vec4");
+static_assert(sizeof(Quat) == 16 && alignof(Quat) == 16, "Quat must match vec4");
+static_assert(sizeof(Mat4) == 64 && alignof(Mat4) == 16, "Mat4 must match mat4");
+
+//-------------------------------------------------------------------------
+// Vec3 / Vec4
+//-------------------------------------------------------------------------
+
+inline Vec3 operator+(const Vec3& a, const Vec3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+inline Vec3 operator-(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+inline Vec3 operator-(const Vec3& a)                { return { -a.x, -a.y, -a.z }; }
+inline Vec3 operator*(const Vec3& a, float s)       { return { a.x * s, a.y * s, a.z * s }; }
+inline Vec3 operator*(float s, const Vec3& a)       { return a * s; }
+inline Vec3 operator*(const Vec3& a, const Vec3& b) { return { a.x * b.x, a.y * b.y, a.z * b.z }; }
+
+inline float dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline Vec3  cross(const Vec3& a, const Vec3& b) {
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+inline float length(const Vec3& v)    { return std::sqrt(dot(v, v)); }
+inline Vec3  normalize(const Vec3& v) { return v * (1.0f / length(v)); }
+
+inline Vec4 operator+(const Vec4& a, const Vec4& b) { return { a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w }; }
+inline Vec4 operator*(const Vec4& a, float s)       { return { a.x * s, a.y * s, a.z * s, a.w * s }; }
+inline float dot(const Vec4& a, const Vec4& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+//-------------------------------------------------------------------------
+// Quat
+//-------------------------------------------------------------------------
+
+inline Quat Quat::fromAxisAngle(const Vec3& axis, float radians) {
+    float s = std::sin(radians * 0.5f);
+    return { axis.x * s, axis.y * s, axis.z * s, std::cos(radians * 0.5f) };
+}
+
+inline Quat operator*(const Quat& a, const Quat& b) {
+    return {
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+    };
+}
+
+inline float dot(const Quat& a, const Quat& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+inline Quat normalize(const Quat& q) {
+    float inv = 1.0f / std::sqrt(dot(q, q));
+    return { q.x * inv, q.y * inv, q.z * inv, q.w * inv };
+}
+
+inline Quat conjugate(const Quat& q) { return { -q.x, -q.y, -q.z, q.w }; }
+
+// Rotates v by unit quaternion q.
+inline Vec3 rotate(const Quat& q, const Vec3& v) {
+    Vec3 u{ q.x, q.y, q.z };
+    Vec3 t = cross(u, v) * 2.0f;
+    return v + t * q.w + cross(u, t);
+}
+
+// Normalized lerp along the shorter arc; cheap and good for small angles.
+inline Quat nlerp(const Quat& a, const Quat& b, float t) {
+    float sign = dot(a, b) < 0.0f ? -1.0f : 1.0f;
+    return normalize(Quat{
+        a.x + (b.x * sign - a.x) * t, a.y + (b.y * sign - a.y) * t,
+        a.z + (b.z * sign - a.z) * t, a.w + (b.w * sign - a.w) * t });
+}
+
+Quat slerp(const Quat& a, const Quat& b, float t);
+
+//-------------------------------------------------------------------------
+// Mat4
+//-------------------------------------------------------------------------
+
+inline Mat4 Mat4::identity() {
+    Mat4 r;
+    r.m[0] = r.m[5] = r.m[10] = r.m[15] = 1.0f;
+    return r;
+}
+
+inline Mat4 operator*(const Mat4& a, const Mat4& b) {
+    Mat4 r;
+#if ENGINE_MATH_SSE
+    __m128 a0 = _mm_load_ps(a.m), a1 = _mm_load_ps(a.m + 4);
+    __m128 a2 = _mm_load_ps(a.m + 8), a3 = _mm_load_ps(a.m + 12);
+    for (int c = 0; c < 4; c++) {
+        const float* bc = b.m + c * 4;
+        __m128 col = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+        col = _mm_add_ps(col, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+        col = _mm_add_ps(col, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+        col = _mm_add_ps(col, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+        _mm_store_ps(r.m + c * 4, col);
+    }
+#else
+    for (int c = 0; c < 4; c++) {
+        for (int row = 0; row < 4; row++) {
+            r.m[c * 4 + row] = a.m[row] * b.m[c * 4] + a.m[4 + row] * b.m[c * 4 + 1]
+                             + a.m[8 + row] * b.m[c * 4 + 2] + a.m[12 + row] * b.m[c * 4 + 3];
+        }
+    }
+#endif
+    return r;
+}
+
+inline Vec4 operator*(const Mat4& a, const Vec4& v) {
+    Vec4 r;
+#if ENGINE_MATH_SSE
+    __m128 col = _mm_mul_ps(_mm_load_ps(a.m), _mm_set1_ps(v.x));
+    col = _mm_add_ps(col, _mm_mul_ps(_mm_load_ps(a.m + 4), _mm_set1_ps(v.y)));
+    col = _mm_add_ps(col, _mm_mul_ps(_mm_load_ps(a.m + 8), _mm_set1_ps(v.z)));
+    col = _mm_add_ps(col, _mm_mul_ps(_mm_load_ps(a.m + 12), _mm_set1_ps(v.w)));
+    _mm_store_ps(&r.x, col);
+#else
+    r.x = a.m[0] * v.x + a.m[4] * v.y + a.m[8]  * v.z + a.m[12] * v.w;
+    r.y = a.m[1] * v.x + a.m[5] * v.y + a.m[9]  * v.z + a.m[13] * v.w;
+    r.z = a.m[2] * v.x + a.m[6] * v.y + a.m[10] * v.z + a.m[14] * v.w;
+    r.w = a.m[3] * v.x + a.m[7] * v.y + a.m[11] * v.z + a.m[15] * v.w;
+#endif
+    return r;
+}
+
+// Affine point (w = 1) and direction (w = 0) transforms.
+inline Vec3 transformPoint(const Mat4& a, const Vec3& p) {
+    Vec4 r = a * Vec4(p, 1.0f);
+    return { r.x, r.y, r.z };
+}
+inline Vec3 transformVector(const Mat4& a, const Vec3& v) {
+    Vec4 r = a * Vec4(v, 0.0f);
+    return { r.x, r.y, r.z };
+}
+
+Mat4 transpose(const Mat4& a);
+// Inverse of an affine matrix (last row 0, 0, 0, 1).
+Mat4 inverseAffine(const Mat4& a);
+
+//-------------------------------------------------------------------------
+// Batch kernels (Math.cpp). `in` and `out` may alias element for element.
+//-------------------------------------------------------------------------
+
+// out[i] = m * (in[i], 1)
+void transformPoints(const Mat4& m, const Vec3* in, Vec3* out, size_t count);
+// out[i] = m * in[i]
+void transformVec4s(const Mat4& m, const Vec4* in, Vec4* out, size_t count);
+// out[i] = lhs * rhs[i]
+void multiplyMatrices(const Mat4& lhs, const Mat4* rhs, Mat4* out, size_t count);
+// out[i] = lhs[i] * rhs[i]
+void multiplyMatrices(const Mat4* lhs, const Mat4* rhs, Mat4* out, size_t count);
+
+// "AVX2", "SSE" or "scalar".
+const char* mathBackendName();
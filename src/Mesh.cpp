@@ -0,0 +1,136 @@
+// src/Mesh.cpp
+#include "Mesh.h"
+#include "PoolAllocator.h"
+
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+
+namespace {
+    // Big enough for an unordered_map<uint64_t, uint32_t> node in the common standard libraries.
+    const size_t MIDPOINT_NODE_BYTES = 32;
+
+    void normalize3(float v[3]) {
+        float len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        if (len > 0.0f) {
+            v[0] /= len; v[1] /= len; v[2] /= len;
+        }
+    }
+
+    // Cheap smooth noise: a few rotated sine octaves. Good enough for lumpy rocks.
+    float displacement(const float p[3], uint32_t seed) {
+        float s = float(seed % 1000) * 0.137f;
+        float d = 0.0f;
+        float amplitude = 0.12f;
+        float frequency = 1.7f;
+        for (int octave = 0; octave < 4; octave++) {
+            d += amplitude * std::sin(p[0] * frequency + s)
+                           * std::sin(p[1] * frequency * 1.3f + s * 0.7f)
+                           * std::sin(p[2] * frequency * 0.9f + s * 1.9f);
+            amplitude *= 0.5f;
+            frequency *= 2.1f;
+        }
+        return d;
+    }
+}
+
+MeshData createRockMesh(uint32_t subdivisions, uint32_t seed) {
+    MeshData mesh;
+
+    // Icosahedron
+    const float t = (1.0f + std::sqrt(5.0f)) * 0.5f;
+    const float base[12][3] = {
+        { -1,  t,  0 }, {  1,  t,  0 }, { -1, -t,  0 }, {  1, -t,  0 },
+        {  0, -1,  t }, {  0,  1,  t }, {  0, -1, -t }, {  0,  1, -t },
+        {  t,  0, -1 }, {  t,  0,  1 }, { -t,  0, -1 }, { -t,  0,  1 },
+    };
+    for (const auto& p : base) {
+        MeshVertex v{ { p[0], p[1], p[2] }, {} };
+        normalize3(v.position);
+        mesh.vertices.push_back(v);
+    }
+    // Clockwise seen from outside (the pipelines' front face).
+    mesh.indices = {
+        0, 5, 11,   0, 1, 5,    0, 7, 1,    0, 10, 7,   0, 11, 10,
+        1, 9, 5,    5, 4, 11,   11, 2, 10,  10, 6, 7,   7, 8, 1,
+        3, 4, 9,    3, 2, 4,    3, 6, 2,    3, 8, 6,    3, 9, 8,
+        4, 5, 9,    2, 11, 4,   6, 10, 2,   8, 7, 6,    9, 1, 8,
+    };
+
+    // Subdivide: split every edge once, sharing midpoints between neighbours.
+    // Map nodes come from one pool that every level reuses.
+    using MidpointMap = std::unordered_map<uint64_t, uint32_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                                           PoolStlAllocator<std::pair<const uint64_t, uint32_t>>>;
+    PoolAllocator nodePool(MIDPOINT_NODE_BYTES, 4096);
+    for (uint32_t level = 0; level < subdivisions; level++) {
+        MidpointMap midpoints(0, std::hash<uint64_t>(), std::equal_to<uint64_t>(),
+                              PoolStlAllocator<std::pair<const uint64_t, uint32_t>>(nodePool));
+        auto midpoint = [&](uint32_t a, uint32_t b) {
+            uint64_t key = a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+            auto it = midpoints.find(key);
+            if (it != midpoints.end()) return it->second;
+
+            MeshVertex v{};
+            for (int i = 0; i < 3; i++) {
+                v.position[i] = (mesh.vertices[a].position[i] + mesh.vertices[b].position[i]) * 0.5f;
+            }
+            normalize3(v.position);
+            uint32_t index = static_cast<uint32_t>(mesh.vertices.size());
+            mesh.vertices.push_back(v);
+            midpoints.emplace(key, index);
+            return index;
+        };
+
+        std::vector<uint32_t> next;
+        next.reserve(mesh.indices.size() * 4);
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            uint32_t a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+            uint32_t ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+            next.insert(next.end(), { a, ab, ca,  b, bc, ab,  c, ca, bc,  ab, bc, ca });
+        }
+        mesh.indices.swap(next);
+    }
+
+    for (MeshVertex& v : mesh.vertices) {
+        float scale = 1.0f + displacement(v.position, seed);
+        v.position[0] *= scale;
+        v.position[1] *= scale * 0.8f;   // a little flatter than tall
+        v.position[2] *= scale;
+    }
+
+    computeNormals(mesh);
+    return mesh;
+}
+
+void computeNormals(MeshData& mesh) {
+    for (MeshVertex& v : mesh.vertices) {
+        v.normal[0] = v.normal[1] = v.normal[2] = 0.0f;
+    }
+
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        MeshVertex& a = mesh.vertices[mesh.indices[i]];
+        MeshVertex& b = mesh.vertices[mesh.indices[i + 1]];
+        MeshVertex& c = mesh.vertices[mesh.indices[i + 2]];
+
+        float e1[3], e2[3];
+        for (int k = 0; k < 3; k++) {
+            e1[k] = b.position[k] - a.position[k];
+            e2[k] = c.position[k] - a.position[k];
+        }
+        // Clockwise winding: outward normal is e2 x e1 (length = 2 * area).
+        float n[3] = {
+            e2[1] * e1[2] - e2[2] * e1[1],
+            e2[2] * e1[0] - e2[0] * e1[2],
+            e2[0] * e1[1] - e2[1] * e1[0],
+        };
+        for (int k = 0; k < 3; k++) {
+            a.normal[k] += n[k];
+            b.normal[k] += n[k];
+            c.normal[k] += n[k];
+        }
+    }
+
+    for (MeshVertex& v : mesh.vertices) {
+        normalize3(v.normal);
+    }
+}
@@ -0,0 +1,24 @@
+// src/Mesh.h
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Vertex layout used by indexed meshes (binding 0 in lod.vert).
+struct MeshVertex {
+    float position[3];
+    float normal[3];
+};
+
+// CPU-side indexed triangle list.
+struct MeshData {
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t>   indices;
+};
+
+// Procedural rock: an icosphere subdivided `subdivisions` times (20 * 4^n
+// triangles) with low-frequency noise displacement. Unit-ish radius.
+MeshData createRockMesh(uint32_t subdivisions, uint32_t seed);
+
+// Recomputes smooth, area-weighted vertex normals from the triangles.
+void computeNormals(MeshData& mesh);
@@ -0,0 +1,207 @@
+// src/MeshLod.cpp
+#include "MeshLod.h"
+#include "MeshSimplifier.h"
+#include "Camera.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    const uint32_t LOD_CACHE_MAGIC = 0x4c4f4443;   // "LODC"
+    const uint32_t LOD_CACHE_VERSION = 1;
+
+    // FNV-1a over the mesh and the chain settings.
+    uint64_t hashSource(const MeshData& mesh, const LodChainSettings& settings) {
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; i++) {
+                h ^= bytes[i];
+                h *= 1099511628211ull;
+            }
+        };
+        mix(mesh.vertices.data(), mesh.vertices.size() * sizeof(MeshVertex));
+        mix(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+        mix(&settings, sizeof(settings));
+        mix(&LOD_CACHE_VERSION, sizeof(LOD_CACHE_VERSION));
+        return h;
+    }
+
+    void computeBounds(const MeshData& mesh, LodMesh& lodMesh) {
+        float lo[3] = { 1e30f, 1e30f, 1e30f };
+        float hi[3] = { -1e30f, -1e30f, -1e30f };
+        for (const MeshVertex& v : mesh.vertices) {
+            for (int k = 0; k < 3; k++) {
+                lo[k] = std::min(lo[k], v.position[k]);
+                hi[k] = std::max(hi[k], v.position[k]);
+            }
+        }
+        for (int k = 0; k < 3; k++) {
+            lodMesh.center[k] = (lo[k] + hi[k]) * 0.5f;
+        }
+        float r2 = 0.0f;
+        for (const MeshVertex& v : mesh.vertices) {
+            float dx = v.position[0] - lodMesh.center[0];
+            float dy = v.position[1] - lodMesh.center[1];
+            float dz = v.position[2] - lodMesh.center[2];
+            r2 = std::max(r2, dx * dx + dy * dy + dz * dz);
+        }
+        lodMesh.radius = std::sqrt(r2);
+    }
+}
+
+//-------------------------------------------------------------------------
+// LOD chain
+//-------------------------------------------------------------------------
+
+LodMesh buildLodChain(const MeshData& mesh, std::vector<uint32_t>& sharedIndices,
+                      const LodChainSettings& settings)
+{
+    LodMesh lodMesh;
+    computeBounds(mesh, lodMesh);
+
+    auto append = [&](const std::vector<uint32_t>& indices, float error) {
+        MeshLod lod;
+        lod.firstIndex = static_cast<uint32_t>(sharedIndices.size());
+        lod.indexCount = static_cast<uint32_t>(indices.size());
+        lod.error = error;
+        sharedIndices.insert(sharedIndices.end(), indices.begin(), indices.end());
+        lodMesh.lods.push_back(lod);
+    };
+
+    append(mesh.indices, 0.0f);
+
+    std::vector<uint32_t> current = mesh.indices;
+    float error = 0.0f;
+    while (lodMesh.lods.size() < settings.maxLods) {
+        size_t target = size_t(float(current.size()) * settings.reduction) / 3 * 3;
+        if (target / 3 < settings.minTriangles) break;
+
+        SimplifyResult result = simplifyMesh(mesh.vertices, current, target);
+        // Not worth a level if the simplifier got stuck (e.g. locked borders).
+        if (result.indices.size() > current.size() * 0.9f) break;
+
+        // Each level is simplified from the previous one, so errors add up.
+        error += result.error;
+        append(result.indices, error);
+        current.swap(result.indices);
+    }
+    return lodMesh;
+}
+
+LodMesh loadOrBuildLodChain(const std::string& cachePath, const MeshData& mesh,
+                            std::vector<uint32_t>& sharedIndices, const LodChainSettings& settings)
+{
+    uint64_t sourceHash = hashSource(mesh, settings);
+
+    // Cached: header, lod records, then this mesh's indices (firstIndex relative to them).
+    std::ifstream in(cachePath, std::ios::binary);
+    if (in) {
+        uint32_t magic = 0, lodCount = 0;
+        uint64_t storedHash = 0;
+        LodMesh lodMesh;
+        in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        in.read(reinterpret_cast<char*>(&storedHash), sizeof(storedHash));
+        in.read(reinterpret_cast<char*>(&lodCount), sizeof(lodCount));
+        in.read(reinterpret_cast<char*>(lodMesh.center), sizeof(lodMesh.center));
+        in.read(reinterpret_cast<char*>(&lodMesh.radius), sizeof(lodMesh.radius));
+
+        if (in && magic == LOD_CACHE_MAGIC && storedHash == sourceHash && lodCount > 0) {
+            lodMesh.lods.resize(lodCount);
+            in.read(reinterpret_cast<char*>(lodMesh.lods.data()), lodCount * sizeof(MeshLod));
+
+            const MeshLod& last = lodMesh.lods.back();
+            std::vector<uint32_t> indices(last.firstIndex + last.indexCount);
+            in.read(reinterpret_cast<char*>(indices.data()), indices.size() * sizeof(uint32_t));
+
+            if (in) {
+                uint32_t base = static_cast<uint32_t>(sharedIndices.size());
+                for (MeshLod& lod : lodMesh.lods) lod.firstIndex += base;
+                sharedIndices.insert(sharedIndices.end(), indices.begin(), indices.end());
+                return lodMesh;
+            }
+        }
+    }
+
+    std::vector<uint32_t> indices;
+    LodMesh lodMesh = buildLodChain(mesh, indices, settings);
+
+    std::error_code ec;
+    std::filesystem::path path(cachePath);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    std::ofstream out(cachePath, std::ios::binary);
+    if (out) {
+        uint32_t lodCount = static_cast<uint32_t>(lodMesh.lods.size());
+        out.write(reinterpret_cast<const char*>(&LOD_CACHE_MAGIC), sizeof(LOD_CACHE_MAGIC));
+        out.write(reinterpret_cast<const char*>(&sourceHash), sizeof(sourceHash));
+        out.write(reinterpret_cast<const char*>(&lodCount), sizeof(lodCount));
+        out.write(reinterpret_cast<const char*>(lodMesh.center), sizeof(lodMesh.center));
+        out.write(reinterpret_cast<const char*>(&lodMesh.radius), sizeof(lodMesh.radius));
+        out.write(reinterpret_cast<const char*>(lodMesh.lods.data()), lodCount * sizeof(MeshLod));
+        out.write(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+    }
+    else {
+        Logger::global().logf(LogSeverity::Warning, "engine", "could not write LOD cache %s", cachePath.c_str());
+    }
+
+    uint32_t base = static_cast<uint32_t>(sharedIndices.size());
+    for (MeshLod& lod : lodMesh.lods) lod.firstIndex += base;
+    sharedIndices.insert(sharedIndices.end(), indices.begin(), indices.end());
+    return lodMesh;
+}
+
+//-------------------------------------------------------------------------
+// LodSelector
+//-------------------------------------------------------------------------
+
+void LodSelector::configure(float thresholdPixels_, float hysteresis_) {
+    thresholdPixels = thresholdPixels_;
+    hysteresis = std::clamp(hysteresis_, 0.0f, 0.9f);
+}
+
+void LodSelector::setView(const Camera& camera, float viewportHeight) {
+    pixelsPerUnit = viewportHeight / (2.0f * std::tan(camera.fovY() * 0.5f));
+    nearPlane = camera.nearPlane();
+    eye[0] = camera.position().x;
+    eye[1] = camera.position().y;
+    eye[2] = camera.position().z;
+}
+
+float LodSelector::projectedError(float error, float distance) const {
+    return error * pixelsPerUnit / std::max(distance, nearPlane);
+}
+
+uint32_t LodSelector::select(const LodMesh& mesh, const float position[3], float scale, uint32_t currentLod) const {
+    if (mesh.lods.size() <= 1) return 0;
+
+    // Distance to the bounding sphere's surface: conservative for the nearest point.
+    float dx = position[0] + mesh.center[0] * scale - eye[0];
+    float dy = position[1] + mesh.center[1] * scale - eye[1];
+    float dz = position[2] + mesh.center[2] * scale - eye[2];
+    float distance = std::sqrt(dx * dx + dy * dy + dz * dz) - mesh.radius * scale;
+
+    uint32_t last = static_cast<uint32_t>(mesh.lods.size()) - 1;
+    currentLod = std::min(currentLod, last);
+
+    // Coarsest level within the threshold (errors grow monotonically).
+    uint32_t target = 0;
+    for (uint32_t lod = last; lod > 0; lod--) {
+        if (projectedError(mesh.lods[lod].error * scale, distance) <= thresholdPixels) {
+            target = lod;
+            break;
+        }
+    }
+
+    // Coarsening needs a margin; refining does not.
+    float coarsenThreshold = thresholdPixels * (1.0f - hysteresis);
+    while (target > currentLod &&
+           projectedError(mesh.lods[target].error * scale, distance) > coarsenThreshold) {
+        target--;
+    }
+    return target;
+}
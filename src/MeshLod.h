@@ -0,0 +1,68 @@
+// src/MeshLod.h
+#pragma once
+
+#include "Mesh.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Camera;
+
+// One level of detail: a range of the shared index buffer.
+struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float    error = 0.0f;   // object-space deviation from LOD 0 (conservative)
+};
+
+// LOD chain of one mesh, finest first. All levels index the same vertex buffer.
+struct LodMesh {
+    std::vector<MeshLod> lods;
+    float center[3] = {};
+    float radius = 0.0f;     // bounding sphere in object space
+};
+
+struct LodChainSettings {
+    uint32_t maxLods = 6;
+    float    reduction = 0.5f;      // index count ratio between consecutive levels
+    uint32_t minTriangles = 64;     // stop before going below this
+};
+
+// Runs the QEM simplifier repeatedly and appends every level's indices to
+// `sharedIndices`. Stops early when a level fails to shrink meaningfully.
+LodMesh buildLodChain(const MeshData& mesh, std::vector<uint32_t>& sharedIndices,
+                      const LodChainSettings& settings = LodChainSettings{});
+
+// Offline path: loads the chain from `cachePath` when it was built from the
+// same mesh and settings, otherwise builds it and writes the cache.
+LodMesh loadOrBuildLodChain(const std::string& cachePath, const MeshData& mesh,
+                            std::vector<uint32_t>& sharedIndices,
+                            const LodChainSettings& settings = LodChainSettings{});
+
+// Picks LODs by projected screen-space error.
+//
+// A level is acceptable when its error, projected at the object's distance,
+// is at most `thresholdPixels`. To stop objects near a switch distance from
+// flickering between levels, moving to a coarser level additionally requires
+// the error to be below threshold * (1 - hysteresis); moving finer happens as
+// soon as the current level exceeds the threshold.
+class LodSelector {
+public:
+    void configure(float thresholdPixels, float hysteresis);
+
+    // Call once per frame before select().
+    void setView(const Camera& camera, float viewportHeight);
+
+    // `position`/`scale` place the mesh in the world; `currentLod` is last frame's choice.
+    uint32_t select(const LodMesh& mesh, const float position[3], float scale, uint32_t currentLod) const;
+
+    float projectedError(float error, float distance) const;
+
+private:
+    float thresholdPixels = 1.0f;
+    float hysteresis = 0.25f;
+    float pixelsPerUnit = 1.0f;   // at distance 1
+    float nearPlane = 0.1f;
+    float eye[3] = {};
+};
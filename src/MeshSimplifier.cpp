@@ -0,0 +1,236 @@
+// src/MeshSimplifier.cpp
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+
+namespace {
+    // Symmetric 4x4 quadric stored as its 10 unique coefficients.
+    struct Quadric {
+        double a2 = 0, ab = 0, ac = 0, ad = 0;
+        double b2 = 0, bc = 0, bd = 0;
+        double c2 = 0, cd = 0;
+        double d2 = 0;
+        double weight = 0;   // total area of the planes accumulated so far
+
+        // Plane ax + by + cz + d = 0 with unit normal, scaled by `weight`.
+        static Quadric plane(double a, double b, double c, double d, double weight) {
+            Quadric q;
+            q.a2 = a * a * weight; q.ab = a * b * weight; q.ac = a * c * weight; q.ad = a * d * weight;
+            q.b2 = b * b * weight; q.bc = b * c * weight; q.bd = b * d * weight;
+            q.c2 = c * c * weight; q.cd = c * d * weight;
+            q.d2 = d * d * weight;
+            q.weight = weight;
+            return q;
+        }
+
+        void add(const Quadric& o) {
+            a2 += o.a2; ab += o.ab; ac += o.ac; ad += o.ad;
+            b2 += o.b2; bc += o.bc; bd += o.bd;
+            c2 += o.c2; cd += o.cd;
+            d2 += o.d2;
+            weight += o.weight;
+        }
+
+        // Sum of squared distances (weighted) from p to the accumulated planes.
+        double evaluate(const float p[3]) const {
+            double x = p[0], y = p[1], z = p[2];
+            return x * x * a2 + 2 * x * y * ab + 2 * x * z * ac + 2 * x * ad
+                 + y * y * b2 + 2 * y * z * bc + 2 * y * bd
+                 + z * z * c2 + 2 * z * cd
+                 + d2;
+        }
+    };
+
+    struct Collapse {
+        double   cost;
+        double   error;   // cost / quadric area: mean squared distance over the merged region
+        uint32_t from;
+        uint32_t to;
+        uint32_t fromVersion;
+        uint32_t toVersion;
+
+        bool operator>(const Collapse& o) const { return cost > o.cost; }
+    };
+
+    void triangleNormal(const float* a, const float* b, const float* c, double n[3]) {
+        double e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        double e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+    }
+}
+
+SimplifyResult simplifyMesh(const std::vector<MeshVertex>& vertices,
+                            const std::vector<uint32_t>& indices,
+                            size_t targetIndexCount)
+{
+    const size_t vertexCount = vertices.size();
+    const size_t triangleCount = indices.size() / 3;
+
+    std::vector<uint32_t> tris(indices.begin(), indices.begin() + triangleCount * 3);
+    std::vector<bool> triangleAlive(triangleCount, true);
+    size_t aliveTriangles = triangleCount;
+
+    // Vertex -> incident triangles (may contain dead entries; filtered on use).
+    std::vector<std::vector<uint32_t>> vertexTriangles(vertexCount);
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) {
+            vertexTriangles[tris[t * 3 + k]].push_back(t);
+        }
+    }
+
+    // Quadrics: area-weighted planes of the incident faces.
+    std::vector<Quadric> quadrics(vertexCount);
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        const float* p0 = vertices[tris[t * 3]].position;
+        const float* p1 = vertices[tris[t * 3 + 1]].position;
+        const float* p2 = vertices[tris[t * 3 + 2]].position;
+
+        double n[3];
+        triangleNormal(p0, p1, p2, n);
+        double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (len == 0.0) continue;
+        n[0] /= len; n[1] /= len; n[2] /= len;
+        double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+
+        Quadric q = Quadric::plane(n[0], n[1], n[2], d, len * 0.5);
+        for (int k = 0; k < 3; k++) {
+            quadrics[tris[t * 3 + k]].add(q);
+        }
+    }
+
+    // Lock vertices on open borders: an edge used by exactly one triangle.
+    std::vector<bool> locked(vertexCount, false);
+    {
+        std::unordered_map<uint64_t, int> edgeUse;
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t a = tris[t * 3 + k], b = tris[t * 3 + (k + 1) % 3];
+                uint64_t key = a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+                edgeUse[key]++;
+            }
+        }
+        for (const auto& [key, uses] : edgeUse) {
+            if (uses == 1) {
+                locked[uint32_t(key >> 32)] = true;
+                locked[uint32_t(key & 0xffffffffu)] = true;
+            }
+        }
+    }
+
+    std::vector<bool> removed(vertexCount, false);
+    std::vector<uint32_t> version(vertexCount, 0);
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+
+    auto pushCollapse = [&](uint32_t from, uint32_t to) {
+        if (locked[from]) return;
+        Quadric q = quadrics[from];
+        q.add(quadrics[to]);
+        double cost = std::max(q.evaluate(vertices[to].position), 0.0);
+        double error = q.weight > 0.0 ? cost / q.weight : 0.0;
+        heap.push({ cost, error, from, to, version[from], version[to] });
+    };
+
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) {
+            uint32_t a = tris[t * 3 + k], b = tris[t * 3 + (k + 1) % 3];
+            pushCollapse(a, b);
+            pushCollapse(b, a);
+        }
+    }
+
+    // Moving `from` onto `to` must not flip any surviving triangle around `from`.
+    auto collapseFlips = [&](uint32_t from, uint32_t to) {
+        for (uint32_t t : vertexTriangles[from]) {
+            if (!triangleAlive[t]) continue;
+            uint32_t* tri = &tris[t * 3];
+            if (tri[0] == to || tri[1] == to || tri[2] == to) continue;   // removed by the collapse
+
+            const float* p[3];
+            const float* moved[3];
+            for (int k = 0; k < 3; k++) {
+                p[k] = vertices[tri[k]].position;
+                moved[k] = tri[k] == from ? vertices[to].position : p[k];
+            }
+            double before[3], after[3];
+            triangleNormal(p[0], p[1], p[2], before);
+            triangleNormal(moved[0], moved[1], moved[2], after);
+            if (before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    double maxError = 0.0;
+    const size_t targetTriangles = targetIndexCount / 3;
+
+    while (aliveTriangles > targetTriangles && !heap.empty()) {
+        Collapse c = heap.top();
+        heap.pop();
+
+        if (removed[c.from] || removed[c.to] ||
+            c.fromVersion != version[c.from] || c.toVersion != version[c.to]) {
+            continue;   // stale entry
+        }
+
+        // The edge may have disappeared through an earlier collapse.
+        bool edgeExists = false;
+        for (uint32_t t : vertexTriangles[c.from]) {
+            const uint32_t* tri = &tris[t * 3];
+            if (triangleAlive[t] && (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to)) {
+                edgeExists = true;
+                break;
+            }
+        }
+        if (!edgeExists || collapseFlips(c.from, c.to)) continue;
+
+        for (uint32_t t : vertexTriangles[c.from]) {
+            if (!triangleAlive[t]) continue;
+            uint32_t* tri = &tris[t * 3];
+            if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) {
+                triangleAlive[t] = false;
+                aliveTriangles--;
+                continue;
+            }
+            for (int k = 0; k < 3; k++) {
+                if (tri[k] == c.from) tri[k] = c.to;
+            }
+            vertexTriangles[c.to].push_back(t);
+        }
+        vertexTriangles[c.from].clear();
+
+        quadrics[c.to].add(quadrics[c.from]);
+        removed[c.from] = true;
+        version[c.to]++;
+        maxError = std::max(maxError, c.error);
+
+        // Re-queue the edges around the merged vertex with its new quadric.
+        auto& around = vertexTriangles[c.to];
+        around.erase(std::remove_if(around.begin(), around.end(),
+            [&](uint32_t t) { return !triangleAlive[t]; }), around.end());
+        for (uint32_t t : around) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t n = tris[t * 3 + k];
+                if (n == c.to) continue;
+                pushCollapse(c.to, n);
+                pushCollapse(n, c.to);
+            }
+        }
+    }
+
+    SimplifyResult result;
+    result.indices.reserve(aliveTriangles * 3);
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        if (triangleAlive[t]) {
+            result.indices.insert(result.indices.end(), { tris[t * 3], tris[t * 3 + 1], tris[t * 3 + 2] });
+        }
+    }
+
+    result.error = float(std::sqrt(maxError));
+    return result;
+}
@@ -0,0 +1,25 @@
+// src/MeshSimplifier.h
+#pragma once
+
+#include "Mesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Quadric error metric (Garland & Heckbert) edge-collapse simplifier.
+//
+// Collapses always move a vertex onto one of its existing neighbours, so the
+// result only needs a new index list: every LOD of a mesh can share the
+// original vertex buffer.
+struct SimplifyResult {
+    std::vector<uint32_t> indices;
+    float error = 0.0f;   // largest collapse error, as an object-space distance
+};
+
+// Simplifies `indices` (a triangle list over `vertices`) until it has at most
+// `targetIndexCount` indices or no collapse is possible without flipping a
+// triangle. Vertices on open borders are never moved.
+SimplifyResult simplifyMesh(const std::vector<MeshVertex>& vertices,
+                            const std::vector<uint32_t>& indices,
+                            size_t targetIndexCount);
@@ -0,0 +1,78 @@
+// src/MpscQueue.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free queue for any number of producer threads and exactly one
+// consumer thread. Capacity is rounded up to a power of two. push() fails
+// instead of blocking when the queue is full.
+//
+// Each slot carries a sequence number: producers claim a slot by advancing
+// `tail` with a CAS, fill it, then publish it by bumping the slot's sequence,
+// so a slow producer never exposes a half-written value to the consumer.
+template <typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.reset(new Slot[size]);
+        for (size_t i = 0; i < size; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+        mask = size - 1;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Producer side, safe from any thread.
+    bool push(const T& value) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[pos & mask];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(seq) - intptr_t(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                return false;   // the consumer has not freed this slot yet: full
+            }
+            else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = value;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. peek() returns nullptr when empty; the pointer stays valid until pop().
+    const T* peek() const {
+        const Slot& slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) return nullptr;
+        return &slot.value;
+    }
+    void pop() {
+        slots[head & mask].sequence.store(head + mask + 1, std::memory_order_release);
+        head++;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{ 0 };
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask = 0;
+
+    // Separate cache lines so producers and the consumer do not false-share.
+    alignas(64) size_t head = 0;   // consumer only
+    alignas(64) std::atomic<size_t> tail{ 0 };
+};
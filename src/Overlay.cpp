@@ -0,0 +1,242 @@
+// src/Overlay.cpp
+#include "Overlay.h"
+#include "HostMemoryTracker.h"
+#include "OverlayFont.h"
+#include "Device.h"
+#include "SwapChain.h"
+#include "RenderPass.h"
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+    const uint32_t VERTICES_PER_QUAD = 6;
+
+    // Matches the push constant block in overlay.vert: pixels -> clip space.
+    struct OverlayPushConstants {
+        float scale[2];
+        float offset[2];
+    };
+
+    // Glyphs stay crisp at whole-pixel scales; 2x from 1440p up.
+    const uint32_t LARGE_GLYPH_MIN_HEIGHT = 1440;
+}
+
+void Overlay::init(Device& device_, SwapChain& swapChain, RenderPass& renderPass, uint32_t framesInFlight) {
+    device = &device_;
+
+    createAtlas();
+    createDescriptors();
+    createRing(framesInFlight);
+
+    // Drawn last in the main pass: no depth, no culling, standard alpha blending.
+    PipelineConfig config;
+    config.vertShader = "shaders_spv/overlay_vert.spv";
+    config.fragShader = "shaders_spv/overlay_frag.spv";
+    config.depthTest = false;
+    config.depthWrite = false;
+    config.cullMode = VK_CULL_MODE_NONE;
+    config.alphaBlend = true;
+    config.pushConstantSize = sizeof(OverlayPushConstants);
+    config.setLayouts = { descriptorSetLayout };
+    config.vertexBindings = { { 0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX } };
+    config.vertexAttributes = {
+        { 0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, position) },
+        { 1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv) },
+        { 2, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(Vertex, color) },
+    };
+    pipeline.init(*device, swapChain, renderPass, config);
+}
+
+void Overlay::cleanup() {
+    VkDevice dev = device->device();
+
+    pipeline.cleanup();
+    vkDestroyDescriptorPool(dev, descriptorPool, hostAllocator("Overlay"));
+    vkDestroyDescriptorSetLayout(dev, descriptorSetLayout, hostAllocator("Overlay"));
+
+    vkUnmapMemory(dev, ringMemory);
+    vkDestroyBuffer(dev, ringBuffer, hostAllocator("Overlay"));
+    device->freeMemory(ringMemory);
+    ringMapped = nullptr;
+    cursor = nullptr;
+
+    vkDestroySampler(dev, atlasSampler, hostAllocator("Overlay"));
+    vkDestroyImageView(dev, atlasView, hostAllocator("Overlay"));
+    vkDestroyImage(dev, atlasImage, hostAllocator("Overlay"));
+    device->freeMemory(atlasMemory);
+}
+
+void Overlay::createAtlas() {
+    std::vector<uint8_t> pixels = OverlayFont::bakeAtlas();
+    device->createDeviceLocalImage(pixels.data(), pixels.size(), OverlayFont::ATLAS_WIDTH, OverlayFont::ATLAS_HEIGHT,
+        VK_FORMAT_R8_UNORM, atlasImage, atlasMemory);
+    atlasView = device->createImageView(atlasImage, VK_FORMAT_R8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT);
+
+    // Nearest: glyphs land on whole pixels, so no filtering is wanted.
+    VkSamplerCreateInfo samplerInfo{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    if (vkCreateSampler(device->device(), &samplerInfo, hostAllocator("Overlay"), &atlasSampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create overlay sampler!");
+    }
+
+    uint32_t x, y;
+    OverlayFont::glyphOrigin(OverlayFont::SOLID_CHAR, x, y);
+    solidU = (float(x) + 0.5f * OverlayFont::GLYPH_CELL_WIDTH) / float(OverlayFont::ATLAS_WIDTH);
+    solidV = (float(y) + 0.5f * OverlayFont::GLYPH_CELL_HEIGHT) / float(OverlayFont::ATLAS_HEIGHT);
+}
+
+void Overlay::createDescriptors() {
+    VkDevice dev = device->device();
+
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+    if (vkCreateDescriptorSetLayout(dev, &layoutInfo, hostAllocator("Overlay"), &descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create overlay descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1 };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(dev, &poolInfo, hostAllocator("Overlay"), &descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create overlay descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &descriptorSetLayout;
+    if (vkAllocateDescriptorSets(dev, &allocInfo, &descriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate overlay descriptor set!");
+    }
+
+    VkDescriptorImageInfo imageInfo{ atlasSampler, atlasView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    write.dstSet = descriptorSet;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(dev, 1, &write, 0, nullptr);
+}
+
+void Overlay::createRing(uint32_t framesInFlight) {
+    VkDeviceSize regionBytes = VkDeviceSize(MAX_QUADS) * VERTICES_PER_QUAD * sizeof(Vertex);
+    device->createBuffer(regionBytes * framesInFlight, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        ringBuffer, ringMemory);
+
+    void* mapped = nullptr;
+    vkMapMemory(device->device(), ringMemory, 0, VK_WHOLE_SIZE, 0, &mapped);
+    ringMapped = static_cast<Vertex*>(mapped);
+}
+
+//-------------------------------------------------------------------------
+// Batching
+//-------------------------------------------------------------------------
+
+void Overlay::begin(uint32_t frame, VkExtent2D extent_) {
+    extent = extent_;
+    cursor = ringMapped + size_t(frame) * MAX_QUADS * VERTICES_PER_QUAD;
+    quads = 0;
+    dropped = 0;
+    scale = extent.height >= LARGE_GLYPH_MIN_HEIGHT ? 2.0f : 1.0f;
+}
+
+float Overlay::charWidth() const {
+    return float(OverlayFont::GLYPH_CELL_WIDTH) * scale;
+}
+
+float Overlay::lineHeight() const {
+    return float(OverlayFont::GLYPH_CELL_HEIGHT + 2) * scale;
+}
+
+void Overlay::quad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, uint32_t color) {
+    if (quads == MAX_QUADS) {
+        dropped++;
+        return;
+    }
+    // Two triangles; written straight into mapped (write-combined) memory in order.
+    const Vertex v[VERTICES_PER_QUAD] = {
+        { { x0, y0 }, { u0, v0 }, color },
+        { { x1, y0 }, { u1, v0 }, color },
+        { { x1, y1 }, { u1, v1 }, color },
+        { { x0, y0 }, { u0, v0 }, color },
+        { { x1, y1 }, { u1, v1 }, color },
+        { { x0, y1 }, { u0, v1 }, color },
+    };
+    Vertex* out = cursor + size_t(quads) * VERTICES_PER_QUAD;
+    for (uint32_t i = 0; i < VERTICES_PER_QUAD; i++) out[i] = v[i];
+    quads++;
+}
+
+void Overlay::rect(float x, float y, float width, float height, uint32_t color) {
+    if (width <= 0.0f || height <= 0.0f) return;
+    quad(x, y, x + width, y + height, solidU, solidV, solidU, solidV, color);
+}
+
+float Overlay::text(float x, float y, const char* text, uint32_t color) {
+    const float invWidth = 1.0f / float(OverlayFont::ATLAS_WIDTH);
+    const float invHeight = 1.0f / float(OverlayFont::ATLAS_HEIGHT);
+    const float glyphW = float(OverlayFont::GLYPH_WIDTH) * scale;
+    const float glyphH = float(OverlayFont::GLYPH_HEIGHT) * scale;
+
+    float penX = x;
+    for (const char* c = text; *c; c++) {
+        if (*c == '\n') {
+            penX = x;
+            y += lineHeight();
+            continue;
+        }
+        if (*c != ' ') {
+            uint32_t gx, gy;
+            OverlayFont::glyphOrigin(*c, gx, gy);
+            quad(penX, y, penX + glyphW, y + glyphH,
+                float(gx) * invWidth, float(gy) * invHeight,
+                float(gx + OverlayFont::GLYPH_WIDTH) * invWidth, float(gy + OverlayFont::GLYPH_HEIGHT) * invHeight,
+                color);
+        }
+        penX += charWidth();
+    }
+    return penX;
+}
+
+float Overlay::textf(float x, float y, uint32_t color, const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return text(x, y, buffer, color);
+}
+
+void Overlay::recordDraw(VkCommandBuffer commandBuffer, uint32_t frame) {
+    if (quads == 0) return;
+
+    OverlayPushConstants push{ { 2.0f / float(extent.width), 2.0f / float(extent.height) }, { -1.0f, -1.0f } };
+    VkDeviceSize offset = VkDeviceSize(frame) * MAX_QUADS * VERTICES_PER_QUAD * sizeof(Vertex);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.get());
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &ringBuffer, &offset);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout(),
+        0, 1, &descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, pipeline.layout(), VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        0, sizeof(push), &push);
+    vkCmdDraw(commandBuffer, quads * VERTICES_PER_QUAD, 1, 0, 0);
+}
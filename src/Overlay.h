@@ -0,0 +1,95 @@
+// src/Overlay.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+#include "Pipeline.h"
+
+class Device;
+class SwapChain;
+class RenderPass;
+
+// RGBA8 as the overlay vertex format stores it (R in the low byte).
+constexpr uint32_t overlayColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+    return uint32_t(r) | (uint32_t(g) << 8) | (uint32_t(b) << 16) | (uint32_t(a) << 24);
+}
+
+// Immediate-mode 2D batcher for on-screen diagnostics (the --overlay panel).
+//
+// Text and filled rectangles share one pipeline and one texture: glyphs come
+// from the baked OverlayFont atlas and rectangles sample its solid cell. Every
+// quad of a frame is appended as six vertices to that frame slot's region of a
+// host-visible vertex ring, so recordDraw() is one bind and one vkCmdDraw no
+// matter how much is on screen. Coordinates are framebuffer pixels, origin top-left.
+class Overlay {
+public:
+    // Quads per frame; anything past this is dropped (and counted).
+    static constexpr uint32_t MAX_QUADS = 8192;
+
+    void init(Device& device, SwapChain& swapChain, RenderPass& renderPass, uint32_t framesInFlight);
+    void cleanup();
+
+    // Starts frame slot `frame`'s batch for a framebuffer of `extent`. Its previous
+    // contents must be retired (the renderer's in-flight fence).
+    void begin(uint32_t frame, VkExtent2D extent);
+
+    void rect(float x, float y, float width, float height, uint32_t color);
+    // Draws `text` at integer glyph scale; '\n' starts a new line. Returns the x after the last glyph.
+    float text(float x, float y, const char* text, uint32_t color);
+    // printf-style text, truncated to 255 characters.
+    float textf(float x, float y, uint32_t color, const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((format(printf, 5, 6)))
+#endif
+        ;
+
+    // Glyph scale in whole pixels (1 = 5x7 glyphs); begin() picks one from the framebuffer height.
+    float glyphScale() const { return scale; }
+    float charWidth() const;
+    float lineHeight() const;
+
+    // Draws the current batch inside the active render pass; nothing when it is empty.
+    void recordDraw(VkCommandBuffer commandBuffer, uint32_t frame);
+
+    uint32_t quadCount() const { return quads; }
+    uint32_t droppedQuads() const { return dropped; }
+
+private:
+    struct Vertex {
+        float    position[2];
+        float    uv[2];
+        uint32_t color;
+    };
+
+    void createAtlas();
+    void createDescriptors();
+    void createRing(uint32_t framesInFlight);
+    void quad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, uint32_t color);
+
+    Device* device = nullptr;
+
+    VkImage        atlasImage = VK_NULL_HANDLE;
+    VkDeviceMemory atlasMemory = VK_NULL_HANDLE;
+    VkImageView    atlasView = VK_NULL_HANDLE;
+    VkSampler      atlasSampler = VK_NULL_HANDLE;
+    float          solidU = 0.0f, solidV = 0.0f;   // center of the atlas' solid cell
+
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool      descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet       descriptorSet = VK_NULL_HANDLE;   // the atlas never changes
+    Pipeline              pipeline;
+
+    // One MAX_QUADS region per frame in flight, persistently mapped.
+    VkBuffer       ringBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory ringMemory = VK_NULL_HANDLE;
+    Vertex*        ringMapped = nullptr;
+
+    // Batch being built by begin()/rect()/text().
+    Vertex*    cursor = nullptr;
+    uint32_t   quads = 0;
+    uint32_t   dropped = 0;
+    float      scale = 1.0f;
+    VkExtent2D extent{};
+};
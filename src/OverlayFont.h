@@ -0,0 +1,31 @@
+// src/OverlayFont.h
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Built-in 5x7 bitmap font for the performance overlay, baked into a single
+// R8 atlas at startup so text needs no font files and no per-glyph textures.
+//
+// Atlas layout: printable ASCII 32..126 in a 16 x 6 grid of GLYPH_CELL_WIDTH x
+// GLYPH_CELL_HEIGHT cells (one texel of spacing right and below each glyph).
+// The last cell (code 127) is solid, so untextured rectangles can go through
+// the same pipeline and draw call as text.
+namespace OverlayFont {
+    constexpr uint32_t GLYPH_WIDTH = 5;
+    constexpr uint32_t GLYPH_HEIGHT = 7;
+    constexpr uint32_t GLYPH_CELL_WIDTH = 6;
+    constexpr uint32_t GLYPH_CELL_HEIGHT = 8;
+    constexpr uint32_t ATLAS_COLUMNS = 16;
+    constexpr uint32_t ATLAS_ROWS = 6;
+    constexpr uint32_t ATLAS_WIDTH = ATLAS_COLUMNS * GLYPH_CELL_WIDTH;    // 96
+    constexpr uint32_t ATLAS_HEIGHT = ATLAS_ROWS * GLYPH_CELL_HEIGHT;     // 48
+    constexpr char     FIRST_CHAR = 32;
+    constexpr char     SOLID_CHAR = 127;   // fully covered cell, for rectangles
+
+    // ATLAS_WIDTH * ATLAS_HEIGHT coverage bytes (0 or 255), row-major.
+    std::vector<uint8_t> bakeAtlas();
+
+    // Top-left texel of `c`'s cell; characters outside 32..127 map to '?'.
+    void glyphOrigin(char c, uint32_t& x, uint32_t& y);
+}
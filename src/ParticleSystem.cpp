@@ -0,0 +1,378 @@
+// src/ParticleSystem.cpp
+#include "ParticleSystem.h"
+#include "HostMemoryTracker.h"
+#include "Device.h"
+#include "SwapChain.h"
+#include "RenderPass.h"
+#include "Camera.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    const uint32_t WORKGROUP_SIZE = 256;
+    const float    AVERAGE_LIFETIME = 3.0f;   // seconds, matches particle_emit.comp
+
+    // Matches `struct Particle` in the particle shaders (two vec4s).
+    const VkDeviceSize PARTICLE_SIZE = 32;
+
+    // counterBuffer layout (std430, see particle_*.comp):
+    //   int  deadCount;  uint aliveCount[2];  uint pad;
+    //   uvec4 simulateDispatch[2];            // VkDispatchIndirectCommand + pad
+    const VkDeviceSize COUNTER_BUFFER_SIZE = 48;
+    const VkDeviceSize DISPATCH_ARGS_OFFSET = 16;
+
+    struct ComputePushConstants {
+        float    deltaTime;
+        float    time;
+        uint32_t emitCount;
+        uint32_t outParity;
+        uint32_t maxParticles;
+        uint32_t seed;
+    };
+
+    struct DrawPushConstants {
+        float viewProj[16];
+        float cameraRight[4];   // w = particle half size
+        float cameraUp[4];
+    };
+
+    uint32_t groupCount(uint32_t items) {
+        return (items + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    }
+}
+
+//-------------------------------------------------------------------------
+// Init & cleanup
+//-------------------------------------------------------------------------
+
+void ParticleSystem::init(Device& dev, SwapChain& sc, RenderPass& renderPass,
+                          uint32_t particleCount, uint32_t framesInFlight)
+{
+    device = &dev;
+    swapChain = &sc;
+    maxParticles = particleCount;
+    maxEmitPerFrame = std::max(maxParticles / 16, 1u);
+    emitRate = float(maxParticles) / AVERAGE_LIFETIME;
+
+    createBuffers();
+    createDescriptors();
+    createPipelines(renderPass);
+    createCommandObjects(framesInFlight);
+
+    startTime = std::chrono::steady_clock::now();
+    lastSubmit = startTime;
+}
+
+void ParticleSystem::cleanup() {
+    VkDevice dev = device->device();
+
+    drawPipeline.cleanup();
+    compactPipeline.cleanup();
+    simulatePipeline.cleanup();
+    emitPipeline.cleanup();
+    initPipeline.cleanup();
+
+    for (VkSemaphore semaphore : computeFinished) {
+        vkDestroySemaphore(dev, semaphore, hostAllocator("ParticleSystem"));
+    }
+    vkDestroyCommandPool(dev, commandPool, hostAllocator("ParticleSystem"));
+
+    vkDestroyDescriptorPool(dev, descriptorPool, hostAllocator("ParticleSystem"));
+    vkDestroyDescriptorSetLayout(dev, drawSetLayout, hostAllocator("ParticleSystem"));
+    vkDestroyDescriptorSetLayout(dev, computeSetLayout, hostAllocator("ParticleSystem"));
+
+    for (int p = 0; p < 2; p++) {
+        vkDestroyBuffer(dev, particleBuffers[p], hostAllocator("ParticleSystem"));
+        device->freeMemory(particleMemory[p]);
+        vkDestroyBuffer(dev, aliveBuffers[p], hostAllocator("ParticleSystem"));
+        device->freeMemory(aliveMemory[p]);
+    }
+    vkDestroyBuffer(dev, deadBuffer, hostAllocator("ParticleSystem"));
+    device->freeMemory(deadMemory);
+    vkDestroyBuffer(dev, counterBuffer, hostAllocator("ParticleSystem"));
+    device->freeMemory(counterMemory);
+    vkDestroyBuffer(dev, drawBuffer, hostAllocator("ParticleSystem"));
+    device->freeMemory(drawMemory);
+}
+
+void ParticleSystem::createBuffers() {
+    const VkMemoryPropertyFlags deviceLocal = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    // Anything the graphics queue reads is shared CONCURRENT with the compute family.
+    for (int p = 0; p < 2; p++) {
+        device->createBuffer(maxParticles * PARTICLE_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            deviceLocal, particleBuffers[p], particleMemory[p], true);
+        device->createBuffer(maxParticles * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            deviceLocal, aliveBuffers[p], aliveMemory[p], true);
+    }
+    device->createBuffer(maxParticles * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        deviceLocal, deadBuffer, deadMemory);
+    device->createBuffer(COUNTER_BUFFER_SIZE,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        deviceLocal, counterBuffer, counterMemory);
+    device->createBuffer(2 * sizeof(VkDrawIndirectCommand),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        deviceLocal, drawBuffer, drawMemory, true);
+}
+
+void ParticleSystem::createDescriptors() {
+    VkDevice dev = device->device();
+
+    // Compute: particlesIn, particlesOut, aliveIn, aliveOut, dead, counters, draw args
+    VkDescriptorSetLayoutBinding computeBindings[7]{};
+    for (uint32_t i = 0; i < 7; i++) {
+        computeBindings[i].binding = i;
+        computeBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        computeBindings[i].descriptorCount = 1;
+        computeBindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    VkDescriptorSetLayoutCreateInfo computeLayoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    computeLayoutInfo.bindingCount = 7;
+    computeLayoutInfo.pBindings = computeBindings;
+    if (vkCreateDescriptorSetLayout(dev, &computeLayoutInfo, hostAllocator("ParticleSystem"), &computeSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create particle compute descriptor set layout!");
+    }
+
+    // Draw: particles, alive list
+    VkDescriptorSetLayoutBinding drawBindings[2]{};
+    for (uint32_t i = 0; i < 2; i++) {
+        drawBindings[i].binding = i;
+        drawBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        drawBindings[i].descriptorCount = 1;
+        drawBindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    }
+    VkDescriptorSetLayoutCreateInfo drawLayoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    drawLayoutInfo.bindingCount = 2;
+    drawLayoutInfo.pBindings = drawBindings;
+    if (vkCreateDescriptorSetLayout(dev, &drawLayoutInfo, hostAllocator("ParticleSystem"), &drawSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create particle draw descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 2 * 7 + 2 * 2;
+
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = 4;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(dev, &poolInfo, hostAllocator("ParticleSystem"), &descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create particle descriptor pool!");
+    }
+
+    VkDescriptorSetLayout layouts[4] = { computeSetLayout, computeSetLayout, drawSetLayout, drawSetLayout };
+    VkDescriptorSet sets[4];
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = 4;
+    allocInfo.pSetLayouts = layouts;
+    if (vkAllocateDescriptorSets(dev, &allocInfo, sets) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate particle descriptor sets!");
+    }
+    computeSets[0] = sets[0];
+    computeSets[1] = sets[1];
+    drawSets[0] = sets[2];
+    drawSets[1] = sets[3];
+
+    for (uint32_t out = 0; out < 2; out++) {
+        uint32_t in = 1 - out;
+
+        VkDescriptorBufferInfo computeInfos[7] = {
+            { particleBuffers[in],  0, VK_WHOLE_SIZE },
+            { particleBuffers[out], 0, VK_WHOLE_SIZE },
+            { aliveBuffers[in],     0, VK_WHOLE_SIZE },
+            { aliveBuffers[out],    0, VK_WHOLE_SIZE },
+            { deadBuffer,           0, VK_WHOLE_SIZE },
+            { counterBuffer,        0, VK_WHOLE_SIZE },
+            { drawBuffer,           0, VK_WHOLE_SIZE },
+        };
+        VkDescriptorBufferInfo drawInfos[2] = {
+            { particleBuffers[out], 0, VK_WHOLE_SIZE },
+            { aliveBuffers[out],    0, VK_WHOLE_SIZE },
+        };
+
+        VkWriteDescriptorSet writes[2]{};
+        writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[0].dstSet = computeSets[out];
+        writes[0].dstBinding = 0;
+        writes[0].descriptorCount = 7;
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[0].pBufferInfo = computeInfos;
+
+        writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[1].dstSet = drawSets[out];
+        writes[1].dstBinding = 0;
+        writes[1].descriptorCount = 2;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[1].pBufferInfo = drawInfos;
+
+        vkUpdateDescriptorSets(dev, 2, writes, 0, nullptr);
+    }
+}
+
+void ParticleSystem::createPipelines(RenderPass& renderPass) {
+    std::vector<VkDescriptorSetLayout> computeLayouts = { computeSetLayout };
+    uint32_t pushSize = sizeof(ComputePushConstants);
+
+    initPipeline.init(*device, "shaders_spv/particle_init_comp.spv", computeLayouts, pushSize);
+    emitPipeline.init(*device, "shaders_spv/particle_emit_comp.spv", computeLayouts, pushSize);
+    simulatePipeline.init(*device, "shaders_spv/particle_simulate_comp.spv", computeLayouts, pushSize);
+    compactPipeline.init(*device, "shaders_spv/particle_compact_comp.spv", computeLayouts, pushSize);
+
+    // Camera-facing additive quads, depth-tested against the scene but not written.
+    PipelineConfig drawConfig;
+    drawConfig.vertShader = "shaders_spv/particle_vert.spv";
+    drawConfig.fragShader = "shaders_spv/particle_frag.spv";
+    drawConfig.depthWrite = false;
+    drawConfig.cullMode = VK_CULL_MODE_NONE;
+    drawConfig.additiveBlend = true;
+    drawConfig.pushConstantSize = sizeof(DrawPushConstants);
+    drawConfig.setLayouts = { drawSetLayout };
+    drawPipeline.init(*device, *swapChain, renderPass, drawConfig);
+}
+
+void ParticleSystem::createCommandObjects(uint32_t framesInFlight) {
+    VkCommandPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = device->queueFamilies().computeFamily.value();
+    if (vkCreateCommandPool(device->device(), &poolInfo, hostAllocator("ParticleSystem"), &commandPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create particle command pool!");
+    }
+
+    commandBuffers.resize(framesInFlight);
+    VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    allocInfo.commandPool = commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = framesInFlight;
+    if (vkAllocateCommandBuffers(device->device(), &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate particle command buffers!");
+    }
+
+    computeFinished.resize(framesInFlight);
+    VkSemaphoreCreateInfo semaphoreInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    for (auto& semaphore : computeFinished) {
+        if (vkCreateSemaphore(device->device(), &semaphoreInfo, hostAllocator("ParticleSystem"), &semaphore) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create particle semaphore!");
+        }
+    }
+}
+
+//-------------------------------------------------------------------------
+// Per frame
+//-------------------------------------------------------------------------
+
+VkSemaphore ParticleSystem::submitCompute(uint32_t frame) {
+    auto now = std::chrono::steady_clock::now();
+    float dt = std::min(std::chrono::duration<float>(now - lastSubmit).count(), 0.1f);
+    lastSubmit = now;
+
+    uint32_t outParity = static_cast<uint32_t>(frameCounter & 1);
+    uint32_t inParity = 1 - outParity;
+
+    // Emit at the rate that keeps the pool near capacity, capped per frame so a
+    // hitch does not spawn a wall of particles at once.
+    emitAccumulator += emitRate * dt;
+    uint32_t emitCount = std::min(static_cast<uint32_t>(emitAccumulator), maxEmitPerFrame);
+    emitAccumulator -= float(emitCount);
+
+    ComputePushConstants push{};
+    push.deltaTime = dt;
+    push.time = std::chrono::duration<float>(now - startTime).count();
+    push.emitCount = emitCount;
+    push.outParity = outParity;
+    push.maxParticles = maxParticles;
+    push.seed = static_cast<uint32_t>(frameCounter * 2654435761u);
+
+    VkCommandBuffer cmd = commandBuffers[frame];
+    vkResetCommandBuffer(cmd, 0);
+
+    VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(cmd, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("failed to begin particle command buffer!");
+    }
+
+    // All three pipelines share one layout definition, so the set and push
+    // constants stay bound across the pipeline switches.
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, simulatePipeline.layout(),
+        0, 1, &computeSets[outParity], 0, nullptr);
+    vkCmdPushConstants(cmd, simulatePipeline.layout(), VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(push), &push);
+
+    if (!initialized) {
+        initPipeline.bind(cmd);
+        vkCmdDispatch(cmd, groupCount(maxParticles), 1, 1);
+        initialized = true;
+    }
+
+    // Also orders this frame after the previous submission's counter/dead-list writes.
+    computeBarrier(cmd);
+
+    // 1) Simulate last frame's survivors into the output state; the dispatch size
+    //    was written by last frame's compact step.
+    simulatePipeline.bind(cmd);
+    vkCmdDispatchIndirect(cmd, counterBuffer, DISPATCH_ARGS_OFFSET + inParity * 16);
+    computeBarrier(cmd);
+
+    // 2) Emit new particles into slots freed so far.
+    if (emitCount > 0) {
+        emitPipeline.bind(cmd);
+        vkCmdDispatch(cmd, groupCount(emitCount), 1, 1);
+        computeBarrier(cmd);
+    }
+
+    // 3) Compact: turn the output alive count into draw / dispatch arguments.
+    compactPipeline.bind(cmd);
+    vkCmdDispatch(cmd, 1, 1, 1);
+
+    if (vkEndCommandBuffer(cmd) != VK_SUCCESS) {
+        throw std::runtime_error("failed to record particle command buffer!");
+    }
+
+    VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &computeFinished[frame];
+
+    if (vkQueueSubmit(device->computeQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("failed to submit particle compute work!");
+    }
+
+    drawParity = outParity;
+    frameCounter++;
+    return computeFinished[frame];
+}
+
+void ParticleSystem::recordDraw(VkCommandBuffer commandBuffer, const Camera& camera) {
+    DrawPushConstants push{};
+    Mat4 viewProj = camera.viewProjection();
+    std::copy(viewProj.m, viewProj.m + 16, push.viewProj);
+    push.cameraRight[0] = camera.right().x;
+    push.cameraRight[1] = camera.right().y;
+    push.cameraRight[2] = camera.right().z;
+    push.cameraRight[3] = 0.05f;
+    push.cameraUp[0] = camera.up().x;
+    push.cameraUp[1] = camera.up().y;
+    push.cameraUp[2] = camera.up().z;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, drawPipeline.get());
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, drawPipeline.layout(),
+        0, 1, &drawSets[drawParity], 0, nullptr);
+    vkCmdPushConstants(commandBuffer, drawPipeline.layout(),
+        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(push), &push);
+    vkCmdDrawIndirect(commandBuffer, drawBuffer, drawParity * sizeof(VkDrawIndirectCommand), 1, 0);
+}
+
+void ParticleSystem::computeBarrier(VkCommandBuffer commandBuffer) {
+    VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                            VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
@@ -0,0 +1,93 @@
+// src/ParticleSystem.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <chrono>
+
+#include "ComputePipeline.h"
+#include "Pipeline.h"
+
+class Device;
+class SwapChain;
+class RenderPass;
+class Camera;
+
+// GPU particle system. Emission, simulation and compaction run as compute shaders
+// on the async compute queue (the graphics queue when the device has no separate
+// compute family). Survivors are drawn with a single vkCmdDrawIndirect, so the
+// CPU never touches individual particles.
+//
+// Particle state and alive lists are double-buffered by frame parity: the compute
+// work for frame N reads the state frame N-1 draws and writes a fresh copy, so it
+// overlaps with frame N-1's graphics work. The state it overwrites was drawn by
+// frame N-2, which the renderer's in-flight fence has already retired.
+class ParticleSystem {
+public:
+    void init(Device& device, SwapChain& swapChain, RenderPass& renderPass,
+              uint32_t maxParticles, uint32_t framesInFlight);
+    void cleanup();
+
+    // Records and submits this frame's compute work. Returns the semaphore the
+    // graphics submission must wait on at `waitStage`.
+    VkSemaphore submitCompute(uint32_t frame);
+
+    // Records the indirect draw of the particles produced by the last submitCompute().
+    // Call inside the main render pass.
+    void recordDraw(VkCommandBuffer commandBuffer, const Camera& camera);
+
+    static constexpr VkPipelineStageFlags waitStage =
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+
+private:
+    void createBuffers();
+    void createDescriptors();
+    void createPipelines(RenderPass& renderPass);
+    void createCommandObjects(uint32_t framesInFlight);
+
+    // Global compute -> compute/indirect barrier between dependent dispatches.
+    void computeBarrier(VkCommandBuffer commandBuffer);
+
+    Device* device = nullptr;
+    SwapChain* swapChain = nullptr;
+    uint32_t maxParticles = 0;
+    uint32_t maxEmitPerFrame = 0;
+    float    emitRate = 0.0f;         // particles per second, keeps the pool near full
+    float    emitAccumulator = 0.0f;
+
+    // GPU buffers ([2] = per frame parity)
+    VkBuffer       particleBuffers[2] = {};
+    VkDeviceMemory particleMemory[2] = {};
+    VkBuffer       aliveBuffers[2] = {};
+    VkDeviceMemory aliveMemory[2] = {};
+    VkBuffer       deadBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory deadMemory = VK_NULL_HANDLE;
+    VkBuffer       counterBuffer = VK_NULL_HANDLE;   // counts + simulate dispatch args
+    VkDeviceMemory counterMemory = VK_NULL_HANDLE;
+    VkBuffer       drawBuffer = VK_NULL_HANDLE;      // VkDrawIndirectCommand per parity
+    VkDeviceMemory drawMemory = VK_NULL_HANDLE;
+
+    // Descriptors ([p] = sets for output parity p)
+    VkDescriptorSetLayout computeSetLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout drawSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool      descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet       computeSets[2] = {};
+    VkDescriptorSet       drawSets[2] = {};
+
+    ComputePipeline initPipeline;
+    ComputePipeline emitPipeline;
+    ComputePipeline simulatePipeline;
+    ComputePipeline compactPipeline;
+    Pipeline        drawPipeline;
+
+    // Compute queue submission state (per frame in flight)
+    VkCommandPool                commandPool = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> commandBuffers;
+    std::vector<VkSemaphore>     computeFinished;
+
+    bool     initialized = false;   // first submission also fills the dead list
+    uint64_t frameCounter = 0;
+    uint32_t drawParity = 0;        // parity written by the last submitCompute()
+    std::chrono::steady_clock::time_point startTime{};
+    std::chrono::steady_clock::time_point lastSubmit{};
+};
@@ -1,10 +1,11 @@
 // src/Pipeline.cpp
 
 #include "Pipeline.h"
+#include "HostMemoryTracker.h"
 #include "Device.h"
 #include "SwapChain.h"
 #include "RenderPass.h"
-#include "Utils.h"       // for readFile()
+#include "ShaderCache.h"
 
 #include <stdexcept>
 #include <vector>
@@ -14,21 +15,40 @@
 // Init & cleanup
 //-------------------------------------------------------------------------
 
-void Pipeline::init(Device& dev, SwapChain& sc, RenderPass& rp) {
+void Pipeline::init(Device& dev, SwapChain& sc, RenderPass& rp, const PipelineConfig& cfg) {
     // stash pointers so cleanup() can destroy in reverse
     device = &dev;
-    swapChain = &sc;
+    extent = sc.getExtent();
     // pull the raw VkRenderPass handle out of your RenderPass wrapper
     vkRenderPassHandle = rp.get();
+    dynamicRendering = rp.usesDynamicRendering();
+    colorFormat = rp.colorFormat();
+    depthFormat = rp.depthFormat();
+    samples = rp.sampleCount();
+    config = cfg;
 
     // now build the pipeline
     createGraphicsPipeline();
 }
 
+void Pipeline::initDepthOnly(Device& dev, VkRenderPass rp, VkExtent2D extent_, const PipelineConfig& cfg) {
+    device = &dev;
+    extent = extent_;
+    vkRenderPassHandle = rp;
+    dynamicRendering = false;
+    hasColorAttachment = false;
+    samples = VK_SAMPLE_COUNT_1_BIT;
+    config = cfg;
+    config.fragShader.clear();
+    config.colorWrite = false;
+
+    createGraphicsPipeline();
+}
+
 void Pipeline::cleanup() {
     // destroy pipeline in reverse order
-    vkDestroyPipeline(device->device(), graphicsPipeline, nullptr);
-    vkDestroyPipelineLayout(device->device(), pipelineLayout, nullptr);
+    vkDestroyPipeline(device->device(), graphicsPipeline, hostAllocator("Pipeline"));
+    vkDestroyPipelineLayout(device->device(), pipelineLayout, hostAllocator("Pipeline"));
 }
 
 //-------------------------------------------------------------------------
@@ -39,11 +59,14 @@ void Pipeline::createGraphicsPipeline() {
     //-------------------------------------------------------------
     // 1) Load & create shader modules
     //-------------------------------------------------------------
-    auto vertShaderCode = readFile("shaders_spv/vert.spv");
-    auto fragShaderCode = readFile("shaders_spv/frag.spv");
+    VkShaderModule vertShaderModule = createShaderModule(ShaderCache::global().load(config.vertShader));
 
-    VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
-    VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+    // A depth-only pipeline (e.g. the depth pre-pass) has no fragment stage at all.
+    bool hasFragmentStage = !config.fragShader.empty();
+    VkShaderModule fragShaderModule = VK_NULL_HANDLE;
+    if (hasFragmentStage) {
+        fragShaderModule = createShaderModule(ShaderCache::global().load(config.fragShader));
+    }
 
     VkPipelineShaderStageCreateInfo vertStageInfo{};
     vertStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -63,10 +86,8 @@ void Pipeline::createGraphicsPipeline() {
     };
 
     //-------------------------------------------------------------
-    // 2) Viewport & scissor (from swap chain extent)
+    // 2) Viewport & scissor (from the extent given to init)
     //-------------------------------------------------------------
-    VkExtent2D extent = swapChain->getExtent();
-
     VkViewport viewport{};
     viewport.x = 0.0f;
     viewport.y = 0.0f;
@@ -89,7 +110,7 @@ void Pipeline::createGraphicsPipeline() {
     //-------------------------------------------------------------
     // 3) Dynamic state (viewport & scissor)
     //-------------------------------------------------------------
-    std::vector<VkDynamicState> dynamicStates = {
+    const std::array<VkDynamicState, 2> dynamicStates = {
         VK_DYNAMIC_STATE_VIEWPORT,
         VK_DYNAMIC_STATE_SCISSOR
     };
@@ -103,10 +124,10 @@ void Pipeline::createGraphicsPipeline() {
     //-------------------------------------------------------------
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 0;
-    vertexInputInfo.pVertexBindingDescriptions = nullptr;
-    vertexInputInfo.vertexAttributeDescriptionCount = 0;
-    vertexInputInfo.pVertexAttributeDescriptions = nullptr;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(config.vertexBindings.size());
+    vertexInputInfo.pVertexBindingDescriptions = config.vertexBindings.data();
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(config.vertexAttributes.size());
+    vertexInputInfo.pVertexAttributeDescriptions = config.vertexAttributes.data();
 
     //-------------------------------------------------------------
     // 5) Input assembly
@@ -125,9 +146,14 @@ void Pipeline::createGraphicsPipeline() {
     rasterizer.rasterizerDiscardEnable = VK_FALSE;
     rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
     rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    rasterizer.cullMode = config.cullMode;
     rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
     rasterizer.depthBiasEnable = VK_FALSE;
+    if (config.depthBiasConstant != 0.0f || config.depthBiasSlope != 0.0f) {
+        rasterizer.depthBiasEnable = VK_TRUE;
+        rasterizer.depthBiasConstantFactor = config.depthBiasConstant;
+        rasterizer.depthBiasSlopeFactor = config.depthBiasSlope;
+    }
 
     //-------------------------------------------------------------
     // 7) Multisampling
@@ -135,55 +161,91 @@ void Pipeline::createGraphicsPipeline() {
     VkPipelineMultisampleStateCreateInfo multisampling{};
     multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
     multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    multisampling.rasterizationSamples = samples;
 
     //-------------------------------------------------------------
-    // 8) Color blending
+    // 8) Depth testing
+    //-------------------------------------------------------------
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = config.depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = config.depthWrite ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = config.depthCompareOp;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
+
+    //-------------------------------------------------------------
+    // 9) Color blending
     //-------------------------------------------------------------
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask =
-        VK_COLOR_COMPONENT_R_BIT |
-        VK_COLOR_COMPONENT_G_BIT |
-        VK_COLOR_COMPONENT_B_BIT |
-        VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.colorWriteMask = config.colorWrite
+        ? (VK_COLOR_COMPONENT_R_BIT |
+           VK_COLOR_COMPONENT_G_BIT |
+           VK_COLOR_COMPONENT_B_BIT |
+           VK_COLOR_COMPONENT_A_BIT)
+        : 0;
     colorBlendAttachment.blendEnable = VK_FALSE;
+    if (config.additiveBlend) {
+        colorBlendAttachment.blendEnable = VK_TRUE;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    }
+    else if (config.alphaBlend) {
+        colorBlendAttachment.blendEnable = VK_TRUE;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    }
 
     VkPipelineColorBlendStateCreateInfo colorBlending{};
     colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
     colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.attachmentCount = 1;
+    colorBlending.attachmentCount = hasColorAttachment ? 1 : 0;
     colorBlending.pAttachments = &colorBlendAttachment;
 
     //-------------------------------------------------------------
-    // 9) Pipeline layout
+    // 10) Pipeline layout
     //-------------------------------------------------------------
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = config.pushConstantSize;
+
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 0;
-    pipelineLayoutInfo.pSetLayouts = nullptr;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
-    pipelineLayoutInfo.pPushConstantRanges = nullptr;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(config.setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = config.setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = config.pushConstantSize > 0 ? 1 : 0;
+    pipelineLayoutInfo.pPushConstantRanges = config.pushConstantSize > 0 ? &pushConstantRange : nullptr;
 
     if (vkCreatePipelineLayout(
         device->device(),
         &pipelineLayoutInfo,
-        nullptr,
+        hostAllocator("Pipeline"),
         &pipelineLayout) != VK_SUCCESS) {
         throw std::runtime_error("failed to create pipeline layout!");
     }
 
     //-------------------------------------------------------------
-    // 10) Assemble & create the pipeline
+    // 11) Assemble & create the pipeline
     //-------------------------------------------------------------
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
+    pipelineInfo.stageCount = hasFragmentStage ? 2 : 1;
     pipelineInfo.pStages = shaderStages;
     pipelineInfo.pVertexInputState = &vertexInputInfo;
     pipelineInfo.pInputAssemblyState = &inputAssembly;
     pipelineInfo.pViewportState = &viewportState;
     pipelineInfo.pRasterizationState = &rasterizer;
     pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
     pipelineInfo.pDynamicState = &dynamicState;
     pipelineInfo.layout = pipelineLayout;
@@ -191,21 +253,34 @@ void Pipeline::createGraphicsPipeline() {
     pipelineInfo.subpass = 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
+    // With dynamic rendering the pipeline only needs the attachment formats;
+    // renderPass stays VK_NULL_HANDLE.
+    VkPipelineRenderingCreateInfoKHR renderingInfo{ VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR };
+    if (dynamicRendering) {
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachmentFormats = &colorFormat;
+        renderingInfo.depthAttachmentFormat = depthFormat;
+        pipelineInfo.pNext = &renderingInfo;
+        pipelineInfo.renderPass = VK_NULL_HANDLE;
+    }
+
     if (vkCreateGraphicsPipelines(
         device->device(),
         VK_NULL_HANDLE,
         1,
         &pipelineInfo,
-        nullptr,
+        hostAllocator("Pipeline"),
         &graphicsPipeline) != VK_SUCCESS) {
         throw std::runtime_error("failed to create graphics pipeline!");
     }
 
     //-------------------------------------------------------------
-    // 11) Cleanup shader modules
+    // 12) Cleanup shader modules
     //-------------------------------------------------------------
-    vkDestroyShaderModule(device->device(), fragShaderModule, nullptr);
-    vkDestroyShaderModule(device->device(), vertShaderModule, nullptr);
+    if (fragShaderModule != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(device->device(), fragShaderModule, hostAllocator("Pipeline"));
+    }
+    vkDestroyShaderModule(device->device(), vertShaderModule, hostAllocator("Pipeline"));
 }
 
 //-------------------------------------------------------------------------
@@ -222,7 +297,7 @@ VkShaderModule Pipeline::createShaderModule(const std::vector<char>& code) {
     if (vkCreateShaderModule(
         device->device(),  // stored Device*
         &createInfo,
-        nullptr,
+        hostAllocator("Pipeline"),
         &shaderModule) != VK_SUCCESS) {
         throw std::runtime_error("failed to create shader module!");
     }
@@ -3,19 +3,53 @@
 
 #include <vulkan/vulkan.h>   // VkPipeline, VkPipelineLayout, VkRenderPass, VK_NULL_HANDLE
 #include <vector>            // std::vector<char>
+#include <string>
 
 #include "Device.h"
 #include "SwapChain.h"
 #include "RenderPass.h"      // for the RenderPass wrapper
 
+/// Per-pipeline knobs; the defaults reproduce the original triangle pipeline
+/// with depth testing enabled.
+struct PipelineConfig {
+    std::string vertShader = "shaders_spv/vert.spv";
+    std::string fragShader = "shaders_spv/frag.spv";  // empty -> depth-only (no fragment stage)
+
+    bool        depthTest = true;
+    bool        depthWrite = true;
+    VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+    bool        colorWrite = true;
+
+    uint32_t    pushConstantSize = 0;                  // bytes, visible to vertex + fragment
+    std::vector<VkDescriptorSetLayout> setLayouts;     // bound as sets 0..n-1
+
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    bool        additiveBlend = false;                 // dst += src * src.a
+    bool        alphaBlend = false;                    // dst = mix(dst, src, src.a)
+
+    // Rasterizer depth bias, e.g. for shadow casters; both zero disables it.
+    float       depthBiasConstant = 0.0f;
+    float       depthBiasSlope = 0.0f;
+
+    // Vertex buffer layout; empty for shaders that generate their geometry.
+    std::vector<VkVertexInputBindingDescription>   vertexBindings;
+    std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+};
+
 /// Encapsulates creation & cleanup of the Vulkan graphics pipeline.
 class Pipeline {
 public:
     /// Initialize the pipeline.
     ///   dev provides vkDevice via dev.device()  
     ///   sc provides swapchain extent via sc.getExtent()  
-    ///   rp provides the VkRenderPass via rp.get()
-    void init(Device& dev, SwapChain& sc, RenderPass& rp);
+    ///   rp provides the VkRenderPass via rp.get(), or the attachment
+    ///    formats when it uses dynamic rendering
+    ///   config selects shaders, depth state and push constants
+    void init(Device& dev, SwapChain& sc, RenderPass& rp, const PipelineConfig& config = PipelineConfig{});
+
+    /// Initialize against an offscreen, depth-only VkRenderPass (e.g. a shadow map)
+    /// with a single-sampled depth attachment and no colour attachment.
+    void initDepthOnly(Device& dev, VkRenderPass rp, VkExtent2D extent, const PipelineConfig& config);
 
     /// Destroy the pipeline object and its layout (in that order).
     void cleanup();
@@ -39,8 +73,14 @@ private:
     // Set in init():
     //------------------------------------------------------------------------
     Device* device = nullptr;         // wrapper for VkDevice
-    SwapChain* swapChain = nullptr;         // wrapper for extent/format
+    VkExtent2D   extent{};                              // initial viewport; the real one is dynamic
     VkRenderPass vkRenderPassHandle = VK_NULL_HANDLE;  // raw handle from RenderPass
+    bool         dynamicRendering = false;              // build against formats instead
+    VkFormat     colorFormat = VK_FORMAT_UNDEFINED;     // attachment formats for dynamic rendering
+    VkFormat     depthFormat = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;  // must match the render pass
+    bool         hasColorAttachment = true;             // false for depth-only offscreen passes
+    PipelineConfig config;
 
     //------------------------------------------------------------------------
     // Owned & destroyed here:
@@ -0,0 +1,45 @@
+// src/PoolAllocator.cpp
+#include "PoolAllocator.h"
+
+#include <algorithm>
+
+PoolAllocator::PoolAllocator(size_t blockSize, size_t blocksPerChunk_)
+    : blocksPerChunk(std::max<size_t>(blocksPerChunk_, 1))
+{
+    // Every block must hold the free-list link and keep the next block aligned.
+    size_t size = std::max(blockSize, sizeof(FreeBlock));
+    blockBytes = (size + blockAlignment - 1) & ~(blockAlignment - 1);
+}
+
+PoolAllocator::~PoolAllocator() {
+    for (unsigned char* chunk : chunks) {
+        delete[] chunk;
+    }
+}
+
+void* PoolAllocator::allocate() {
+    if (!freeList) addChunk();
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    live++;
+    return block;
+}
+
+void PoolAllocator::free(void* block) {
+    if (!block) return;
+    FreeBlock* b = static_cast<FreeBlock*>(block);
+    b->next = freeList;
+    freeList = b;
+    live--;
+}
+
+void PoolAllocator::addChunk() {
+    // new[] of unsigned char is aligned for max_align_t, and blockBytes is a multiple of it.
+    unsigned char* chunk = new unsigned char[blockBytes * blocksPerChunk];
+    chunks.push_back(chunk);
+    for (size_t i = blocksPerChunk; i-- > 0;) {
+        FreeBlock* b = reinterpret_cast<FreeBlock*>(chunk + i * blockBytes);
+        b->next = freeList;
+        freeList = b;
+    }
+}
@@ -0,0 +1,74 @@
+// src/PoolAllocator.h
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Fixed-size block allocator. Blocks come from chunks of `blocksPerChunk` and
+// are recycled through an intrusive free list, so allocate/free are O(1) and
+// a pool that has reached its working-set size never touches the heap again.
+class PoolAllocator {
+public:
+    PoolAllocator(size_t blockSize, size_t blocksPerChunk = 256);
+    ~PoolAllocator();
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    void* allocate();
+    void  free(void* block);
+
+    size_t blockSize() const { return blockBytes; }
+    size_t liveBlocks() const { return live; }
+    size_t capacityBlocks() const { return chunks.size() * blocksPerChunk; }
+
+    static constexpr size_t blockAlignment = alignof(std::max_align_t);
+
+private:
+    void addChunk();
+
+    struct FreeBlock { FreeBlock* next; };
+
+    size_t blockBytes;
+    size_t blocksPerChunk;
+    std::vector<unsigned char*> chunks;
+    FreeBlock* freeList = nullptr;
+    size_t live = 0;
+};
+
+// STL allocator for node-based containers (std::list, std::map, std::unordered_map).
+// Single-object allocations that fit the pool's block size come from the pool;
+// anything else (bucket arrays, oversized nodes) falls back to operator new.
+template <typename T>
+class PoolStlAllocator {
+public:
+    using value_type = T;
+
+    explicit PoolStlAllocator(PoolAllocator& pool) : pool(&pool) {}
+    template <typename U>
+    PoolStlAllocator(const PoolStlAllocator<U>& other) : pool(other.pool) {}
+
+    T* allocate(size_t n) {
+        if (fromPool(n)) return static_cast<T*>(pool->allocate());
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+        if (fromPool(n)) pool->free(p);
+        else ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const PoolStlAllocator<U>& other) const { return pool == other.pool; }
+    template <typename U>
+    bool operator!=(const PoolStlAllocator<U>& other) const { return pool != other.pool; }
+
+private:
+    template <typename U> friend class PoolStlAllocator;
+
+    bool fromPool(size_t n) const {
+        return n == 1 && sizeof(T) <= pool->blockSize() && alignof(T) <= PoolAllocator::blockAlignment;
+    }
+
+    PoolAllocator* pool;
+};
@@ -0,0 +1,444 @@
+// src/PostProcess.cpp
+#include "PostProcess.h"
+#include "HostMemoryTracker.h"
+#include "Device.h"
+#include "SwapChain.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    const uint32_t GROUP_SIZE = 8;          // local_size_x/y of the per-pixel passes
+    const uint32_t HISTOGRAM_BINS = 256;    // post_common.glsl; also post_exposure.comp's workgroup
+    const uint32_t MAX_BLOOM_LEVELS = 6;
+    const uint32_t MIN_BLOOM_SIZE = 8;      // smallest level side worth blurring into
+
+    const float BLOOM_THRESHOLD = 1.0f;     // exposed luminance where bloom starts
+    const float BLOOM_KNEE = 0.5f;          // soft ramp below the threshold
+    const float BLOOM_STRENGTH = 0.05f;
+    const float ADAPTATION_RATE = 1.5f;     // 1/s; exposure covers ~78% of a change per second
+
+    // std430 mirror of the Luminance buffer in post_common.glsl.
+    struct LuminanceState {
+        uint32_t histogram[HISTOGRAM_BINS];
+        float    exposure;
+        float    averageLuminance;
+        float    padding[2];
+    };
+
+    struct PrefilterPushConstants {
+        int32_t sourceSize[2];
+        int32_t destinationSize[2];
+        float   threshold;
+        float   knee;
+    };
+
+    struct ExposurePushConstants {
+        float deltaSeconds;
+        float adaptationRate;
+    };
+
+    struct ResamplePushConstants {
+        int32_t sourceSize[2];
+        int32_t destinationSize[2];
+    };
+
+    struct TonemapPushConstants {
+        int32_t size[2];
+        float   bloomStrength;
+        float   padding;
+    };
+
+    uint32_t groupCount(uint32_t pixels) {
+        return (pixels + GROUP_SIZE - 1) / GROUP_SIZE;
+    }
+
+    VkImageMemoryBarrier imageBarrier(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+        VkAccessFlags srcAccess, VkAccessFlags dstAccess)
+    {
+        VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, 1 };
+        return barrier;
+    }
+
+    // The next dispatch reads what the previous ones wrote.
+    void computeBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags extraSrcStages = 0,
+        uint32_t imageBarrierCount = 0, const VkImageMemoryBarrier* imageBarriers = nullptr)
+    {
+        VkMemoryBarrier written{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+        written.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        written.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | extraSrcStages,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &written, 0, nullptr, imageBarrierCount, imageBarriers);
+    }
+}
+
+//-------------------------------------------------------------------------
+// Init & cleanup
+//-------------------------------------------------------------------------
+
+void PostProcess::init(Device& dev, SwapChain& swapChain) {
+    device = &dev;
+    subgroups = device->capabilities().subgroupArithmetic;
+
+    VkSamplerCreateInfo samplerInfo{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    if (vkCreateSampler(device->device(), &samplerInfo, hostAllocator("PostProcess"), &linearSampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create post-processing sampler!");
+    }
+
+    // Starts at exposure 1 with an empty histogram; the exposure pass keeps it empty.
+    LuminanceState initial{};
+    initial.exposure = 1.0f;
+    initial.averageLuminance = 0.18f;
+    device->createDeviceLocalBuffer(&initial, sizeof(initial), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        luminanceBuffer, luminanceMemory);
+
+    createDescriptorLayout();
+    prefilterPipeline.init(*device, "shaders_spv/post_prefilter_comp.spv", { descriptorSetLayout },
+        sizeof(PrefilterPushConstants));
+    exposurePipeline.init(*device, subgroups ? "shaders_spv/post_exposure_subgroup_comp.spv"
+                                             : "shaders_spv/post_exposure_comp.spv",
+        { descriptorSetLayout }, sizeof(ExposurePushConstants));
+    downsamplePipeline.init(*device, "shaders_spv/post_downsample_comp.spv", { descriptorSetLayout },
+        sizeof(ResamplePushConstants));
+    upsamplePipeline.init(*device, "shaders_spv/post_upsample_comp.spv", { descriptorSetLayout },
+        sizeof(ResamplePushConstants));
+
+    // Whether the swapchain is a storage image depends on the surface, not on its size,
+    // so the tonemap variant is picked once.
+    directOutput = swapChain.isStorageTarget();
+    tonemapPipeline.init(*device, directOutput ? "shaders_spv/post_tonemap_direct_comp.spv"
+                                               : "shaders_spv/post_tonemap_comp.spv",
+        { descriptorSetLayout }, sizeof(TonemapPushConstants));
+
+    createTargets(swapChain);
+}
+
+void PostProcess::cleanup() {
+    VkDevice dev = device->device();
+
+    destroyTargets();
+    prefilterPipeline.cleanup();
+    exposurePipeline.cleanup();
+    downsamplePipeline.cleanup();
+    upsamplePipeline.cleanup();
+    tonemapPipeline.cleanup();
+    vkDestroyDescriptorSetLayout(dev, descriptorSetLayout, hostAllocator("PostProcess"));
+    vkDestroyBuffer(dev, luminanceBuffer, hostAllocator("PostProcess"));
+    device->freeMemory(luminanceMemory);
+    vkDestroySampler(dev, linearSampler, hostAllocator("PostProcess"));
+}
+
+void PostProcess::resize(SwapChain& swapChain) {
+    destroyTargets();
+    createTargets(swapChain);
+}
+
+void PostProcess::createDescriptorLayout() {
+    // One layout for every pass; each set fills in the bindings its shader reads.
+    //   0 source texture, 1 destination image, 2 luminance buffer, 3 bloom (tonemap)
+    VkDescriptorSetLayoutBinding bindings[4]{};
+    const VkDescriptorType types[4] = {
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+    };
+    for (uint32_t i = 0; i < 4; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = types[i];
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.bindingCount = 4;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(device->device(), &layoutInfo, hostAllocator("PostProcess"), &descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create post-processing descriptor set layout!");
+    }
+}
+
+void PostProcess::createTargets(SwapChain& swapChain) {
+    VkDevice dev = device->device();
+
+    hdrView = swapChain.getHdrImageView();
+    extent = swapChain.getExtent();
+    swapchainImages = swapChain.getImages();
+    swapchainViews = swapChain.getImageViews();
+
+    // Bloom starts at half resolution and halves until a level would be too small to matter.
+    bloomExtent = { std::max((extent.width + 1) / 2, 1u), std::max((extent.height + 1) / 2, 1u) };
+    levels = 1;
+    while (levels < MAX_BLOOM_LEVELS &&
+           (std::min(bloomExtent.width, bloomExtent.height) >> levels) >= MIN_BLOOM_SIZE) {
+        levels++;
+    }
+
+    device->createImage(bloomExtent.width, bloomExtent.height, SwapChain::HDR_FORMAT, VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        bloomImage, bloomMemory, VK_SAMPLE_COUNT_1_BIT, GpuMemoryCategory::RenderTarget, levels);
+
+    VkImageViewCreateInfo viewInfo{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewInfo.image = bloomImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = SwapChain::HDR_FORMAT;
+    bloomViews.resize(levels);
+    for (uint32_t level = 0; level < levels; level++) {
+        viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1 };
+        if (vkCreateImageView(dev, &viewInfo, hostAllocator("PostProcess"), &bloomViews[level]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create bloom level view!");
+        }
+    }
+
+    if (!directOutput) {
+        device->createImage(extent.width, extent.height, SwapChain::HDR_FORMAT, VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            outputImage, outputMemory, VK_SAMPLE_COUNT_1_BIT, GpuMemoryCategory::RenderTarget);
+        outputView = device->createImageView(outputImage, SwapChain::HDR_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+
+    // The set count follows the level and swapchain image counts, so the pool is
+    // rebuilt with the targets rather than sized for the worst case.
+    uint32_t tonemapCount = directOutput ? uint32_t(swapchainViews.size()) : 1u;
+    uint32_t setCount = 1 + 2 * (levels - 1) + tonemapCount;
+    VkDescriptorPoolSize poolSizes[3] = {
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2 * setCount },
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, setCount },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, setCount },
+    };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = setCount;
+    poolInfo.poolSizeCount = 3;
+    poolInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(dev, &poolInfo, hostAllocator("PostProcess"), &descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create post-processing descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(setCount, descriptorSetLayout);
+    std::vector<VkDescriptorSet> sets(setCount);
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = setCount;
+    allocInfo.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(dev, &allocInfo, sets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate post-processing descriptor sets!");
+    }
+    auto next = sets.begin();
+    prefilterSet = *next++;
+    downsampleSets.assign(next, next + (levels - 1));
+    next += levels - 1;
+    upsampleSets.assign(next, next + (levels - 1));
+    next += levels - 1;
+    tonemapSets.assign(next, sets.end());
+
+    writeDescriptorSets();
+    needsLayoutInit = true;
+}
+
+void PostProcess::writeDescriptorSets() {
+    VkDevice dev = device->device();
+    VkDescriptorBufferInfo luminance{ luminanceBuffer, 0, sizeof(LuminanceState) };
+    VkDescriptorImageInfo hdr{ linearSampler, hdrView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+
+    std::vector<VkWriteDescriptorSet> writes;
+    std::vector<VkDescriptorImageInfo> images;
+    images.reserve(4 * (1 + 2 * levels + tonemapSets.size()));   // pointers into it must stay put
+    auto image = [&](VkDescriptorSet set, uint32_t binding, VkDescriptorType type, VkDescriptorImageInfo info) {
+        images.push_back(info);
+        VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.descriptorCount = 1;
+        write.descriptorType = type;
+        write.pImageInfo = &images.back();
+        writes.push_back(write);
+    };
+    auto buffer = [&](VkDescriptorSet set) {
+        VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.dstSet = set;
+        write.dstBinding = 2;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &luminance;
+        writes.push_back(write);
+    };
+    auto storage = [](VkImageView view) {
+        return VkDescriptorImageInfo{ VK_NULL_HANDLE, view, VK_IMAGE_LAYOUT_GENERAL };
+    };
+    auto sampled = [this](VkImageView view) {
+        return VkDescriptorImageInfo{ linearSampler, view, VK_IMAGE_LAYOUT_GENERAL };
+    };
+
+    // Prefilter (and exposure, which only reads binding 2).
+    image(prefilterSet, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, hdr);
+    image(prefilterSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, storage(bloomViews[0]));
+    buffer(prefilterSet);
+
+    for (uint32_t i = 0; i + 1 < levels; i++) {
+        image(downsampleSets[i], 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, sampled(bloomViews[i]));
+        image(downsampleSets[i], 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, storage(bloomViews[i + 1]));
+        image(upsampleSets[i], 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, sampled(bloomViews[i + 1]));
+        image(upsampleSets[i], 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, storage(bloomViews[i]));
+    }
+
+    for (size_t i = 0; i < tonemapSets.size(); i++) {
+        image(tonemapSets[i], 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, hdr);
+        image(tonemapSets[i], 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            storage(directOutput ? swapchainViews[i] : outputView));
+        buffer(tonemapSets[i]);
+        image(tonemapSets[i], 3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, sampled(bloomViews[0]));
+    }
+
+    vkUpdateDescriptorSets(dev, uint32_t(writes.size()), writes.data(), 0, nullptr);
+}
+
+void PostProcess::destroyTargets() {
+    VkDevice dev = device->device();
+
+    vkDestroyDescriptorPool(dev, descriptorPool, hostAllocator("PostProcess"));
+    descriptorPool = VK_NULL_HANDLE;
+    for (VkImageView view : bloomViews) {
+        vkDestroyImageView(dev, view, hostAllocator("PostProcess"));
+    }
+    bloomViews.clear();
+    vkDestroyImage(dev, bloomImage, hostAllocator("PostProcess"));
+    device->freeMemory(bloomMemory);
+    bloomImage = VK_NULL_HANDLE;
+    bloomMemory = VK_NULL_HANDLE;
+
+    vkDestroyImageView(dev, outputView, hostAllocator("PostProcess"));
+    vkDestroyImage(dev, outputImage, hostAllocator("PostProcess"));
+    device->freeMemory(outputMemory);
+    outputView = VK_NULL_HANDLE;
+    outputImage = VK_NULL_HANDLE;
+    outputMemory = VK_NULL_HANDLE;
+}
+
+//-------------------------------------------------------------------------
+// Per frame
+//-------------------------------------------------------------------------
+
+void PostProcess::dispatch(VkCommandBuffer commandBuffer, const ComputePipeline& pipeline, VkDescriptorSet set,
+                           const void* push, uint32_t pushSize, VkExtent2D size)
+{
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.get());
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.layout(),
+        0, 1, &set, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, pipeline.layout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, pushSize, push);
+    vkCmdDispatch(commandBuffer, groupCount(size.width), groupCount(size.height), 1);
+}
+
+void PostProcess::record(VkCommandBuffer commandBuffer, uint32_t imageIndex, float deltaSeconds, bool drawOnTop) {
+    // The scene pass already made the HDR target readable. The bloom chain and the
+    // luminance buffer are shared with the previous frame, whose post chain wrote
+    // them last (and whose blit, without direct output, read the output image).
+    VkImageMemoryBarrier initBarriers[2] = {
+        imageBarrier(bloomImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, 0, VK_ACCESS_SHADER_WRITE_BIT),
+        imageBarrier(outputImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, 0, VK_ACCESS_SHADER_WRITE_BIT),
+    };
+    computeBarrier(commandBuffer, 0, needsLayoutInit ? (directOutput ? 1 : 2) : 0, initBarriers);
+    needsLayoutInit = false;
+
+    // HDR target -> bloom level 0 + histogram.
+    PrefilterPushConstants prefilter{
+        { int32_t(extent.width), int32_t(extent.height) },
+        { int32_t(bloomExtent.width), int32_t(bloomExtent.height) },
+        BLOOM_THRESHOLD, BLOOM_KNEE };
+    dispatch(commandBuffer, prefilterPipeline, prefilterSet, &prefilter, sizeof(prefilter), bloomExtent);
+    computeBarrier(commandBuffer);
+
+    // Histogram -> exposure. Nothing before the tonemap reads it, so it shares
+    // the next barrier with the first downsample instead of getting its own.
+    ExposurePushConstants exposure{ std::min(deltaSeconds, 0.25f), ADAPTATION_RATE };
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, exposurePipeline.get());
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, exposurePipeline.layout(),
+        0, 1, &prefilterSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, exposurePipeline.layout(), VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(exposure), &exposure);
+    vkCmdDispatch(commandBuffer, 1, 1, 1);
+
+    auto levelExtent = [this](uint32_t level) {
+        return VkExtent2D{ std::max(bloomExtent.width >> level, 1u), std::max(bloomExtent.height >> level, 1u) };
+    };
+    for (uint32_t level = 1; level < levels; level++) {
+        if (level > 1) computeBarrier(commandBuffer);
+        VkExtent2D source = levelExtent(level - 1), destination = levelExtent(level);
+        ResamplePushConstants push{ { int32_t(source.width), int32_t(source.height) },
+                                    { int32_t(destination.width), int32_t(destination.height) } };
+        dispatch(commandBuffer, downsamplePipeline, downsampleSets[level - 1], &push, sizeof(push), destination);
+    }
+    for (uint32_t level = levels - 1; level-- > 0;) {
+        computeBarrier(commandBuffer);
+        VkExtent2D source = levelExtent(level + 1), destination = levelExtent(level);
+        ResamplePushConstants push{ { int32_t(source.width), int32_t(source.height) },
+                                    { int32_t(destination.width), int32_t(destination.height) } };
+        dispatch(commandBuffer, upsamplePipeline, upsampleSets[level], &push, sizeof(push), destination);
+    }
+
+    // The swapchain image is written for the first time here. Chaining on the acquire
+    // semaphore's wait stage (COLOR_ATTACHMENT_OUTPUT) orders the writes after it.
+    VkImage swapchainImage = swapchainImages[imageIndex];
+    VkImageMemoryBarrier toStorage = imageBarrier(swapchainImage, VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_GENERAL, 0, VK_ACCESS_SHADER_WRITE_BIT);
+    computeBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, directOutput ? 1 : 0, &toStorage);
+
+    TonemapPushConstants tonemap{ { int32_t(extent.width), int32_t(extent.height) }, BLOOM_STRENGTH, 0.0f };
+    dispatch(commandBuffer, tonemapPipeline, tonemapSets[directOutput ? imageIndex : 0],
+        &tonemap, sizeof(tonemap), extent);
+
+    VkImageLayout finalLayout = drawOnTop ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    VkPipelineStageFlags finalStage = drawOnTop ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+                                                : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    VkAccessFlags finalAccess = drawOnTop ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : 0;
+
+    if (directOutput) {
+        VkImageMemoryBarrier done = imageBarrier(swapchainImage, VK_IMAGE_LAYOUT_GENERAL, finalLayout,
+            VK_ACCESS_SHADER_WRITE_BIT, finalAccess);
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, finalStage,
+            0, 0, nullptr, 0, nullptr, 1, &done);
+        return;
+    }
+
+    // Blit fallback: converts RGBA16F to the (sRGB) swapchain format on the way.
+    VkImageMemoryBarrier toTransfer[2] = {
+        imageBarrier(outputImage, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT),
+        imageBarrier(swapchainImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            0, VK_ACCESS_TRANSFER_WRITE_BIT),
+    };
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 2, toTransfer);
+
+    VkImageBlit blit{};
+    blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    blit.srcOffsets[1] = { int32_t(extent.width), int32_t(extent.height), 1 };
+    blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    blit.dstOffsets[1] = { int32_t(extent.width), int32_t(extent.height), 1 };
+    vkCmdBlitImage(commandBuffer, outputImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_NEAREST);
+
+    // The output image goes back to GENERAL for the next frame's tonemap.
+    VkImageMemoryBarrier done = imageBarrier(swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, finalLayout,
+        VK_ACCESS_TRANSFER_WRITE_BIT, finalAccess);
+    VkImageMemoryBarrier back = imageBarrier(outputImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        VK_IMAGE_LAYOUT_GENERAL, 0, 0);
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, finalStage,
+        0, 0, nullptr, 0, nullptr, 1, &done);
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &back);
+}
@@ -0,0 +1,102 @@
+// src/PostProcess.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+#include "ComputePipeline.h"
+
+class Device;
+class SwapChain;
+
+// Compute post-processing from the swapchain's HDR target to the swapchain image.
+//
+// Passes are fused wherever one can take over another's reads or writes, so the
+// chain is a handful of compute dispatches with a barrier between dependent ones:
+//
+//   prefilter   HDR target -> bloom level 0 (half resolution) and the luminance
+//               histogram. The HDR target is read once for both; the bright-pass
+//               threshold and the first 2x downsample are the same 2x2 fetch.
+//   exposure    histogram -> exposure, adapted over time. One workgroup, one
+//               thread per bin, reduced with subgroupAdd() where the device has
+//               subgroup arithmetic (a shared-memory tree otherwise). It clears
+//               the histogram for the next frame as it reads it.
+//   downsample  bloom level i-1 -> level i (13-tap filter), down to ~8 pixels.
+//   upsample    level i += tent(level i+1), back up to level 0, in place.
+//   tonemap     HDR target + tent(bloom level 0), times exposure, ACES fit,
+//               straight into the swapchain image. The last bloom upsample is
+//               folded in here instead of writing a full-resolution bloom image.
+//
+// The tonemap writes the swapchain image itself when SwapChain::isStorageTarget()
+// (encoding sRGB in the shader); otherwise it writes an RGBA16F image that is
+// blitted across.
+//
+// Needs SwapChain::setHdrTarget(true). The luminance buffer and the bloom chain
+// are shared by all frames in flight, like the depth attachment.
+class PostProcess {
+public:
+    void init(Device& device, SwapChain& swapChain);
+    void cleanup();
+    // Recreates the size-dependent images and descriptor sets for the new swapchain.
+    void resize(SwapChain& swapChain);
+
+    // Records the chain after the scene pass has ended. `deltaSeconds` drives the
+    // exposure adaptation. Leaves swapchain image `imageIndex` in PRESENT_SRC_KHR,
+    // or in COLOR_ATTACHMENT_OPTIMAL when `drawOnTop` (for a RenderPassTarget::Present pass).
+    void record(VkCommandBuffer commandBuffer, uint32_t imageIndex, float deltaSeconds, bool drawOnTop);
+
+    uint32_t bloomLevels() const { return levels; }
+    bool     writesSwapchainDirectly() const { return directOutput; }
+    bool     usesSubgroups() const { return subgroups; }
+
+private:
+    void createDescriptorLayout();
+    void createTargets(SwapChain& swapChain);
+    void destroyTargets();
+    void writeDescriptorSets();
+    // Binds `set` and pushes `push`, then dispatches one thread per pixel of `extent`.
+    void dispatch(VkCommandBuffer commandBuffer, const ComputePipeline& pipeline, VkDescriptorSet set,
+                  const void* push, uint32_t pushSize, VkExtent2D extent);
+
+    Device* device = nullptr;
+    bool    directOutput = false;   // tonemap writes the swapchain image (storage usage)
+    bool    subgroups = false;      // exposure pass built with subgroupAdd()
+
+    // Size-dependent, recreated by resize().
+    VkImageView hdrView = VK_NULL_HANDLE;       // owned by the swapchain
+    VkExtent2D  extent{};
+    std::vector<VkImage>     swapchainImages;   // owned by the swapchain
+    std::vector<VkImageView> swapchainViews;
+
+    VkImage        bloomImage = VK_NULL_HANDLE;
+    VkDeviceMemory bloomMemory = VK_NULL_HANDLE;
+    std::vector<VkImageView> bloomViews;         // one per level
+    uint32_t       levels = 0;
+    VkExtent2D     bloomExtent{};                // level 0
+
+    // Tonemap output when the swapchain cannot be a storage image.
+    VkImage        outputImage = VK_NULL_HANDLE;
+    VkDeviceMemory outputMemory = VK_NULL_HANDLE;
+    VkImageView    outputView = VK_NULL_HANDLE;
+
+    // Histogram bins, then the adapted exposure (post_common.glsl).
+    VkBuffer       luminanceBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory luminanceMemory = VK_NULL_HANDLE;
+
+    VkSampler             linearSampler = VK_NULL_HANDLE;
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool      descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet              prefilterSet = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> downsampleSets;   // [i] writes level i + 1
+    std::vector<VkDescriptorSet> upsampleSets;     // [i] writes level i
+    std::vector<VkDescriptorSet> tonemapSets;      // per swapchain image (one when blitting)
+
+    ComputePipeline prefilterPipeline;
+    ComputePipeline exposurePipeline;
+    ComputePipeline downsamplePipeline;
+    ComputePipeline upsamplePipeline;
+    ComputePipeline tonemapPipeline;
+
+    bool needsLayoutInit = true;   // bloom (and output) images are still UNDEFINED
+};
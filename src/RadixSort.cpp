@@ -0,0 +1,46 @@
+// src/RadixSort.cpp
+#include "RadixSort.h"
+
+#include <utility>
+
+RadixSortResult radixSortPairs(uint32_t* keys, uint32_t* values,
+                               uint32_t* keyScratch, uint32_t* valueScratch, size_t count) {
+    // All four histograms in one read of the keys.
+    size_t histograms[4][256] = {};
+    for (size_t i = 0; i < count; i++) {
+        uint32_t key = keys[i];
+        histograms[0][key & 0xFF]++;
+        histograms[1][(key >> 8) & 0xFF]++;
+        histograms[2][(key >> 16) & 0xFF]++;
+        histograms[3][key >> 24]++;
+    }
+
+    uint32_t* srcKeys = keys;
+    uint32_t* srcValues = values;
+    uint32_t* dstKeys = keyScratch;
+    uint32_t* dstValues = valueScratch;
+
+    for (uint32_t pass = 0; pass < 4; pass++) {
+        size_t* histogram = histograms[pass];
+        uint32_t shift = pass * 8;
+
+        // Every key in one bucket: this byte cannot change the order.
+        if (count == 0 || histogram[(srcKeys[0] >> shift) & 0xFF] == count) continue;
+
+        size_t offset = 0;
+        for (uint32_t bucket = 0; bucket < 256; bucket++) {
+            size_t n = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint32_t key = srcKeys[i];
+            size_t slot = histogram[(key >> shift) & 0xFF]++;
+            dstKeys[slot] = key;
+            dstValues[slot] = srcValues[i];
+        }
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcValues, dstValues);
+    }
+    return { srcKeys, srcValues };
+}
@@ -0,0 +1,18 @@
+// src/RadixSort.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Stable LSD radix sort of (key, value) pairs by 32-bit key, 8 bits per pass.
+// A pass is skipped when every key has the same byte there, so keys that only
+// use their low bits (small layer/texture ids) cost one or two passes instead
+// of four. Linear in `count`, no allocation: the scratch arrays must hold
+// `count` elements each. Returns the array holding the sorted keys, either
+// `keys` or `keyScratch`; its values are in the matching values array.
+struct RadixSortResult {
+    uint32_t* keys;
+    uint32_t* values;
+};
+RadixSortResult radixSortPairs(uint32_t* keys, uint32_t* values,
+                               uint32_t* keyScratch, uint32_t* valueScratch, size_t count);
@@ -1,48 +1,344 @@
 // src/RenderPass.cpp
 #include "RenderPass.h"
+#include "HostMemoryTracker.h"
 #include "Device.h"
 #include "SwapChain.h"
 #include <stdexcept>
 
-void RenderPass::init(Device& device, SwapChain& swapChain) {
-    createRenderPass(device, swapChain);
+void RenderPass::init(Device& device, SwapChain& swapChain, bool allowDynamicRendering, RenderPassTarget target) {
+    this->device = &device;
+    passTarget = target;
+    dynamicRendering = allowDynamicRendering && device.dynamicRenderingSupported();
+
+    if (target == RenderPassTarget::Present) {
+        colorAttachmentFormat = swapChain.getImageFormat();
+        depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+        samples = VK_SAMPLE_COUNT_1_BIT;
+        if (!dynamicRendering) {
+            createPresentRenderPass(device);
+        }
+        return;
+    }
+
+    colorAttachmentFormat = swapChain.getSceneFormat();
+    depthAttachmentFormat = swapChain.getDepthFormat();
+    samples = swapChain.getSampleCount();
+    storeDepth = swapChain.isDepthSampled();
+    hdrTarget = swapChain.hasHdrTarget();
+
+    // Dynamic rendering needs no render-pass object: pipelines are built against
+    // colorFormat() and begin() describes the attachments every frame.
+    if (!dynamicRendering) {
+        createRenderPass(device, swapChain);
+    }
 }
 
 void RenderPass::cleanup(Device& device) {
-    vkDestroyRenderPass(device.device(), renderPass, nullptr);
+    if (renderPass != VK_NULL_HANDLE) {
+        vkDestroyRenderPass(device.device(), renderPass, hostAllocator("RenderPass"));
+        renderPass = VK_NULL_HANDLE;
+    }
+}
+
+void RenderPass::begin(VkCommandBuffer commandBuffer, SwapChain& swapChain, uint32_t imageIndex) {
+    if (passTarget == RenderPassTarget::Present) {
+        beginPresent(commandBuffer, swapChain, imageIndex);
+        return;
+    }
+
+    VkClearValue clearValues[2]{};
+    clearValues[0].color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+    clearValues[1].depthStencil = { 1.0f, 0 };
+
+    if (!dynamicRendering) {
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = swapChain.getFramebuffers()[imageIndex];
+        renderPassInfo.renderArea.offset = { 0, 0 };
+        renderPassInfo.renderArea.extent = swapChain.getExtent();
+        renderPassInfo.clearValueCount = 2;
+        renderPassInfo.pClearValues = clearValues;
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        return;
+    }
+
+    // Same dependency the render pass declares: wait for the acquire (signalled at
+    // COLOR_ATTACHMENT_OUTPUT) before writing; the old contents are discarded. The
+    // HDR target is shared by all frames in flight, so it also waits for the
+    // previous frame's post chain to finish reading it.
+    bool msaa = samples != VK_SAMPLE_COUNT_1_BIT;
+    VkImage     sceneImage = hdrTarget ? swapChain.getHdrImage() : swapChain.getImages()[imageIndex];
+    VkImageView sceneView = hdrTarget ? swapChain.getHdrImageView() : swapChain.getImageViews()[imageIndex];
+
+    transitionImage(commandBuffer, sceneImage, VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        hdrTarget ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                  : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+
+    // Like depth, the multisampled target is shared by all frames in flight.
+    if (msaa) {
+        transitionImage(commandBuffer, swapChain.getColorImage(), VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+    }
+
+    // The depth image is shared by all frames in flight: wait for the previous
+    // frame's depth writes before clearing it again.
+    transitionImage(commandBuffer, swapChain.getDepthImage(), depthAspectMask(),
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+
+    VkRenderingAttachmentInfoKHR colorAttachment{ VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR };
+    colorAttachment.imageView = sceneView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.clearValue = clearValues[0];
+
+    // MSAA: render into the transient multisampled target and resolve into the
+    // scene target at the end of the pass; the samples themselves are never stored.
+    if (msaa) {
+        colorAttachment.imageView = swapChain.getColorImageView();
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+        colorAttachment.resolveImageView = sceneView;
+        colorAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    }
+
+    VkRenderingAttachmentInfoKHR depthAttachment{ VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR };
+    depthAttachment.imageView = swapChain.getDepthImageView();
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = storeDepth ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.clearValue = clearValues[1];
+
+    VkRenderingInfoKHR renderingInfo{ VK_STRUCTURE_TYPE_RENDERING_INFO_KHR };
+    renderingInfo.renderArea.offset = { 0, 0 };
+    renderingInfo.renderArea.extent = swapChain.getExtent();
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = &depthAttachment;
+
+    device->cmdBeginRendering(commandBuffer, &renderingInfo);
+}
+
+void RenderPass::end(VkCommandBuffer commandBuffer, SwapChain& swapChain, uint32_t imageIndex) {
+    if (!dynamicRendering) {
+        vkCmdEndRenderPass(commandBuffer);
+        return;
+    }
+
+    device->cmdEndRendering(commandBuffer);
+
+    if (hdrTarget) {
+        transitionImage(commandBuffer, swapChain.getHdrImage(), VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+        return;
+    }
+
+    transitionImage(commandBuffer, swapChain.getImages()[imageIndex], VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+}
+
+void RenderPass::beginPresent(VkCommandBuffer commandBuffer, SwapChain& swapChain, uint32_t imageIndex) {
+    // PostProcess::record() left the image in COLOR_ATTACHMENT_OPTIMAL; its
+    // barrier also orders the writes below after the post chain's.
+    if (!dynamicRendering) {
+        VkRenderPassBeginInfo renderPassInfo{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = swapChain.getPresentFramebuffers()[imageIndex];
+        renderPassInfo.renderArea.offset = { 0, 0 };
+        renderPassInfo.renderArea.extent = swapChain.getExtent();
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        return;
+    }
+
+    VkRenderingAttachmentInfoKHR colorAttachment{ VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR };
+    colorAttachment.imageView = swapChain.getImageViews()[imageIndex];
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+    VkRenderingInfoKHR renderingInfo{ VK_STRUCTURE_TYPE_RENDERING_INFO_KHR };
+    renderingInfo.renderArea.offset = { 0, 0 };
+    renderingInfo.renderArea.extent = swapChain.getExtent();
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+
+    device->cmdBeginRendering(commandBuffer, &renderingInfo);
+}
+
+VkImageAspectFlags RenderPass::depthAspectMask() const {
+    VkImageAspectFlags aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (depthAttachmentFormat == VK_FORMAT_D32_SFLOAT_S8_UINT ||
+        depthAttachmentFormat == VK_FORMAT_D24_UNORM_S8_UINT) {
+        aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    return aspect;
+}
+
+void RenderPass::transitionImage(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspect,
+    VkImageLayout oldLayout, VkImageLayout newLayout,
+    VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+    VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = aspect;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0,
+        0, nullptr, 0, nullptr, 1, &barrier);
 }
 
 
 void RenderPass::createRenderPass(Device& device, SwapChain& swapChain) {
+    bool msaa = samples != VK_SAMPLE_COUNT_1_BIT;
+
+    // With MSAA attachment 0 is the transient multisampled target, which is
+    // resolved into the scene target (attachment 2) and then discarded. The HDR
+    // target ends the pass ready for the post chain instead of for presentation.
+    VkImageLayout sceneFinalLayout = hdrTarget ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
     VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = swapChain.getImageFormat();
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.format = colorAttachmentFormat;
+    colorAttachment.samples = samples;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.storeOp = msaa ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachment.finalLayout = msaa ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : sceneFinalLayout;
+
+    VkAttachmentDescription depthAttachment{};
+    depthAttachment.format = swapChain.getDepthFormat();
+    depthAttachment.samples = samples;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = storeDepth ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentDescription resolveAttachment{};
+    resolveAttachment.format = colorAttachmentFormat;
+    resolveAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    resolveAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    resolveAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    resolveAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    resolveAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    resolveAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    resolveAttachment.finalLayout = sceneFinalLayout;
 
     VkAttachmentReference colorAttachmentRef{};
     colorAttachmentRef.attachment = 0;
     colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+    VkAttachmentReference depthAttachmentRef{};
+    depthAttachmentRef.attachment = 1;
+    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference resolveAttachmentRef{};
+    resolveAttachmentRef.attachment = 2;
+    resolveAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    // A single subpass serves both the depth pre-pass and shading: the pre-pass
+    // is just a depth-only pipeline bound first (see Renderer::recordCommandBuffer).
     VkSubpassDescription subpass{};
     subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorAttachmentRef;
+    subpass.pDepthStencilAttachment = &depthAttachmentRef;
+    subpass.pResolveAttachments = msaa ? &resolveAttachmentRef : nullptr;
+
+    // The depth and MSAA images are shared across frames in flight, so the clear has
+    // to wait for the previous frame's attachment writes as well as for the acquire
+    // (and, for the HDR target, for the previous frame's post chain reading it).
+    VkSubpassDependency dependencies[2]{};
+    VkSubpassDependency& dependency = dependencies[0];
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    if (hdrTarget) dependency.srcStageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // The post chain samples the HDR target right after the pass.
+    VkSubpassDependency& toPost = dependencies[1];
+    toPost.srcSubpass = 0;
+    toPost.dstSubpass = VK_SUBPASS_EXTERNAL;
+    toPost.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    toPost.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    toPost.dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    toPost.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
+    VkAttachmentDescription attachments[] = { colorAttachment, depthAttachment, resolveAttachment };
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = msaa ? 3 : 2;
+    renderPassInfo.pAttachments = attachments;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = hdrTarget ? 2 : 1;
+    renderPassInfo.pDependencies = dependencies;
+
+    if (vkCreateRenderPass(device.device(), &renderPassInfo, hostAllocator("RenderPass"), &renderPass) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create render pass!");
+    }
+}
+
+void RenderPass::createPresentRenderPass(Device& device) {
+    VkAttachmentDescription colorAttachment{};
+    colorAttachment.format = colorAttachmentFormat;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    VkAttachmentReference colorAttachmentRef{ 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorAttachmentRef;
+
+    // Chains onto PostProcess's barrier, whose destination is this stage.
     VkSubpassDependency dependency{};
     dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
     dependency.dstSubpass = 0;
     dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     dependency.srcAccessMask = 0;
     dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
-    VkRenderPassCreateInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    VkRenderPassCreateInfo renderPassInfo{ VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
     renderPassInfo.attachmentCount = 1;
     renderPassInfo.pAttachments = &colorAttachment;
     renderPassInfo.subpassCount = 1;
@@ -50,7 +346,7 @@ void RenderPass::createRenderPass(Device& device, SwapChain& swapChain) {
     renderPassInfo.dependencyCount = 1;
     renderPassInfo.pDependencies = &dependency;
 
-    if (vkCreateRenderPass(device.device(), &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create render pass!");
+    if (vkCreateRenderPass(device.device(), &renderPassInfo, hostAllocator("RenderPass"), &renderPass) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create present render pass!");
     }
 }
\ No newline at end of file
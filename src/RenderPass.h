@@ -1,26 +1,77 @@
 // src/RenderPass.h
 #pragma once
 
-#include <vulkan/vulkan.h> 
+#include <vulkan/vulkan.h>
 
 // Forward declarations
 class Device;
 class SwapChain;
 
+/// What a RenderPass draws into.
+enum class RenderPassTarget {
+    /// The scene: cleared colour and depth. Colour is the swapchain image, or the
+    /// HDR target when the swapchain has one (left readable by compute shaders).
+    Scene,
+    /// Draws over the post-processed swapchain image (loaded, colour only,
+    /// single-sampled) and leaves it ready to present. See PostProcess.
+    Present,
+};
+
 class RenderPass {
 public:
     /// Builds the VkRenderPass using the given device and swapchain settings.
-    void init(Device& device, SwapChain& swapChain);
+    /// When the device supports dynamic rendering (and it is allowed) no VkRenderPass
+    /// is created at all; only the attachment formats are recorded for pipelines.
+    void init(Device& device, SwapChain& swapChain, bool allowDynamicRendering = true,
+              RenderPassTarget target = RenderPassTarget::Scene);
 
     /// Destroys the VkRenderPass.
     void cleanup(Device& device);
 
-    /// Accessor for the render-pass handle.
+    /// Accessor for the render-pass handle (VK_NULL_HANDLE on the dynamic rendering path).
     VkRenderPass get() const { return renderPass; }
 
+    /// True when begin()/end() use vkCmdBeginRendering instead of a render pass.
+    bool usesDynamicRendering() const { return dynamicRendering; }
+
+    RenderPassTarget target() const { return passTarget; }
+
+    /// Attachment formats that pipelines must be created against.
+    VkFormat colorFormat() const { return colorAttachmentFormat; }
+    VkFormat depthFormat() const { return depthAttachmentFormat; }
+    VkSampleCountFlagBits sampleCount() const { return samples; }
+
+    /// Records the start of the pass targeting swapchain image `imageIndex`.
+    void begin(VkCommandBuffer commandBuffer, SwapChain& swapChain, uint32_t imageIndex);
+
+    /// Records the end of the pass and leaves the image ready for presentation
+    /// (the HDR target, if any, ready for the post chain).
+    void end(VkCommandBuffer commandBuffer, SwapChain& swapChain, uint32_t imageIndex);
+
 private:
     /// Actually fills out the VkRenderPassCreateInfo and calls vkCreateRenderPass.
     void createRenderPass(Device& device, SwapChain& swapChain);
 
+    /// DEPTH, plus STENCIL for combined depth/stencil formats.
+    VkImageAspectFlags depthAspectMask() const;
+
+    /// Image layout transition for the dynamic rendering path (render passes do this implicitly).
+    void transitionImage(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspect,
+        VkImageLayout oldLayout, VkImageLayout newLayout,
+        VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+        VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+    /// Present target: begin()/end() and the attachment description.
+    void beginPresent(VkCommandBuffer commandBuffer, SwapChain& swapChain, uint32_t imageIndex);
+    void createPresentRenderPass(Device& device);
+
+    Device* device = nullptr;
+    RenderPassTarget passTarget = RenderPassTarget::Scene;
     VkRenderPass renderPass = VK_NULL_HANDLE;
-};
\ No newline at end of file
+    bool dynamicRendering = false;
+    VkFormat colorAttachmentFormat = VK_FORMAT_UNDEFINED;
+    VkFormat depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    bool storeDepth = false;   // SwapChain::isDepthSampled(): depth is read after the pass
+    bool hdrTarget = false;    // SwapChain::hasHdrTarget(): the scene renders offscreen
+};
@@ -0,0 +1,152 @@
+// src/RenderSettings.cpp
+#include "RenderSettings.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    // Returns the text after "--name=" if `arg` is that option, otherwise nullptr.
+    const char* optionValue(const char* arg, const char* name) {
+        size_t len = std::strlen(name);
+        if (std::strncmp(arg, name, len) == 0 && arg[len] == '=') {
+            return arg + len + 1;
+        }
+        return nullptr;
+    }
+}
+
+RenderSettings parseRenderSettings(int argc, char** argv) {
+    RenderSettings settings;
+
+    if (const char* env = std::getenv("ENGINE_VALIDATION")) {
+        settings.validation = std::strcmp(env, "0") != 0;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = nullptr;
+
+        if (std::strcmp(arg, "--legacy-render-pass") == 0) {
+            settings.dynamicRendering = false;
+        }
+        else if (std::strcmp(arg, "--depth-prepass") == 0) {
+            settings.depthPrepass = true;
+        }
+        else if (std::strcmp(arg, "--no-command-buffer-cache") == 0) {
+            settings.cacheCommandBuffers = false;
+        }
+        else if (std::strcmp(arg, "--stats") == 0) {
+            settings.printFrameStats = true;
+        }
+        else if (std::strcmp(arg, "--serial-init") == 0) {
+            settings.parallelInit = false;
+        }
+        else if (std::strcmp(arg, "--zero-alloc-frames") == 0) {
+            settings.zeroAllocFrames = true;
+        }
+        else if (std::strcmp(arg, "--overlay") == 0) {
+            settings.overlay = true;
+        }
+        else if (std::strcmp(arg, "--validation") == 0) {
+            settings.validation = true;
+        }
+        else if (std::strcmp(arg, "--no-validation") == 0) {
+            settings.validation = false;
+        }
+        else if ((value = optionValue(arg, "--log-level")) != nullptr) {
+            if (!Logger::parseSeverity(value, settings.logLevel)) {
+                Logger::global().logf(LogSeverity::Warning, "engine",
+                    "unknown log level '%s'; expected verbose, info, warning or error", value);
+            }
+        }
+        else if (std::strcmp(arg, "--lod-tint") == 0) {
+            settings.lodTint = true;
+        }
+        else if (std::strcmp(arg, "--lod-draw-per-instance") == 0) {
+            settings.lodDrawPerInstance = true;
+        }
+        else if (std::strcmp(arg, "--occlusion-culling") == 0) {
+            settings.occlusionCulling = true;
+        }
+        else if (std::strcmp(arg, "--shadows") == 0) {
+            settings.shadows = true;
+        }
+        else if (std::strcmp(arg, "--no-shadow-cache") == 0) {
+            settings.shadowCache = false;
+        }
+        else if (std::strcmp(arg, "--post") == 0) {
+            settings.postProcess = true;
+        }
+        else if ((value = optionValue(arg, "--scene")) != nullptr) {
+            if (std::strcmp(value, "triangle") == 0) {
+                settings.scene = SceneKind::Triangle;
+            }
+            else if (std::strcmp(value, "overdraw") == 0) {
+                settings.scene = SceneKind::Overdraw;
+            }
+            else if (std::strcmp(value, "lights") == 0) {
+                settings.scene = SceneKind::Lights;
+            }
+            else if (std::strcmp(value, "lod") == 0) {
+                settings.scene = SceneKind::Lod;
+            }
+            else if (std::strcmp(value, "sprites") == 0) {
+                settings.scene = SceneKind::Sprites;
+            }
+            else if (std::strcmp(value, "crowd") == 0) {
+                settings.scene = SceneKind::Crowd;
+            }
+            else {
+                Logger::global().logf(LogSeverity::Warning, "engine", "unknown scene '%s', using triangle", value);
+            }
+        }
+        else if ((value = optionValue(arg, "--msaa")) != nullptr) {
+            int samples = std::atoi(value);
+            if (samples == 1 || samples == 2 || samples == 4 || samples == 8) {
+                settings.msaaSamples = static_cast<uint32_t>(samples);
+            }
+            else {
+                Logger::global().logf(LogSeverity::Warning, "engine",
+                    "--msaa expects 1, 2, 4 or 8; keeping %u", settings.msaaSamples);
+            }
+        }
+        else if ((value = optionValue(arg, "--overdraw-layers")) != nullptr) {
+            int layers = std::atoi(value);
+            if (layers > 0) settings.overdrawLayers = static_cast<uint32_t>(layers);
+        }
+        else if ((value = optionValue(arg, "--lights")) != nullptr) {
+            int count = std::atoi(value);
+            if (count >= 0) settings.lightCount = static_cast<uint32_t>(count);
+        }
+        else if ((value = optionValue(arg, "--lod-error")) != nullptr) {
+            float pixels = static_cast<float>(std::atof(value));
+            if (pixels > 0.0f) settings.lodErrorPixels = pixels;
+        }
+        else if ((value = optionValue(arg, "--shadow-size")) != nullptr) {
+            int size = std::atoi(value);
+            if (size >= 256 && size <= 8192) {
+                settings.shadowMapSize = static_cast<uint32_t>(size);
+            }
+            else {
+                Logger::global().logf(LogSeverity::Warning, "engine",
+                    "--shadow-size expects 256..8192; keeping %u", settings.shadowMapSize);
+            }
+        }
+        else if ((value = optionValue(arg, "--sprites")) != nullptr) {
+            int count = std::atoi(value);
+            if (count > 0) settings.spriteCount = static_cast<uint32_t>(count);
+        }
+        else if ((value = optionValue(arg, "--characters")) != nullptr) {
+            int count = std::atoi(value);
+            if (count > 0) settings.characterCount = static_cast<uint32_t>(count);
+        }
+        else if ((value = optionValue(arg, "--jobs")) != nullptr) {
+            int count = std::atoi(value);
+            if (count > 0) settings.jobThreads = static_cast<uint32_t>(count);
+        }
+        else if ((value = optionValue(arg, "--particles")) != nullptr) {
+            int count = std::atoi(value);
+            if (count >= 0) settings.particleCount = static_cast<uint32_t>(count);
+        }
+    }
+    return settings;
+}
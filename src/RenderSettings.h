@@ -0,0 +1,124 @@
+// src/RenderSettings.h
+#pragma once
+
+#include <cstdint>
+
+#include "Logger.h"
+
+// Which content the renderer draws.
+enum class SceneKind {
+    Triangle,   // the original hard-coded triangle
+    Overdraw,   // stacked full-screen layers drawn back to front (depth pre-pass benchmark)
+    Lights,     // boxes on a floor lit by many dynamic point lights (clustered forward)
+    Lod,        // a large field of rock instances drawn through a mesh LOD chain
+    Sprites,    // many spinning 2D sprites drawn through the batched sprite renderer
+    Crowd,      // many skinned characters animated on the job system
+};
+
+// Startup options for the renderer, parsed from the command line in main().
+struct RenderSettings {
+    // Use dynamic rendering (vkCmdBeginRendering) when the device supports it.
+    // false forces the VkRenderPass/VkFramebuffer path.
+    bool dynamicRendering = true;
+
+    // Lay down depth with a depth-only pipeline first, then shade with
+    // depth compare EQUAL so every pixel is shaded at most once.
+    bool depthPrepass = false;
+
+    // MSAA sample count (1, 2, 4 or 8); clamped to what the device supports.
+    uint32_t msaaSamples = 1;
+
+    // Keep each recorded command buffer (per frame slot and swapchain image) and
+    // submit it again while nothing it depends on has changed, instead of
+    // re-recording every frame. Off re-records every frame, for comparison.
+    bool cacheCommandBuffers = true;
+
+    // Render into an HDR target and finish the frame with the compute post chain
+    // (auto-exposure from a luminance histogram, bloom, ACES tonemapping).
+    bool postProcess = false;
+
+    SceneKind scene = SceneKind::Triangle;
+    uint32_t  overdrawLayers = 32;          // layers in the overdraw scene
+    uint32_t  overdrawShadingIterations = 64; // fragment cost per layer
+
+    uint32_t  lightCount = 1024;            // dynamic point lights in the lights scene
+
+    uint32_t  lodGridSize = 64;             // rocks per side in the LOD scene
+    float     lodErrorPixels = 1.0f;        // max projected simplification error
+    bool      lodTint = false;              // color rocks by selected LOD
+    bool      lodDrawPerInstance = false;   // one draw call per rock instead of per LOD (draw-call stress)
+    // Cull rocks on the GPU against a Hi-Z pyramid of the previous frame's depth
+    // and draw the survivors indirectly (LOD scene, single-sampled only).
+    bool      occlusionCulling = false;
+    // Cascaded sun shadows in the LOD scene. Still clusters are static casters,
+    // cached per cascade unless shadowCache is off; spinning ones are redrawn every frame.
+    bool      shadows = false;
+    bool      shadowCache = true;
+    uint32_t  shadowMapSize = 2048;         // texels per side of each cascade
+
+    uint32_t  spriteCount = 100000;         // sprites per frame in the sprites scene
+
+    uint32_t  characterCount = 1000;        // animated characters in the crowd scene
+
+    // Threads for parallel CPU work (animation, startup), the render thread included;
+    // 0 uses every hardware thread, 1 runs everything on the render thread.
+    uint32_t jobThreads = 0;
+
+    // Run startup as a dependency graph on jobThreads threads; off runs the same
+    // steps one after another on the main thread.
+    bool parallelInit = true;
+
+    // GPU particle count simulated on the (async) compute queue; 0 disables particles.
+    uint32_t particleCount = 0;
+
+    // Print averaged CPU/GPU frame timings to stdout every couple of seconds.
+    bool printFrameStats = false;
+
+    // Log an error naming the allocating sites for every frame, after a short
+    // warm-up, that allocates host memory. Heap allocations are only seen in
+    // builds with ENGINE_HOST_ALLOCATION_HOOK; Vulkan ones always are.
+    bool zeroAllocFrames = false;
+
+    // Start with the performance overlay shown; F1 toggles it at runtime.
+    bool overlay = false;
+
+    // Vulkan validation layers, on by default in debug builds only. Overridden
+    // by the ENGINE_VALIDATION environment variable (0/1), then by the flags.
+#ifdef NDEBUG
+    bool validation = false;
+#else
+    bool validation = true;
+#endif
+
+    // Messages below this severity (engine and validation) are discarded.
+    LogSeverity logLevel = LogSeverity::Warning;
+};
+
+// Parse command-line flags into RenderSettings. Unknown flags are ignored.
+//   --legacy-render-pass   never use dynamic rendering
+//   --depth-prepass        enable the depth-only pre-pass
+//   --msaa=<n>             MSAA sample count (1, 2, 4, 8)
+//   --no-command-buffer-cache  re-record the command buffer every frame
+//   --post                 HDR rendering with compute bloom, auto-exposure and tonemapping
+//   --scene=<name>         triangle | overdraw | lights | lod | sprites | crowd
+//   --overdraw-layers=<n>  number of layers in the overdraw scene
+//   --lights=<n>           number of point lights in the lights scene
+//   --lod-error=<px>       LOD selection threshold in pixels
+//   --lod-tint             tint rocks by their selected LOD
+//   --lod-draw-per-instance  issue one draw per rock instead of one per LOD
+//   --occlusion-culling    GPU frustum + Hi-Z occlusion culling in the lod scene
+//   --shadows              cascaded sun shadows in the lod scene
+//   --no-shadow-cache      redraw static shadow casters every frame
+//   --shadow-size=<n>      shadow cascade resolution
+//   --sprites=<n>          number of sprites in the sprites scene
+//   --characters=<n>       number of animated characters in the crowd scene
+//   --jobs=<n>             threads for parallel CPU work, the render thread included
+//   --serial-init          run the startup steps one at a time
+//   --particles=<n>        simulate and draw up to n GPU particles
+//   --stats                print frame timings
+//   --zero-alloc-frames    report every frame that allocates host memory
+//   --overlay              show the performance overlay (toggle with F1)
+//   --validation           enable the Vulkan validation layers
+//   --no-validation        disable them
+//   --log-level=<level>    verbose | info | warning | error
+RenderSettings parseRenderSettings(int argc, char** argv);
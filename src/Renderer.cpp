@@ -1,4 +1,6 @@
 #include "Renderer.h"
+#include "HostMemoryTracker.h"
+#include "Logger.h"
 #include "Device.h"
 #include "SwapChain.h"
 #include "RenderPass.h"
@@ -8,30 +10,95 @@
 #include <stdexcept>
 #include <vector>
 #include <array>
+#include <algorithm>
 #include <iostream>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    // Boxes per side in the lights scene; must match GRID in lit.vert.
+    const uint32_t LIT_SCENE_GRID = 16;
+
+    // Initial per-frame scratch; an arena that overflows grows to its high-water mark.
+    const size_t FRAME_ARENA_BYTES = 1 << 20;
+
+    // Overlay layout, in glyph-scale pixels.
+    const float OVERLAY_MARGIN = 8.0f;
+    const float OVERLAY_PADDING = 6.0f;
+    const float GRAPH_HEIGHT = 40.0f;
+    const float GRAPH_MAX_MS = 33.3f;        // top of the graph; longer frames are clipped
+    const float TARGET_FRAME_MS = 16.7f;     // reference line and the green/yellow threshold
+
+    // --zero-alloc-frames: frames before this are still filling caches and arenas.
+    const uint64_t ZERO_ALLOC_WARMUP_FRAMES = 120;
+    // Scopes that format text for the stats line and the overlay, and the
+    // logger's writer thread; they are reported but not held to zero.
+    const char* const DIAGNOSTIC_SITES[] = { "frame/stats", "frame/overlay", "logger" };
+
+    bool isDiagnosticSite(const char* site) {
+        for (const char* name : DIAGNOSTIC_SITES) {
+            if (std::strcmp(site, name) == 0) return true;
+        }
+        return false;
+    }
+
+    const uint32_t OVERLAY_BACKGROUND = overlayColor(0, 0, 0, 170);
+    const uint32_t OVERLAY_TEXT = overlayColor(235, 235, 235);
+    const uint32_t OVERLAY_LABEL = overlayColor(140, 200, 255);
+    const uint32_t OVERLAY_GRAPH_BACKGROUND = overlayColor(40, 40, 40, 200);
+    const uint32_t OVERLAY_TARGET_LINE = overlayColor(255, 255, 255, 90);
+
+    uint32_t frameTimeColor(float ms) {
+        if (ms <= TARGET_FRAME_MS) return overlayColor(90, 220, 90);
+        if (ms <= 2.0f * TARGET_FRAME_MS) return overlayColor(240, 200, 60);
+        return overlayColor(240, 70, 60);
+    }
+}
 
-void Renderer::init(Device& device_, SwapChain& swapChain_, RenderPass& renderPass_, Pipeline& pipeline_) {
+void Renderer::init(Device& device_, SwapChain& swapChain_, RenderPass& renderPass_, Pipeline& pipeline_,
+                    const RenderSettings& settings_, Pipeline* depthPrepassPipeline_) {
     // assign the pointers
     device = &device_;
     swapChain = &swapChain_;
     renderPass = &renderPass_;
     pipeline = &pipeline_;
+    depthPrepassPipeline = depthPrepassPipeline_;
+    settings = settings_;
 
     createCommandPool();
     createCommandBuffers();
     createSyncObjects();
+
+    camera.setPerspective(1.0472f, 0.1f, 500.0f);
+    camera.lookAt(Vec3{ 0.0f, 10.0f, 28.0f }, Vec3{ 0.0f, 2.0f, 0.0f });
+
+    gpuTimer.init(*device, MAX_FRAMES_IN_FLIGHT, GpuScopeCount);
+
+    for (FrameArena& arena : frameArenas) {
+        arena.init(FRAME_ARENA_BYTES);
+    }
+
+    if (settings.zeroAllocFrames && !HostMemoryTracker::global().heapHookEnabled()) {
+        Logger::global().log(LogSeverity::Warning, "memory", 0,
+            "--zero-alloc-frames only sees Vulkan host allocations; build with ENGINE_HOST_ALLOCATION_HOOK=ON to check the heap too");
+    }
 }
 
 void Renderer::cleanup() {
     vkDeviceWaitIdle(device->device());
 
+    gpuTimer.cleanup();
+    for (FrameArena& arena : frameArenas) {
+        arena.cleanup();
+    }
+
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        vkDestroySemaphore(device->device(), renderFinishedSemaphores[i], nullptr);
-        vkDestroySemaphore(device->device(), imageAvailableSemaphores[i], nullptr);
-        vkDestroyFence(device->device(), inFlightFences[i], nullptr);
+        vkDestroySemaphore(device->device(), renderFinishedSemaphores[i], hostAllocator("Renderer"));
+        vkDestroySemaphore(device->device(), imageAvailableSemaphores[i], hostAllocator("Renderer"));
+        vkDestroyFence(device->device(), inFlightFences[i], hostAllocator("Renderer"));
     }
     if (commandPool != VK_NULL_HANDLE) {
-        vkDestroyCommandPool(device->device(), commandPool, nullptr);
+        vkDestroyCommandPool(device->device(), commandPool, hostAllocator("Renderer"));
         commandPool = VK_NULL_HANDLE;
     }
 }
@@ -44,20 +111,37 @@ void Renderer::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t image
         throw std::runtime_error("failed to begin recording command buffer!");
     }
 
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = renderPass->get();
-    renderPassInfo.framebuffer = swapChain->getFramebuffers()[imageIndex];
-    renderPassInfo.renderArea.offset = { 0, 0 };
-    renderPassInfo.renderArea.extent = swapChain->getExtent();
+    gpuTimer.reset(commandBuffer, currentFrame);
+    gpuTimer.begin(commandBuffer, currentFrame, GpuScopeFrame);
+    drawCalls = 0;
 
-    VkClearValue clearColor = { {{0.0f, 0.0f, 0.0f, 1.0f}} };
-    renderPassInfo.clearValueCount = 1;
-    renderPassInfo.pClearValues = &clearColor;
+    // Light binning has to finish before the pass; it writes the cluster lists lit.frag reads.
+    if (lighting) {
+        gpuTimer.begin(commandBuffer, currentFrame, GpuScopeLightCulling);
+        lighting->recordCulling(commandBuffer, currentFrame);
+        gpuTimer.end(commandBuffer, currentFrame, GpuScopeLightCulling);
+    }
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    // GPU instance culling against the pyramid built at the end of the previous frame.
+    if (lodScene && depthPyramid) {
+        gpuTimer.begin(commandBuffer, currentFrame, GpuScopeOcclusionCulling);
+        lodScene->recordCulling(commandBuffer, currentFrame);
+        gpuTimer.end(commandBuffer, currentFrame, GpuScopeOcclusionCulling);
+    }
 
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->get());
+    // Shadow cascades: cached static casters plus this frame's dynamic ones.
+    if (lodScene && shadowMap) {
+        gpuTimer.begin(commandBuffer, currentFrame, GpuScopeShadows);
+        drawCalls += shadowMap->record(commandBuffer,
+            [&](VkCommandBuffer cmd, VkPipelineLayout layout, uint32_t cascade, CascadedShadowMap::Casters casters) {
+                return lodScene->recordShadowCasters(cmd, layout, currentFrame, cascade,
+                    casters == CascadedShadowMap::Casters::Static);
+            });
+        gpuTimer.end(commandBuffer, currentFrame, GpuScopeShadows);
+    }
+
+    // Legacy render pass or vkCmdBeginRendering, depending on what the device supports.
+    renderPass->begin(commandBuffer, *swapChain, imageIndex);
 
     VkViewport viewport{};
     viewport.x = 0.0f;
@@ -73,15 +157,121 @@ void Renderer::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t image
     scissor.extent = swapChain->getExtent();
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+    // Depth pre-pass: same geometry, no fragment shader. Afterwards the depth buffer
+    // holds the nearest surface and the shading pipeline (compare EQUAL, no writes)
+    // runs its fragment shader once per pixel.
+    if (depthPrepassPipeline) {
+        gpuTimer.begin(commandBuffer, currentFrame, GpuScopeDepthPrepass);
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, depthPrepassPipeline->get());
+        recordSceneDraws(commandBuffer, *depthPrepassPipeline);
+        gpuTimer.end(commandBuffer, currentFrame, GpuScopeDepthPrepass);
+    }
+
+    gpuTimer.begin(commandBuffer, currentFrame, GpuScopeShading);
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->get());
+    recordSceneDraws(commandBuffer, *pipeline);
+    gpuTimer.end(commandBuffer, currentFrame, GpuScopeShading);
+
+    // Particles go last: additive and depth-tested against the scene without writing depth.
+    if (particles) {
+        gpuTimer.begin(commandBuffer, currentFrame, GpuScopeParticles);
+        particles->recordDraw(commandBuffer, camera);
+        gpuTimer.end(commandBuffer, currentFrame, GpuScopeParticles);
+        drawCalls++;
+    }
+
+    // Overlay on top of everything, still inside the pass (so it is resolved with MSAA).
+    // With post-processing it waits for the finished image instead, so the tonemap
+    // and the exposure leave the text alone.
+    bool drawOverlay = overlayVisible && overlay->quadCount() > 0;
+    if (drawOverlay && !postProcess) {
+        recordOverlay(commandBuffer);
+    }
 
-    vkCmdEndRenderPass(commandBuffer);
+    renderPass->end(commandBuffer, *swapChain, imageIndex);
+
+    // This frame's depth becomes next frame's occluders.
+    if (depthPyramid) {
+        gpuTimer.begin(commandBuffer, currentFrame, GpuScopeDepthPyramid);
+        depthPyramid->recordBuild(commandBuffer, camera.viewProjection());
+        gpuTimer.end(commandBuffer, currentFrame, GpuScopeDepthPyramid);
+    }
+
+    if (postProcess) {
+        gpuTimer.begin(commandBuffer, currentFrame, GpuScopePostProcess);
+        postProcess->record(commandBuffer, imageIndex, float(lastFrameMs / 1000.0), drawOverlay);
+        gpuTimer.end(commandBuffer, currentFrame, GpuScopePostProcess);
+
+        if (drawOverlay) {
+            presentPass->begin(commandBuffer, *swapChain, imageIndex);
+            recordOverlay(commandBuffer);
+            presentPass->end(commandBuffer, *swapChain, imageIndex);
+        }
+    }
+
+    gpuTimer.end(commandBuffer, currentFrame, GpuScopeFrame);
 
     if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to record command buffer!");
     }
 }
 
+void Renderer::recordOverlay(VkCommandBuffer commandBuffer) {
+    gpuTimer.begin(commandBuffer, currentFrame, GpuScopeOverlay);
+    overlay->recordDraw(commandBuffer, currentFrame);
+    gpuTimer.end(commandBuffer, currentFrame, GpuScopeOverlay);
+    drawCalls++;
+}
+
+void Renderer::recordSceneDraws(VkCommandBuffer commandBuffer, Pipeline& boundPipeline) {
+    switch (settings.scene) {
+    case SceneKind::Triangle:
+        vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+        drawCalls++;
+        break;
+
+    case SceneKind::Overdraw: {
+        // One instance per layer, drawn back to front: without a pre-pass every
+        // layer passes the depth test and pays for the full fragment shader.
+        OverdrawPushConstants push{ settings.overdrawLayers, settings.overdrawShadingIterations };
+        vkCmdPushConstants(commandBuffer, boundPipeline.layout(),
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(push), &push);
+        vkCmdDraw(commandBuffer, 6, settings.overdrawLayers, 0, 0);
+        drawCalls++;
+        break;
+    }
+
+    case SceneKind::Lights:
+        // 36 vertices per box; instance 0 is the floor.
+        lighting->bind(commandBuffer, boundPipeline.layout(), currentFrame);
+        vkCmdDraw(commandBuffer, 36, 1 + LIT_SCENE_GRID * LIT_SCENE_GRID, 0, 0);
+        drawCalls++;
+        break;
+
+    case SceneKind::Lod:
+        if (shadowMap) {
+            VkDescriptorSet shadowSet = shadowMap->descriptorSet(currentFrame);
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, boundPipeline.layout(),
+                1, 1, &shadowSet, 0, nullptr);
+        }
+        // Instances were bucketed by LOD in LodScene::update(); one draw per LOD.
+        drawCalls += lodScene->recordDraws(commandBuffer, boundPipeline.layout(), currentFrame, camera,
+            settings.lodTint, settings.lodDrawPerInstance);
+        break;
+
+    case SceneKind::Sprites:
+        // Sorted by layer and texture in SpriteScene::update(); one instanced draw per texture run.
+        drawCalls += spriteScene->recordDraws(commandBuffer, boundPipeline.layout(), currentFrame,
+            swapChain->getExtent());
+        break;
+
+    case SceneKind::Crowd:
+        // Palettes were written in CrowdScene::update(); the whole crowd is one instanced draw.
+        drawCalls += crowdScene->recordDraws(commandBuffer, boundPipeline.layout(), currentFrame, camera);
+        break;
+    }
+}
+
 void Renderer::createCommandPool() {
 
     Device::QueueFamilyIndices queueFamilyIndices = device->findQueueFamilies(device->physicalDevice());
@@ -91,46 +281,91 @@ void Renderer::createCommandPool() {
     poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
 
-    if (vkCreateCommandPool(device->device(), &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
+    if (vkCreateCommandPool(device->device(), &poolInfo, hostAllocator("Renderer"), &commandPool) != VK_SUCCESS) {
         throw std::runtime_error("failed to create command pool!");
     }
 }
 void Renderer::createCommandBuffers() {
-    // 1) size your storage to match how many you need:
-    size_t count = swapChain->getFramebuffers().size();
-    commandBuffers.resize(count);
+    // One per frame slot and swapchain image, so a recording stays valid (same
+    // per-frame resources, same target image) and can be submitted again the
+    // next time this slot acquires this image.
+    imagesPerFrame = static_cast<uint32_t>(swapChain->getImageViews().size());
+    commandBuffers.resize(size_t(MAX_FRAMES_IN_FLIGHT) * imagesPerFrame);
+    recordedCommands.assign(commandBuffers.size(), RecordedCommands{});
 
-    // 2) fill out the allocator info
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = commandPool;                         // your pool
+    allocInfo.commandPool = commandPool;
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = static_cast<uint32_t>(count);
+    allocInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
 
-    // 3) allocate into the array/vector .data()
     if (vkAllocateCommandBuffers(device->device(),
         &allocInfo,
         commandBuffers.data()) != VK_SUCCESS) {
         throw std::runtime_error("failed to allocate command buffers!");
     }
+}
 
-    // 4) (optional) record each buffer
-    for (size_t i = 0; i < count; i++) {
-        VkCommandBufferBeginInfo beginInfo{};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        //  any flags 
-
-        vkBeginCommandBuffer(commandBuffers[i], &beginInfo);
-        // record your draw calls into commandBuffers[i]
-        vkEndCommandBuffer(commandBuffers[i]);
+bool Renderer::buildRecordKey(RecordKey& key) const {
+    // These record values computed on the CPU every frame: LOD buckets and
+    // culling, shadow cascade matrices, the particle buffer parity, the frame
+    // time that drives exposure adaptation.
+    if (lodScene || particles || postProcess || depthPyramid || shadowMap) {
+        return false;
     }
+
+    key.pipeline = pipeline->get();
+    key.depthPrepassPipeline = depthPrepassPipeline ? depthPrepassPipeline->get() : VK_NULL_HANDLE;
+    key.drawListVersion = spriteScene ? spriteScene->drawListVersion() : 0;
+    // The crowd pushes the view-projection matrix with its draw; the other scenes
+    // read the camera from buffers written in update().
+    key.cameraVersion = crowdScene ? cameraVersion : 0;
+    key.overlayQuads = overlayVisible ? overlay->quadCount() : 0;
+    return true;
 }
 
-void Renderer::drawFrame() {
-    vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+void Renderer::drawFrame(const FramePacket& packet) {
+    swapChain->setFramebufferExtent(packet.framebufferExtent);
+    framebufferResized |= packet.framebufferResized;
+
+    using Clock = std::chrono::steady_clock;
+    auto phaseStart = Clock::now();
+    auto endPhase = [&phaseStart](double& ms) {
+        auto now = Clock::now();
+        ms = std::chrono::duration<double, std::milli>(now - phaseStart).count();
+        phaseStart = now;
+    };
+    previousCpuTimings = cpuTimings;   // the overlay shows the last complete frame
+    cpuTimings = {};
+    HostMemoryTracker::global().endFrame(hostAllocations);
+    checkHostAllocations();
+    HostAllocationScope allocationScope("frame/wait");
+
+    // 1) Wait on the previous frames GPU work
+    vkWaitForFences(device->device(), 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+    endPhase(cpuTimings.wait);
+    allocationScope.enter("frame/acquire");
+
+    // This slot's previous submission is finished, so its timestamps are ready
+    // and its transient CPU allocations can be recycled.
+    gpuTimer.collect(currentFrame);
+    frameArenas[currentFrame].reset();
+    // Budgets move with other processes too, so re-read them every frame;
+    // pressure listeners run here, between frames.
+    device->memory().update();
+    updateFrameStats();
 
-    uint32_t imageIndex;
-    VkResult result = vkAcquireNextImageKHR(device, swapChain, UINT64_MAX, imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+    // 2) Grab the next swapchain image directly into currentImageIndex
+    VkResult result = vkAcquireNextImageKHR(
+        device->device(),
+        swapChain->getSwapChain(),
+        UINT64_MAX,
+        imageAvailableSemaphores[currentFrame],
+        VK_NULL_HANDLE,
+        &currentImageIndex
+    );
+    endPhase(cpuTimings.acquire);
+    allocationScope.enter("frame/update");
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
         recreateSwapChain();
@@ -140,32 +375,83 @@ void Renderer::drawFrame() {
         throw std::runtime_error("failed to acquire swap chain image!");
     }
 
-    // 1) Wait on the previous frames GPU work
+    // Only reset the fence once we know work will be submitted this frame
     vkResetFences(device->device(), 1, &inFlightFences[currentFrame]);
 
-    // 2) Grab the next swapchain image directly into currentImageIndex
-    vkAcquireNextImageKHR(
-        device->device(),
-        swapChain->getSwapChain(),
-        UINT64_MAX,
-        imageAvailableSemaphores[currentFrame],
-        VK_NULL_HANDLE,
-        &currentImageIndex
-    );
+    // Particle compute goes to the compute queue first; with a separate compute family
+    // it overlaps the previous frame's graphics work. The fence above already retired
+    // the graphics frame that last read the buffers it writes.
+    VkSemaphore particlesReady = particles ? particles->submitCompute(currentFrame) : VK_NULL_HANDLE;
 
-    // 3) Re-record this frames command buffer against the newly acquired image
-    vkResetCommandBuffer(commandBuffers[currentFrame], 0);
-    recordCommandBuffer(commandBuffers[currentFrame], currentImageIndex);
+    // Everything above may have blocked (fence, acquire); aim the camera now.
+    if (lateCameraUpdate) {
+        lateCameraUpdate(packet, camera);
+    }
+
+    VkExtent2D extent = swapChain->getExtent();
+    camera.setAspect(float(extent.width) / float(std::max(extent.height, 1u)));
+    Mat4 viewProjection = camera.viewProjection();
+    if (std::memcmp(viewProjection.m, lastViewProjection.m, sizeof(viewProjection.m)) != 0) {
+        lastViewProjection = viewProjection;
+        cameraVersion++;
+    }
+    float time = packet.time;
+    if (lighting) {
+        lighting->update(currentFrame, camera, extent, time);
+    }
+    if (lodScene) {
+        lodScene->update(currentFrame, camera, extent, time, frameArenas[currentFrame]);
+        if (shadowMap) {
+            shadowMap->update(currentFrame, camera, LodScene::lightDirection());
+        }
+    }
+    if (spriteScene) {
+        spriteScene->update(currentFrame, extent, time);
+    }
+    if (crowdScene) {
+        crowdScene->update(currentFrame, time);
+    }
+    overlayVisible = overlay && packet.showOverlay;
+    if (overlayVisible) {
+        auto overlayStart = Clock::now();
+        HostAllocationScope overlayScope("frame/overlay");
+        buildOverlay();
+        overlayCpuMs = std::chrono::duration<double, std::milli>(Clock::now() - overlayStart).count();
+    }
+    endPhase(cpuTimings.update);
+    allocationScope.enter("frame/record");
+
+    // 3) Reuse this frame slot's command buffer for the acquired image if it was
+    //    recorded with the same inputs, otherwise re-record it
+    commandBufferIndex = currentFrame * imagesPerFrame + currentImageIndex;
+    RecordedCommands& recorded = recordedCommands[commandBufferIndex];
+    RecordKey key;
+    bool reusable = settings.cacheCommandBuffers && buildRecordKey(key);
+    lastFrameReused = reusable && recorded.reusable && recorded.key == key;
+    if (lastFrameReused) {
+        gpuTimer.replay(currentFrame, recorded.timerScopes);
+        drawCalls = recorded.drawCalls;
+    }
+    else {
+        vkResetCommandBuffer(commandBuffers[commandBufferIndex], 0);
+        recordCommandBuffer(commandBuffers[commandBufferIndex], currentImageIndex);
+        recorded.reusable = reusable;
+        recorded.key = key;
+        recorded.drawCalls = drawCalls;
+        recorded.timerScopes = gpuTimer.recordedScopes(currentFrame);
+    }
+    endPhase(cpuTimings.record);
+    allocationScope.enter("frame/submit");
 
     // 4) Submit to the graphics queue
     VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-    VkSemaphore waitSemaphores[] = { imageAvailableSemaphores[currentFrame] };
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    submitInfo.waitSemaphoreCount = 1;
+    VkSemaphore waitSemaphores[] = { imageAvailableSemaphores[currentFrame], particlesReady };
+    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, ParticleSystem::waitStage };
+    submitInfo.waitSemaphoreCount = particles ? 2 : 1;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffers[currentFrame];
+    submitInfo.pCommandBuffers = &commandBuffers[commandBufferIndex];
     VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame] };
     submitInfo.signalSemaphoreCount = 1;
     submitInfo.pSignalSemaphores = signalSemaphores;
@@ -173,6 +459,8 @@ void Renderer::drawFrame() {
     if (vkQueueSubmit(device->graphicsQueue(), 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) {
         throw std::runtime_error("failed to submit draw command buffer!");
     }
+    endPhase(cpuTimings.submit);
+    allocationScope.enter("frame/present");
 
     // 5) Present, using that same currentImageIndex
     VkPresentInfoKHR presentInfo{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
@@ -192,6 +480,7 @@ void Renderer::drawFrame() {
     else if (result != VK_SUCCESS) {
         throw std::runtime_error("failed to present swap chain image!");
     }
+    endPhase(cpuTimings.present);
 
     // 6) Advance to the next frame slot
     currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
@@ -199,6 +488,234 @@ void Renderer::drawFrame() {
 
 
 
+void Renderer::updateFrameStats() {
+    auto now = std::chrono::steady_clock::now();
+    if (lastFrameStart == std::chrono::steady_clock::time_point{}) {
+        lastFrameStart = now;
+        lastStatsReport = now;
+        return;
+    }
+
+    lastFrameMs = std::chrono::duration<double, std::milli>(now - lastFrameStart).count();
+    statsCpuMs += lastFrameMs;
+    historyCpuMs[historyNext] = float(lastFrameMs);
+    historyGpuMs[historyNext] = float(gpuTimer.lastMs(GpuScopeFrame));
+    historyNext = (historyNext + 1) % FRAME_HISTORY;
+    for (uint32_t scope = 0; scope < GpuScopeCount; scope++) {
+        statsGpuMs[scope] += gpuTimer.lastMs(scope);
+    }
+    if (lodScene) {
+        statsTriangles += lodScene->triangleCount();
+        statsTransforms += lodScene->transformsUpdated();
+    }
+    if (crowdScene) {
+        statsAnimationMs += crowdScene->animationMs();
+    }
+    statsReusedFrames += lastFrameReused ? 1 : 0;
+    statsHostAllocations += hostAllocations.count;
+    statsHostBytes += hostAllocations.bytes;
+    statsFrames++;
+    lastFrameStart = now;
+
+    if (!settings.printFrameStats || now - lastStatsReport < std::chrono::seconds(2)) return;
+
+    HostAllocationScope allocationScope("frame/stats");
+    double frames = double(statsFrames);
+    std::cout << "frame " << statsCpuMs / frames << " ms cpu";
+    if (gpuTimer.supported()) {
+        std::cout << " | gpu " << statsGpuMs[GpuScopeFrame] / frames << " ms"
+                  << " (";
+        if (lighting) {
+            std::cout << "light culling " << statsGpuMs[GpuScopeLightCulling] / frames << " ms, ";
+        }
+        std::cout << "depth pre-pass " << statsGpuMs[GpuScopeDepthPrepass] / frames << " ms"
+                  << ", shading " << statsGpuMs[GpuScopeShading] / frames << " ms";
+        if (particles) {
+            std::cout << ", particles " << statsGpuMs[GpuScopeParticles] / frames << " ms";
+        }
+        if (depthPyramid) {
+            std::cout << ", occlusion culling " << statsGpuMs[GpuScopeOcclusionCulling] / frames << " ms"
+                      << ", depth pyramid " << statsGpuMs[GpuScopeDepthPyramid] / frames << " ms";
+        }
+        if (shadowMap) {
+            std::cout << ", shadows " << statsGpuMs[GpuScopeShadows] / frames << " ms";
+        }
+        if (postProcess) {
+            std::cout << ", post " << statsGpuMs[GpuScopePostProcess] / frames << " ms";
+        }
+        std::cout << ")";
+    }
+    if (lodScene) {
+        std::cout << " | " << statsTriangles / statsFrames << " triangles, "
+                  << statsTransforms / statsFrames << " transforms updated";
+        if (depthPyramid) {
+            std::cout << ", " << lodScene->visibleInstances() << "/" << lodScene->instanceCount() << " rocks visible";
+        }
+    }
+    if (crowdScene) {
+        std::cout << " | animation " << statsAnimationMs / frames << " ms for " << crowdScene->characterCount()
+                  << " characters on " << crowdScene->animationThreads() << " threads";
+    }
+    if (settings.cacheCommandBuffers) {
+        std::cout << " | " << statsReusedFrames * 100 / statsFrames << "% command buffers reused";
+    }
+    std::cout << " | " << double(statsHostAllocations) / frames << " host allocations ("
+              << double(statsHostBytes) / frames / 1024.0 << " KiB) per frame";
+    std::cout << std::endl;
+    std::cout << "  " << device->memory().summary() << std::endl;
+    std::cout << "  " << HostMemoryTracker::global().summary() << std::endl;
+
+    statsCpuMs = 0.0;
+    statsTriangles = 0;
+    statsTransforms = 0;
+    statsAnimationMs = 0.0;
+    statsReusedFrames = 0;
+    statsHostAllocations = 0;
+    statsHostBytes = 0;
+    for (double& ms : statsGpuMs) ms = 0.0;
+    statsFrames = 0;
+    lastStatsReport = now;
+}
+
+void Renderer::buildOverlay() {
+    overlay->begin(currentFrame, swapChain->getExtent());
+    const float k = overlay->glyphScale();
+
+    // Format first, so the background can be sized to the longest line.
+    char lines[12][160];
+    uint32_t lineCount = 0;
+    auto line = [&](const char* format, auto... args) {
+        std::snprintf(lines[lineCount++], sizeof(lines[0]), format, args...);
+    };
+
+    const FrameCpuTimings& cpu = previousCpuTimings;
+    line("frame %6.2f ms %6.1f fps   gpu %6.2f ms", lastFrameMs, lastFrameMs > 0.0 ? 1000.0 / lastFrameMs : 0.0,
+        gpuTimer.lastMs(GpuScopeFrame));
+    line("cpu   wait %.2f  acquire %.2f  update %.2f", cpu.wait, cpu.acquire, cpu.update);
+    line("      record %.2f%s  submit %.2f  present %.2f", cpu.record, lastFrameReused ? " (cached)" : "",
+        cpu.submit, cpu.present);
+    if (gpuTimer.supported()) {
+        line("gpu   culling %.2f  prepass %.2f  shading %.2f  particles %.2f",
+            gpuTimer.lastMs(GpuScopeLightCulling), gpuTimer.lastMs(GpuScopeDepthPrepass),
+            gpuTimer.lastMs(GpuScopeShading), gpuTimer.lastMs(GpuScopeParticles));
+    }
+    line("draws %u  triangles %llu", drawCalls,
+        static_cast<unsigned long long>(lodScene ? lodScene->triangleCount() : 0));
+    if (lodScene && depthPyramid) {
+        line("hi-z  cull %.2f  pyramid %.2f ms  %zu/%zu visible", gpuTimer.lastMs(GpuScopeOcclusionCulling),
+            gpuTimer.lastMs(GpuScopeDepthPyramid), lodScene->visibleInstances(), lodScene->instanceCount());
+    }
+    if (lodScene && shadowMap) {
+        line("shadows %.2f ms  %u/%u cascades re-cached", gpuTimer.lastMs(GpuScopeShadows),
+            shadowMap->cascadesRefreshed(), shadowMap->cascadeCount());
+    }
+    if (crowdScene) {
+        line("anim  %.2f ms cpu  %zu characters x %u joints  %u threads", crowdScene->animationMs(),
+            crowdScene->characterCount(), crowdScene->jointCount(), crowdScene->animationThreads());
+    }
+    if (postProcess) {
+        line("post  %.2f ms  %u bloom levels  %s exposure  %s output", gpuTimer.lastMs(GpuScopePostProcess),
+            postProcess->bloomLevels(), postProcess->usesSubgroups() ? "subgroup" : "shared-memory",
+            postProcess->writesSwapchainDirectly() ? "direct" : "blit");
+    }
+    line("%s", device->memory().summary().c_str());
+    if (hostAllocations.siteCount > 0) {
+        const HostSiteFrame& top = hostAllocations.sites[0];
+        line("host  %u allocs  %.1f KiB per frame  most: %s %u", hostAllocations.count,
+            double(hostAllocations.bytes) / 1024.0, top.name, top.count());
+    }
+    else {
+        line("host  0 allocs per frame");
+    }
+    line("overlay cpu %.3f ms  gpu %.3f ms  %u quads", overlayCpuMs, gpuTimer.lastMs(GpuScopeOverlay),
+        overlayQuads);
+
+    size_t longest = 0;
+    for (uint32_t i = 0; i < lineCount; i++) longest = std::max(longest, std::strlen(lines[i]));
+
+    const float pad = OVERLAY_PADDING * k;
+    const float graphWidth = float(FRAME_HISTORY) * k;
+    const float graphHeight = GRAPH_HEIGHT * k;
+    float width = std::max(float(longest) * overlay->charWidth(), graphWidth) + 2.0f * pad;
+    float height = float(lineCount) * overlay->lineHeight() + 2.0f * (graphHeight + overlay->lineHeight()) + 2.0f * pad;
+
+    float x = OVERLAY_MARGIN * k;
+    float y = OVERLAY_MARGIN * k;
+    overlay->rect(x, y, width, height, OVERLAY_BACKGROUND);
+    x += pad;
+    y += pad;
+
+    for (uint32_t i = 0; i < lineCount; i++) {
+        overlay->text(x, y, lines[i], i == 0 ? OVERLAY_TEXT : OVERLAY_LABEL);
+        y += overlay->lineHeight();
+    }
+    drawFrameGraph(x, y, historyCpuMs, "cpu frame time");
+    y += graphHeight + overlay->lineHeight();
+    drawFrameGraph(x, y, historyGpuMs, "gpu frame time");
+    overlayQuads = overlay->quadCount() + overlay->droppedQuads();
+}
+
+void Renderer::drawFrameGraph(float x, float y, const float* samples, const char* label) {
+    const float k = overlay->glyphScale();
+    const float height = GRAPH_HEIGHT * k;
+
+    overlay->text(x, y, label, OVERLAY_LABEL);
+    y += overlay->lineHeight();
+    overlay->rect(x, y, float(FRAME_HISTORY) * k, height, OVERLAY_GRAPH_BACKGROUND);
+
+    for (uint32_t i = 0; i < FRAME_HISTORY; i++) {
+        float ms = samples[(historyNext + i) % FRAME_HISTORY];
+        float barHeight = std::min(ms / GRAPH_MAX_MS, 1.0f) * height;
+        overlay->rect(x + float(i) * k, y + height - barHeight, k, barHeight, frameTimeColor(ms));
+    }
+
+    float targetY = y + height - (TARGET_FRAME_MS / GRAPH_MAX_MS) * height;
+    overlay->rect(x, targetY, float(FRAME_HISTORY) * k, k, OVERLAY_TARGET_LINE);
+}
+
+void Renderer::recreateSwapChain() {
+    // With dynamic rendering this only rebuilds the swapchain images and views;
+    // the legacy path also rebuilds its framebuffers.
+    swapChain->recreateSwapChain(*device, *renderPass, presentPass);
+    if (depthPyramid) {
+        depthPyramid->resize(*swapChain);
+    }
+    if (postProcess) {
+        postProcess->resize(*swapChain);
+    }
+
+    // Every recording names the old images, and the image count may have
+    // changed. The recreation above waited for the device, so none is pending.
+    vkFreeCommandBuffers(device->device(), commandPool, static_cast<uint32_t>(commandBuffers.size()),
+        commandBuffers.data());
+    createCommandBuffers();
+    swapChainRecreated = true;
+}
+
+void Renderer::checkHostAllocations() {
+    hostFrames++;
+    bool exempt = hostFrames <= ZERO_ALLOC_WARMUP_FRAMES || swapChainRecreated;
+    swapChainRecreated = false;
+    if (!settings.zeroAllocFrames || exempt) return;
+
+    uint32_t count = 0;
+    char sites[512] = "";
+    size_t length = 0;
+    for (uint32_t i = 0; i < hostAllocations.siteCount; i++) {
+        const HostSiteFrame& site = hostAllocations.sites[i];
+        if (isDiagnosticSite(site.name)) continue;
+        count += site.count();
+        if (length < sizeof(sites)) {
+            length += std::snprintf(sites + length, sizeof(sites) - length, "%s%s %u (%llu bytes)",
+                length ? ", " : "", site.name, site.count(), static_cast<unsigned long long>(site.bytes()));
+        }
+    }
+    if (count == 0) return;
+    // One message ID for every frame, so the logger's rate limit caps the spam.
+    Logger::global().logf(LogSeverity::Error, "memory", "frame %llu made %u host allocations: %s",
+        static_cast<unsigned long long>(hostFrames - 1), count, sites);
+}
+
 void Renderer::createSyncObjects() {
     imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
     renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
@@ -212,9 +729,9 @@ void Renderer::createSyncObjects() {
     fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        if (vkCreateSemaphore(device->device(), &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS ||
-            vkCreateSemaphore(device->device(), &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS ||
-            vkCreateFence(device->device(), &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS) {
+        if (vkCreateSemaphore(device->device(), &semaphoreInfo, hostAllocator("Renderer"), &imageAvailableSemaphores[i]) != VK_SUCCESS ||
+            vkCreateSemaphore(device->device(), &semaphoreInfo, hostAllocator("Renderer"), &renderFinishedSemaphores[i]) != VK_SUCCESS ||
+            vkCreateFence(device->device(), &fenceInfo, hostAllocator("Renderer"), &inFlightFences[i]) != VK_SUCCESS) {
 
             throw std::runtime_error("failed to create synchronization objects for a frame!");
         }
@@ -223,6 +740,6 @@ void Renderer::createSyncObjects() {
 }
 
 VkCommandBuffer Renderer::getCurrentCommandBuffer() const {
-    return commandBuffers[currentImageIndex];
+    return commandBuffers[commandBufferIndex];
 }
     
\ No newline at end of file
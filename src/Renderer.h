@@ -4,39 +4,229 @@
 #include "SwapChain.h"
 #include "RenderPass.h"
 #include "Pipeline.h"
+#include "GpuTimer.h"
+#include "RenderSettings.h"
+#include "ParticleSystem.h"
+#include "ClusteredLighting.h"
+#include "LodScene.h"
+#include "SpriteScene.h"
+#include "CrowdScene.h"
+#include "DepthPyramid.h"
+#include "CascadedShadowMap.h"
+#include "PostProcess.h"
+#include "Overlay.h"
+#include "Camera.h"
+#include "FrameArena.h"
+#include "FramePacket.h"
+#include "HostMemoryTracker.h"
 
 #include <vulkan/vulkan.h>
 #include <vector>
+#include <chrono>
+#include <functional>
+
+// Push constants shared by overdraw.vert / overdraw.frag.
+struct OverdrawPushConstants {
+    uint32_t layerCount;
+    uint32_t shadingIterations;
+};
+
+// Where the CPU spent the last drawFrame(), in milliseconds.
+struct FrameCpuTimings {
+    double wait = 0.0;      // in-flight fence
+    double acquire = 0.0;   // vkAcquireNextImageKHR
+    double update = 0.0;    // camera, lights, LOD selection, animation
+    double record = 0.0;    // command buffer recording
+    double submit = 0.0;    // vkQueueSubmit
+    double present = 0.0;   // vkQueuePresentKHR plus any swapchain recreation
+};
 
 class Renderer {
 public:
-    void init(Device& device_, SwapChain& swapChain_, RenderPass& renderPass_, Pipeline& pipeline_);
+    // depthPrepassPipeline_ is optional: when set it runs before pipeline_ over the same draws.
+    void init(Device& device_, SwapChain& swapChain_, RenderPass& renderPass_, Pipeline& pipeline_,
+              const RenderSettings& settings_, Pipeline* depthPrepassPipeline_ = nullptr);
     void cleanup();
 
+    // Optional GPU particles: simulated on the compute queue each frame and drawn after the scene.
+    void setParticleSystem(ParticleSystem* particles_) { particles = particles_; }
+    // Required by SceneKind::Lights: bins lights before the pass and feeds the lit shaders.
+    void setLighting(ClusteredLighting* lighting_) { lighting = lighting_; }
+    // Required by SceneKind::Lod.
+    void setLodScene(LodScene* lodScene_) { lodScene = lodScene_; }
+    // Required by SceneKind::Sprites.
+    void setSpriteScene(SpriteScene* spriteScene_) { spriteScene = spriteScene_; }
+    // Required by SceneKind::Crowd.
+    void setCrowdScene(CrowdScene* crowdScene_) { crowdScene = crowdScene_; }
+    // Optional Hi-Z pyramid, rebuilt from the depth attachment after every main pass
+    // and resized with the swapchain. LodScene culls against it when given one too.
+    void setDepthPyramid(DepthPyramid* depthPyramid_) { depthPyramid = depthPyramid_; }
+    // Optional sun shadows for SceneKind::Lod: cascades are rendered before the main
+    // pass from LodScene's casters, and the scene pipeline reads them as set 1.
+    void setShadowMap(CascadedShadowMap* shadowMap_) { shadowMap = shadowMap_; }
+    // Optional post chain: the render pass then draws into the swapchain's HDR target
+    // and postProcess_ writes the swapchain image. The overlay moves to presentPass_
+    // (a RenderPassTarget::Present pass), which draws over the finished image.
+    void setPostProcess(PostProcess* postProcess_, RenderPass* presentPass_) {
+        postProcess = postProcess_;
+        presentPass = presentPass_;
+    }
+    // Performance overlay, drawn last in the main pass on frames whose packet asks for it.
+    void setOverlay(Overlay* overlay_) { overlay = overlay_; }
+    // Called once the swapchain image is acquired, right before the frame's
+    // camera-dependent work is recorded, so view input can be sampled late.
+    // Runs on the render thread.
+    using LateCameraUpdate = std::function<void(const FramePacket&, Camera&)>;
+    void setLateCameraUpdate(LateCameraUpdate update) { lateCameraUpdate = std::move(update); }
+    const Camera& getCamera() const { return camera; }
+
+    static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+
     void createSyncObjects();
     void createCommandPool();
+    // One command buffer per frame slot and swapchain image, all initially empty.
     void createCommandBuffers();
     void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
-    void drawFrame();
+    // Renders one frame from `packet`. Makes no GLFW calls, so it can run on a
+    // render thread while the main thread builds the next packet.
+    void drawFrame(const FramePacket& packet);
+    void recreateSwapChain();
 
     // Declaration of getter
     VkCommandBuffer getCurrentCommandBuffer() const;
-    bool framebufferResized = false;
+    // Scratch memory for the frame being recorded; reclaimed once its fence signals.
+    FrameArena& frameArena() { return frameArenas[currentFrame]; }
+
+    // Timings of the most recent frame, for benchmarks and overlays. GPU time
+    // lags a couple of frames behind (read back once the frame's fence signals).
+    const FrameCpuTimings& lastCpuTimings() const { return cpuTimings; }
+    double lastGpuFrameMs() const { return gpuTimer.lastMs(GpuScopeFrame); }
 
 private:
+    // Everything a recorded command buffer depends on besides its frame slot and
+    // swapchain image (both fixed by which buffer it is). A buffer whose key
+    // still matches is submitted again as is.
+    struct RecordKey {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipeline depthPrepassPipeline = VK_NULL_HANDLE;
+        uint64_t   drawListVersion = 0;   // the scene's, for scenes whose draws vary
+        uint64_t   cameraVersion = 0;     // for scenes that push camera data with their draws
+        uint32_t   overlayQuads = 0;      // 0 when the overlay is not drawn
+
+        bool operator==(const RecordKey& other) const {
+            return pipeline == other.pipeline && depthPrepassPipeline == other.depthPrepassPipeline &&
+                   drawListVersion == other.drawListVersion && cameraVersion == other.cameraVersion &&
+                   overlayQuads == other.overlayQuads;
+        }
+    };
+    // What one of commandBuffers holds.
+    struct RecordedCommands {
+        bool      reusable = false;       // recorded from a complete key
+        RecordKey key;
+        uint32_t  drawCalls = 0;
+        uint32_t  timerScopes = 0;        // GpuTimer scopes it writes
+    };
+
+    // Fills `key` for the frame about to be recorded. Returns false when some
+    // recorded value is recomputed every frame, so the frame cannot be cached.
+    bool buildRecordKey(RecordKey& key) const;
+    // Issues the active scene's draw calls; the caller has bound `boundPipeline`.
+    void recordSceneDraws(VkCommandBuffer commandBuffer, Pipeline& boundPipeline);
+    // Draws the overlay batch inside whichever pass is open.
+    void recordOverlay(VkCommandBuffer commandBuffer);
+    // Accumulates this frame's timings and prints an average every couple of seconds.
+    void updateFrameStats();
+    // Fills the overlay batch for this frame from the latest timings and counters.
+    void buildOverlay();
+    // Runs the --zero-alloc-frames check over hostAllocations.
+    void checkHostAllocations();
+    // Frame-time history graph: `samples` (ms) as bars, newest on the right.
+    void drawFrameGraph(float x, float y, const float* samples, const char* label);
+
     Device* device = nullptr;
     SwapChain* swapChain = nullptr;
     RenderPass* renderPass = nullptr;
     Pipeline* pipeline = nullptr;
+    Pipeline* depthPrepassPipeline = nullptr;
+    ParticleSystem* particles = nullptr;
+    ClusteredLighting* lighting = nullptr;
+    LodScene* lodScene = nullptr;
+    SpriteScene* spriteScene = nullptr;
+    CrowdScene* crowdScene = nullptr;
+    DepthPyramid* depthPyramid = nullptr;
+    CascadedShadowMap* shadowMap = nullptr;
+    PostProcess* postProcess = nullptr;
+    RenderPass* presentPass = nullptr;
+    Overlay* overlay = nullptr;
+    bool overlayVisible = false;       // FramePacket::showOverlay of the frame being recorded
+    RenderSettings settings;
 
     VkCommandPool                   commandPool;
+    // [frame slot * imagesPerFrame + swapchain image]; see createCommandBuffers().
     std::vector<VkCommandBuffer>    commandBuffers;
-    
+    std::vector<RecordedCommands>   recordedCommands;
+    uint32_t imagesPerFrame = 0;
+    uint32_t commandBufferIndex = 0;   // the buffer submitted by the current frame
+    bool     lastFrameReused = false;  // it was submitted without re-recording
+
     uint32_t currentImageIndex = 0;
     uint32_t currentFrame = 0;
-    const int MAX_FRAMES_IN_FLIGHT = 2;
+
+    Camera camera;
+    Mat4     lastViewProjection;
+    uint64_t cameraVersion = 0;        // bumped whenever the view-projection matrix changes
+    LateCameraUpdate lateCameraUpdate;
+    bool framebufferResized = false;   // set from FramePacket::framebufferResized
 
     std::vector<VkSemaphore> imageAvailableSemaphores;
     std::vector<VkSemaphore> renderFinishedSemaphores;
     std::vector<VkFence> inFlightFences;
+    FrameArena frameArenas[MAX_FRAMES_IN_FLIGHT];
+
+    // GPU timestamp scopes recorded every frame.
+    enum GpuScope : uint32_t {
+        GpuScopeFrame,
+        GpuScopeLightCulling,
+        GpuScopeDepthPrepass,
+        GpuScopeShading,
+        GpuScopeParticles,
+        GpuScopeOverlay,
+        GpuScopeOcclusionCulling,
+        GpuScopeDepthPyramid,
+        GpuScopeShadows,
+        GpuScopePostProcess,
+        GpuScopeCount
+    };
+    GpuTimer gpuTimer;
+    FrameCpuTimings cpuTimings;
+    FrameCpuTimings previousCpuTimings;
+
+    // Running totals for the periodic stats line.
+    std::chrono::steady_clock::time_point lastFrameStart{};
+    std::chrono::steady_clock::time_point lastStatsReport{};
+    double   statsCpuMs = 0.0;
+    double   statsGpuMs[GpuScopeCount] = {};
+    uint64_t statsTriangles = 0;
+    uint64_t statsTransforms = 0;
+    double   statsAnimationMs = 0.0;
+    uint32_t statsReusedFrames = 0;
+    uint64_t statsHostAllocations = 0;
+    uint64_t statsHostBytes = 0;
+    uint32_t statsFrames = 0;
+
+    // Overlay inputs: per-frame history for the graphs and the last frame's counters.
+    static constexpr uint32_t FRAME_HISTORY = 240;
+    float    historyCpuMs[FRAME_HISTORY] = {};
+    float    historyGpuMs[FRAME_HISTORY] = {};
+    uint32_t historyNext = 0;            // oldest sample, overwritten next
+    double   lastFrameMs = 0.0;          // frame start to frame start
+    uint32_t drawCalls = 0;              // recorded into the last command buffer
+    double   overlayCpuMs = 0.0;         // building the last overlay batch
+    uint32_t overlayQuads = 0;           // in the last overlay batch
+
+    // Host allocations of the last complete frame (drawFrame start to drawFrame
+    // start, so the main thread's packet building is included), by site.
+    HostFrameAllocations hostAllocations;
+    uint64_t hostFrames = 0;
+    bool     swapChainRecreated = false; // the last frame rebuilt it, so it may allocate
 };
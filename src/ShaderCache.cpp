@@ -0,0 +1,32 @@
+// src/ShaderCache.cpp
+#include "ShaderCache.h"
+#include "Utils.h"       // for readFile()
+
+#include <filesystem>
+
+ShaderCache& ShaderCache::global() {
+    static ShaderCache cache;
+    return cache;
+}
+
+void ShaderCache::preload(const std::string& directory) {
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() != ".spv") continue;
+        // Same spelling as the paths pipelines ask for: "<directory>/<name>.spv".
+        load(directory + "/" + entry.path().filename().string());
+    }
+}
+
+const std::vector<char>& ShaderCache::load(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = files.find(path);
+        if (it != files.end()) return it->second;
+    }
+    // Read without the lock so several threads can hit the disk at once; if two
+    // race on the same file the first insert wins.
+    std::vector<char> code = readFile(path);
+    std::lock_guard<std::mutex> lock(mutex);
+    return files.emplace(path, std::move(code)).first->second;
+}
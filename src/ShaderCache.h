@@ -0,0 +1,28 @@
+// src/ShaderCache.h
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// SPIR-V bytecode by path, shared by Pipeline and ComputePipeline. Startup
+// preloads every shader while the device is still being created, and the init
+// steps that build pipelines wait for that, so they never read the disk; a path
+// that was not preloaded is read on first use. Safe to use from any thread.
+class ShaderCache {
+public:
+    static ShaderCache& global();
+
+    // Reads every .spv file in `directory`. A missing directory is not an
+    // error: load() reports the missing file instead.
+    void preload(const std::string& directory);
+
+    // The file's contents; throws if it cannot be read. Files stay cached for
+    // the life of the process (a few hundred KiB), so the reference stays valid.
+    const std::vector<char>& load(const std::string& path);
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, std::vector<char>> files;   // nodes never move
+};
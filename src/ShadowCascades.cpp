@@ -0,0 +1,73 @@
+// src/ShadowCascades.cpp
+#include "ShadowCascades.h"
+#include "Camera.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Radii are rounded up to this so float noise in the projection cannot resize a cascade.
+    const float RADIUS_QUANTUM = 1.0f / 16.0f;
+
+    int32_t snapToStep(float value, float step) {
+        return int32_t(std::floor(value / step + 0.5f));
+    }
+}
+
+void fitShadowCascades(const Camera& camera, const Vec3& towardsLight, const ShadowCascadeSettings& settings,
+                       ShadowCascade* cascades)
+{
+    // The light's rotation is fixed; only the translation of each cascade follows the camera.
+    Vec3 toLight = normalize(towardsLight);
+    Vec3 up = std::fabs(toLight.y) > 0.99f ? Vec3{ 0.0f, 0.0f, 1.0f } : Vec3{ 0.0f, 1.0f, 0.0f };
+    Mat4 lightView = Mat4::lookAt(Vec3{ 0.0f, 0.0f, 0.0f }, -toLight, up);
+
+    // Squared tangent of the angle between the view axis and a frustum corner.
+    float tanY = std::tan(camera.fovY() * 0.5f);
+    float tanX = tanY * camera.aspect();
+    float cornerSlope2 = tanX * tanX + tanY * tanY;
+
+    float nearDistance = camera.nearPlane();
+    float farDistance = std::min(settings.maxDistance, camera.farPlane());
+    float resolution = float(settings.resolution);
+    float snapFraction = float(settings.snapTexels) / resolution;
+
+    float sliceNear = nearDistance;
+    for (uint32_t c = 0; c < settings.cascadeCount; c++) {
+        float p = float(c + 1) / float(settings.cascadeCount);
+        float logSplit = nearDistance * std::pow(farDistance / nearDistance, p);
+        float uniformSplit = nearDistance + (farDistance - nearDistance) * p;
+        float sliceFar = settings.splitLambda * logSplit + (1.0f - settings.splitLambda) * uniformSplit;
+
+        // Smallest sphere through the slice's near and far corners, centred on the view axis.
+        float centerDistance = std::min(0.5f * (sliceNear + sliceFar) * (1.0f + cornerSlope2), sliceFar);
+        float radius = std::max(
+            std::sqrt((centerDistance - sliceNear) * (centerDistance - sliceNear) + sliceNear * sliceNear * cornerSlope2),
+            std::sqrt((sliceFar - centerDistance) * (sliceFar - centerDistance) + sliceFar * sliceFar * cornerSlope2));
+        radius = std::ceil(radius / RADIUS_QUANTUM) * RADIUS_QUANTUM;
+
+        // Snapping moves the centre by up to half a step; widen the cascade so the
+        // sphere still fits: halfExtent = radius + step / 2, step = snapFraction * 2 * halfExtent.
+        float halfExtent = radius / (1.0f - snapFraction);
+        float step = 2.0f * halfExtent * snapFraction;
+
+        ShadowCascade& cascade = cascades[c];
+        Vec3 center = transformPoint(lightView, camera.position() + camera.forward() * centerDistance);
+        cascade.cell[0] = snapToStep(center.x, step);
+        cascade.cell[1] = snapToStep(center.y, step);
+        cascade.cell[2] = snapToStep(center.z, step);
+        cascade.halfExtent = halfExtent;
+
+        float x = float(cascade.cell[0]) * step;
+        float y = float(cascade.cell[1]) * step;
+        float z = float(cascade.cell[2]) * step;
+        // Light space looks down -Z from the light: near is the side facing it.
+        Mat4 projection = Mat4::orthographic(x - halfExtent, x + halfExtent, y - halfExtent, y + halfExtent,
+            -(z + halfExtent + settings.casterMargin), -(z - halfExtent));
+        cascade.viewProjection = projection * lightView;
+        cascade.splitFar = sliceFar;
+        cascade.texelSize = 2.0f * halfExtent / resolution;
+
+        sliceNear = sliceFar;
+    }
+}
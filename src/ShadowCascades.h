@@ -0,0 +1,47 @@
+// src/ShadowCascades.h
+#pragma once
+
+#include <cstdint>
+
+#include "Math.h"
+
+class Camera;
+
+struct ShadowCascadeSettings {
+    uint32_t cascadeCount = 4;       // at most CascadedShadowMap::MAX_CASCADES
+    uint32_t resolution = 2048;      // texels per side of every cascade
+    float    maxDistance = 150.0f;   // view distance where the last cascade ends
+    float    splitLambda = 0.75f;    // 0 = uniform splits, 1 = logarithmic
+    float    casterMargin = 80.0f;   // extra depth towards the light for casters outside the view
+    // Placement step in texels. Cascades only move in whole steps, so a cached
+    // layer stays valid until the camera has travelled that far; the cascade is
+    // widened by the same amount so the view slice always fits.
+    uint32_t snapTexels = 64;
+};
+
+// One cascade of a directional light's shadow map.
+struct ShadowCascade {
+    Mat4  viewProjection = Mat4::identity();   // world -> cascade clip space
+    float splitFar = 0.0f;     // view depth where the cascade ends
+    float texelSize = 0.0f;    // world units per texel
+
+    // Placement in light space, in snap steps. Two fits with the same light
+    // direction and equal placement have the same viewProjection, bit for bit.
+    int32_t cell[3] = {};
+    float   halfExtent = 0.0f;
+};
+
+inline bool samePlacement(const ShadowCascade& a, const ShadowCascade& b) {
+    return a.cell[0] == b.cell[0] && a.cell[1] == b.cell[1] && a.cell[2] == b.cell[2] &&
+           a.halfExtent == b.halfExtent;
+}
+
+// Fits settings.cascadeCount cascades to consecutive depth slices of `camera`.
+//
+// Each slice is bounded by a sphere whose radius depends only on the slice and
+// the projection, never on where the camera looks, so cascades keep their size
+// (and their texel size) while the camera turns. The sphere's centre is snapped
+// to whole steps of the light-space grid, so shadow edges do not shimmer when
+// the camera moves and a cascade's matrix only changes when it crosses a step.
+void fitShadowCascades(const Camera& camera, const Vec3& towardsLight, const ShadowCascadeSettings& settings,
+                       ShadowCascade* cascades);
@@ -0,0 +1,43 @@
+// src/SpriteBatcher.cpp
+#include "SpriteBatcher.h"
+#include "RadixSort.h"
+
+#include <algorithm>
+
+void SpriteBatcher::begin() {
+    instances.clear();
+    keys.clear();
+    order.clear();
+    drawRuns.clear();
+}
+
+void SpriteBatcher::draw(const Sprite& sprite) {
+    uint32_t index = uint32_t(instances.size());
+    instances.push_back(SpriteInstance{
+        { sprite.x, sprite.y },
+        { 0.5f * sprite.width, 0.5f * sprite.height },
+        { sprite.uv[0], sprite.uv[1], sprite.uv[2], sprite.uv[3] },
+        sprite.rotation,
+        sprite.color });
+    keys.push_back(uint32_t(sprite.layer) << 16 | sprite.texture);
+    order.push_back(index);
+}
+
+size_t SpriteBatcher::finish(SpriteInstance* out, size_t capacity) {
+    size_t count = keys.size();
+    keyScratch.resize(count);
+    orderScratch.resize(count);
+    RadixSortResult sorted = radixSortPairs(keys.data(), order.data(), keyScratch.data(), orderScratch.data(), count);
+
+    count = std::min(count, capacity);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = instances[sorted.values[i]];
+
+        uint32_t texture = sorted.keys[i] & 0xFFFF;
+        if (drawRuns.empty() || drawRuns.back().texture != texture) {
+            drawRuns.push_back(SpriteDrawRun{ texture, uint32_t(i), 0 });
+        }
+        drawRuns.back().instanceCount++;
+    }
+    return count;
+}
@@ -0,0 +1,63 @@
+// src/SpriteBatcher.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One textured, tinted quad in framebuffer pixels (origin top-left).
+struct Sprite {
+    float    x = 0.0f, y = 0.0f;              // center
+    float    width = 0.0f, height = 0.0f;
+    float    rotation = 0.0f;                 // radians, clockwise on screen
+    float    uv[4] = { 0.0f, 0.0f, 1.0f, 1.0f };   // u0, v0, u1, v1
+    uint32_t color = 0xFFFFFFFF;              // RGBA8, R in the low byte
+    uint16_t texture = 0;                     // SpriteRenderer texture id
+    uint16_t layer = 0;                       // lower layers are drawn first
+};
+
+// Per-instance vertex data; must match the inputs of sprite.vert.
+struct SpriteInstance {
+    float    center[2];
+    float    halfSize[2];
+    float    uvRect[4];
+    float    rotation;
+    uint32_t color;
+};
+
+// Consecutive instances sharing a texture: one instanced draw.
+struct SpriteDrawRun {
+    uint32_t texture;
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+};
+
+// CPU half of the sprite renderer, free of Vulkan so it can be benchmarked alone.
+//
+// draw() only appends the instance and a (layer, texture) sort key. finish()
+// radix-sorts the keys (stable, so submission order holds within a layer and
+// texture), gathers the instances in that order into the caller's buffer, which
+// is normally persistently mapped GPU memory written front to back, and splits
+// the result into runs wherever the texture changes. A frame of N sprites on T
+// textures therefore costs about T * layers draws at most, often far fewer.
+// Storage is reused between frames, so steady-state batching never allocates.
+class SpriteBatcher {
+public:
+    void begin();
+    void draw(const Sprite& sprite);
+
+    // Writes at most `capacity` sorted instances to `out` and returns how many;
+    // sprites past the capacity (from the top layers) are dropped.
+    size_t finish(SpriteInstance* out, size_t capacity);
+
+    size_t submitted() const { return keys.size(); }
+    const std::vector<SpriteDrawRun>& runs() const { return drawRuns; }
+
+private:
+    std::vector<SpriteInstance> instances;   // submission order
+    std::vector<uint32_t> keys;              // layer << 16 | texture
+    std::vector<uint32_t> order;             // instance index per key
+    std::vector<uint32_t> keyScratch;
+    std::vector<uint32_t> orderScratch;
+    std::vector<SpriteDrawRun> drawRuns;
+};
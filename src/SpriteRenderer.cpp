@@ -0,0 +1,193 @@
+// src/SpriteRenderer.cpp
+#include "SpriteRenderer.h"
+#include "HostMemoryTracker.h"
+#include "Device.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+namespace {
+    const uint32_t VERTICES_PER_SPRITE = 6;
+
+    // Matches the push constant block in sprite.vert: pixels -> clip space.
+    struct SpritePushConstants {
+        float scale[2];
+        float offset[2];
+    };
+    static_assert(sizeof(SpritePushConstants) == SpriteRenderer::pushConstantSize, "sprite push constant size mismatch");
+}
+
+void SpriteRenderer::init(Device& device_, uint32_t maxSprites_, uint32_t framesInFlight) {
+    device = &device_;
+    maxSprites = maxSprites_;
+
+    createDescriptors();
+    createRing(framesInFlight);
+    frameRuns.resize(framesInFlight);
+
+    const uint8_t white[4] = { 255, 255, 255, 255 };
+    createTexture(white, 1, 1);
+}
+
+void SpriteRenderer::cleanup() {
+    VkDevice dev = device->device();
+
+    for (Texture& texture : textures) {
+        vkDestroyImageView(dev, texture.view, hostAllocator("SpriteRenderer"));
+        vkDestroyImage(dev, texture.image, hostAllocator("SpriteRenderer"));
+        device->freeMemory(texture.memory);
+    }
+    textures.clear();
+
+    vkDestroyDescriptorPool(dev, descriptorPool, hostAllocator("SpriteRenderer"));
+    vkDestroyDescriptorSetLayout(dev, descriptorSetLayout, hostAllocator("SpriteRenderer"));
+    vkDestroySampler(dev, sampler, hostAllocator("SpriteRenderer"));
+
+    vkUnmapMemory(dev, ringMemory);
+    vkDestroyBuffer(dev, ringBuffer, hostAllocator("SpriteRenderer"));
+    device->freeMemory(ringMemory);
+    ringMapped = nullptr;
+}
+
+void SpriteRenderer::createDescriptors() {
+    VkDevice dev = device->device();
+
+    VkSamplerCreateInfo samplerInfo{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    if (vkCreateSampler(dev, &samplerInfo, hostAllocator("SpriteRenderer"), &sampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create sprite sampler!");
+    }
+
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+    if (vkCreateDescriptorSetLayout(dev, &layoutInfo, hostAllocator("SpriteRenderer"), &descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create sprite descriptor set layout!");
+    }
+
+    // One set per texture, written once when the texture is created.
+    VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_TEXTURES };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = MAX_TEXTURES;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(dev, &poolInfo, hostAllocator("SpriteRenderer"), &descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create sprite descriptor pool!");
+    }
+}
+
+void SpriteRenderer::createRing(uint32_t framesInFlight) {
+    VkDeviceSize bytes = VkDeviceSize(maxSprites) * framesInFlight * sizeof(SpriteInstance);
+    device->createBuffer(bytes, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        ringBuffer, ringMemory);
+
+    void* mapped = nullptr;
+    vkMapMemory(device->device(), ringMemory, 0, VK_WHOLE_SIZE, 0, &mapped);
+    ringMapped = static_cast<SpriteInstance*>(mapped);
+}
+
+uint16_t SpriteRenderer::createTexture(const uint8_t* rgba, uint32_t width, uint32_t height) {
+    if (textures.size() >= MAX_TEXTURES) {
+        throw std::runtime_error("too many sprite textures!");
+    }
+
+    Texture texture;
+    device->createDeviceLocalImage(rgba, VkDeviceSize(width) * height * 4, width, height,
+        VK_FORMAT_R8G8B8A8_UNORM, texture.image, texture.memory);
+    texture.view = device->createImageView(texture.image, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT);
+
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &descriptorSetLayout;
+    if (vkAllocateDescriptorSets(device->device(), &allocInfo, &texture.set) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate sprite descriptor set!");
+    }
+
+    VkDescriptorImageInfo imageInfo{ sampler, texture.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    write.dstSet = texture.set;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(device->device(), 1, &write, 0, nullptr);
+
+    textures.push_back(texture);
+    return uint16_t(textures.size() - 1);
+}
+
+std::vector<VkVertexInputBindingDescription> SpriteRenderer::vertexBindings() {
+    return { { 0, sizeof(SpriteInstance), VK_VERTEX_INPUT_RATE_INSTANCE } };
+}
+
+std::vector<VkVertexInputAttributeDescription> SpriteRenderer::vertexAttributes() {
+    return {
+        { 0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(SpriteInstance, center) },
+        { 1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(SpriteInstance, halfSize) },
+        { 2, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(SpriteInstance, uvRect) },
+        { 3, 0, VK_FORMAT_R32_SFLOAT, offsetof(SpriteInstance, rotation) },
+        { 4, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(SpriteInstance, color) },
+    };
+}
+
+//-------------------------------------------------------------------------
+// Per frame
+//-------------------------------------------------------------------------
+
+void SpriteRenderer::begin(uint32_t) {
+    batcher.begin();
+}
+
+void SpriteRenderer::end(uint32_t frame) {
+    SpriteInstance* region = ringMapped + size_t(frame) * maxSprites;
+    written = batcher.finish(region, maxSprites);
+    dropped = batcher.submitted() - written;
+
+    const std::vector<SpriteDrawRun>& runs = batcher.runs();
+    std::vector<SpriteDrawRun>& previous = frameRuns[frame];
+    bool same = runs.size() == previous.size() &&
+        std::equal(runs.begin(), runs.end(), previous.begin(), [](const SpriteDrawRun& a, const SpriteDrawRun& b) {
+            return a.texture == b.texture && a.firstInstance == b.firstInstance && a.instanceCount == b.instanceCount;
+        });
+    if (!same) {
+        previous = runs;
+        runsVersion++;
+    }
+}
+
+uint32_t SpriteRenderer::recordDraws(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frame,
+                                     VkExtent2D extent)
+{
+    const std::vector<SpriteDrawRun>& runs = frameRuns[frame];
+    if (runs.empty()) return 0;
+
+    SpritePushConstants push{ { 2.0f / float(extent.width), 2.0f / float(extent.height) }, { -1.0f, -1.0f } };
+    vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        0, sizeof(push), &push);
+
+    // firstInstance indexes into this frame's region, so one bind covers every run.
+    VkDeviceSize offset = VkDeviceSize(frame) * maxSprites * sizeof(SpriteInstance);
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &ringBuffer, &offset);
+
+    for (const SpriteDrawRun& run : runs) {
+        uint32_t texture = run.texture < textures.size() ? run.texture : 0;
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+            0, 1, &textures[texture].set, 0, nullptr);
+        vkCmdDraw(commandBuffer, VERTICES_PER_SPRITE, run.instanceCount, 0, run.firstInstance);
+    }
+    return uint32_t(runs.size());
+}
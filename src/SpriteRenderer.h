@@ -0,0 +1,80 @@
+// src/SpriteRenderer.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+#include "SpriteBatcher.h"
+
+class Device;
+
+// GPU half of the 2D sprite path: textures, the per-frame instance ring and
+// the draw calls. Each frame: begin(frame), batch().draw() any number of
+// sprites, then end(frame) sorts them into this frame slot's region of the
+// persistently mapped instance buffer. recordDraws() issues one instanced
+// vkCmdDraw per texture run; the bound pipeline is built from setLayout(),
+// vertexBindings(), vertexAttributes() and pushConstantSize, as for LodScene.
+// Quad corners come from gl_VertexIndex, so the instances are the only vertex data.
+class SpriteRenderer {
+public:
+    static constexpr uint32_t MAX_TEXTURES = 64;
+
+    void init(Device& device, uint32_t maxSprites, uint32_t framesInFlight);
+    void cleanup();
+
+    // RGBA8 texture, returns its id for Sprite::texture. Id 0 is a 1x1 white
+    // texture created by init(), for untextured (color-only) sprites.
+    uint16_t createTexture(const uint8_t* rgba, uint32_t width, uint32_t height);
+
+    VkDescriptorSetLayout setLayout() const { return descriptorSetLayout; }
+    static std::vector<VkVertexInputBindingDescription>   vertexBindings();
+    static std::vector<VkVertexInputAttributeDescription> vertexAttributes();
+    // Bytes of push constants sprite.vert expects (pixel -> clip transform).
+    static constexpr uint32_t pushConstantSize = 16;
+
+    void begin(uint32_t frame);
+    SpriteBatcher& batch() { return batcher; }
+    void end(uint32_t frame);
+
+    // Returns the number of draw calls recorded.
+    uint32_t recordDraws(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frame, VkExtent2D extent);
+    // Bumped by end() whenever a frame slot's runs differ from the ones it had
+    // before, i.e. when recordDraws() would record something different. Sprites
+    // that only move keep it unchanged: their instances live in the ring buffer.
+    uint64_t drawListVersion() const { return runsVersion; }
+
+    // Sprites written by the last end(), and those dropped for lack of space.
+    size_t spriteCount() const { return written; }
+    size_t droppedCount() const { return dropped; }
+
+private:
+    struct Texture {
+        VkImage         image = VK_NULL_HANDLE;
+        VkDeviceMemory  memory = VK_NULL_HANDLE;
+        VkImageView     view = VK_NULL_HANDLE;
+        VkDescriptorSet set = VK_NULL_HANDLE;
+    };
+
+    void createDescriptors();
+    void createRing(uint32_t framesInFlight);
+
+    Device* device = nullptr;
+    uint32_t maxSprites = 0;
+
+    VkSampler             sampler = VK_NULL_HANDLE;
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool      descriptorPool = VK_NULL_HANDLE;
+    std::vector<Texture>  textures;
+
+    // maxSprites instances per frame in flight, persistently mapped.
+    VkBuffer        ringBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory  ringMemory = VK_NULL_HANDLE;
+    SpriteInstance* ringMapped = nullptr;
+
+    SpriteBatcher batcher;
+    std::vector<std::vector<SpriteDrawRun>> frameRuns;   // per frame slot, from end()
+    uint64_t runsVersion = 0;
+    size_t written = 0;
+    size_t dropped = 0;
+};
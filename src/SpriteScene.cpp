@@ -0,0 +1,97 @@
+// src/SpriteScene.cpp
+#include "SpriteScene.h"
+
+#include <cmath>
+#include <random>
+
+namespace {
+    const uint32_t TEXTURE_SIZE = 32;
+    const uint16_t LAYERS = 4;
+
+    // Procedural RGBA8 shapes; `shape` picks checker, disc, ring or diamond.
+    std::vector<uint8_t> makeShape(uint32_t shape) {
+        std::vector<uint8_t> pixels(TEXTURE_SIZE * TEXTURE_SIZE * 4);
+        const float half = TEXTURE_SIZE * 0.5f;
+        for (uint32_t y = 0; y < TEXTURE_SIZE; y++) {
+            for (uint32_t x = 0; x < TEXTURE_SIZE; x++) {
+                float dx = (float(x) + 0.5f - half) / half;
+                float dy = (float(y) + 0.5f - half) / half;
+                float r = std::sqrt(dx * dx + dy * dy);
+                bool inside = false;
+                uint8_t shade = 255;
+                switch (shape) {
+                case 0: inside = true; shade = ((x / 8 + y / 8) & 1) ? 255 : 96; break;
+                case 1: inside = r <= 1.0f; shade = uint8_t(255.0f - 120.0f * r); break;
+                case 2: inside = r <= 1.0f && r >= 0.6f; break;
+                default: inside = std::fabs(dx) + std::fabs(dy) <= 1.0f; break;
+                }
+                uint8_t* p = &pixels[(y * TEXTURE_SIZE + x) * 4];
+                p[0] = p[1] = p[2] = shade;
+                p[3] = inside ? 255 : 0;
+            }
+        }
+        return pixels;
+    }
+
+    // Wraps v into [lo, lo + range).
+    float wrap(float v, float lo, float range) {
+        float t = std::fmod(v - lo, range);
+        return (t < 0.0f ? t + range : t) + lo;
+    }
+}
+
+void SpriteScene::init(Device& device, uint32_t spriteCount, uint32_t framesInFlight) {
+    sprites.init(device, spriteCount, framesInFlight);
+    createTextures();
+
+    std::mt19937 rng(4242);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    movers.resize(spriteCount);
+    for (Mover& m : movers) {
+        m.x = unit(rng);
+        m.y = unit(rng);
+        m.vx = (unit(rng) - 0.5f) * 0.2f;
+        m.vy = (unit(rng) - 0.5f) * 0.2f;
+        m.size = 4.0f + unit(rng) * 12.0f;
+        m.spin = (unit(rng) - 0.5f) * 6.0f;
+        m.color = uint32_t(64 + rng() % 192) | (uint32_t(64 + rng() % 192) << 8) |
+                  (uint32_t(64 + rng() % 192) << 16) | (uint32_t(160 + rng() % 96) << 24);
+        // Index 0 of `textures` is the renderer's white texture: plain tinted quads.
+        m.texture = textures[rng() % textures.size()];
+        m.layer = uint16_t(rng() % LAYERS);
+    }
+}
+
+void SpriteScene::cleanup() {
+    sprites.cleanup();
+    textures.clear();
+    movers.clear();
+}
+
+void SpriteScene::createTextures() {
+    textures.push_back(0);
+    for (uint32_t shape = 0; shape < 4; shape++) {
+        std::vector<uint8_t> pixels = makeShape(shape);
+        textures.push_back(sprites.createTexture(pixels.data(), TEXTURE_SIZE, TEXTURE_SIZE));
+    }
+}
+
+void SpriteScene::update(uint32_t frame, VkExtent2D extent, float time) {
+    const float w = float(extent.width);
+    const float h = float(extent.height);
+
+    sprites.begin(frame);
+    SpriteBatcher& batch = sprites.batch();
+    Sprite sprite;
+    for (const Mover& m : movers) {
+        sprite.x = wrap((m.x + m.vx * time) * w, -m.size, w + 2.0f * m.size);
+        sprite.y = wrap((m.y + m.vy * time) * h, -m.size, h + 2.0f * m.size);
+        sprite.width = sprite.height = m.size;
+        sprite.rotation = m.spin * time;
+        sprite.color = m.color;
+        sprite.texture = m.texture;
+        sprite.layer = m.layer;
+        batch.draw(sprite);
+    }
+    sprites.end(frame);
+}
@@ -0,0 +1,55 @@
+// src/SpriteScene.h
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+#include "SpriteRenderer.h"
+
+class Device;
+
+// 2D stress scene for the sprite batcher: a swarm of spinning, tinted sprites
+// on a handful of procedural textures and four layers, submitted in shuffled
+// texture order every frame so the batcher has real sorting work to do.
+// Positions are a function of time only, so the scene needs no per-sprite state
+// besides its seed parameters and stays deterministic for benchmarks.
+class SpriteScene {
+public:
+    void init(Device& device, uint32_t spriteCount, uint32_t framesInFlight);
+    void cleanup();
+
+    VkDescriptorSetLayout setLayout() const { return sprites.setLayout(); }
+    static std::vector<VkVertexInputBindingDescription>   vertexBindings() { return SpriteRenderer::vertexBindings(); }
+    static std::vector<VkVertexInputAttributeDescription> vertexAttributes() { return SpriteRenderer::vertexAttributes(); }
+    static constexpr uint32_t pushConstantSize = SpriteRenderer::pushConstantSize;
+
+    // Submits and batches every sprite into this frame slot's instance buffer.
+    void update(uint32_t frame, VkExtent2D extent, float time);
+
+    // Returns the number of draw calls recorded.
+    uint32_t recordDraws(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frame, VkExtent2D extent) {
+        return sprites.recordDraws(commandBuffer, layout, frame, extent);
+    }
+    uint64_t drawListVersion() const { return sprites.drawListVersion(); }
+
+    size_t spriteCount() const { return sprites.spriteCount(); }
+
+private:
+    // Seed parameters of one sprite, in units of the framebuffer size.
+    struct Mover {
+        float    x, y;            // start position
+        float    vx, vy;          // velocity per second
+        float    size;            // pixels
+        float    spin;            // radians per second
+        uint32_t color;
+        uint16_t texture;
+        uint16_t layer;
+    };
+
+    void createTextures();
+
+    SpriteRenderer        sprites;
+    std::vector<uint16_t> textures;
+    std::vector<Mover>    movers;
+};
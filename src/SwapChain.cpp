@@ -1,35 +1,67 @@
 // src/SwapChain.cpp
 #include "SwapChain.h"
+#include "HostMemoryTracker.h"
 #include "RenderPass.h"
 #include "Device.h"            // for Device::instance(), Device::device(), Device::physicalDevice()
 #include <stdexcept>
 #include <algorithm>           // for std::clamp
 #include <limits>              // for numeric_limits
 
-void SwapChain::init(Device& dev, GLFWwindow* win) {
+void SwapChain::init(Device& dev, GLFWwindow* win, VkSampleCountFlagBits samples) {
     device = &dev;
     window = win;
+    sampleCount = samples;
+
+    // Headless callers set the extent up front with setFramebufferExtent().
+    if (window) {
+        int width = 0, height = 0;
+        glfwGetFramebufferSize(window, &width, &height);
+        framebufferExtent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+    }
 
     createSwapChain();
     createImageViews();
+    createColorResources();
+    createHdrResources();
+    createDepthResources();
 
     // build those VkFramebuffer objects now that we have a renderPass
 }
 
 void SwapChain::cleanup() {
+    destroyAttachments();
+
     for (auto view : imageViews) {
-        vkDestroyImageView(device->device(), view, nullptr);
+        vkDestroyImageView(device->device(), view, hostAllocator("SwapChain"));
     }
-    for (auto framebuffer : swapChainFramebuffers) {
-        vkDestroyFramebuffer(device->device(), framebuffer, nullptr);
-    }
-    vkDestroySwapchainKHR(device->device(), swapChain, nullptr);
+    cleanupFramebuffers(*device);
+    vkDestroySwapchainKHR(device->device(), swapChain, hostAllocator("SwapChain"));
 }
 
 void SwapChain::createSwapChain() {
-    auto support = querySwapChainSupport(device->physicalDevice(), device->surface());
+    const SwapChainSupportDetails& support = device->swapChainSupport();
 
     VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(support.formats);
+    VkImageUsageFlags  usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+    // Post-processing writes the final image from a compute shader when it can,
+    // and otherwise blits it from a storage image of its own.
+    storageTarget = false;
+    if (hdrTarget) {
+        VkSurfaceFormatKHR storageFormat = chooseStorageSurfaceFormat(support.formats);
+        if ((support.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) &&
+            storageFormat.format != VK_FORMAT_UNDEFINED) {
+            surfaceFormat = storageFormat;
+            usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+            storageTarget = true;
+        }
+        else if (support.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) {
+            usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
+        else {
+            throw std::runtime_error("swapchain images can be neither stored to nor blitted to!");
+        }
+    }
     VkPresentModeKHR   presentMode = chooseSwapPresentMode(support.presentModes);
     VkExtent2D         ext = chooseSwapExtent(support.capabilities);
 
@@ -46,9 +78,9 @@ void SwapChain::createSwapChain() {
     ci.imageColorSpace = surfaceFormat.colorSpace;
     ci.imageExtent = ext;
     ci.imageArrayLayers = 1;
-    ci.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    ci.imageUsage = usage;
 
-    auto indices = device->findQueueFamilies(device->physicalDevice());
+    const auto& indices = device->queueFamilies();
     uint32_t families[] = {
         indices.graphicsFamily.value(),
         indices.presentFamily.value()
@@ -68,7 +100,7 @@ void SwapChain::createSwapChain() {
     ci.clipped = VK_TRUE;
     ci.oldSwapchain = VK_NULL_HANDLE;
 
-    if (vkCreateSwapchainKHR(device->device(), &ci, nullptr, &swapChain) != VK_SUCCESS) {
+    if (vkCreateSwapchainKHR(device->device(), &ci, hostAllocator("SwapChain"), &swapChain) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create swap chain!");
     }
 
@@ -99,34 +131,77 @@ void SwapChain::createImageViews() {
         ivci.subresourceRange.baseArrayLayer = 0;
         ivci.subresourceRange.layerCount = 1;
 
-        if (vkCreateImageView(device->device(), &ivci, nullptr, &imageViews[i]) != VK_SUCCESS) {
+        if (vkCreateImageView(device->device(), &ivci, hostAllocator("SwapChain"), &imageViews[i]) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create image view!");
         }
     }
 }
 
-SwapChainSupportDetails SwapChain::querySwapChainSupport(VkPhysicalDevice physDev, VkSurfaceKHR surface) {
-    SwapChainSupportDetails details;
+// Render targets that never leave the render pass (the MSAA color target is
+// resolved in-pass, depth is discarded) are created TRANSIENT and prefer lazily
+// allocated memory, so tilers never back them with real memory or bandwidth.
+static const VkMemoryPropertyFlags TRANSIENT_ATTACHMENT_MEMORY =
+    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
 
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physDev, surface, &details.capabilities);
+void SwapChain::createColorResources() {
+    if (sampleCount == VK_SAMPLE_COUNT_1_BIT) return;
 
-    uint32_t formatCount = 0;
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physDev, surface, &formatCount, nullptr);
-    if (formatCount > 0) {
-        details.formats.resize(formatCount);
-        vkGetPhysicalDeviceSurfaceFormatsKHR(
-            physDev, surface, &formatCount, details.formats.data());
-    }
+    device->createImage(swapChainExtent.width, swapChainExtent.height, getSceneFormat(),
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+        TRANSIENT_ATTACHMENT_MEMORY, colorImage, colorImageMemory, sampleCount,
+        GpuMemoryCategory::RenderTarget);
+    colorImageView = device->createImageView(colorImage, getSceneFormat(), VK_IMAGE_ASPECT_COLOR_BIT);
+}
 
-    uint32_t presentCount = 0;
-    vkGetPhysicalDeviceSurfacePresentModesKHR(physDev, surface, &presentCount, nullptr);
-    if (presentCount > 0) {
-        details.presentModes.resize(presentCount);
-        vkGetPhysicalDeviceSurfacePresentModesKHR(
-            physDev, surface, &presentCount, details.presentModes.data());
-    }
+void SwapChain::createHdrResources() {
+    if (!hdrTarget) return;
+
+    // Single-sampled (the MSAA target resolves into it) and read by the post chain,
+    // so unlike the attachments above it has to be real memory.
+    device->createImage(swapChainExtent.width, swapChainExtent.height, HDR_FORMAT,
+        VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, hdrImage, hdrImageMemory, VK_SAMPLE_COUNT_1_BIT,
+        GpuMemoryCategory::RenderTarget);
+    hdrImageView = device->createImageView(hdrImage, HDR_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT);
+}
+
+void SwapChain::createDepthResources() {
+    depthFormat = device->findDepthFormat();
 
-    return details;
+    // Depth is cleared every frame and, unless the depth pyramid reads it after the
+    // pass, never read back, so its contents need not survive the pass.
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    usage |= depthSampled ? VK_IMAGE_USAGE_SAMPLED_BIT : VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    device->createImage(swapChainExtent.width, swapChainExtent.height, depthFormat,
+        VK_IMAGE_TILING_OPTIMAL, usage,
+        depthSampled ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : TRANSIENT_ATTACHMENT_MEMORY,
+        depthImage, depthImageMemory, sampleCount, GpuMemoryCategory::RenderTarget);
+    depthImageView = device->createImageView(depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
+}
+
+void SwapChain::destroyAttachments() {
+    // vkDestroy* and freeMemory ignore VK_NULL_HANDLE, so 1x MSAA needs no special case.
+    vkDestroyImageView(device->device(), colorImageView, hostAllocator("SwapChain"));
+    vkDestroyImage(device->device(), colorImage, hostAllocator("SwapChain"));
+    device->freeMemory(colorImageMemory);
+    colorImageView = VK_NULL_HANDLE;
+    colorImage = VK_NULL_HANDLE;
+    colorImageMemory = VK_NULL_HANDLE;
+
+    vkDestroyImageView(device->device(), hdrImageView, hostAllocator("SwapChain"));
+    vkDestroyImage(device->device(), hdrImage, hostAllocator("SwapChain"));
+    device->freeMemory(hdrImageMemory);
+    hdrImageView = VK_NULL_HANDLE;
+    hdrImage = VK_NULL_HANDLE;
+    hdrImageMemory = VK_NULL_HANDLE;
+
+    vkDestroyImageView(device->device(), depthImageView, hostAllocator("SwapChain"));
+    vkDestroyImage(device->device(), depthImage, hostAllocator("SwapChain"));
+    device->freeMemory(depthImageMemory);
+    depthImageView = VK_NULL_HANDLE;
+    depthImage = VK_NULL_HANDLE;
+    depthImageMemory = VK_NULL_HANDLE;
 }
 
 VkSurfaceFormatKHR SwapChain::chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& avail) {
@@ -139,6 +214,22 @@ VkSurfaceFormatKHR SwapChain::chooseSwapSurfaceFormat(const std::vector<VkSurfac
     return avail[0];
 }
 
+VkSurfaceFormatKHR SwapChain::chooseStorageSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& avail) {
+    // The post chain writes BGRA and RGBA alike through an image declared without a format.
+    if (device->capabilities().storageImageWriteWithoutFormat) {
+        for (auto const& fmt : avail) {
+            if ((fmt.format != VK_FORMAT_B8G8R8A8_UNORM && fmt.format != VK_FORMAT_R8G8B8A8_UNORM) ||
+                fmt.colorSpace != VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
+                continue;
+            }
+            VkFormatProperties props;
+            vkGetPhysicalDeviceFormatProperties(device->physicalDevice(), fmt.format, &props);
+            if (props.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) return fmt;
+        }
+    }
+    return { VK_FORMAT_UNDEFINED, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+}
+
 VkPresentModeKHR SwapChain::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& avail) {
     for (auto mode : avail) {
         if (mode == VK_PRESENT_MODE_MAILBOX_KHR) return mode;
@@ -151,12 +242,7 @@ VkExtent2D SwapChain::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& caps) {
         return caps.currentExtent;
     }
     else {
-        int w, h;
-        glfwGetFramebufferSize(window, &w, &h);
-        VkExtent2D actual = {
-            static_cast<uint32_t>(w),
-            static_cast<uint32_t>(h)
-        };
+        VkExtent2D actual = framebufferExtent;
         actual.width = std::clamp(actual.width, caps.minImageExtent.width, caps.maxImageExtent.width);
         actual.height = std::clamp(actual.height, caps.minImageExtent.height, caps.maxImageExtent.height);
         return actual;
@@ -164,18 +250,27 @@ VkExtent2D SwapChain::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& caps) {
 }
 
 void SwapChain::createFramebuffers(Device& device, RenderPass& renderPass) {
-    swapChainFramebuffers.resize(imageViews.size());
+    if (renderPass.usesDynamicRendering()) {
+        return;
+    }
+
+    bool present = renderPass.target() == RenderPassTarget::Present;
+    std::vector<VkFramebuffer>& framebuffers = present ? presentFramebuffers : swapChainFramebuffers;
+    framebuffers.resize(imageViews.size());
 
     for (size_t i = 0; i < imageViews.size(); i++) {
-        VkImageView attachments[] = {
-            imageViews[i]
-        };
+        // Attachment order matches RenderPass::createRenderPass: with MSAA the
+        // scene target (swapchain image or HDR target) is the resolve target in slot 2.
+        VkImageView sceneTarget = hdrTarget ? hdrImageView : imageViews[i];
+        VkImageView singleSampled[] = { sceneTarget, depthImageView };
+        VkImageView multisampled[] = { colorImageView, depthImageView, sceneTarget };
+        bool msaa = sampleCount != VK_SAMPLE_COUNT_1_BIT;
 
         VkFramebufferCreateInfo fbInfo{};
         fbInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         fbInfo.renderPass = renderPass.get();
-        fbInfo.attachmentCount = 1;
-        fbInfo.pAttachments = attachments;
+        fbInfo.attachmentCount = present ? 1 : msaa ? 3 : 2;
+        fbInfo.pAttachments = present ? &imageViews[i] : msaa ? multisampled : singleSampled;
         fbInfo.width = swapChainExtent.width;
         fbInfo.height = swapChainExtent.height;
         fbInfo.layers = 1;
@@ -183,8 +278,8 @@ void SwapChain::createFramebuffers(Device& device, RenderPass& renderPass) {
         if (vkCreateFramebuffer(
             device.device(),
             &fbInfo,
-            nullptr,
-            &swapChainFramebuffers[i]) != VK_SUCCESS) {
+            hostAllocator("SwapChain"),
+            &framebuffers[i]) != VK_SUCCESS) {
             throw std::runtime_error("failed to create framebuffer!");
         }
     }
@@ -192,23 +287,28 @@ void SwapChain::createFramebuffers(Device& device, RenderPass& renderPass) {
 
 void SwapChain::cleanupFramebuffers(Device& device) {
     for (auto fb : swapChainFramebuffers) {
-        vkDestroyFramebuffer(device.device(), fb, nullptr);
+        vkDestroyFramebuffer(device.device(), fb, hostAllocator("SwapChain"));
+    }
+    for (auto fb : presentFramebuffers) {
+        vkDestroyFramebuffer(device.device(), fb, hostAllocator("SwapChain"));
     }
     swapChainFramebuffers.clear();
+    presentFramebuffers.clear();
 }
 
-void SwapChain::recreateSwapChain(Device& device, RenderPass& renderPass) {
-    int width = 0, height = 0;
-    glfwGetFramebufferSize(window, &width, &height);
-    while (width == 0 || height == 0) {
-        glfwGetFramebufferSize(window, &width, &height);
-        glfwWaitEvents();
-    }
+void SwapChain::recreateSwapChain(Device& device, RenderPass& renderPass, RenderPass* presentPass) {
+    // The caller never asks for a zero-sized (minimized) swapchain.
     vkDeviceWaitIdle(device.device());
 
     cleanup();
 
     createSwapChain();
     createImageViews();
+    createColorResources();
+    createHdrResources();
+    createDepthResources();
     createFramebuffers(device, renderPass);
+    if (presentPass) {
+        createFramebuffers(device, *presentPass);
+    }
 }
\ No newline at end of file
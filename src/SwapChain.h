@@ -18,40 +18,104 @@ struct SwapChainSupportDetails {
 class SwapChain {
 public:
     // Initialize window surface, swap chain, and image views.
-    void init(Device& dev, GLFWwindow* win);
+    // samples > 1 adds a multisampled color target that resolves into the swapchain image.
+    // `win` may be null for a headless device; set the extent first in that case.
+    void init(Device& dev, GLFWwindow* win, VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT);
 
     // Destroy image views, swap chain, and surface.
     void cleanup();
 
+    // No-op when the render pass uses dynamic rendering: there is nothing to rebuild on resize.
+    // Scene and present passes (see RenderPassTarget) each get their own set.
     void createFramebuffers(Device& device, RenderPass& renderPass);
     void cleanupFramebuffers(Device& device);
-    void recreateSwapChain(Device& device, RenderPass& renderPass);
+    // Rebuilds the swapchain for the size last passed to setFramebufferExtent().
+    // Makes no GLFW calls, so it is safe on the render thread.
+    void recreateSwapChain(Device& device, RenderPass& renderPass, RenderPass* presentPass = nullptr);
+
+    // Window framebuffer size in pixels, read by the main thread (GLFW calls must stay there).
+    void setFramebufferExtent(VkExtent2D extent) { framebufferExtent = extent; }
 
     // Accessors for rendering code.
     VkSwapchainKHR getSwapChain() const { return swapChain; }
     const std::vector<VkFramebuffer>& getFramebuffers() const { return swapChainFramebuffers; }
+    const std::vector<VkFramebuffer>& getPresentFramebuffers() const { return presentFramebuffers; }
     VkFormat                        getImageFormat() const { return swapChainImageFormat; }
     VkExtent2D                      getExtent()      const { return swapChainExtent; }
     const std::vector<VkImageView>& getImageViews()  const { return imageViews; }
+    const std::vector<VkImage>&     getImages()      const { return images; }
+
+    // Depth attachment shared by every swapchain image (recreated on resize).
+    VkFormat    getDepthFormat()    const { return depthFormat; }
+    VkImage     getDepthImage()     const { return depthImage; }
+    VkImageView getDepthImageView() const { return depthImageView; }
+    // Keep depth after the pass and make it sampleable (for the Hi-Z depth pyramid)
+    // instead of a transient attachment. Call before init(); single-sampled only.
+    void setDepthSampled(bool sampled) { depthSampled = sampled; }
+    bool isDepthSampled() const { return depthSampled; }
+
+    // Render the scene into an offscreen HDR target for PostProcess instead of into
+    // the swapchain image, and ask for swapchain images compute shaders can write
+    // (a UNORM format with storage usage) where the surface allows it. Call before init().
+    static constexpr VkFormat HDR_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+    void setHdrTarget(bool hdr) { hdrTarget = hdr; }
+    bool hasHdrTarget() const { return hdrTarget; }
+    VkImage     getHdrImage()     const { return hdrImage; }
+    VkImageView getHdrImageView() const { return hdrImageView; }
+    // Format the scene pass renders into: HDR_FORMAT or the swapchain's.
+    VkFormat    getSceneFormat()  const { return hdrTarget ? HDR_FORMAT : swapChainImageFormat; }
+    // True when the images have VK_IMAGE_USAGE_STORAGE_BIT (only asked for with an HDR
+    // target). Their format is then UNORM: writers encode sRGB themselves.
+    bool        isStorageTarget() const { return storageTarget; }
+
+    // MSAA: sample count of the color/depth attachments. When > 1 the scene renders
+    // into getColorImage() and resolves into the swapchain image inside the pass.
+    VkSampleCountFlagBits getSampleCount()    const { return sampleCount; }
+    VkImage               getColorImage()     const { return colorImage; }
+    VkImageView           getColorImageView() const { return colorImageView; }
 
 private:
     // Internal setup steps.
     void createSwapChain();
     void createImageViews();
+    void createColorResources();
+    void createHdrResources();
+    void createDepthResources();
+    void destroyAttachments();
 
-    // Helpers for querying swapchain support.
-    SwapChainSupportDetails  querySwapChainSupport(VkPhysicalDevice physDev, VkSurfaceKHR surface);
+    // Helpers for choosing swapchain settings from Device::swapChainSupport().
     VkSurfaceFormatKHR       chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
+    // A UNORM sRGB-colour-space format usable as a storage image, or VK_FORMAT_UNDEFINED.
+    VkSurfaceFormatKHR       chooseStorageSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
     VkPresentModeKHR         chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes);
     VkExtent2D               chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities);
 
     // State
     Device* device = nullptr;
     GLFWwindow* window = nullptr;
+    VkExtent2D  framebufferExtent{};   // used when the surface leaves the extent to us
     VkSwapchainKHR          swapChain = VK_NULL_HANDLE;
     std::vector<VkImage>    images;
     std::vector<VkImageView> imageViews;
     std::vector<VkFramebuffer> swapChainFramebuffers;
+    std::vector<VkFramebuffer> presentFramebuffers;   // RenderPassTarget::Present
     VkFormat                swapChainImageFormat = VK_FORMAT_UNDEFINED;
     VkExtent2D              swapChainExtent = {};
+
+    VkSampleCountFlagBits   sampleCount = VK_SAMPLE_COUNT_1_BIT;
+    VkImage                 colorImage = VK_NULL_HANDLE;
+    VkDeviceMemory          colorImageMemory = VK_NULL_HANDLE;
+    VkImageView             colorImageView = VK_NULL_HANDLE;
+
+    bool                    hdrTarget = false;
+    bool                    storageTarget = false;
+    VkImage                 hdrImage = VK_NULL_HANDLE;
+    VkDeviceMemory          hdrImageMemory = VK_NULL_HANDLE;
+    VkImageView             hdrImageView = VK_NULL_HANDLE;
+
+    VkFormat                depthFormat = VK_FORMAT_UNDEFINED;
+    bool                    depthSampled = false;
+    VkImage                 depthImage = VK_NULL_HANDLE;
+    VkDeviceMemory          depthImageMemory = VK_NULL_HANDLE;
+    VkImageView             depthImageView = VK_NULL_HANDLE;
 };
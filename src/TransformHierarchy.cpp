@@ -0,0 +1,323 @@
+// src/TransformHierarchy.cpp
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    const uint32_t NO_SLOT = ~0u;
+}
+
+//-------------------------------------------------------------------------
+// Structure
+//-------------------------------------------------------------------------
+
+TransformHierarchy::NodeId TransformHierarchy::createNode(NodeId parent) {
+    NodeId id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    else {
+        id = static_cast<NodeId>(slotOf.size());
+        slotOf.push_back(NO_SLOT);
+        parentOf.push_back(InvalidNode);
+    }
+
+    // Append at the end; rebuildOrder() moves it into breadth-first position.
+    uint32_t slot = static_cast<uint32_t>(slotNode.size());
+    slotOf[id] = slot;
+    parentOf[id] = parent;
+
+    slotNode.push_back(id);
+    parentSlot.push_back(NO_SLOT);
+    firstChild.push_back(0);
+    childCount.push_back(0);
+    posX.push_back(0.0f);   posY.push_back(0.0f);   posZ.push_back(0.0f);
+    rotX.push_back(0.0f);   rotY.push_back(0.0f);   rotZ.push_back(0.0f);   rotW.push_back(1.0f);
+    scaleX.push_back(1.0f); scaleY.push_back(1.0f); scaleZ.push_back(1.0f);
+    dirty.push_back(1);
+    world.push_back(Mat4::identity());
+
+    orderDirty = true;
+    return id;
+}
+
+void TransformHierarchy::destroyNode(NodeId node) {
+    // Collect the subtree (parentOf is per id, so scan for children).
+    std::vector<NodeId> doomed{ node };
+    for (size_t i = 0; i < doomed.size(); i++) {
+        for (NodeId id = 0; id < parentOf.size(); id++) {
+            if (slotOf[id] != NO_SLOT && parentOf[id] == doomed[i]) {
+                doomed.push_back(id);
+            }
+        }
+    }
+
+    // Swap-remove each slot; rebuildOrder() restores the breadth-first order.
+    for (NodeId id : doomed) {
+        uint32_t slot = slotOf[id];
+        uint32_t last = static_cast<uint32_t>(slotNode.size()) - 1;
+        if (slot != last) {
+            NodeId moved = slotNode[last];
+            slotNode[slot] = moved;
+            slotOf[moved] = slot;
+            posX[slot] = posX[last];     posY[slot] = posY[last];     posZ[slot] = posZ[last];
+            rotX[slot] = rotX[last];     rotY[slot] = rotY[last];     rotZ[slot] = rotZ[last];
+            rotW[slot] = rotW[last];
+            scaleX[slot] = scaleX[last]; scaleY[slot] = scaleY[last]; scaleZ[slot] = scaleZ[last];
+            world[slot] = world[last];
+        }
+        slotNode.pop_back();
+        parentSlot.pop_back();
+        firstChild.pop_back();
+        childCount.pop_back();
+        posX.pop_back();   posY.pop_back();   posZ.pop_back();
+        rotX.pop_back();   rotY.pop_back();   rotZ.pop_back();   rotW.pop_back();
+        scaleX.pop_back(); scaleY.pop_back(); scaleZ.pop_back();
+        dirty.pop_back();
+        world.pop_back();
+
+        slotOf[id] = NO_SLOT;
+        parentOf[id] = InvalidNode;
+        freeIds.push_back(id);
+    }
+    orderDirty = true;
+}
+
+void TransformHierarchy::setParent(NodeId node, NodeId parent) {
+    for (NodeId p = parent; p != InvalidNode; p = parentOf[p]) {
+        if (p == node) throw std::runtime_error("transform hierarchy: parenting would create a cycle!");
+    }
+    parentOf[node] = parent;
+    orderDirty = true;
+}
+
+void TransformHierarchy::rebuildOrder() {
+    const size_t count = slotNode.size();
+
+    // Children lists per id, in current slot order so the result is stable.
+    std::vector<uint32_t> childStart(slotOf.size() + 1, 0);
+    for (uint32_t slot = 0; slot < count; slot++) {
+        NodeId parent = parentOf[slotNode[slot]];
+        if (parent != InvalidNode) childStart[parent + 1]++;
+    }
+    for (size_t i = 1; i < childStart.size(); i++) childStart[i] += childStart[i - 1];
+    std::vector<NodeId> children(count);
+    std::vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+    for (uint32_t slot = 0; slot < count; slot++) {
+        NodeId id = slotNode[slot];
+        if (parentOf[id] != InvalidNode) children[fill[parentOf[id]]++] = id;
+    }
+
+    // Breadth-first: roots, then level by level.
+    std::vector<NodeId> order;
+    std::vector<uint32_t> orderFirstChild(count), orderChildCount(count);
+    order.reserve(count);
+    for (uint32_t slot = 0; slot < count; slot++) {
+        if (parentOf[slotNode[slot]] == InvalidNode) order.push_back(slotNode[slot]);
+    }
+    levelStart.assign(1, 0);
+    size_t levelEnd = order.size();
+    for (size_t i = 0; i < order.size(); i++) {
+        if (i == levelEnd) {
+            levelStart.push_back(static_cast<uint32_t>(i));
+            levelEnd = order.size();
+        }
+        NodeId id = order[i];
+        orderFirstChild[i] = static_cast<uint32_t>(order.size());
+        orderChildCount[i] = childStart[id + 1] - childStart[id];
+        for (uint32_t c = childStart[id]; c < childStart[id + 1]; c++) {
+            order.push_back(children[c]);
+        }
+    }
+    levelStart.push_back(static_cast<uint32_t>(order.size()));
+
+    // Permute the SoA arrays into the new order.
+    auto permute = [&](auto& array) {
+        auto old = array;
+        for (size_t slot = 0; slot < count; slot++) {
+            array[slot] = old[slotOf[order[slot]]];
+        }
+    };
+    permute(posX);   permute(posY);   permute(posZ);
+    permute(rotX);   permute(rotY);   permute(rotZ);   permute(rotW);
+    permute(scaleX); permute(scaleY); permute(scaleZ);
+    permute(world);
+
+    for (uint32_t slot = 0; slot < count; slot++) {
+        slotNode[slot] = order[slot];
+        slotOf[order[slot]] = slot;
+    }
+    for (uint32_t slot = 0; slot < count; slot++) {
+        NodeId parent = parentOf[slotNode[slot]];
+        parentSlot[slot] = parent == InvalidNode ? NO_SLOT : slotOf[parent];
+    }
+    firstChild.swap(orderFirstChild);
+    childCount.swap(orderChildCount);
+
+    // Cheaper to recompute everything once than to track what moved: mark the roots.
+    std::fill(dirty.begin(), dirty.end(), uint8_t(0));
+    dirtyNodes.clear();
+    for (uint32_t slot = levelStart[0]; slot < levelStart[1]; slot++) {
+        markDirty(slotNode[slot]);
+    }
+    orderDirty = false;
+}
+
+uint32_t TransformHierarchy::levelOf(uint32_t slot) const {
+    auto it = std::upper_bound(levelStart.begin(), levelStart.end(), slot);
+    return static_cast<uint32_t>(it - levelStart.begin()) - 1;
+}
+
+//-------------------------------------------------------------------------
+// Local transforms
+//-------------------------------------------------------------------------
+
+void TransformHierarchy::markDirty(NodeId node) {
+    uint8_t& flag = dirty[slotOf[node]];
+    if (!flag) {
+        flag = 1;
+        dirtyNodes.push_back(node);
+    }
+}
+
+void TransformHierarchy::setLocalTransform(NodeId node, const Vec3& p, const Quat& r, const Vec3& s) {
+    uint32_t slot = slotOf[node];
+    posX[slot] = p.x;   posY[slot] = p.y;   posZ[slot] = p.z;
+    rotX[slot] = r.x;   rotY[slot] = r.y;   rotZ[slot] = r.z;   rotW[slot] = r.w;
+    scaleX[slot] = s.x; scaleY[slot] = s.y; scaleZ[slot] = s.z;
+    markDirty(node);
+}
+
+void TransformHierarchy::setLocalPosition(NodeId node, const Vec3& p) {
+    uint32_t slot = slotOf[node];
+    posX[slot] = p.x; posY[slot] = p.y; posZ[slot] = p.z;
+    markDirty(node);
+}
+
+void TransformHierarchy::setLocalRotation(NodeId node, const Quat& r) {
+    uint32_t slot = slotOf[node];
+    rotX[slot] = r.x; rotY[slot] = r.y; rotZ[slot] = r.z; rotW[slot] = r.w;
+    markDirty(node);
+}
+
+//-------------------------------------------------------------------------
+// Update
+//-------------------------------------------------------------------------
+
+void TransformHierarchy::update() {
+    updatedCount = 0;
+    if (orderDirty) rebuildOrder();
+    if (dirtyNodes.empty()) return;
+
+    // Modified nodes, in slot order (so also level order).
+    dirtySlots.clear();
+    for (NodeId node : dirtyNodes) dirtySlots.push_back(slotOf[node]);
+    std::sort(dirtySlots.begin(), dirtySlots.end());
+    dirtyNodes.clear();
+
+    // Level by level: this level's modified nodes plus the children of last
+    // level's updated nodes. Parents are always final before their children.
+    size_t next = 0;
+    nextLevel.clear();
+    for (uint32_t level = levelOf(dirtySlots[0]); level + 1 < levelStart.size(); level++) {
+        currentLevel.swap(nextLevel);
+        nextLevel.clear();
+        while (next < dirtySlots.size() && dirtySlots[next] < levelStart[level + 1]) {
+            currentLevel.push_back(dirtySlots[next++]);
+        }
+        if (currentLevel.empty()) {
+            if (next == dirtySlots.size()) break;
+            continue;
+        }
+
+        for (size_t i = 0; i < currentLevel.size(); i += 4) {
+            uint32_t n = static_cast<uint32_t>(std::min<size_t>(4, currentLevel.size() - i));
+            updateBatch(&currentLevel[i], n);
+        }
+        updatedCount += currentLevel.size();
+
+        for (uint32_t slot : currentLevel) {
+            dirty[slot] = 0;
+            for (uint32_t c = firstChild[slot], end = c + childCount[slot]; c < end; c++) {
+                // Children that were modified themselves are already queued.
+                if (!dirty[c]) {
+                    dirty[c] = 1;
+                    nextLevel.push_back(c);
+                }
+            }
+        }
+    }
+}
+
+#if ENGINE_MATH_SSE
+
+void TransformHierarchy::updateBatch(const uint32_t* slots, uint32_t count) {
+    // Gather four nodes' TRS into SSE lanes (unused lanes repeat the first node).
+    uint32_t s[4];
+    for (uint32_t i = 0; i < 4; i++) s[i] = slots[i < count ? i : 0];
+    auto lanes = [&](const std::vector<float>& v) { return _mm_setr_ps(v[s[0]], v[s[1]], v[s[2]], v[s[3]]); };
+
+    __m128 qx = lanes(rotX), qy = lanes(rotY), qz = lanes(rotZ), qw = lanes(rotW);
+    __m128 sx = lanes(scaleX), sy = lanes(scaleY), sz = lanes(scaleZ);
+    __m128 tx = lanes(posX), ty = lanes(posY), tz = lanes(posZ);
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+    __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+    __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+    // Rotation * scale, column-major, one register per element across four nodes.
+    __m128 m[12];
+    m[0]  = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+    m[1]  = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+    m[2]  = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+    m[3]  = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+    m[4]  = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+    m[5]  = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+    m[6]  = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+    m[7]  = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+    m[8]  = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+    m[9]  = tx;
+    m[10] = ty;
+    m[11] = tz;
+
+    alignas(16) float soa[12][4];
+    for (int e = 0; e < 12; e++) _mm_store_ps(soa[e], m[e]);
+
+    for (uint32_t i = 0; i < count; i++) {
+        // Local matrix columns for lane i.
+        __m128 l0 = _mm_setr_ps(soa[0][i], soa[1][i], soa[2][i], 0.0f);
+        __m128 l1 = _mm_setr_ps(soa[3][i], soa[4][i], soa[5][i], 0.0f);
+        __m128 l2 = _mm_setr_ps(soa[6][i], soa[7][i], soa[8][i], 0.0f);
+        __m128 l3 = _mm_setr_ps(soa[9][i], soa[10][i], soa[11][i], 1.0f);
+
+        Mat4 local;
+        _mm_store_ps(local.m, l0);
+        _mm_store_ps(local.m + 4, l1);
+        _mm_store_ps(local.m + 8, l2);
+        _mm_store_ps(local.m + 12, l3);
+
+        uint32_t parent = parentSlot[s[i]];
+        world[s[i]] = parent == NO_SLOT ? local : world[parent] * local;
+    }
+}
+
+#else
+
+void TransformHierarchy::updateBatch(const uint32_t* slots, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t s = slots[i];
+
+        Mat4 local = Mat4::fromTRS(Vec3{ posX[s], posY[s], posZ[s] },
+                                   Quat{ rotX[s], rotY[s], rotZ[s], rotW[s] },
+                                   Vec3{ scaleX[s], scaleY[s], scaleZ[s] });
+
+        uint32_t parent = parentSlot[s];
+        world[s] = parent == NO_SLOT ? local : world[parent] * local;
+    }
+}
+
+#endif
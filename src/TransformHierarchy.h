@@ -0,0 +1,77 @@
+// src/TransformHierarchy.h
+#pragma once
+
+#include "Math.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Scene transform hierarchy.
+//
+// Nodes are addressed by stable NodeId handles; internally they live in
+// breadth-first order in structure-of-arrays storage, so every parent precedes
+// its children, each tree level is a contiguous slot range and so are the
+// children of any one node. update() starts from the nodes modified since the
+// last update and walks down level by level, adding each dirty node's child
+// range, so its cost is proportional to the subtrees that moved. World
+// matrices are computed four at a time with SSE (scalar fallback elsewhere).
+class TransformHierarchy {
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId InvalidNode = ~0u;
+
+    NodeId createNode(NodeId parent = InvalidNode);
+    // Destroys the node and its whole subtree.
+    void   destroyNode(NodeId node);
+    void   setParent(NodeId node, NodeId parent);
+
+    void setLocalTransform(NodeId node, const Vec3& position, const Quat& rotation, const Vec3& scale);
+    void setLocalPosition(NodeId node, const Vec3& position);
+    void setLocalRotation(NodeId node, const Quat& rotation);
+
+    // Valid after update().
+    const Mat4& worldMatrix(NodeId node) const { return world[slotOf[node]]; }
+
+    // Recomputes world matrices of every node whose local transform, or an
+    // ancestor's, changed since the last update.
+    void update();
+
+    size_t nodeCount() const { return slotNode.size(); }
+    size_t lastUpdatedCount() const { return updatedCount; }
+
+private:
+    // Re-sorts the slots into breadth-first order after structural changes.
+    void rebuildOrder();
+    uint32_t levelOf(uint32_t slot) const;
+    void markDirty(NodeId node);
+
+    // Computes world[slots[i]] for up to four slots whose parents are up to date.
+    void updateBatch(const uint32_t* slots, uint32_t count);
+
+    // Per NodeId (stable handles)
+    std::vector<uint32_t> slotOf;       // NodeId -> slot, ~0 when free
+    std::vector<NodeId>   parentOf;
+    std::vector<NodeId>   freeIds;
+
+    // Per slot, breadth-first order (SoA)
+    std::vector<NodeId>   slotNode;     // slot -> NodeId
+    std::vector<uint32_t> parentSlot;   // ~0 for roots; always < own slot
+    std::vector<float>    posX, posY, posZ;
+    std::vector<float>    rotX, rotY, rotZ, rotW;
+    std::vector<float>    scaleX, scaleY, scaleZ;
+    std::vector<uint32_t> firstChild;   // children occupy [firstChild, firstChild + childCount)
+    std::vector<uint32_t> childCount;
+    std::vector<uint8_t>  dirty;
+    std::vector<Mat4>     world;
+    std::vector<uint32_t> levelStart;   // slot where each depth level begins, plus end sentinel
+
+    bool   orderDirty = false;          // structure changed since the last rebuildOrder()
+    size_t updatedCount = 0;
+    std::vector<NodeId>   dirtyNodes;   // modified since the last update (flag set in `dirty`)
+
+    // Scratch, reused between updates
+    std::vector<uint32_t> dirtySlots;
+    std::vector<uint32_t> currentLevel;
+    std::vector<uint32_t> nextLevel;
+};
@@ -16,10 +16,17 @@ std::vector<char> readFile(const std::string& filename) {
     return buffer;
 }
 
-std::vector<const char*> getRequiredExtensions(bool enableValidation) {
-    uint32_t count = 0;
-    const char** glfwExts = glfwGetRequiredInstanceExtensions(&count);
-    std::vector<const char*> extensions(glfwExts, glfwExts + count);
+std::vector<const char*> getRequiredExtensions(bool enableValidation, bool headless) {
+    std::vector<const char*> extensions;
+    if (headless) {
+        extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+        extensions.push_back(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+    }
+    else {
+        uint32_t count = 0;
+        const char** glfwExts = glfwGetRequiredInstanceExtensions(&count);
+        extensions.assign(glfwExts, glfwExts + count);
+    }
 
     if (enableValidation) {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
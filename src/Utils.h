@@ -10,4 +10,5 @@
 std::vector<char> readFile(const std::string& filename);
 
 // Get required instance extensions from GLFW, plus debug utils if enabled.
-std::vector<const char*> getRequiredExtensions(bool enableValidation);
+// Headless instances skip GLFW and ask for VK_EXT_headless_surface instead.
+std::vector<const char*> getRequiredExtensions(bool enableValidation, bool headless = false);
@@ -1,10 +1,24 @@
 // src/VulkanApp.cpp
 #include "VulkanApp.h"
 #include "Renderer.h"
+#include "HostMemoryTracker.h"
+#include "InitGraph.h"
+#include "ShaderCache.h"
+#include <iostream>
 #include <stdexcept> // for runtime_error
+#include <thread>
 
-VulkanApp::VulkanApp() {
-    // nothing special
+namespace {
+    // Simulation rate, independent of the frame rate.
+    const double SIMULATION_STEP = 1.0 / 120.0;
+    // After a long stall (window drag, breakpoint) skip ahead instead of catching up.
+    const double MAX_SIMULATION_LAG = 0.25;
+    // How long the main thread waits for a free packet before pumping events again.
+    const std::chrono::microseconds PACKET_WAIT{ 500 };
+}
+
+VulkanApp::VulkanApp(const RenderSettings& settings)
+    : settings(settings) {
 }
 
 VulkanApp::~VulkanApp() {
@@ -18,6 +32,29 @@ void VulkanApp::run() {
     cleanup();
 }
 
+void VulkanApp::initHeadless(VkExtent2D extent) {
+    headlessExtent = extent;
+    swapChain.setFramebufferExtent(extent);   // no window to query
+    initVulkan();
+}
+
+void VulkanApp::renderFrame(float time) {
+    FramePacket packet;
+    fillFramePacket(packet, headlessExtent);
+    packet.time = time;
+    renderer.drawFrame(packet);
+}
+
+void VulkanApp::resize(VkExtent2D extent) {
+    headlessExtent = extent;
+    framebufferResized = true;
+}
+
+void VulkanApp::shutdown() {
+    vkDeviceWaitIdle(device.device());
+    cleanup();
+}
+
 void VulkanApp::initWindow() {
     glfwInit();
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
@@ -26,39 +63,379 @@ void VulkanApp::initWindow() {
 
     glfwSetWindowUserPointer(window, this);
     glfwSetFramebufferSizeCallback(window, VulkanApp::framebufferResizeCallback);
+    glfwSetKeyCallback(window, VulkanApp::keyCallback);
+    glfwSetMouseButtonCallback(window, VulkanApp::mouseButtonCallback);
+    glfwSetCursorPosCallback(window, VulkanApp::cursorPosCallback);
+    glfwSetScrollCallback(window, VulkanApp::scrollCallback);
 }
 void VulkanApp::framebufferResizeCallback(GLFWwindow* window, int width, int height) {
     auto app = static_cast<VulkanApp*>(glfwGetWindowUserPointer(window)); // I FIXED IT
-    app->setFramebufferResized(true);
+    app->framebufferResized = true;
+}
+
+void VulkanApp::keyCallback(GLFWwindow* window, int key, int, int action, int) {
+    static_cast<VulkanApp*>(glfwGetWindowUserPointer(window))->input.onKey(key, action);
+}
+
+void VulkanApp::mouseButtonCallback(GLFWwindow* window, int button, int action, int) {
+    static_cast<VulkanApp*>(glfwGetWindowUserPointer(window))->input.onMouseButton(button, action);
+}
+
+void VulkanApp::cursorPosCallback(GLFWwindow* window, double x, double y) {
+    static_cast<VulkanApp*>(glfwGetWindowUserPointer(window))->input.onCursorMove(x, y);
+}
+
+void VulkanApp::scrollCallback(GLFWwindow* window, double dx, double dy) {
+    static_cast<VulkanApp*>(glfwGetWindowUserPointer(window))->input.onScroll(dx, dy);
 }
 
 void VulkanApp::initVulkan() {
-    debugUtils.setupValidationLayers();
-    device.init(window, debugUtils);
-    swapChain.init(device, window); // creates swapchain + image views
+    Logger::global().setMinSeverity(settings.logLevel);
+    jobs.init(settings.jobThreads);
+    debugUtils.setupValidationLayers(settings.validation);
+
+    // Checks that need no device, so the graph below knows which steps exist.
+    if (settings.occlusionCulling && settings.scene != SceneKind::Lod) {
+        Logger::global().logf(LogSeverity::Warning, "engine", "ignoring --occlusion-culling: only the lod scene supports it");
+        settings.occlusionCulling = false;
+    }
+    if (settings.shadows && settings.scene != SceneKind::Lod) {
+        Logger::global().logf(LogSeverity::Warning, "engine", "ignoring --shadows: only the lod scene supports it");
+        settings.shadows = false;
+    }
+    if (settings.depthPrepass && settings.scene == SceneKind::Sprites) {
+        Logger::global().logf(LogSeverity::Warning, "engine", "the sprites scene has no depth, ignoring --depth-prepass");
+        settings.depthPrepass = false;
+    }
+
+    // Startup as a dependency graph: the device and swapchain stay on this thread
+    // (they talk to the window), while shader loading, scene assets and pipeline
+    // compilation run on worker threads as soon as what they need exists.
+    InitGraph graph;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    PipelineConfig mainConfig;   // scene shaders; the depth pre-pass reuses the vertex shader
+
+    // Runs while the device is created; every step that builds a pipeline waits
+    // for it, directly or through the steps it depends on.
+    InitGraph::StepId shaderStep = graph.add("shader files", [] { ShaderCache::global().preload("shaders_spv"); });
+
+    InitGraph::StepId deviceStep = graph.add("device", [&] {
+        device.init(window, debugUtils);
+
+        samples = device.clampSampleCount(settings.msaaSamples);
+        if (static_cast<uint32_t>(samples) != settings.msaaSamples) {
+            Logger::global().logf(LogSeverity::Warning, "engine", "MSAA %ux not supported, using %ux",
+                settings.msaaSamples, static_cast<uint32_t>(samples));
+        }
+        // Occlusion culling reads depth back after the pass, so it has to be stored and sampleable.
+        if (settings.occlusionCulling) {
+            const char* reason = nullptr;
+            if (samples != VK_SAMPLE_COUNT_1_BIT) reason = "it needs a single-sampled depth buffer";
+            else if (!DepthPyramid::supported(device, device.findDepthFormat())) reason = "the depth format cannot be sampled";
+            if (reason) {
+                Logger::global().logf(LogSeverity::Warning, "engine", "ignoring --occlusion-culling: %s", reason);
+                settings.occlusionCulling = false;
+            }
+            else if (settings.lodDrawPerInstance) {
+                Logger::global().logf(LogSeverity::Warning, "engine",
+                    "--lod-draw-per-instance has no effect with --occlusion-culling (draws are indirect)");
+            }
+        }
+    }, {}, InitThread::Main);
+
+    InitGraph::StepId swapChainStep = graph.add("swapchain", [&] {
+        swapChain.setDepthSampled(settings.occlusionCulling);
+        swapChain.setHdrTarget(settings.postProcess);
+        swapChain.init(device, window, samples); // creates swapchain + image views (+ MSAA/depth targets)
+    }, { deviceStep }, InitThread::Main);
+
+    InitGraph::StepId pyramidStep = InitGraph::none;
+    if (settings.occlusionCulling) {
+        pyramidStep = graph.add("depth pyramid", [&] {
+            if (settings.occlusionCulling) depthPyramid.init(device, swapChain);   // may have been ruled out above
+        }, { swapChainStep, shaderStep });
+    }
+
+    InitGraph::StepId renderPassStep = graph.add("render passes", [&] {
+        renderPass.init(device, swapChain, settings.dynamicRendering); // creates VkRenderPass (legacy path only)
+        if (settings.postProcess) {
+            presentPass.init(device, swapChain, settings.dynamicRendering, RenderPassTarget::Present);
+        }
+    }, { swapChainStep });
+
+    // Scene assets only need the device, so they load alongside swapchain setup.
+    InitGraph::StepId sceneStep = graph.add("scene assets", [&] {
+        if (settings.scene == SceneKind::Overdraw) {
+            mainConfig.vertShader = "shaders_spv/overdraw_vert.spv";
+            mainConfig.fragShader = "shaders_spv/overdraw_frag.spv";
+            mainConfig.pushConstantSize = sizeof(OverdrawPushConstants);
+        }
+        else if (settings.scene == SceneKind::Lights) {
+            lighting.init(device, settings.lightCount, Renderer::MAX_FRAMES_IN_FLIGHT);
+            mainConfig.vertShader = "shaders_spv/lit_vert.spv";
+            mainConfig.fragShader = "shaders_spv/lit_frag.spv";
+            mainConfig.setLayouts = { lighting.setLayout() };
+        }
+        else if (settings.scene == SceneKind::Lod) {
+            lodScene.init(device, settings.lodGridSize, settings.lodErrorPixels, Renderer::MAX_FRAMES_IN_FLIGHT,
+                settings.occlusionCulling ? &depthPyramid : nullptr, settings.shadows);
+            mainConfig.vertShader = "shaders_spv/lod_vert.spv";
+            mainConfig.fragShader = "shaders_spv/lod_frag.spv";
+            mainConfig.setLayouts = { lodScene.setLayout() };
+            mainConfig.vertexBindings = LodScene::vertexBindings();
+            mainConfig.vertexAttributes = LodScene::vertexAttributes();
+            mainConfig.pushConstantSize = LodScene::pushConstantSize;
+        }
+        else if (settings.scene == SceneKind::Sprites) {
+            spriteScene.init(device, settings.spriteCount, Renderer::MAX_FRAMES_IN_FLIGHT);
+            mainConfig.vertShader = "shaders_spv/sprite_vert.spv";
+            mainConfig.fragShader = "shaders_spv/sprite_frag.spv";
+            mainConfig.setLayouts = { spriteScene.setLayout() };
+            mainConfig.vertexBindings = SpriteScene::vertexBindings();
+            mainConfig.vertexAttributes = SpriteScene::vertexAttributes();
+            mainConfig.pushConstantSize = SpriteScene::pushConstantSize;
+            // Layers are ordered by the batcher, not by depth; blending needs painter's order.
+            mainConfig.depthTest = false;
+            mainConfig.depthWrite = false;
+            mainConfig.cullMode = VK_CULL_MODE_NONE;
+            mainConfig.alphaBlend = true;
+        }
+        else if (settings.scene == SceneKind::Crowd) {
+            crowdScene.init(device, jobs, settings.characterCount, Renderer::MAX_FRAMES_IN_FLIGHT);
+            mainConfig.vertShader = "shaders_spv/skinned_vert.spv";
+            mainConfig.fragShader = "shaders_spv/skinned_frag.spv";
+            mainConfig.setLayouts = { crowdScene.setLayout() };
+            mainConfig.vertexBindings = CrowdScene::vertexBindings();
+            mainConfig.vertexAttributes = CrowdScene::vertexAttributes();
+            mainConfig.pushConstantSize = CrowdScene::pushConstantSize;
+        }
+    }, { deviceStep, pyramidStep, shaderStep });
+
+    InitGraph::StepId shadowStep = InitGraph::none;
+    if (settings.shadows) {
+        shadowStep = graph.add("shadow map", [&] {
+            ShadowCascadeSettings cascades;
+            cascades.resolution = settings.shadowMapSize;
+            // Casters only need positions (location 0).
+            shadowMap.init(device, cascades, Renderer::MAX_FRAMES_IN_FLIGHT, lodScene.setLayout(),
+                LodScene::vertexBindings(), { LodScene::vertexAttributes()[0] }, settings.shadowCache);
+            mainConfig.fragShader = "shaders_spv/lod_shadowed_frag.spv";
+            mainConfig.setLayouts.push_back(shadowMap.setLayout());
+        }, { sceneStep });
+    }
+
+    // Both pipelines only read mainConfig, so they compile side by side.
+    InitGraph::StepId prepassStep = InitGraph::none;
+    if (settings.depthPrepass) {
+        prepassStep = graph.add("depth pre-pass pipeline", [&] {
+            PipelineConfig prepassConfig = mainConfig;
+            prepassConfig.fragShader.clear();
+            prepassConfig.colorWrite = false;
+            depthPrepassPipeline.init(device, swapChain, renderPass, prepassConfig);
+        }, { renderPassStep, sceneStep, shadowStep });
+    }
+    InitGraph::StepId pipelineStep = graph.add("scene pipeline", [&] {
+        PipelineConfig config = mainConfig;
+        if (settings.depthPrepass) {
+            // Depth is already final after the pre-pass: only the visible fragment passes.
+            config.depthWrite = false;
+            config.depthCompareOp = VK_COMPARE_OP_EQUAL;
+        }
+        pipeline.init(device, swapChain, renderPass, config); // creates graphics pipeline
+    }, { renderPassStep, sceneStep, shadowStep });
 
-    renderPass.init(device, swapChain); // creates VkRenderPass
-    pipeline.init(device, swapChain, renderPass); // creates graphics pipeline
+    //build the framebuffers now that renderPass is valid (skipped with dynamic rendering)
+    InitGraph::StepId framebufferStep = graph.add("framebuffers", [&] {
+        swapChain.createFramebuffers(device, renderPass);
+        if (settings.postProcess) {
+            swapChain.createFramebuffers(device, presentPass);
+        }
+    }, { renderPassStep });
 
-    //build the framebuffers now that renderPass is valid
-    swapChain.createFramebuffers(device, renderPass);
+    InitGraph::StepId postStep = InitGraph::none;
+    if (settings.postProcess) {
+        postStep = graph.add("post process", [&] {
+            postProcess.init(device, swapChain);
+            if (!swapChain.isStorageTarget()) {
+                Logger::global().logf(LogSeverity::Info, "engine",
+                    "swapchain images cannot be storage images; post-processing blits its result");
+            }
+        }, { swapChainStep, shaderStep });
+    }
+
+    InitGraph::StepId overlayStep = graph.add("overlay", [&] {
+        overlay.init(device, swapChain, settings.postProcess ? presentPass : renderPass, Renderer::MAX_FRAMES_IN_FLIGHT);
+    }, { renderPassStep, shaderStep });
+
+    InitGraph::StepId particleStep = InitGraph::none;
+    if (settings.particleCount > 0) {
+        particleStep = graph.add("particles", [&] {
+            particles.init(device, swapChain, renderPass, settings.particleCount, Renderer::MAX_FRAMES_IN_FLIGHT);
+            if (!device.hasAsyncCompute()) {
+                Logger::global().logf(LogSeverity::Info, "engine",
+                    "no separate compute queue family; particles run on the graphics queue");
+            }
+        }, { renderPassStep, shaderStep });
+    }
 
     // now the renderer can size its command buffers to match those framebuffers
-    renderer.init(device, swapChain, renderPass, pipeline);
+    graph.add("renderer", [&] {
+        renderer.init(device, swapChain, renderPass, pipeline, settings,
+            settings.depthPrepass ? &depthPrepassPipeline : nullptr);
+        if (settings.scene == SceneKind::Lights) {
+            renderer.setLighting(&lighting);
+        }
+        else if (settings.scene == SceneKind::Lod) {
+            renderer.setLodScene(&lodScene);
+        }
+        else if (settings.scene == SceneKind::Sprites) {
+            renderer.setSpriteScene(&spriteScene);
+        }
+        else if (settings.scene == SceneKind::Crowd) {
+            renderer.setCrowdScene(&crowdScene);
+        }
+        if (settings.occlusionCulling) {
+            renderer.setDepthPyramid(&depthPyramid);
+        }
+        if (settings.shadows) {
+            renderer.setShadowMap(&shadowMap);
+        }
+        if (settings.postProcess) {
+            renderer.setPostProcess(&postProcess, &presentPass);
+        }
+
+        // Camera input: simulated in fixed steps, view re-aimed just before recording.
+        cameraController.init(renderer.getCamera());
+        renderer.setLateCameraUpdate([this](const FramePacket& packet, Camera& camera) {
+            CameraController::lateSample(packet.camera, input, camera);
+        });
+
+        renderer.setOverlay(&overlay);
+        overlayVisible = settings.overlay;
+        if (settings.particleCount > 0) {
+            renderer.setParticleSystem(&particles);
+        }
+    }, { pipelineStep, prepassStep, framebufferStep, pyramidStep, shadowStep, postStep, overlayStep, particleStep },
+       InitThread::Main);
+
+    graph.run(settings.parallelInit ? settings.jobThreads : 1);
+
+    if (settings.printFrameStats) {
+        std::cout << graph.report() << std::endl;
+    }
+    else {
+        Logger::global().log(LogSeverity::Info, "engine", 0, graph.report().c_str());
+    }
 }
 
 void VulkanApp::mainLoop() {
-    while (!glfwWindowShouldClose(window)) {
+    simulationStart = simulationTime = input.now();
+    std::thread renderThread(&VulkanApp::renderLoop, this);
+
+    while (!glfwWindowShouldClose(window) && !packets.isShutdown()) {
+        HostAllocationScope allocationScope("main/events");
         glfwPollEvents();
-        renderer.drawFrame();
+
+        int width = 0, height = 0;
+        glfwGetFramebufferSize(window, &width, &height);
+        if (width == 0 || height == 0) {
+            glfwWaitEvents();   // minimized: nothing to render
+            continue;
+        }
+
+        // Simulates frame N+1 while the render thread is still busy with frame N.
+        allocationScope.enter("main/simulate");
+        simulate(input.now());
+        allocationScope.enter("main/packet");
+
+        FramePacket* packet = nullptr;
+        while (!packet && !packets.isShutdown()) {
+            packet = packets.beginWrite(PACKET_WAIT);
+            if (!packet) glfwPollEvents();   // keep the late-sampled cursor fresh
+        }
+        if (!packet) break;
+
+        fillFramePacket(*packet, { static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
+        packets.publish();
     }
+
+    packets.shutdown();
+    renderThread.join();
+
     // Wait for GPU before destroying resources
     vkDeviceWaitIdle(device.device());
+
+    if (renderError) {
+        std::rethrow_exception(renderError);
+    }
+}
+
+void VulkanApp::renderLoop() {
+    try {
+        while (const FramePacket* packet = packets.acquire()) {
+            renderer.drawFrame(*packet);
+            packets.release();
+        }
+    }
+    catch (...) {
+        renderError = std::current_exception();
+        packets.shutdown();
+    }
+}
+
+void VulkanApp::simulate(double now) {
+    if (now - simulationTime > MAX_SIMULATION_LAG) {
+        simulationTime = now - MAX_SIMULATION_LAG;
+    }
+    while (simulationTime + SIMULATION_STEP <= now) {
+        simulationTime += SIMULATION_STEP;
+        input.beginStep(simulationTime);
+        cameraController.fixedUpdate(input.state(), float(SIMULATION_STEP));
+        if (input.state().keyPressed(GLFW_KEY_F1)) overlayVisible = !overlayVisible;
+    }
+}
+
+void VulkanApp::fillFramePacket(FramePacket& packet, VkExtent2D framebufferExtent) {
+    packet.frameNumber = nextFrameNumber++;
+    packet.time = float(simulationTime - simulationStart);
+    packet.camera = cameraController.pose(input.state());
+    packet.framebufferExtent = framebufferExtent;
+    packet.framebufferResized = framebufferResized.exchange(false);
+    packet.showOverlay = overlayVisible;
 }
 
 void VulkanApp::cleanup() {
     renderer.cleanup();
+    overlay.cleanup();
+    if (settings.particleCount > 0) {
+        particles.cleanup();
+    }
+    if (settings.scene == SceneKind::Lights) {
+        lighting.cleanup();
+    }
+    else if (settings.scene == SceneKind::Lod) {
+        if (settings.shadows) {
+            shadowMap.cleanup();
+        }
+        lodScene.cleanup();
+    }
+    else if (settings.scene == SceneKind::Sprites) {
+        spriteScene.cleanup();
+    }
+    else if (settings.scene == SceneKind::Crowd) {
+        crowdScene.cleanup();
+    }
+    if (settings.occlusionCulling) {
+        depthPyramid.cleanup();
+    }
+    if (settings.postProcess) {
+        postProcess.cleanup();
+        presentPass.cleanup(device);
+    }
     pipeline.cleanup();
+    if (settings.depthPrepass) {
+        depthPrepassPipeline.cleanup();
+    }
     renderPass.cleanup(device);
 
     // destroy framebuffers before tearing down the swapchain
@@ -68,7 +445,10 @@ void VulkanApp::cleanup() {
     debugUtils.cleanup(device.instance());
 
     device.cleanup();
+    jobs.cleanup();
 
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    if (window) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
 }
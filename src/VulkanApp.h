@@ -10,10 +10,26 @@
 #include "Pipeline.h"
 #include "Renderer.h"
 #include "DebugUtils.h"
+#include "RenderSettings.h"
+#include "ParticleSystem.h"
+#include "ClusteredLighting.h"
+#include "LodScene.h"
+#include "SpriteScene.h"
+#include "CrowdScene.h"
+#include "JobSystem.h"
+#include "DepthPyramid.h"
+#include "CascadedShadowMap.h"
+#include "PostProcess.h"
+#include "InputSystem.h"
+#include "CameraController.h"
+#include "FramePacket.h"
+
+#include <atomic>
+#include <exception>
 
 class VulkanApp {
 public:
-    VulkanApp();
+    explicit VulkanApp(const RenderSettings& settings = RenderSettings{});
     ~VulkanApp();
 
     // Runs the application:
@@ -23,27 +39,77 @@ public:
     //   - cleanup()
     void run();
 
+    // Headless driving for benchmarks: no window and no render thread. Frames
+    // render on the calling thread to a VK_EXT_headless_surface swapchain.
+    void initHeadless(VkExtent2D extent);
+    // Renders one frame at simulation time `time` (seconds).
+    void renderFrame(float time);
+    // Recreates the swapchain at `extent` on the next frame, like a window resize.
+    void resize(VkExtent2D extent);
+    // Waits for the GPU and destroys everything initHeadless() created.
+    void shutdown();
+
+    Device&     getDevice() { return device; }
+    SwapChain&  getSwapChain() { return swapChain; }
+    RenderPass& getRenderPass() { return renderPass; }
+    Renderer&   getRenderer() { return renderer; }
+
 private:
     void initWindow();
     static void framebufferResizeCallback(GLFWwindow* window, int width, int height);
+    static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+    static void cursorPosCallback(GLFWwindow* window, double x, double y);
+    static void scrollCallback(GLFWwindow* window, double dx, double dy);
     void initVulkan();
+    // Main thread: window events, input and the fixed-step simulation. Publishes
+    // a FramePacket per frame to the render thread running renderLoop().
     void mainLoop();
+    void renderLoop();
+    // Runs every fixed simulation step that ends before `now`.
+    void simulate(double now);
+    void fillFramePacket(FramePacket& packet, VkExtent2D framebufferExtent);
     void cleanup();
-    void setFramebufferResized(bool resized) {
-        renderer.framebufferResized = resized;
-    };
 
     const uint32_t WIDTH = 800;
     const uint32_t HEIGHT = 600;
 
     GLFWwindow* window = nullptr;
+    RenderSettings settings;
 
     // Subsystem managers
+    JobSystem  jobs;                   // worker threads for the render thread's parallel loops
     DebugUtils debugUtils;
     Device     device;
     SwapChain  swapChain;
     RenderPass renderPass;
     Pipeline   pipeline;
+    Pipeline   depthPrepassPipeline;   // only created with settings.depthPrepass
+    ClusteredLighting lighting;        // only created for SceneKind::Lights
+    LodScene   lodScene;               // only created for SceneKind::Lod
+    SpriteScene spriteScene;           // only created for SceneKind::Sprites
+    CrowdScene crowdScene;             // only created for SceneKind::Crowd
+    DepthPyramid depthPyramid;         // only created with settings.occlusionCulling
+    CascadedShadowMap shadowMap;       // only created with settings.shadows
+    PostProcess postProcess;           // only created with settings.postProcess
+    RenderPass presentPass;            // overlay over the post-processed image (settings.postProcess)
+    ParticleSystem particles;          // only created with settings.particleCount > 0
+    Overlay    overlay;
     Renderer   renderer;
+
+    // Input and fixed-step simulation
+    InputSystem      input;
+    CameraController cameraController;
+    double           simulationTime = 0.0;   // end of the last simulated step, on input's clock
+    double           simulationStart = 0.0;
+    bool             overlayVisible = false;   // toggled with F1
+
+    // Logic/render thread hand-off
+    FramePacketExchange packets;
+    uint64_t            nextFrameNumber = 0;
+    std::atomic<bool>   framebufferResized{ false };   // set by the GLFW callback
+    std::exception_ptr  renderError;                   // rethrown on the main thread
+
+    VkExtent2D headlessExtent{};   // framebuffer size without a window
 };
 
@@ -1,13 +1,14 @@
 #include <iostream>
 #include "VulkanApp.h"
 
-int main() {
-    VulkanApp app;
+int main(int argc, char** argv) {
+    VulkanApp app(parseRenderSettings(argc, argv));
 
     try {
         app.run();
     }
     catch (const std::exception& e) {
+        Logger::global().flush();   // queued messages usually explain the failure
         std::cerr << "Error: " << e.what() << std::endl;
         return EXIT_FAILURE;
     }
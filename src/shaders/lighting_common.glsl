@@ -0,0 +1,27 @@
+// Shared clustered-lighting declarations for lit.vert, lit.frag and light_cull.comp.
+// Layout must match ClusteredLighting.cpp.
+
+#define MAX_LIGHTS_PER_CLUSTER 128
+
+layout(set = 0, binding = 0) uniform FrameUniforms {
+    mat4  viewProj;
+    mat4  view;
+    vec4  cameraPosition;
+    vec4  projParams;      // tan(fovX/2), tan(fovY/2), near, far
+    vec4  clusterParams;   // slice scale, slice bias, tile width, tile height (pixels)
+    vec4  screenSize;      // width, height
+    uvec4 clusterGrid;     // grid x, y, z, light count
+} frame;
+
+struct Light {
+    vec4 positionRadius;   // world-space position, radius of influence
+    vec4 colorIntensity;
+};
+
+layout(set = 0, binding = 1) readonly buffer Lights { Light lights[]; };
+layout(set = 0, binding = 2) CLUSTER_ACCESS buffer ClusterCounts { uint clusterCounts[]; };
+layout(set = 0, binding = 3) CLUSTER_ACCESS buffer ClusterLights { uint clusterLights[]; };
+
+uint clusterIndex(uvec3 cluster) {
+    return cluster.x + frame.clusterGrid.x * (cluster.y + frame.clusterGrid.y * cluster.z);
+}
@@ -0,0 +1,61 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// Clustered forward shading: only the lights binned into this fragment's
+// cluster by light_cull.comp are evaluated.
+#define CLUSTER_ACCESS readonly
+#include "lighting_common.glsl"
+
+layout(location = 0) in vec3 fragWorldPos;
+layout(location = 1) in vec3 fragNormal;
+layout(location = 2) in vec3 fragAlbedo;
+
+layout(location = 0) out vec4 outColor;
+
+const vec3 AMBIENT = vec3(0.03);
+
+uvec3 fragmentCluster() {
+    float depth = -(frame.view * vec4(fragWorldPos, 1.0)).z;
+    float slice = log(max(depth, frame.projParams.z)) * frame.clusterParams.x + frame.clusterParams.y;
+
+    uvec3 cluster;
+    cluster.xy = uvec2(gl_FragCoord.xy / frame.clusterParams.zw);
+    cluster.z = uint(max(slice, 0.0));
+    return min(cluster, frame.clusterGrid.xyz - 1u);
+}
+
+void main() {
+    vec3 N = normalize(fragNormal);
+    vec3 V = normalize(frame.cameraPosition.xyz - fragWorldPos);
+
+    uint cluster = clusterIndex(fragmentCluster());
+    uint count = clusterCounts[cluster];
+    uint base = cluster * MAX_LIGHTS_PER_CLUSTER;
+
+    vec3 color = AMBIENT * fragAlbedo;
+    for (uint i = 0; i < count; i++) {
+        Light light = lights[clusterLights[base + i]];
+
+        vec3 L = light.positionRadius.xyz - fragWorldPos;
+        float dist2 = dot(L, L);
+        float radius2 = light.positionRadius.w * light.positionRadius.w;
+        if (dist2 >= radius2) {
+            continue;
+        }
+
+        // Inverse-square falloff windowed to reach zero at the light's radius.
+        float window = 1.0 - (dist2 * dist2) / (radius2 * radius2);
+        float attenuation = window * window / (dist2 + 1.0);
+
+        L *= inversesqrt(dist2);
+        vec3 H = normalize(L + V);
+        float diffuse = max(dot(N, L), 0.0);
+        float specular = pow(max(dot(N, H), 0.0), 32.0) * 0.25;
+
+        vec3 radiance = light.colorIntensity.rgb * light.colorIntensity.w * attenuation;
+        color += radiance * (fragAlbedo * diffuse + specular * diffuse);
+    }
+
+    // Simple Reinhard so dense light clusters do not clip to white.
+    outColor = vec4(color / (1.0 + color), 1.0);
+}
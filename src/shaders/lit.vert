@@ -0,0 +1,74 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// Lit scene: instance 0 is the floor, the others a GRID x GRID field of boxes.
+// Geometry is generated from the vertex/instance index; no vertex buffers.
+#define CLUSTER_ACCESS readonly
+#include "lighting_common.glsl"
+
+const uint  GRID = 16;          // must match LIT_SCENE_GRID in Renderer.cpp
+const float SPACING = 3.0;
+const float FLOOR_HALF_EXTENT = 26.0;
+
+layout(location = 0) out vec3 fragWorldPos;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec3 fragAlbedo;
+
+// Must match the depth pre-pass bit for bit.
+invariant gl_Position;
+
+// Per face: outward normal, tangent, bitangent with tangent x bitangent = normal.
+const vec3 faceAxes[18] = vec3[](
+    vec3( 1, 0, 0), vec3( 0, 0,-1), vec3(0, 1, 0),
+    vec3(-1, 0, 0), vec3( 0, 0, 1), vec3(0, 1, 0),
+    vec3( 0, 1, 0), vec3( 1, 0, 0), vec3(0, 0,-1),
+    vec3( 0,-1, 0), vec3( 1, 0, 0), vec3(0, 0, 1),
+    vec3( 0, 0, 1), vec3( 1, 0, 0), vec3(0, 1, 0),
+    vec3( 0, 0,-1), vec3(-1, 0, 0), vec3(0, 1, 0)
+);
+
+// Clockwise as seen from outside, matching the pipeline's front face.
+const vec2 corners[6] = vec2[](
+    vec2(-1, -1), vec2( 1,  1), vec2( 1, -1),
+    vec2(-1, -1), vec2(-1,  1), vec2( 1,  1)
+);
+
+float hash(uint x) {
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return float(x) / 4294967295.0;
+}
+
+void main() {
+    uint face = uint(gl_VertexIndex) / 6;
+    vec2 corner = corners[gl_VertexIndex % 6];
+    vec3 n = faceAxes[face * 3];
+    vec3 t = faceAxes[face * 3 + 1];
+    vec3 b = faceAxes[face * 3 + 2];
+
+    vec3 position;
+    if (gl_InstanceIndex == 0) {
+        // Floor: only the +Y face; other vertices collapse to a point and are culled.
+        if (face != 2) {
+            gl_Position = vec4(0.0);
+            return;
+        }
+        position = (corner.x * t + corner.y * b) * FLOOR_HALF_EXTENT;
+        fragAlbedo = vec3(0.55);
+    }
+    else {
+        uint box = uint(gl_InstanceIndex) - 1;
+        vec2 cell = vec2(box % GRID, box / GRID) - float(GRID - 1) * 0.5;
+        float height = 0.5 + 2.5 * hash(box);
+        vec3 halfSize = vec3(0.6, height, 0.6);
+        vec3 center = vec3(cell.x * SPACING, height, cell.y * SPACING);
+
+        position = center + (n + corner.x * t + corner.y * b) * halfSize;
+        fragAlbedo = mix(vec3(0.6), vec3(hash(box * 3 + 1), hash(box * 3 + 2), hash(box * 3 + 3)), 0.3);
+    }
+
+    fragWorldPos = position;
+    fragNormal = n;
+    gl_Position = frame.viewProj * vec4(position, 1.0);
+}
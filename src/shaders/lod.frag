@@ -0,0 +1,13 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+layout(location = 0) in vec3 fragNormal;
+layout(location = 1) flat in uint fragLod;
+
+#include "lod_common.glsl"
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = shadeRock(normalize(fragNormal), fragLod, 1.0);
+}
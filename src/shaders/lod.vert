@@ -0,0 +1,32 @@
+#version 450
+
+// Instanced rock; LodScene groups instances by LOD and issues one draw per LOD.
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+
+struct Instance {
+    mat4 model;    // world matrix from the transform hierarchy (uniform scale)
+    vec4 lod;      // x = LOD
+};
+layout(set = 0, binding = 0) readonly buffer Instances { Instance instances[]; };
+
+layout(push_constant) uniform Push {
+    mat4 viewProj;
+    vec4 lightDirTint;   // xyz = towards the light, w = 1 to tint by LOD
+} pc;
+
+layout(location = 0) out vec3 fragNormal;
+layout(location = 1) flat out uint fragLod;
+layout(location = 2) out vec3 fragWorldPos;   // read by lod_shadowed.frag only
+
+invariant gl_Position;
+
+void main() {
+    Instance inst = instances[gl_InstanceIndex];
+
+    vec4 worldPos = inst.model * vec4(inPosition, 1.0);
+    gl_Position = pc.viewProj * worldPos;
+    fragWorldPos = worldPos.xyz;
+    fragNormal = mat3(inst.model) * inNormal;   // uniform scale: renormalized in the fragment shader
+    fragLod = uint(inst.lod.x);
+}
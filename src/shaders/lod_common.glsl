@@ -0,0 +1,22 @@
+// Shared by lod.frag and lod_shadowed.frag; must match LodScene's push constants.
+
+layout(push_constant) uniform Push {
+    mat4 viewProj;
+    vec4 lightDirTint;   // xyz = towards the light, w = 1 to tint by LOD
+} pc;
+
+const vec3 lodColors[6] = vec3[](
+    vec3(1.0, 0.3, 0.3), vec3(1.0, 0.7, 0.2), vec3(0.9, 1.0, 0.3),
+    vec3(0.3, 1.0, 0.4), vec3(0.3, 0.7, 1.0), vec3(0.7, 0.4, 1.0)
+);
+
+// `lit` scales the direct light: 1 unshadowed, 0 fully in shadow.
+vec4 shadeRock(vec3 normal, uint lod, float lit) {
+    vec3 albedo = vec3(0.55, 0.5, 0.45);
+    if (pc.lightDirTint.w > 0.5) {
+        albedo = lodColors[min(lod, 5u)];
+    }
+
+    float diffuse = max(dot(normal, normalize(pc.lightDirTint.xyz)), 0.0);
+    return vec4(albedo * (0.15 + 0.85 * diffuse * lit), 1.0);
+}
@@ -0,0 +1,49 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// lod.frag plus cascaded shadows from CascadedShadowMap.
+layout(location = 0) in vec3 fragNormal;
+layout(location = 1) flat in uint fragLod;
+layout(location = 2) in vec3 fragWorldPos;
+
+#include "lod_common.glsl"
+
+layout(set = 1, binding = 0) uniform Shadows {
+    mat4 cascadeViewProj[4];
+    vec4 splitFar;         // view depth where each cascade ends
+    vec4 texelSize;        // world units per texel, per cascade
+    vec4 cameraPosition;   // w = cascade count
+    vec4 cameraForward;
+} shadows;
+layout(set = 1, binding = 1) uniform sampler2DArrayShadow shadowMap;
+
+layout(location = 0) out vec4 outColor;
+
+float shadowFactor(vec3 worldPos, vec3 normal) {
+    uint count = uint(shadows.cameraPosition.w);
+    float depth = dot(worldPos - shadows.cameraPosition.xyz, shadows.cameraForward.xyz);
+    if (depth > shadows.splitFar[count - 1]) return 1.0;
+
+    uint cascade = 0;
+    while (cascade + 1 < count && depth > shadows.splitFar[cascade]) cascade++;
+
+    // Normal offset of about a texel keeps surfaces from shadowing themselves.
+    vec3 offsetPos = worldPos + normal * (1.5 * shadows.texelSize[cascade]);
+    vec4 clip = shadows.cascadeViewProj[cascade] * vec4(offsetPos, 1.0);
+    vec2 uv = clip.xy * 0.5 + 0.5;
+
+    // 3x3 PCF; the map is sampled with NEAREST, so every tap is one comparison.
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    float lit = 0.0;
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+            lit += texture(shadowMap, vec4(uv + vec2(x, y) * texel, float(cascade), clip.z));
+        }
+    }
+    return lit / 9.0;
+}
+
+void main() {
+    vec3 normal = normalize(fragNormal);
+    outColor = shadeRock(normal, fragLod, shadowFactor(fragWorldPos, normal));
+}
@@ -0,0 +1,22 @@
+#version 450
+
+// Deliberately expensive shading so overdraw dominates the frame.
+layout(push_constant) uniform Push {
+    uint layerCount;
+    uint shadingIterations;
+} pc;
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragUV;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    vec2 p = fragUV;
+    vec3 accum = vec3(0.0);
+    for (uint i = 0u; i < pc.shadingIterations; ++i) {
+        p = vec2(sin(p.x * 3.1 + p.y), cos(p.y * 2.7 - p.x)) + fragUV;
+        accum += vec3(p, p.x * p.y);
+    }
+    outColor = vec4(fragColor * (0.75 + 0.25 * fract(accum * 0.01)), 1.0);
+}
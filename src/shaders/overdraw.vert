@@ -0,0 +1,40 @@
+#version 450
+
+// Overdraw benchmark: `layerCount` nearly full-screen quads, one per instance.
+// Instance 0 is the farthest layer, so layers arrive back to front, which is the
+// worst case for early-Z without a depth pre-pass.
+layout(push_constant) uniform Push {
+    uint layerCount;
+    uint shadingIterations;
+} pc;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragUV;
+
+// The depth pre-pass and the shading pass must produce bit-identical depth
+// for the EQUAL test to pass.
+invariant gl_Position;
+
+// Clockwise on screen to match the pipeline's front face.
+vec2 corners[6] = vec2[](
+    vec2(-1.0, -1.0),
+    vec2( 1.0, -1.0),
+    vec2( 1.0,  1.0),
+    vec2(-1.0, -1.0),
+    vec2( 1.0,  1.0),
+    vec2(-1.0,  1.0)
+);
+
+void main() {
+    uint layer = uint(gl_InstanceIndex);
+    float t = float(layer) / float(max(pc.layerCount, 1u));
+
+    // Jitter each layer a little so edges stay visible.
+    vec2 offset = 0.1 * vec2(sin(float(layer) * 1.7), cos(float(layer) * 2.3));
+    vec2 corner = corners[gl_VertexIndex];
+    float depth = 1.0 - float(layer + 1u) / float(pc.layerCount + 1u);
+
+    gl_Position = vec4(corner * 0.85 + offset, depth, 1.0);
+    fragColor = vec3(t, 1.0 - t, 0.5 + 0.5 * sin(float(layer)));
+    fragUV = corner * 0.5 + 0.5;
+}
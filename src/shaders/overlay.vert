@@ -0,0 +1,20 @@
+#version 450
+
+// Screen-space overlay quads (text and rectangles), positions in framebuffer pixels.
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec4 inColor;
+
+layout(push_constant) uniform Push {
+    vec2 scale;    // 2 / framebuffer size
+    vec2 offset;   // -1, -1
+} pc;
+
+layout(location = 0) out vec2 fragUV;
+layout(location = 1) out vec4 fragColor;
+
+void main() {
+    gl_Position = vec4(inPosition * pc.scale + pc.offset, 0.0, 1.0);
+    fragUV = inUV;
+    fragColor = inColor;
+}
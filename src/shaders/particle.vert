@@ -0,0 +1,42 @@
+#version 450
+
+// Camera-facing quad per alive particle; instance i draws aliveList[i].
+struct Particle {
+    vec4 positionLife;
+    vec4 velocityMaxLife;
+};
+
+layout(set = 0, binding = 0) readonly buffer Particles { Particle particles[]; };
+layout(set = 0, binding = 1) readonly buffer AliveList { uint aliveList[]; };
+
+layout(push_constant) uniform Push {
+    mat4 viewProj;
+    vec4 cameraRight;   // w = half size
+    vec4 cameraUp;
+} pc;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragCorner;
+
+vec2 corners[6] = vec2[](
+    vec2(-1.0, -1.0),
+    vec2( 1.0, -1.0),
+    vec2( 1.0,  1.0),
+    vec2(-1.0, -1.0),
+    vec2( 1.0,  1.0),
+    vec2(-1.0,  1.0)
+);
+
+void main() {
+    Particle p = particles[aliveList[gl_InstanceIndex]];
+    float age = 1.0 - clamp(p.positionLife.w / p.velocityMaxLife.w, 0.0, 1.0);
+
+    vec2 corner = corners[gl_VertexIndex];
+    float size = pc.cameraRight.w * mix(1.0, 2.5, age);
+    vec3 world = p.positionLife.xyz
+               + (corner.x * pc.cameraRight.xyz + corner.y * pc.cameraUp.xyz) * size;
+
+    gl_Position = pc.viewProj * vec4(world, 1.0);
+    fragColor = vec4(mix(vec3(1.0, 0.85, 0.4), vec3(0.9, 0.25, 0.05), age), 1.0 - age);
+    fragCorner = corner;
+}
@@ -0,0 +1,51 @@
+// Shared particle declarations for the particle_*.comp shaders.
+// Buffer layout must match ParticleSystem.cpp.
+
+#define WORKGROUP_SIZE 256
+
+struct Particle {
+    vec4 positionLife;      // xyz = position, w = remaining life (s)
+    vec4 velocityMaxLife;   // xyz = velocity, w = initial life (s)
+};
+
+layout(set = 0, binding = 0) readonly  buffer ParticlesIn  { Particle particlesIn[]; };
+layout(set = 0, binding = 1) writeonly buffer ParticlesOut { Particle particlesOut[]; };
+layout(set = 0, binding = 2) readonly  buffer AliveIn      { uint aliveIn[]; };
+layout(set = 0, binding = 3) writeonly buffer AliveOut     { uint aliveOut[]; };
+layout(set = 0, binding = 4)           buffer DeadList     { uint deadList[]; };
+
+layout(set = 0, binding = 5) buffer Counters {
+    int   deadCount;
+    uint  aliveCount[2];
+    uint  pad;
+    uvec4 simulateDispatch[2];   // VkDispatchIndirectCommand + pad, per parity
+};
+
+struct DrawCommand {
+    uint vertexCount;
+    uint instanceCount;
+    uint firstVertex;
+    uint firstInstance;
+};
+layout(set = 0, binding = 6) buffer DrawArgs { DrawCommand drawArgs[2]; };
+
+layout(push_constant) uniform Push {
+    float deltaTime;
+    float time;
+    uint  emitCount;
+    uint  outParity;
+    uint  maxParticles;
+    uint  seed;
+} pc;
+
+uint hash(uint x) {
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+float random01(inout uint state) {
+    state = hash(state);
+    return float(state) / 4294967295.0;
+}
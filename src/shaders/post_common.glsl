@@ -0,0 +1,39 @@
+// Shared by the post_*.comp passes; must match PostProcess.cpp.
+
+const uint HISTOGRAM_BINS = 256;
+// Bin 0 counts (near) black pixels; bins 1..255 split log2 luminance evenly
+// over [MIN_LOG_LUMINANCE, MIN_LOG_LUMINANCE + LOG_LUMINANCE_RANGE].
+const float MIN_LOG_LUMINANCE = -10.0;
+const float LOG_LUMINANCE_RANGE = 22.0;
+
+layout(set = 0, binding = 2, std430) buffer Luminance {
+    uint  histogram[HISTOGRAM_BINS];
+    float exposure;            // scene -> display scale, adapted over time
+    float averageLuminance;    // what the exposure is adapting to
+} luminanceState;
+
+float luminance(vec3 color) {
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+uint luminanceBin(float value) {
+    if (value < 1e-5) {
+        return 0u;
+    }
+    float t = clamp((log2(value) - MIN_LOG_LUMINANCE) / LOG_LUMINANCE_RANGE, 0.0, 1.0);
+    return uint(t * 254.0 + 1.0);
+}
+
+// 3x3 tent filter around `uv`; `texel` is one texel of `source` in UV units.
+vec3 sampleTent(sampler2D source, vec2 uv, vec2 texel) {
+    vec3 sum = textureLod(source, uv, 0.0).rgb * 4.0;
+    sum += (textureLod(source, uv + vec2(-texel.x, 0.0), 0.0).rgb +
+            textureLod(source, uv + vec2( texel.x, 0.0), 0.0).rgb +
+            textureLod(source, uv + vec2(0.0, -texel.y), 0.0).rgb +
+            textureLod(source, uv + vec2(0.0,  texel.y), 0.0).rgb) * 2.0;
+    sum += textureLod(source, uv + vec2(-texel.x, -texel.y), 0.0).rgb +
+           textureLod(source, uv + vec2( texel.x, -texel.y), 0.0).rgb +
+           textureLod(source, uv + vec2(-texel.x,  texel.y), 0.0).rgb +
+           textureLod(source, uv + vec2( texel.x,  texel.y), 0.0).rgb;
+    return sum / 16.0;
+}
@@ -2,6 +2,9 @@
 
 layout(location = 0) out vec3 fragColor;
 
+// Shared with the depth pre-pass, which must produce identical depth.
+invariant gl_Position;
+
 vec2 positions[3] = vec2[](
     vec2(0.0, -0.5),
     vec2(0.5, 0.5),
@@ -0,0 +1,18 @@
+#version 450
+
+// Shadow caster: depth only, drawn once per cascade with that cascade's matrix.
+layout(location = 0) in vec3 inPosition;
+
+struct Instance {
+    mat4 model;
+    vec4 lod;      // unused here; same layout as lod.vert
+};
+layout(set = 0, binding = 0) readonly buffer Instances { Instance instances[]; };
+
+layout(push_constant) uniform Push {
+    mat4 viewProj;   // cascade's light-space view-projection
+} pc;
+
+void main() {
+    gl_Position = pc.viewProj * (instances[gl_InstanceIndex].model * vec4(inPosition, 1.0));
+}
@@ -0,0 +1,23 @@
+#version 450
+
+layout(location = 0) in vec3 fragNormal;
+layout(location = 1) flat in uint fragCharacter;
+
+layout(push_constant) uniform Push {
+    mat4 viewProj;
+    vec4 lightDir;   // xyz = towards the light
+} pc;
+
+layout(location = 0) out vec4 outColor;
+
+// A few shirt colours so neighbours are told apart.
+const vec3 palette[6] = vec3[](
+    vec3(0.75, 0.3, 0.25), vec3(0.25, 0.45, 0.75), vec3(0.3, 0.65, 0.35),
+    vec3(0.8, 0.7, 0.3), vec3(0.55, 0.35, 0.7), vec3(0.6, 0.6, 0.6)
+);
+
+void main() {
+    vec3 albedo = palette[(fragCharacter * 2654435761u >> 16) % 6u];
+    float diffuse = max(dot(normalize(fragNormal), normalize(pc.lightDir.xyz)), 0.0);
+    outColor = vec4(albedo * (0.2 + 0.8 * diffuse), 1.0);
+}
@@ -0,0 +1,36 @@
+#version 450
+
+// Instanced skinned character: one instance per character, its joint palette at
+// gl_InstanceIndex * JOINT_COUNT. The palettes already include each character's
+// world transform, so skinning lands straight in world space.
+layout(location = 0) in vec3  inPosition;
+layout(location = 1) in vec3  inNormal;
+layout(location = 2) in uvec4 inJoints;
+layout(location = 3) in vec4  inWeights;
+
+// Must match WalkerJointCount (src/Animation.h).
+const uint JOINT_COUNT = 16;
+
+layout(set = 0, binding = 0) readonly buffer Palettes { mat4 joints[]; };
+
+layout(push_constant) uniform Push {
+    mat4 viewProj;
+    vec4 lightDir;   // xyz = towards the light
+} pc;
+
+layout(location = 0) out vec3 fragNormal;
+layout(location = 1) flat out uint fragCharacter;
+
+invariant gl_Position;
+
+void main() {
+    uint base = uint(gl_InstanceIndex) * JOINT_COUNT;
+    mat4 skin = inWeights.x * joints[base + inJoints.x]
+              + inWeights.y * joints[base + inJoints.y]
+              + inWeights.z * joints[base + inJoints.z]
+              + inWeights.w * joints[base + inJoints.w];
+
+    gl_Position = pc.viewProj * (skin * vec4(inPosition, 1.0));
+    fragNormal = mat3(skin) * inNormal;   // rigid joints: renormalized in the fragment shader
+    fragCharacter = uint(gl_InstanceIndex);
+}
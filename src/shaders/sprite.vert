@@ -0,0 +1,34 @@
+#version 450
+
+// Instanced 2D sprites: six vertices per instance, corners from gl_VertexIndex.
+layout(location = 0) in vec2  inCenter;     // framebuffer pixels
+layout(location = 1) in vec2  inHalfSize;
+layout(location = 2) in vec4  inUVRect;     // u0, v0, u1, v1
+layout(location = 3) in float inRotation;   // radians, clockwise on screen
+layout(location = 4) in vec4  inColor;
+
+layout(push_constant) uniform Push {
+    vec2 scale;    // 2 / framebuffer size
+    vec2 offset;   // -1, -1
+} pc;
+
+layout(location = 0) out vec2 fragUV;
+layout(location = 1) out vec4 fragColor;
+
+// Two triangles: (0,1,2) and (2,1,3) over the corners of a unit quad.
+const vec2 CORNERS[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0),
+    vec2(-1.0,  1.0), vec2(1.0, -1.0), vec2(1.0, 1.0)
+);
+
+void main() {
+    vec2 corner = CORNERS[gl_VertexIndex];
+    vec2 local = corner * inHalfSize;
+    float s = sin(inRotation);
+    float c = cos(inRotation);
+    vec2 position = inCenter + vec2(local.x * c - local.y * s, local.x * s + local.y * c);
+
+    gl_Position = vec4(position * pc.scale + pc.offset, 0.0, 1.0);
+    fragUV = mix(inUVRect.xy, inUVRect.zw, corner * 0.5 + 0.5);
+    fragColor = inColor;
+}